@@ -5,9 +5,12 @@ CLOUD_SERVER_SOURCES = \
 	$(SRC)/Cloud/Client.cpp \
 	$(SRC)/Cloud/Thermal.cpp \
 	$(SRC)/Cloud/Data.cpp \
+	$(SRC)/Cloud/Records.cpp \
+	$(SRC)/Cloud/Journal.cpp \
+	$(SRC)/Cloud/Shards.cpp \
 	$(SRC)/Cloud/Sender.cpp \
 	$(SRC)/Cloud/Main.cpp
-CLOUD_SERVER_DEPENDS = ASYNC LIBNET IO OS GEO MATH UTIL
+CLOUD_SERVER_DEPENDS = ASYNC LIBNET IO OS THREAD GEO MATH UTIL
 $(eval $(call link-program,xcsoar-cloud-server,CLOUD_SERVER))
 
 CLOUD_TO_KML_SOURCES = \
@@ -16,6 +19,7 @@ CLOUD_TO_KML_SOURCES = \
 	$(SRC)/Cloud/Client.cpp \
 	$(SRC)/Cloud/Thermal.cpp \
 	$(SRC)/Cloud/Data.cpp \
+	$(SRC)/Cloud/Records.cpp \
 	$(SRC)/Cloud/ToKML.cpp
 CLOUD_TO_KML_DEPENDS = ASYNC LIBNET IO OS GEO MATH UTIL
 $(eval $(call link-program,xcsoar-cloud-to-kml,CLOUD_TO_KML))
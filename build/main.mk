@@ -88,6 +88,7 @@ DIALOG_SOURCES = \
 	$(SRC)/Dialogs/StatusPanels/TaskStatusPanel.cpp \
 	$(SRC)/Dialogs/StatusPanels/RulesStatusPanel.cpp \
 	$(SRC)/Dialogs/StatusPanels/TimesStatusPanel.cpp \
+	$(SRC)/Dialogs/StatusPanels/ProfilerStatusPanel.cpp \
 	\
 	$(SRC)/Dialogs/Waypoint/WaypointInfoWidget.cpp \
 	$(SRC)/Dialogs/Waypoint/WaypointCommandsWidget.cpp \
@@ -241,12 +242,16 @@ XCSOAR_SOURCES := \
 	$(SRC)/Logger/LoggerImpl.cpp \
 	$(SRC)/IGC/IGCFix.cpp \
 	$(SRC)/IGC/IGCWriter.cpp \
+	$(SRC)/IGC/AsyncIGCWriter.cpp \
 	$(SRC)/IGC/IGCString.cpp \
 	$(SRC)/IGC/Generator.cpp \
 	$(SRC)/util/MD5.cpp \
 	$(SRC)/system/OpenLink.cpp \
 	$(SRC)/util/MarkdownParser.cpp \
 	$(SRC)/Logger/NMEALogger.cpp \
+	$(SRC)/Logger/SensorLog.cpp \
+	$(SRC)/Logger/SensorSample.cpp \
+	$(SRC)/Logger/SensorLogger.cpp \
 	$(SRC)/Logger/ExternalLogger.cpp \
 	$(SRC)/Logger/FlightLogger.cpp \
 	$(SRC)/Logger/GlueFlightLogger.cpp \
@@ -254,6 +259,7 @@ XCSOAR_SOURCES := \
 	$(SRC)/IGC/IGCParser.cpp \
 	$(SRC)/Replay/IgcReplay.cpp \
 	$(SRC)/Replay/NmeaReplay.cpp \
+	$(SRC)/Replay/SensorReplay.cpp \
 	$(SRC)/Replay/DemoReplay.cpp \
 	$(SRC)/Replay/DemoReplayGlue.cpp \
 	$(SRC)/Replay/TaskAutoPilot.cpp \
@@ -340,6 +346,7 @@ XCSOAR_SOURCES := \
 	$(SRC)/Renderer/AircraftRenderer.cpp \
 	$(SRC)/Renderer/AirspaceRenderer.cpp \
 	$(SRC)/Renderer/AirspaceRendererGL.cpp \
+	$(SRC)/Renderer/AirspaceGeometryCache.cpp \
 	$(SRC)/Renderer/AirspaceRendererOther.cpp \
 	$(SRC)/Renderer/AirspaceLabelList.cpp \
 	$(SRC)/Renderer/AirspaceLabelRenderer.cpp \
@@ -367,6 +374,7 @@ XCSOAR_SOURCES := \
 	$(SRC)/UIUtil/GestureManager.cpp \
 	$(SRC)/UIUtil/TrackingGestureManager.cpp \
 	$(SRC)/DrawThread.cpp \
+	$(SRC)/Profiler/FrameProfiler.cpp \
 	\
 	$(SRC)/Weather/Rasp/RaspStore.cpp \
 	$(SRC)/Weather/Rasp/RaspCache.cpp \
@@ -39,6 +39,11 @@ endif
 # compile without UI?
 HEADLESS ?= n
 
+# the maximum number of FLARM/ADS-B traffic objects in each
+# blackboard; larger values make every NMEAInfo copy more expensive
+MAX_TRAFFIC ?= 32
+TARGET_CPPFLAGS += -DFLARM_MAX_TRAFFIC=$(MAX_TRAFFIC)
+
 ifeq ($(TARGET_IS_KOBO),y)
   DITHER ?= y
 else
@@ -146,6 +146,10 @@ SCREEN_SOURCES += \
 	$(CANVAS_SRC_DIR)/opengl/Triangulate.cpp
 endif
 
+ifeq ($(call bool_and,$(OPENGL),$(FREETYPE)),y)
+SCREEN_SOURCES += $(CANVAS_SRC_DIR)/opengl/GlyphAtlas.cpp
+endif
+
 ifeq ($(ENABLE_SDL),y)
 SCREEN_SOURCES += $(SCREEN_CUSTOM_SOURCES)
 SCREEN_SOURCES += $(SCREEN_CUSTOM_SOURCES_IMG)
@@ -78,6 +78,11 @@ TEST_NAMES = \
 	test_task \
 	TestInputTransformMode \
 	TestOverwritingRingBuffer \
+	TestFrameProfiler \
+	TestShapeTileIndex \
+	TestSensorLog \
+	TestLabelBlock \
+	TestPixelOperations \
 	TestDateTime TestRoughTime TestWrapClock \
 	TestPolylineDecoder \
 	TestTransponderCode \
@@ -91,9 +96,11 @@ TEST_NAMES = \
 	TestRadixTree TestGeoBounds TestGeoClip \
 	TestLogger TestGRecord TestClimbAvCalc \
 	TestWaypointReader TestThermalBase \
-	TestFlarmNet TestFlarmMessaging \
+	TestFlarmNet TestFlarmMessaging TestTrafficList \
+	TestDeviceBlackboard \
+	TestVarioSynthesiser \
 	TestColorRamp TestGeoPoint TestDiffFilter \
-	TestFileUtil TestPolars TestCSVLine TestGlidePolar \
+	TestFileUtil TestPolars TestCSVLine TestNMEAInputLine TestGlidePolar \
 	test_replay_task TestProjection TestFlatPoint TestFlatLine TestFlatGeoPoint \
 	TestMacCready TestOrderedTask TestAATPoint TestTaskSave \
 	TestTaskFileSeeYouParsing \
@@ -137,6 +144,11 @@ ifeq ($(HAVE_WIN32),y)
 TEST_NAMES += TestUTF8Win
 endif
 
+ifeq ($(TARGET),UNIX)
+# the cloud server is built only for UNIX, see cloud.mk
+TEST_NAMES += TestCloudJournal TestCloudTrack
+endif
+
 TESTS = $(call name-to-bin,$(TEST_NAMES))
 
 TEST_HEX_STRING_SOURCES = \
@@ -177,6 +189,40 @@ TEST_OVERWRITING_RING_BUFFER_SOURCES = \
 TEST_OVERWRITING_RING_BUFFER_DEPENDS = MATH
 $(eval $(call link-program,TestOverwritingRingBuffer,TEST_OVERWRITING_RING_BUFFER))
 
+TEST_FRAME_PROFILER_SOURCES = \
+	$(SRC)/Profiler/FrameProfiler.cpp \
+	$(TEST_SRC_DIR)/tap.c \
+	$(TEST_SRC_DIR)/TestFrameProfiler.cpp
+TEST_FRAME_PROFILER_DEPENDS = IO OS UTIL FMT
+$(eval $(call link-program,TestFrameProfiler,TEST_FRAME_PROFILER))
+
+TEST_SHAPE_TILE_INDEX_SOURCES = \
+	$(SRC)/Topography/ShapeTileIndex.cpp \
+	$(TEST_SRC_DIR)/tap.c \
+	$(TEST_SRC_DIR)/TestShapeTileIndex.cpp
+TEST_SHAPE_TILE_INDEX_DEPENDS = IO UTIL
+$(eval $(call link-program,TestShapeTileIndex,TEST_SHAPE_TILE_INDEX))
+
+TEST_SENSOR_LOG_SOURCES = \
+	$(SRC)/Logger/SensorLog.cpp \
+	$(TEST_SRC_DIR)/tap.c \
+	$(TEST_SRC_DIR)/TestSensorLog.cpp
+TEST_SENSOR_LOG_DEPENDS = IO UTIL
+$(eval $(call link-program,TestSensorLog,TEST_SENSOR_LOG))
+
+TEST_LABEL_BLOCK_SOURCES = \
+	$(SRC)/Renderer/LabelBlock.cpp \
+	$(TEST_SRC_DIR)/tap.c \
+	$(TEST_SRC_DIR)/TestLabelBlock.cpp
+TEST_LABEL_BLOCK_DEPENDS = UTIL
+$(eval $(call link-program,TestLabelBlock,TEST_LABEL_BLOCK))
+
+TEST_PIXEL_OPERATIONS_SOURCES = \
+	$(TEST_SRC_DIR)/tap.c \
+	$(TEST_SRC_DIR)/TestPixelOperations.cpp
+TEST_PIXEL_OPERATIONS_DEPENDS = UTIL
+$(eval $(call link-program,TestPixelOperations,TEST_PIXEL_OPERATIONS))
+
 TEST_IGC_PARSER_SOURCES = \
 	$(SRC)/IGC/IGCParser.cpp \
 	$(TEST_SRC_DIR)/tap.c \
@@ -424,6 +470,12 @@ TEST_CSV_LINE_SOURCES = \
 TEST_CSV_LINE_DEPENDS = MATH
 $(eval $(call link-program,TestCSVLine,TEST_CSV_LINE))
 
+TEST_NMEA_INPUT_LINE_SOURCES = \
+	$(TEST_SRC_DIR)/tap.c \
+	$(TEST_SRC_DIR)/TestNMEAInputLine.cpp
+TEST_NMEA_INPUT_LINE_DEPENDS = LIBNMEA GEO MATH IO UTIL TIME UNITS
+$(eval $(call link-program,TestNMEAInputLine,TEST_NMEA_INPUT_LINE))
+
 TEST_GEO_BOUNDS_SOURCES = \
 	$(TEST_SRC_DIR)/tap.c \
 	$(TEST_SRC_DIR)/TestGeoBounds.cpp
@@ -441,6 +493,39 @@ TEST_FLARM_NET_SOURCES = \
 TEST_FLARM_NET_DEPENDS = IO OS MATH UTIL
 $(eval $(call link-program,TestFlarmNet,TEST_FLARM_NET))
 
+TEST_TRAFFIC_LIST_SOURCES = \
+	$(SRC)/FLARM/List.cpp \
+	$(SRC)/FLARM/Id.cpp \
+	$(TEST_SRC_DIR)/tap.c \
+	$(TEST_SRC_DIR)/TestTrafficList.cpp
+TEST_TRAFFIC_LIST_DEPENDS = MATH UTIL FMT
+$(eval $(call link-program,TestTrafficList,TEST_TRAFFIC_LIST))
+
+TEST_DEVICE_BLACKBOARD_SOURCES = \
+	$(SRC)/Blackboard/DeviceBlackboard.cpp \
+	$(SRC)/Device/DataEditor.cpp \
+	$(SRC)/Device/Simulator.cpp \
+	$(SRC)/Simulator.cpp \
+	$(SRC)/FLARM/List.cpp \
+	$(SRC)/Atmosphere/AirDensity.cpp \
+	$(SRC)/Engine/Navigation/TraceHistory.cpp \
+	$(ENGINE_SRC_DIR)/ThermalBand/ThermalBand.cpp \
+	$(ENGINE_SRC_DIR)/ThermalBand/ThermalSlice.cpp \
+	$(ENGINE_SRC_DIR)/ThermalBand/ThermalEncounterBand.cpp \
+	$(ENGINE_SRC_DIR)/ThermalBand/ThermalEncounterCollection.cpp \
+	$(TEST_SRC_DIR)/tap.c \
+	$(TEST_SRC_DIR)/TestDeviceBlackboard.cpp
+TEST_DEVICE_BLACKBOARD_DEPENDS = LIBCOMPUTER LIBNMEA TASK GLIDE GEO MATH TIME UTIL
+$(eval $(call link-program,TestDeviceBlackboard,TEST_DEVICE_BLACKBOARD))
+
+TEST_VARIO_SYNTHESISER_SOURCES = \
+	$(SRC)/Audio/ToneSynthesiser.cpp \
+	$(SRC)/Audio/VarioSynthesiser.cpp \
+	$(TEST_SRC_DIR)/tap.c \
+	$(TEST_SRC_DIR)/TestVarioSynthesiser.cpp
+TEST_VARIO_SYNTHESISER_DEPENDS = MATH UTIL
+$(eval $(call link-program,TestVarioSynthesiser,TEST_VARIO_SYNTHESISER))
+
 TEST_FLARM_MESSAGING_SOURCES = \
 	$(SRC)/FLARM/Id.cpp \
 	$(SRC)/FLARM/MessagingRecord.cpp \
@@ -531,6 +616,7 @@ TEST_NMEA_FORMATTER_SOURCES = \
 	$(SRC)/Device/Driver/FLARM/StaticParser.cpp \
 	$(SRC)/FLARM/Error.cpp \
 	$(SRC)/FLARM/Traffic.cpp \
+	$(SRC)/FLARM/List.cpp \
 	$(SRC)/FLARM/Id.cpp \
 	$(SRC)/Formatter/NMEAFormatter.cpp \
 	$(TEST_SRC_DIR)/tap.c \
@@ -703,6 +789,7 @@ $(eval $(call link-program,TestRadixTree,TEST_RADIX_TREE))
 TEST_LOGGER_SOURCES = \
 	$(SRC)/IGC/IGCFix.cpp \
 	$(SRC)/IGC/IGCWriter.cpp \
+	$(SRC)/IGC/AsyncIGCWriter.cpp \
 	$(SRC)/IGC/IGCString.cpp \
 	$(SRC)/IGC/Generator.cpp \
 	$(SRC)/Logger/LoggerFRecord.cpp \
@@ -713,7 +800,7 @@ TEST_LOGGER_SOURCES = \
 	$(SRC)/Atmosphere/Pressure.cpp \
 	$(TEST_SRC_DIR)/tap.c \
 	$(TEST_SRC_DIR)/TestLogger.cpp
-TEST_LOGGER_DEPENDS = IO OS GEO MATH UTIL UNITS
+TEST_LOGGER_DEPENDS = IO OS THREAD GEO MATH UTIL UNITS
 $(eval $(call link-program,TestLogger,TEST_LOGGER))
 
 TEST_GRECORD_SOURCES = \
@@ -814,6 +901,9 @@ DEBUG_PROGRAM_NAMES = \
 	FlightTable \
 	BenchmarkProjection \
 	BenchmarkFAITriangleSector \
+	BenchmarkNMEAInputLine \
+	BenchmarkIGCParser \
+	BenchmarkTopographyUpdate \
 	DumpTextInflate \
 	DumpHexColor \
 	RunXMLParser \
@@ -851,6 +941,7 @@ DEBUG_PROGRAM_NAMES += \
 	RunEnableNMEA \
 	CAI302Tool \
 	RunIGCWriter \
+	ConvertSensorLog \
 	RunFlightLogger RunFlyingComputer \
 	RunCirclingWind RunWindEKF RunWindComputer \
 	RunExternalWind \
@@ -885,6 +976,7 @@ endif
 ifeq ($(TARGET),UNIX)
 DEBUG_PROGRAM_NAMES += \
 	AnalyseFlight \
+	RunHeadlessReplay \
 	FeedFlyNetData
 endif
 
@@ -903,7 +995,7 @@ DEBUG_PROGRAM_NAMES += DownloadFile \
 endif
 
 ifeq ($(TARGET_IS_LINUX),y)
-DEBUG_PROGRAM_NAMES += RunWPASupplicant
+DEBUG_PROGRAM_NAMES += RunWPASupplicant BenchmarkCloudServer
 endif
 
 ifeq ($(HAVE_PCM_PLAYER)$(TARGET_IS_ANDROID),yn)
@@ -986,6 +1078,37 @@ BENCHMARK_FAI_TRIANGLE_SECTOR_SOURCES = \
 BENCHMARK_FAI_TRIANGLE_SECTOR_DEPENDS = GEO MATH
 $(eval $(call link-program,BenchmarkFAITriangleSector,BENCHMARK_FAI_TRIANGLE_SECTOR))
 
+BENCHMARK_NMEA_INPUT_LINE_SOURCES = \
+	$(TEST_SRC_DIR)/BenchmarkNMEAInputLine.cpp
+BENCHMARK_NMEA_INPUT_LINE_DEPENDS = LIBNMEA GEO MATH IO OS UTIL TIME UNITS
+$(eval $(call link-program,BenchmarkNMEAInputLine,BENCHMARK_NMEA_INPUT_LINE))
+
+BENCHMARK_IGC_PARSER_SOURCES = \
+	$(SRC)/IGC/IGCParser.cpp \
+	$(TEST_SRC_DIR)/BenchmarkIGCParser.cpp
+BENCHMARK_IGC_PARSER_DEPENDS = IO OS MATH UTIL
+$(eval $(call link-program,BenchmarkIGCParser,BENCHMARK_IGC_PARSER))
+
+BENCHMARK_TOPOGRAPHY_UPDATE_SOURCES = \
+	$(SRC)/Topography/ShapeFile.cpp \
+	$(SRC)/Topography/ShapeTileIndex.cpp \
+	$(SRC)/Topography/TopographyFile.cpp \
+	$(SRC)/Topography/TopographyStore.cpp \
+	$(SRC)/Topography/XShape.cpp \
+	$(SRC)/Topography/Index.cpp \
+	$(SRC)/Projection/Projection.cpp \
+	$(SRC)/Projection/WindowProjection.cpp \
+	$(SRC)/system/Path.cpp \
+	$(TEST_SRC_DIR)/FakeLogFile.cpp \
+	$(TEST_SRC_DIR)/BenchmarkTopographyUpdate.cpp
+ifeq ($(OPENGL),y)
+BENCHMARK_TOPOGRAPHY_UPDATE_SOURCES += \
+	$(CANVAS_SRC_DIR)/opengl/Triangulate.cpp
+endif
+BENCHMARK_TOPOGRAPHY_UPDATE_DEPENDS = SHAPELIB GEO MATH THREAD IO SYSTEM UTIL ZZIP
+BENCHMARK_TOPOGRAPHY_UPDATE_CPPFLAGS = $(SCREEN_CPPFLAGS)
+$(eval $(call link-program,BenchmarkTopographyUpdate,BENCHMARK_TOPOGRAPHY_UPDATE))
+
 DUMP_TEXT_FILE_SOURCES = \
 	$(TEST_SRC_DIR)/DumpTextFile.cpp
 DUMP_TEXT_FILE_DEPENDS = IO OS ZZIP UTIL
@@ -1093,6 +1216,34 @@ RUN_SL_TRACKING_SOURCES = \
 RUN_SL_TRACKING_DEPENDS = $(DEBUG_REPLAY_DEPENDS)
 $(eval $(call link-program,RunSkyLinesTracking,RUN_SL_TRACKING))
 
+TEST_CLOUD_JOURNAL_SOURCES = \
+	$(SRC)/Tracking/SkyLines/Assemble.cpp \
+	$(SRC)/Cloud/Serialiser.cpp \
+	$(SRC)/Cloud/Client.cpp \
+	$(SRC)/Cloud/Thermal.cpp \
+	$(SRC)/Cloud/Records.cpp \
+	$(SRC)/Cloud/Journal.cpp \
+	$(TEST_SRC_DIR)/tap.c \
+	$(TEST_SRC_DIR)/TestCloudJournal.cpp
+TEST_CLOUD_JOURNAL_DEPENDS = ASYNC LIBNET IO OS THREAD GEO MATH UTIL
+$(eval $(call link-program,TestCloudJournal,TEST_CLOUD_JOURNAL))
+
+TEST_CLOUD_TRACK_SOURCES = \
+	$(SRC)/IGC/IGCParser.cpp \
+	$(TEST_SRC_DIR)/CloudTrack.cpp \
+	$(TEST_SRC_DIR)/tap.c \
+	$(TEST_SRC_DIR)/TestCloudTrack.cpp
+TEST_CLOUD_TRACK_DEPENDS = IO OS GEO MATH UTIL
+$(eval $(call link-program,TestCloudTrack,TEST_CLOUD_TRACK))
+
+BENCHMARK_CLOUD_SERVER_SOURCES = \
+	$(SRC)/Tracking/SkyLines/Assemble.cpp \
+	$(SRC)/IGC/IGCParser.cpp \
+	$(TEST_SRC_DIR)/CloudTrack.cpp \
+	$(TEST_SRC_DIR)/BenchmarkCloudServer.cpp
+BENCHMARK_CLOUD_SERVER_DEPENDS = ASYNC LIBNET IO OS GEO MATH UTIL
+$(eval $(call link-program,BenchmarkCloudServer,BENCHMARK_CLOUD_SERVER))
+
 RUN_LIVETRACK24_SOURCES = \
 	$(DEBUG_REPLAY_SOURCES) \
 	$(SRC)/net/SocketError.cxx \
@@ -1547,6 +1698,15 @@ RUN_IGC_WRITER_SOURCES = \
 RUN_IGC_WRITER_DEPENDS = $(DEBUG_REPLAY_DEPENDS) GEO MATH UTIL
 $(eval $(call link-program,RunIGCWriter,RUN_IGC_WRITER))
 
+CONVERT_SENSOR_LOG_SOURCES = \
+	$(DEBUG_REPLAY_SOURCES) \
+	$(SRC)/Logger/SensorLog.cpp \
+	$(SRC)/Logger/SensorSample.cpp \
+	$(SRC)/io/FileMapping.cpp \
+	$(TEST_SRC_DIR)/ConvertSensorLog.cpp
+CONVERT_SENSOR_LOG_DEPENDS = $(DEBUG_REPLAY_DEPENDS) GEO MATH UTIL
+$(eval $(call link-program,ConvertSensorLog,CONVERT_SENSOR_LOG))
+
 RUN_FLIGHT_LOGGER_SOURCES = \
 	$(DEBUG_REPLAY_SOURCES) \
 	$(SRC)/Computer/CirclingComputer.cpp \
@@ -1694,9 +1854,56 @@ ANALYSE_FLIGHT_SOURCES = \
 	$(TEST_SRC_DIR)/FlightPhaseJSON.cpp \
 	$(TEST_SRC_DIR)/FlightPhaseDetector.cpp \
 	$(TEST_SRC_DIR)/AnalyseFlight.cpp
-ANALYSE_FLIGHT_DEPENDS = $(DEBUG_REPLAY_DEPENDS) CONTEST JSON UTIL GEO MATH TIME
+ANALYSE_FLIGHT_DEPENDS = $(DEBUG_REPLAY_DEPENDS) CONTEST JSON THREAD UTIL GEO MATH TIME
 $(eval $(call link-program,AnalyseFlight,ANALYSE_FLIGHT))
 
+RUN_HEADLESS_REPLAY_SOURCES = \
+	$(SRC)/MergeThread.cpp \
+	$(SRC)/CalculationThread.cpp \
+	$(SRC)/Blackboard/DeviceBlackboard.cpp \
+	$(SRC)/Simulator.cpp \
+	$(SRC)/Device/Simulator.cpp \
+	$(SRC)/Replay/IgcReplay.cpp \
+	$(SRC)/IGC/IGCParser.cpp \
+	$(SRC)/FLARM/Computer.cpp \
+	$(SRC)/FLARM/Calculations.cpp \
+	$(SRC)/FLARM/List.cpp \
+	$(SRC)/Atmosphere/AirDensity.cpp \
+	$(SRC)/Atmosphere/Pressure.cpp \
+	$(SRC)/Atmosphere/CuSonde.cpp \
+	$(SRC)/Engine/Util/Gradient.cpp \
+	$(SRC)/Engine/Navigation/Aircraft.cpp \
+	$(SRC)/Engine/Navigation/TraceHistory.cpp \
+	$(ENGINE_SRC_DIR)/Trace/Point.cpp \
+	$(ENGINE_SRC_DIR)/Trace/Trace.cpp \
+	$(ENGINE_SRC_DIR)/Trace/Vector.cpp \
+	$(ENGINE_SRC_DIR)/ThermalBand/ThermalBand.cpp \
+	$(ENGINE_SRC_DIR)/ThermalBand/ThermalSlice.cpp \
+	$(ENGINE_SRC_DIR)/ThermalBand/ThermalEncounterBand.cpp \
+	$(ENGINE_SRC_DIR)/ThermalBand/ThermalEncounterCollection.cpp \
+	$(SRC)/Airspace/ActivePredicate.cpp \
+	$(SRC)/Airspace/AirspaceComputerSettings.cpp \
+	$(SRC)/Airspace/ProtectedAirspaceWarningManager.cpp \
+	$(SRC)/Task/ProtectedTaskManager.cpp \
+	$(SRC)/Task/ProtectedRoutePlanner.cpp \
+	$(SRC)/Task/RoutePlannerGlue.cpp \
+	$(SRC)/TeamCode/TeamCode.cpp \
+	$(SRC)/TeamCode/Settings.cpp \
+	$(SRC)/Logger/Settings.cpp \
+	$(SRC)/Math/SunEphemeris.cpp \
+	$(SRC)/FlightStatistics.cpp \
+	$(SRC)/Profiler/FrameProfiler.cpp \
+	$(TEST_SRC_DIR)/FakeMessage.cpp \
+	$(TEST_SRC_DIR)/FakeLogFile.cpp \
+	$(TEST_SRC_DIR)/FakeTerrain.cpp \
+	$(TEST_SRC_DIR)/RunHeadlessReplay.cpp
+# same audio feature macros as the main program's MergeThread.o, for
+# the fake AudioVarioGlue symbols
+RUN_HEADLESS_REPLAY_CPPFLAGS = $(SCREEN_CPPFLAGS) $(AUDIO_CPPFLAGS)
+RUN_HEADLESS_REPLAY_DEPENDS = LIBCOMPUTER LIBNMEA TASKFILE CONTEST ROUTE GLIDE \
+	WAYPOINT AIRSPACE THREAD IO OS UTIL GEO MATH TIME
+$(eval $(call link-program,RunHeadlessReplay,RUN_HEADLESS_REPLAY))
+
 FLIGHT_PATH_SOURCES = \
 	$(DEBUG_REPLAY_SOURCES) \
 	$(SRC)/TransponderCode.cpp \
@@ -1785,6 +1992,7 @@ RUN_MAP_WINDOW_SOURCES = \
 	$(SRC)/Renderer/AircraftRenderer.cpp \
 	$(SRC)/Renderer/AirspaceRenderer.cpp \
 	$(SRC)/Renderer/AirspaceRendererGL.cpp \
+	$(SRC)/Renderer/AirspaceGeometryCache.cpp \
 	$(SRC)/Renderer/AirspaceRendererOther.cpp \
 	$(SRC)/Renderer/AirspaceLabelList.cpp \
 	$(SRC)/Renderer/AirspaceLabelRenderer.cpp \
@@ -1850,6 +2058,7 @@ RUN_MAP_WINDOW_SOURCES = \
 	$(SRC)/Atmosphere/AirDensity.cpp \
 	$(SRC)/Operation/ConsoleOperationEnvironment.cpp \
 	$(SRC)/TransponderCode.cpp \
+	$(SRC)/Profiler/FrameProfiler.cpp \
 	$(TEST_SRC_DIR)/Fonts.cpp \
 	$(TEST_SRC_DIR)/FakeAsset.cpp \
 	$(TEST_SRC_DIR)/FakeDialogs.cpp \
@@ -2188,6 +2397,7 @@ RUN_ANALYSIS_SOURCES = \
 	$(SRC)/Renderer/GeoBitmapRenderer.cpp \
 	$(SRC)/Renderer/AirspaceRenderer.cpp \
 	$(SRC)/Renderer/AirspaceRendererGL.cpp \
+	$(SRC)/Renderer/AirspaceGeometryCache.cpp \
 	$(SRC)/Renderer/AirspaceRendererOther.cpp \
 	$(SRC)/Renderer/TransparentRendererCache.cpp \
 	$(SRC)/Renderer/GradientRenderer.cpp \
@@ -10,6 +10,7 @@
 #include "io/BufferedLineReader.hpp"
 
 #include <cstdint>
+#include <vector>
 
 #include <stdio.h>
 
@@ -18,6 +19,9 @@ extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size);
 int
 LLVMFuzzerTestOneInput(const uint8_t *data, size_t size)
 {
+  std::vector<IGCFix> fixes;
+  IGCParseFixes({(const char *)data, size}, fixes);
+
   try {
     MemoryReader mr{{(const std::byte *)data, size}};
     BufferedLineReader lr(mr);
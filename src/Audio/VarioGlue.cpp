@@ -11,6 +11,7 @@
 #include "SLES/Init.hpp"
 #endif
 
+#include <atomic>
 #include <cassert>
 
 static constexpr unsigned sample_rate = 44100;
@@ -20,7 +21,18 @@ static bool have_sles;
 #endif
 
 static PCMPlayer *player;
-static VarioSynthesiser *synthesiser;
+
+/**
+ * Atomic because SetDeviceValue() and ConsumeLatency() are called by
+ * other threads than Initialise() and Deinitialise().
+ */
+static std::atomic<VarioSynthesiser *> synthesiser{nullptr};
+
+/**
+ * The device index passed to SetDeviceValue() which is accepted, or
+ * -1.
+ */
+static std::atomic<int> selected_device{-1};
 
 bool
 AudioVarioGlue::HaveAudioVario()
@@ -36,7 +48,7 @@ void
 AudioVarioGlue::Initialise()
 {
   assert(player == nullptr);
-  assert(synthesiser == nullptr);
+  assert(synthesiser.load(std::memory_order_relaxed) == nullptr);
 
 #ifdef ANDROID
   have_sles = SLES::Initialise();
@@ -45,16 +57,18 @@ AudioVarioGlue::Initialise()
 #endif
 
   player = PCMPlayerFactory::CreateInstance();
-  synthesiser = new VarioSynthesiser(sample_rate);
+  synthesiser.store(new VarioSynthesiser(sample_rate),
+                    std::memory_order_release);
 }
 
 void
 AudioVarioGlue::Deinitialise()
 {
+  selected_device.store(-1, std::memory_order_relaxed);
+
   delete player;
   player = nullptr;
-  delete synthesiser;
-  synthesiser = nullptr;
+  delete synthesiser.exchange(nullptr, std::memory_order_acq_rel);
 }
 
 void
@@ -65,17 +79,18 @@ AudioVarioGlue::Configure(const VarioSoundSettings &settings)
     return;
 #endif
 
+  VarioSynthesiser *const s = synthesiser.load(std::memory_order_relaxed);
   assert(player != nullptr);
-  assert(synthesiser != nullptr);
+  assert(s != nullptr);
 
   if (settings.enabled) {
-    synthesiser->SetVolume(settings.volume);
-    synthesiser->SetDeadBand(settings.dead_band_enabled);
-    synthesiser->SetFrequencies(settings.min_frequency, settings.zero_frequency,
-                                settings.max_frequency);
-    synthesiser->SetPeriods(settings.min_period_ms, settings.max_period_ms);
-    synthesiser->SetDeadBandRange(settings.min_dead, settings.max_dead);
-    player->Start(*synthesiser);
+    s->SetVolume(settings.volume);
+    s->SetDeadBand(settings.dead_band_enabled);
+    s->SetFrequencies(settings.min_frequency, settings.zero_frequency,
+                      settings.max_frequency);
+    s->SetPeriods(settings.min_period_ms, settings.max_period_ms);
+    s->SetDeadBandRange(settings.min_dead, settings.max_dead);
+    player->Start(*s);
   } else
     player->Stop();
 }
@@ -88,10 +103,11 @@ AudioVarioGlue::SetValue(double vario)
     return;
 #endif
 
+  VarioSynthesiser *const s = synthesiser.load(std::memory_order_relaxed);
   assert(player != nullptr);
-  assert(synthesiser != nullptr);
+  assert(s != nullptr);
 
-  synthesiser->SetVario(vario);
+  s->SetVario(vario);
 }
 
 void
@@ -102,8 +118,38 @@ AudioVarioGlue::NoValue()
     return;
 #endif
 
+  VarioSynthesiser *const s = synthesiser.load(std::memory_order_relaxed);
   assert(player != nullptr);
-  assert(synthesiser != nullptr);
+  assert(s != nullptr);
+
+  s->SetSilence();
+}
+
+bool
+AudioVarioGlue::SelectDevice(int device) noexcept
+{
+  return selected_device.exchange(device, std::memory_order_relaxed) != device;
+}
+
+void
+AudioVarioGlue::SetDeviceValue(unsigned device, double vario) noexcept
+{
+  if ((int)device != selected_device.load(std::memory_order_relaxed))
+    return;
+
+  /* the devices are opened after Initialise() and closed before
+     Deinitialise(), but the synthesiser may be missing (Android
+     without OpenSL ES) */
+  if (VarioSynthesiser *const s = synthesiser.load(std::memory_order_acquire))
+    s->SetVario(vario);
+}
+
+std::optional<std::chrono::steady_clock::duration>
+AudioVarioGlue::ConsumeLatency() noexcept
+{
+  VarioSynthesiser *const s = synthesiser.load(std::memory_order_acquire);
+  if (s == nullptr)
+    return std::nullopt;
 
-  synthesiser->SetSilence();
+  return s->ConsumeLatency();
 }
@@ -5,6 +5,9 @@
 
 #include "Features.hpp"
 
+#include <chrono>
+#include <optional>
+
 struct VarioSoundSettings;
 
 namespace AudioVarioGlue {
@@ -40,6 +43,35 @@ namespace AudioVarioGlue {
    */
   void NoValue();
 
+  /**
+   * Select the device whose vario values shall be passed to
+   * SetDeviceValue().  The MergeThread calls this with the device
+   * which provides the total energy vario in the merged data.
+   *
+   * @param device the device index or -1 if no device shall be
+   * used
+   * @return true if the selection has changed
+   */
+  bool SelectDevice(int device) noexcept;
+
+  /**
+   * Update the vario value right after a device has received it,
+   * bypassing the MergeThread.  Values from other devices than the
+   * one passed to SelectDevice() are ignored.  This function is
+   * lock-free and may be called from any thread.
+   *
+   * @param device the device index
+   * @param vario the current vario value [m/s]
+   */
+  void SetDeviceValue(unsigned device, double vario) noexcept;
+
+  /**
+   * Returns the delay between the most recent vario value and the
+   * synthesis of the first audio buffer which uses it, or
+   * std::nullopt if there was no new value since the last call.
+   */
+  std::optional<std::chrono::steady_clock::duration> ConsumeLatency() noexcept;
+
   /**
    * Is the audio vario platform available on this platform?
    * Must only be called after Initialise() has been called once before.
@@ -52,6 +84,10 @@ namespace AudioVarioGlue {
   static inline void Configure([[maybe_unused]] const VarioSoundSettings &settings) {}
   static inline void SetValue([[maybe_unused]] double vario) {}
   static inline void NoValue() {}
+  static inline bool SelectDevice([[maybe_unused]] int device) noexcept { return false; }
+  static inline void SetDeviceValue([[maybe_unused]] unsigned device,
+                                    [[maybe_unused]] double vario) noexcept {}
+  static inline std::optional<std::chrono::steady_clock::duration> ConsumeLatency() noexcept { return std::nullopt; }
   static inline bool HaveAudioVario() { return false; }
 #endif
 };
@@ -21,13 +21,84 @@ VarioSynthesiser::VarioToFrequency(int ivario)
     : (zero_frequency - (unsigned)(ivario * (int)(zero_frequency - min_frequency) / min_vario));
 }
 
+/**
+ * The time constant of the glide from one vario value to the next.
+ * This is short compared to the update rate of most variometers, but
+ * it avoids audible steps in the tone frequency.
+ */
+static constexpr std::chrono::milliseconds smoothing{5};
+
 void
-VarioSynthesiser::SetVario(double vario)
+VarioSynthesiser::Submit(int ivario) noexcept
 {
-  const std::lock_guard lock{mutex};
+  /* write the stamp first; a reader which sees the new value will
+     see (at least) this stamp, too */
+  target_stamp.store(Clock::now().time_since_epoch().count(),
+                     std::memory_order_relaxed);
+  target_vario.store(ivario, std::memory_order_release);
+}
+
+void
+VarioSynthesiser::SetVario(double vario) noexcept
+{
+  Submit(std::clamp((int)(vario * 100), min_vario, max_vario));
+}
+
+void
+VarioSynthesiser::SetSilence() noexcept
+{
+  Submit(SILENCE);
+}
+
+void
+VarioSynthesiser::UpdateVario(size_t n) noexcept
+{
+  const int target = target_vario.load(std::memory_order_acquire);
+
+  /* was there a SetVario() or SetSilence() call since the last
+     buffer? */
+  bool submitted = false;
+  if (const auto stamp = target_stamp.load(std::memory_order_relaxed);
+      stamp != applied_stamp) {
+    applied_stamp = stamp;
+    latency.store(Clock::now().time_since_epoch().count() - stamp,
+                  std::memory_order_relaxed);
+    submitted = true;
+  }
 
-  const int ivario = std::clamp((int)(vario * 100), min_vario, max_vario);
+  if (target == SILENCE) {
+    if (current_vario != SILENCE || submitted) {
+      current_vario = SILENCE;
+      UnsafeSetSilence();
+    }
+
+    return;
+  }
+
+  int ivario = target;
+  if (current_vario != SILENCE) {
+    /* exponential smoothing over the duration of this buffer */
+    const size_t tau = sample_rate * smoothing.count() / 1000;
+    const int delta = target - current_vario;
+    int step = (int)((long long)delta * (long long)n / (long long)(n + tau));
+    if (step == 0 && delta != 0)
+      /* make sure we finally reach the target */
+      step = delta > 0 ? 1 : -1;
+
+    ivario = current_vario + step;
+  }
+
+  /* recalculate after each submission even if the value is the
+     same, to apply modified settings */
+  if (ivario != current_vario || submitted) {
+    current_vario = ivario;
+    ApplyVario(ivario);
+  }
+}
 
+void
+VarioSynthesiser::ApplyVario(int ivario) noexcept
+{
   if (dead_band_enabled && InDeadBand(ivario)) {
     /* inside the "dead band" */
     UnsafeSetSilence();
@@ -64,13 +135,6 @@ VarioSynthesiser::SetVario(double vario)
   }
 }
 
-void
-VarioSynthesiser::SetSilence()
-{
-  const std::lock_guard lock{mutex};
-  UnsafeSetSilence();
-}
-
 void
 VarioSynthesiser::UnsafeSetSilence()
 {
@@ -92,6 +156,8 @@ VarioSynthesiser::Synthesise(int16_t *buffer, size_t n)
 {
   const std::lock_guard lock{mutex};
 
+  UpdateVario(n);
+
   assert(audible_count > 0 || silence_count > 0);
 
   if (silence_count == 0) {
@@ -6,16 +6,64 @@
 #include "ToneSynthesiser.hpp"
 #include "thread/Mutex.hxx"
 
+#include <atomic>
+#include <chrono>
+#include <climits>
+#include <optional>
+
 /**
  * This class generates vario sound.
  */
 class VarioSynthesiser final : public ToneSynthesiser {
+public:
+  using Clock = std::chrono::steady_clock;
+
+private:
+  /**
+   * Magic value for #target_vario and #current_vario: produce
+   * silence.
+   */
+  static constexpr int SILENCE = INT_MIN;
+
+  /**
+   * The vario value [cm/s] most recently passed to SetVario(), or
+   * #SILENCE.  This is written without locking the #mutex, so the
+   * caller (which may be a device thread) never waits for the PCM
+   * callback; Synthesise() picks it up at the beginning of each
+   * buffer.
+   */
+  std::atomic<int> target_vario{SILENCE};
+
+  /**
+   * The time of the SetVario() or SetSilence() call which wrote
+   * #target_vario [Clock ticks].
+   */
+  std::atomic<Clock::rep> target_stamp{0};
+
+  /**
+   * The delay between the most recent SetVario() call and the
+   * Synthesise() call which picked it up [Clock ticks], or -1 if it
+   * has already been consumed by ConsumeLatency().
+   */
+  std::atomic<Clock::rep> latency{-1};
+
   /**
    * This mutex protects all atttributes below.  It is locked
    * automatically by all public methods.
    */
   Mutex mutex;
 
+  /**
+   * The smoothed vario value [cm/s] which the current tone was
+   * calculated from, or #SILENCE.
+   */
+  int current_vario = SILENCE;
+
+  /**
+   * The #target_stamp value seen by the last Synthesise() call.
+   */
+  Clock::rep applied_stamp = 0;
+
   /**
    * The number of audible samples in each period.
    */
@@ -78,17 +126,36 @@ public:
      min_dead(-30), max_dead(10) {}
 
   /**
-   * Update the vario value.  This calculates a new tone frequency and
-   * a new "silence" rate (for positive vario values).
+   * Update the vario value.  The next Synthesise() call glides
+   * towards it and calculates a new tone frequency and a new
+   * "silence" rate (for positive vario values).
+   *
+   * This method is lock-free and may be called from any thread.
    *
    * @param vario the current vario value [m/s]
    */
-  void SetVario(double vario);
+  void SetVario(double vario) noexcept;
 
   /**
    * Produce silence from now on.
+   *
+   * This method is lock-free and may be called from any thread.
+   */
+  void SetSilence() noexcept;
+
+  /**
+   * Returns the delay between the most recent SetVario() call and
+   * the Synthesise() call which picked it up (excluding the latency
+   * of the audio output buffer), or std::nullopt if there was no new
+   * value since the last call.
    */
-  void SetSilence();
+  std::optional<Clock::duration> ConsumeLatency() noexcept {
+    const auto value = latency.exchange(-1, std::memory_order_relaxed);
+    if (value < 0)
+      return std::nullopt;
+
+    return Clock::duration{value};
+  }
 
   /**
    * Enable/disable the dead band silence
@@ -127,7 +194,28 @@ public:
 
 private:
   /**
-   * Same as SetSilence(), but doesn't lock the mutex.
+   * Store a new value in #target_vario.
+   */
+  void Submit(int ivario) noexcept;
+
+  /**
+   * Load #target_vario and move #current_vario towards it.  Caller
+   * must lock the mutex.
+   *
+   * @param n the number of samples which are going to be generated
+   */
+  void UpdateVario(size_t n) noexcept;
+
+  /**
+   * Calculate the tone for the given vario value.  Caller must lock
+   * the mutex.
+   *
+   * @param ivario the current vario value [cm/s]
+   */
+  void ApplyVario(int ivario) noexcept;
+
+  /**
+   * Switch to silence.  Caller must lock the mutex.
    */
   void UnsafeSetSilence();
 
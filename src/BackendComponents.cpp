@@ -8,6 +8,7 @@
 #include "Computer/GlideComputer.hpp"
 #include "Logger/Logger.hpp"
 #include "Logger/NMEALogger.hpp"
+#include "Logger/SensorLogger.hpp"
 #include "Logger/GlueFlightLogger.hpp"
 #include "Replay/Replay.hpp"
 #include "MergeThread.hpp"
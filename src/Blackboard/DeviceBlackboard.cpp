@@ -23,6 +23,8 @@ DeviceBlackboard::DeviceBlackboard() noexcept
   gps_info.time = TimeStamp{gps_info.date_time_utc.DurationSinceMidnight()};
 
   std::fill(per_device_data.begin(), per_device_data.end(), gps_info);
+  for (auto &slot : device_slots)
+    slot.Init(gps_info);
 
   real_data = simulator_data = replay_data = gps_info;
 
@@ -52,6 +54,18 @@ DeviceBlackboard::SetStartupLocation(const GeoPoint &loc,
     if (!i.location_available)
       i.SetFakeLocation(loc, alt);
 
+  /* apply the fake location to the working copies as well, or the
+     next update from the device would discard it */
+  for (auto &slot : device_slots) {
+    const std::lock_guard slot_lock{slot.GetMutex()};
+    auto &i = slot.GetWorking();
+    if (!i.location_available) {
+      i.SetFakeLocation(loc, alt);
+      slot.MarkModified();
+      slot.Publish();
+    }
+  }
+
   if (!real_data.location_available)
     real_data.SetFakeLocation(loc, alt);
 
@@ -170,6 +184,22 @@ DeviceBlackboard::ExpireWallClock() noexcept
       modified = true;
   }
 
+  /* the working copies must expire as well, or the next Merge()
+     would revive the stale data */
+  for (auto &slot : device_slots) {
+    const std::lock_guard slot_lock{slot.GetMutex()};
+    auto &basic = slot.GetWorking();
+    if (!basic.alive)
+      continue;
+
+    basic.ExpireWallClock();
+    if (!basic.alive) {
+      slot.MarkModified();
+      slot.Publish();
+      modified = true;
+    }
+  }
+
   if (modified)
     ScheduleMerge();
 }
@@ -186,7 +216,10 @@ DeviceBlackboard::Merge() noexcept
   NMEAInfo &basic = SetBasic();
 
   real_data.Reset();
-  for (auto &basic : per_device_data) {
+  for (unsigned i = 0; i < NUMDEV; ++i) {
+    NMEAInfo &basic = per_device_data[i];
+    device_slots[i].Consume(basic);
+
     if (!basic.alive)
       continue;
 
@@ -213,3 +246,20 @@ DeviceBlackboard::Merge() noexcept
     basic = real_data;
   }
 }
+
+int
+DeviceBlackboard::GetVarioDeviceIndex() const noexcept
+{
+  if (replay_data.alive || simulator_data.alive)
+    return -1;
+
+  /* same order as NMEAInfo::Complement() in Merge(): the first
+     device wins */
+  for (unsigned i = 0; i < NUMDEV; ++i) {
+    const NMEAInfo &basic = per_device_data[i];
+    if (basic.alive && basic.total_energy_vario_available)
+      return i;
+  }
+
+  return -1;
+}
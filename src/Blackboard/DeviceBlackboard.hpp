@@ -5,6 +5,7 @@
 
 #include "Blackboard/BaseBlackboard.hpp"
 #include "Blackboard/ComputerSettingsBlackboard.hpp"
+#include "Blackboard/DeviceDataSlot.hpp"
 #include "Device/Simulator.hpp"
 #include "Device/Features.hpp"
 #include "thread/Mutex.hxx"
@@ -31,7 +32,15 @@ class DeviceBlackboard
   Simulator simulator;
 
   /**
-   * Data from each physical device.
+   * Ingestion buffers for each physical device.  They are written by
+   * the device threads without holding #mutex and consumed by
+   * Merge().
+   */
+  std::array<DeviceDataSlot, NUMDEV> device_slots;
+
+  /**
+   * Data from each physical device, as seen by the last Merge() call.
+   * Protected by #mutex.
    */
   std::array<NMEAInfo, NUMDEV> per_device_data;
 
@@ -90,32 +99,12 @@ public:
     return per_device_data[i];
   }
 
-  NMEAInfo &SetRealState(unsigned i) noexcept {
-    return per_device_data[i];
-  }
-
-  /**
-   * Return a copy of a device's data after updating its clock via
-   * NMEAInfo::UpdateClock().  The method takes care for locking and
-   * unlocking the mutex.
-   */
-  NMEAInfo LockGetDeviceDataUpdateClock(unsigned i) noexcept {
-    const std::lock_guard lock{mutex};
-    per_device_data[i].UpdateClock();
-    return per_device_data[i];
-  }
-
   /**
-   * Overwrites a device's data and schedule the MergeThread.  The
-   * method takes care for locking and unlocking the mutex.
+   * Access the ingestion buffer of a device.  Use #DeviceDataEditor
+   * instead of calling this directly.
    */
-  void LockSetDeviceDataScheduleMerge(unsigned i, const NMEAInfo &src) noexcept {
-    {
-      const std::lock_guard lock{mutex};
-      per_device_data[i] = src;
-    }
-
-    ScheduleMerge();
+  DeviceDataSlot &GetDeviceSlot(unsigned i) noexcept {
+    return device_slots[i];
   }
 
   NMEAInfo &SetSimulatorState() noexcept { return simulator_data; }
@@ -136,6 +125,15 @@ public:
     return RealState(i).flarm.IsDetected();
   }
 
+  /**
+   * Returns the index of the device whose total energy vario was
+   * chosen by the last Merge() call, or -1 if there is none (or if
+   * the replay or the simulator is active).  Caller must lock the
+   * blackboard.
+   */
+  [[gnu::pure]]
+  int GetVarioDeviceIndex() const noexcept;
+
   void SetStartupLocation(const GeoPoint &loc, double alt) noexcept;
   void ProcessSimulation() noexcept;
   void StopReplay() noexcept;
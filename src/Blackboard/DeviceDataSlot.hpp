@@ -0,0 +1,153 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#pragma once
+
+#include "NMEA/Info.hpp"
+#include "thread/Mutex.hxx"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+
+/**
+ * The ingestion buffer for the #NMEAInfo of one physical device.
+ *
+ * The device's threads edit the "working" copy, protected by a
+ * per-device mutex instead of the #DeviceBlackboard mutex.  Publish()
+ * hands a copy to Consume() through a triple buffer: neither side
+ * ever waits for the other, so the I/O thread is not blocked while
+ * DeviceBlackboard::Merge() copies the data, and vice versa.
+ *
+ * The I/O thread calls Publish() once per received chunk of data,
+ * not for every NMEA sentence.
+ */
+class DeviceDataSlot {
+  /**
+   * Protects #working, #modified, #back and #last_expire against
+   * concurrent access by the device's threads (e.g. the I/O thread
+   * and the main thread).  Consume() does not use it.
+   */
+  Mutex mutex;
+
+  NMEAInfo working;
+
+  /**
+   * Was #working modified since the last Publish() call?
+   */
+  bool modified = false;
+
+  /**
+   * The last time Expire() has expired #working.
+   */
+  TimeStamp last_expire = TimeStamp::Undefined();
+
+  std::array<NMEAInfo, 3> buffers;
+
+  static constexpr unsigned INDEX_MASK = 0x3;
+
+  /**
+   * This bit in #middle is set if the buffer was published but not
+   * yet consumed.
+   */
+  static constexpr unsigned FRESH = 0x4;
+
+  /**
+   * The index of the buffer which is written by Publish().  Protected
+   * by #mutex.
+   */
+  unsigned back = 0;
+
+  /**
+   * The index of the buffer which is being handed over from
+   * Publish() to Consume(), plus the #FRESH flag.
+   */
+  std::atomic<unsigned> middle{1};
+
+  /**
+   * The index of the buffer which is read by Consume().  Only
+   * accessed by the (single) consumer.
+   */
+  unsigned front = 2;
+
+public:
+  Mutex &GetMutex() noexcept {
+    return mutex;
+  }
+
+  /**
+   * Obtain the working copy.  Caller must hold the mutex.
+   */
+  NMEAInfo &GetWorking() noexcept {
+    return working;
+  }
+
+  /**
+   * Initialise the working copy with the given value.  Must be
+   * called before any other thread accesses this object.
+   */
+  void Init(const NMEAInfo &src) noexcept {
+    working = src;
+    buffers.fill(src);
+  }
+
+  /**
+   * Mark the working copy as modified; it will be passed to
+   * Consume() by the next Publish() call.  Caller must hold the
+   * mutex.
+   */
+  void MarkModified() noexcept {
+    modified = true;
+  }
+
+  /**
+   * Call NMEAInfo::Expire() on the working copy, but not more than
+   * once per second, because it walks all traffic objects.  Caller
+   * must hold the mutex.
+   */
+  void Expire() noexcept {
+    if (last_expire.IsDefined() && working.clock >= last_expire &&
+        working.clock - last_expire < std::chrono::seconds(1))
+      return;
+
+    last_expire = working.clock;
+    working.Expire();
+  }
+
+  /**
+   * Pass a copy of the working copy to Consume() if it was modified.
+   * Caller must hold the mutex.
+   *
+   * @return true if a new copy was published
+   */
+  bool Publish() noexcept {
+    if (!modified)
+      return false;
+
+    modified = false;
+    buffers[back] = working;
+    back = middle.exchange(back | FRESH, std::memory_order_acq_rel)
+      & INDEX_MASK;
+    return true;
+  }
+
+  /**
+   * Copy the latest published data to the given object if there is
+   * any since the last call.  Must be called by only one thread at a
+   * time; caller must not hold the mutex.
+   *
+   * @return true if the object was updated
+   */
+  bool Consume(NMEAInfo &dest) noexcept {
+    if ((middle.load(std::memory_order_relaxed) & FRESH) == 0)
+      /* a buffer which is published after this check is
+         followed by DeviceBlackboard::ScheduleMerge(), which runs
+         Merge() again */
+      return false;
+
+    front = middle.exchange(front, std::memory_order_acq_rel)
+      & INDEX_MASK;
+    dest = buffers[front];
+    return true;
+  }
+};
@@ -6,6 +6,7 @@
 #include "Protection.hpp"
 #include "Blackboard/DeviceBlackboard.hpp"
 #include "Hardware/CPU.hpp"
+#include "Profiler/FrameProfiler.hpp"
 
 /**
  * Constructor of the CalculationThread class
@@ -55,6 +56,9 @@ CalculationThread::SetScreenDistanceMeters(double new_value) noexcept
 void
 CalculationThread::Tick() noexcept
 {
+  static const auto phase = frame_profiler.RegisterPhase("CalculationThread::Tick");
+  const ScopeProfile profile(phase);
+
 #ifdef HAVE_CPU_FREQUENCY
   const ScopeLockCPU cpu;
 #endif
@@ -14,6 +14,8 @@
 #include <boost/geometry/algorithms/intersection.hpp>
 #include <boost/geometry/strategies/strategies.hpp>
 
+#include <cassert>
+
 CloudClientContainer::CloudClientContainer()
   :key_set(typename KeySet::bucket_traits(key_buckets, N_KEY_BUCKETS)) {}
 
@@ -90,10 +92,24 @@ CloudClientContainer::Insert(CloudClient &client)
 {
   list.push_front(client);
   key_set.insert(client);
-  id_set.push_back(client);
+  id_set.insert(client);
   rtree.insert(client.shared_from_this());
 }
 
+void
+CloudClientContainer::BulkLoad(const std::vector<CloudClientPtr> &clients)
+{
+  assert(empty());
+
+  for (const auto &client : clients) {
+    list.push_front(*client);
+    key_set.insert(*client);
+    id_set.insert(*client);
+  }
+
+  rtree = Tree(clients.begin(), clients.end());
+}
+
 void
 CloudClientContainer::Remove(CloudClient &client)
 {
@@ -188,30 +204,3 @@ CloudClient::Load(Deserialiser &s)
   client.stamp = stamp;
   return client;
 }
-
-void
-CloudClientContainer::Save(Serialiser &s) const
-{
-  s.Write32(next_id);
-
-  for (const auto &client : list) {
-    s.Write8(1);
-    client.Save(s);
-  }
-
-  s.Write8(0);
-  s.Write8(0);
-}
-
-void
-CloudClientContainer::Load(Deserialiser &s)
-{
-  next_id = s.Read32();
-
-  while (s.Read8() != 0) {
-    auto client = std::make_shared<CloudClient>(CloudClient::Load(s));
-    Insert(*client);
-  }
-
-  s.Read8();
-}
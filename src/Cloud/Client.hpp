@@ -13,6 +13,7 @@
 #include <boost/range/iterator_range_core.hpp>
 #include <memory>
 #include <chrono>
+#include <vector>
 
 class Serialiser;
 class Deserialiser;
@@ -208,6 +209,25 @@ public:
     return list.end();
   }
 
+  /**
+   * For iteration from the least recently refreshed client.
+   */
+  List::const_reverse_iterator rbegin() const {
+    return list.rbegin();
+  }
+
+  List::const_reverse_iterator rend() const {
+    return list.rend();
+  }
+
+  unsigned GetNextId() const noexcept {
+    return next_id;
+  }
+
+  void SetNextId(unsigned _next_id) noexcept {
+    next_id = _next_id;
+  }
+
   /**
    * Look up a client by its secret key.  Note that this does not
    * increment the reference counter.
@@ -230,6 +250,15 @@ public:
 
   void Insert(CloudClient &client);
 
+  /**
+   * Insert many clients into this (empty) container at once.  This is
+   * faster than calling Insert() for each of them, because the R-tree
+   * is packed in one pass.
+   *
+   * @param clients the clients, oldest first
+   */
+  void BulkLoad(const std::vector<CloudClientPtr> &clients);
+
   /**
    * Remove a #CloudClient and its data.  Be careful - the given reference
    * is invalidated, unless the caller holds another #CloudClientPtr.
@@ -243,7 +272,4 @@ public:
 
   [[gnu::pure]]
   query_iterator_range QueryWithinRange(GeoPoint location, double range) const;
-
-  void Save(Serialiser &s) const;
-  void Load(Deserialiser &s);
 };
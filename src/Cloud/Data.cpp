@@ -2,8 +2,8 @@
 // Copyright The XCSoar Project
 
 #include "Data.hpp"
+#include "Records.hpp"
 #include "Dump.hpp"
-#include "Serialiser.hpp"
 #include "net/ToString.hxx"
 
 #include <iostream>
@@ -13,9 +13,6 @@ using std::cout;
 using std::cerr;
 using std::endl;
 
-static constexpr uint32_t CLOUD_MAGIC = 0x5753f60f;
-static constexpr uint32_t CLOUD_VERSION = 1;
-
 void
 CloudData::DumpClients()
 {
@@ -30,30 +27,14 @@ CloudData::DumpClients()
   cout.flush();
 }
 
-void
-CloudData::Save(Serialiser &s) const
-{
-  s.Write32(CLOUD_MAGIC);
-  s.Write32(CLOUD_VERSION);
-  clients.Save(s);
-  s.Write8(1);
-  thermals.Save(s);
-  s.Write8(0);
-}
-
 void
 CloudData::Load(Deserialiser &s)
 {
-  if (s.Read32() != CLOUD_MAGIC)
-    throw std::runtime_error("Bad magic");
-
-  if (s.Read32() != CLOUD_VERSION)
-    throw std::runtime_error("Bad version");
+  CloudRecords records;
+  records.Load(s);
+  records.SortByStamp();
 
-  clients.Load(s);
-
-  if (s.Read8() != 0) {
-    thermals.Load(s);
-    s.Read8();
-  }
+  clients.SetNextId(records.next_id);
+  clients.BulkLoad(records.clients);
+  thermals.BulkLoad(records.thermals);
 }
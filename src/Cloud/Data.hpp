@@ -6,7 +6,6 @@
 #include "Client.hpp"
 #include "Thermal.hpp"
 
-class Serialiser;
 class Deserialiser;
 
 struct CloudData {
@@ -15,6 +14,8 @@ struct CloudData {
 
   void DumpClients();
 
-  void Save(Serialiser &s) const;
+  /**
+   * Load a database file into the (empty) containers.
+   */
   void Load(Deserialiser &s);
 };
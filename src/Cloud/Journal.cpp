@@ -0,0 +1,394 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#include "Journal.hpp"
+#include "Records.hpp"
+#include "Client.hpp"
+#include "Thermal.hpp"
+#include "io/FileReader.hxx"
+#include "io/MemoryReader.hxx"
+#include "system/FileUtil.hpp"
+#include "util/CRC16CCITT.hpp"
+#include "util/PrintException.hxx"
+
+#include <algorithm>
+#include <cassert>
+#include <stdexcept>
+
+#include <stdio.h>
+
+/**
+ * How often are the pending records written to the journal?
+ */
+static constexpr std::chrono::steady_clock::duration FLUSH_INTERVAL =
+  std::chrono::seconds(1);
+
+/**
+ * After a write error (e.g. a full disk), the next attempt is
+ * delayed; the delay doubles with each failure up to this limit.
+ */
+static constexpr std::chrono::steady_clock::duration MAX_RETRY_DELAY =
+  std::chrono::minutes(5);
+
+/**
+ * If this many bytes are pending because writing fails, they are
+ * discarded.  The live data is not affected, and each client will be
+ * journaled again with its next update.
+ */
+static constexpr std::size_t MAX_PENDING = 64 * 1024 * 1024;
+
+enum class RecordType : uint8_t {
+  CLIENT = 1,
+  THERMAL = 2,
+};
+
+/**
+ * Each record begins with the (big-endian) payload size (32 bit) and
+ * the CRC16-CCITT of the payload (16 bit).  The payload consists of
+ * the #RecordType and the serialised object.
+ */
+static constexpr std::size_t RECORD_HEADER_SIZE = 6;
+
+CloudJournal::CloudJournal(Path _db_path,
+                           std::chrono::steady_clock::duration _client_expiry,
+                           std::chrono::steady_clock::duration _thermal_expiry) noexcept
+  :Thread("CloudJournal"),
+   db_path(_db_path),
+   journal_path(db_path + ".journal"),
+   old_journal_path(db_path + ".journal.old"),
+   client_expiry(_client_expiry), thermal_expiry(_thermal_expiry) {}
+
+CloudJournal::~CloudJournal() noexcept
+{
+  if (IsDefined())
+    Stop();
+}
+
+static std::vector<std::byte>
+ReadFile(Path path)
+{
+  FileReader r(path);
+
+  std::vector<std::byte> data(r.GetSize());
+  std::size_t fill = 0;
+  while (fill < data.size()) {
+    std::size_t nbytes = r.Read(std::span{data}.subspan(fill));
+    if (nbytes == 0)
+      break;
+
+    fill += nbytes;
+  }
+
+  data.resize(fill);
+  return data;
+}
+
+static uint32_t
+ReadBE32(const std::byte *p) noexcept
+{
+  return (uint32_t(p[0]) << 24) | (uint32_t(p[1]) << 16) |
+    (uint32_t(p[2]) << 8) | uint32_t(p[3]);
+}
+
+static uint16_t
+ReadBE16(const std::byte *p) noexcept
+{
+  return (uint16_t(p[0]) << 8) | uint16_t(p[1]);
+}
+
+static void
+ReplayJournal(Path path, CloudRecords &records)
+{
+  const auto data = ReadFile(path);
+
+  /* find the valid records; after a crash, the last one may be
+     incomplete */
+  std::size_t end = 0, n_records = 0;
+  while (data.size() - end > RECORD_HEADER_SIZE) {
+    const std::byte *header = data.data() + end;
+    const std::size_t size = ReadBE32(header);
+    if (size == 0 || size > data.size() - end - RECORD_HEADER_SIZE)
+      break;
+
+    const std::span<const std::byte> payload{header + RECORD_HEADER_SIZE, size};
+    if (UpdateCRC16CCITT(payload, 0) != ReadBE16(header + 4))
+      break;
+
+    end += RECORD_HEADER_SIZE + size;
+    ++n_records;
+  }
+
+  MemoryReader r(std::span{data}.first(end));
+  Deserialiser s(r);
+
+  for (std::size_t i = 0; i < n_records; ++i) {
+    s.Read32();
+    s.Read16();
+
+    switch (RecordType(s.Read8())) {
+    case RecordType::CLIENT:
+      records.Update(std::make_shared<CloudClient>(CloudClient::Load(s)));
+      break;
+
+    case RecordType::THERMAL:
+      records.Add(std::make_shared<CloudThermal>(CloudThermal::Load(s)));
+      break;
+
+    default:
+      throw std::runtime_error("Malformed journal");
+    }
+  }
+}
+
+void
+CloudJournal::LoadFiles(CloudRecords &records,
+                        std::initializer_list<Path> journals) const
+{
+  if (File::Exists(db_path)) {
+    FileReader fr(db_path);
+    Deserialiser s(fr);
+    records.Load(s);
+  }
+
+  for (const Path path : journals)
+    if (File::Exists(path))
+      ReplayJournal(path, records);
+
+  const auto now = std::chrono::steady_clock::now();
+  records.Expire(now - client_expiry, now - thermal_expiry);
+  records.SortByStamp();
+}
+
+void
+CloudJournal::Load(CloudRecords &records)
+{
+  assert(!IsDefined());
+
+  LoadFiles(records, {old_journal_path, journal_path});
+
+  /* never append to a journal which may end with an incomplete
+     record; compact it before writing anything */
+  compact_requested = File::Exists(journal_path) ||
+    File::Exists(old_journal_path);
+}
+
+std::size_t
+CloudJournal::BeginRecord(uint8_t type)
+{
+  serialiser.Flush();
+  const std::size_t position = buffer.data.size();
+
+  /* placeholder for the header, see EndRecord() */
+  serialiser.Write32(0);
+  serialiser.Write16(0);
+
+  serialiser.Write8(type);
+  return position;
+}
+
+void
+CloudJournal::EndRecord(std::size_t position)
+{
+  serialiser.Flush();
+
+  std::byte *header = buffer.data.data() + position;
+  const std::span<const std::byte> payload{
+    header + RECORD_HEADER_SIZE,
+    buffer.data.data() + buffer.data.size(),
+  };
+
+  const uint32_t size = payload.size();
+  header[0] = std::byte(size >> 24);
+  header[1] = std::byte(size >> 16);
+  header[2] = std::byte(size >> 8);
+  header[3] = std::byte(size);
+
+  const uint16_t crc = UpdateCRC16CCITT(payload, 0);
+  header[4] = std::byte(crc >> 8);
+  header[5] = std::byte(crc);
+}
+
+void
+CloudJournal::Append(const CloudClient &client) noexcept
+{
+  const std::lock_guard lock{mutex};
+
+  std::size_t position = buffer.data.size();
+  try {
+    position = BeginRecord(uint8_t(RecordType::CLIENT));
+    client.Save(serialiser);
+    EndRecord(position);
+  } catch (...) {
+    /* discard the incomplete record */
+    serialiser.Discard();
+    buffer.data.resize(position);
+  }
+}
+
+void
+CloudJournal::Append(const CloudThermal &thermal) noexcept
+{
+  const std::lock_guard lock{mutex};
+
+  std::size_t position = buffer.data.size();
+  try {
+    position = BeginRecord(uint8_t(RecordType::THERMAL));
+    thermal.Save(serialiser);
+    EndRecord(position);
+  } catch (...) {
+    serialiser.Discard();
+    buffer.data.resize(position);
+  }
+}
+
+void
+CloudJournal::WriteJournal(std::span<const std::byte> src)
+{
+  if (src.empty())
+    return;
+
+  if (!file)
+    file.emplace(journal_path, FileOutputStream::Mode::APPEND_OR_CREATE);
+
+  file->Write(src);
+  file->Sync();
+}
+
+void
+CloudJournal::Compact()
+{
+  if (file) {
+    file->Commit();
+    file.reset();
+  }
+
+  CloudRecords records;
+
+  if (File::Exists(old_journal_path)) {
+    /* a previous compaction has failed (or the server has crashed
+       during compaction): fold both journals */
+    LoadFiles(records, {old_journal_path, journal_path});
+  } else {
+    if (File::Exists(journal_path) &&
+        !File::Rename(journal_path, old_journal_path))
+      throw std::runtime_error("Failed to rename journal");
+
+    LoadFiles(records, {old_journal_path});
+  }
+
+  FileOutputStream fos(db_path);
+
+  {
+    Serialiser s(fos);
+    records.Save(s);
+    s.Flush();
+  }
+
+  fos.Sync();
+  fos.Commit();
+
+  File::Delete(old_journal_path);
+  File::Delete(journal_path);
+}
+
+void
+CloudJournal::Run() noexcept
+{
+  std::vector<std::byte> pending;
+
+  /**
+   * Set after a write error: the journal may end with an incomplete
+   * record, and nothing may be appended to it before it has been
+   * compacted.
+   */
+  bool failed = false;
+
+  /**
+   * After a write error: the delay before the next attempt, and
+   * when it is due.
+   */
+  std::chrono::steady_clock::duration retry_delay{};
+  std::chrono::steady_clock::time_point retry_time;
+
+  std::unique_lock lock{mutex};
+
+  while (true) {
+    if (failed)
+      /* don't retry (i.e. rewrite the whole database) every second
+         while the disk is full */
+      cond.wait_until(lock, retry_time, [this]{
+        return stop_requested;
+      });
+    else
+      cond.wait_for(lock, FLUSH_INTERVAL, [this]{
+        return stop_requested || compact_requested;
+      });
+
+    const bool stop = stop_requested;
+
+    /* after an error, the records of the previous iterations are
+       still pending */
+    serialiser.Flush();
+    pending.insert(pending.end(), buffer.data.begin(), buffer.data.end());
+    buffer.data.clear();
+
+    if (pending.size() > MAX_PENDING) {
+      fprintf(stderr, "Discarding %zu bytes of journal records\n",
+              pending.size());
+      pending.clear();
+    }
+
+    const bool compact = compact_requested || failed || stop;
+    compact_requested = false;
+
+    lock.unlock();
+
+    try {
+      if (stop) {
+        WriteJournal(pending);
+        Compact();
+      } else {
+        /* compact first: after startup, the journal may end with an
+           incomplete record */
+        if (compact)
+          Compact();
+
+        WriteJournal(pending);
+      }
+
+      pending.clear();
+      failed = false;
+      retry_delay = {};
+    } catch (...) {
+      PrintException(std::current_exception());
+
+      if (file) {
+        file->Cancel();
+        file.reset();
+      }
+
+      /* try again later */
+      failed = true;
+      retry_delay = std::clamp(retry_delay * 2,
+                               FLUSH_INTERVAL, MAX_RETRY_DELAY);
+      retry_time = std::chrono::steady_clock::now() + retry_delay;
+    }
+
+    if (stop)
+      break;
+
+    lock.lock();
+  }
+}
+
+void
+CloudJournal::Stop() noexcept
+{
+  {
+    const std::lock_guard lock{mutex};
+    stop_requested = true;
+    cond.notify_one();
+  }
+
+  Join();
+}
@@ -0,0 +1,143 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#pragma once
+
+#include "Serialiser.hpp"
+#include "io/OutputStream.hxx"
+#include "io/FileOutputStream.hxx"
+#include "system/Path.hpp"
+#include "thread/Thread.hpp"
+#include "thread/Mutex.hxx"
+#include "thread/Cond.hxx"
+
+#include <chrono>
+#include <initializer_list>
+#include <optional>
+#include <vector>
+
+struct CloudClient;
+struct CloudThermal;
+class CloudRecords;
+
+/**
+ * Persists the cloud data in an append-only change journal
+ * ("DBPATH.journal") next to the database file ("DBPATH").
+ *
+ * The worker threads serialise each modified client and each new
+ * thermal into a memory buffer, and a background thread appends this
+ * buffer to the journal once per second.
+ *
+ * Compaction renames the journal to "DBPATH.journal.old", starts a
+ * new one and folds the old journal into a new database file.  It
+ * works only on the files, so it never locks the live data.
+ *
+ * After a crash, the database file and both journals are replayed;
+ * a truncated or corrupt record ends a journal.
+ */
+class CloudJournal final : Thread {
+  /**
+   * Collects serialised records in memory.
+   */
+  class Buffer final : public OutputStream {
+  public:
+    std::vector<std::byte> data;
+
+    /* virtual methods from class OutputStream */
+    void Write(std::span<const std::byte> src) override {
+      data.insert(data.end(), src.begin(), src.end());
+    }
+  };
+
+  const AllocatedPath db_path, journal_path, old_journal_path;
+
+  const std::chrono::steady_clock::duration client_expiry, thermal_expiry;
+
+  Mutex mutex;
+  Cond cond;
+
+  /**
+   * The records which have not yet been written to the journal.
+   * Protected by #mutex.
+   */
+  Buffer buffer;
+  Serialiser serialiser{buffer};
+
+  /**
+   * Protected by #mutex.
+   */
+  bool compact_requested = false, stop_requested = false;
+
+  /**
+   * The journal file.  Only accessed by the thread.
+   */
+  std::optional<FileOutputStream> file;
+
+public:
+  CloudJournal(Path db_path,
+               std::chrono::steady_clock::duration _client_expiry,
+               std::chrono::steady_clock::duration _thermal_expiry) noexcept;
+  ~CloudJournal() noexcept;
+
+  /**
+   * Load the database file and replay the journals.  This must be
+   * called before Start().
+   *
+   * Throws on error.
+   */
+  void Load(CloudRecords &records);
+
+  /**
+   * Launch the background thread.
+   *
+   * Throws on error.
+   */
+  void Start() {
+    Thread::Start();
+  }
+
+  /**
+   * Write all pending records, compact the journal and stop the
+   * background thread.
+   */
+  void Stop() noexcept;
+
+  void Append(const CloudClient &client) noexcept;
+  void Append(const CloudThermal &thermal) noexcept;
+
+  /**
+   * Ask the background thread to compact the journal.
+   */
+  void RequestCompaction() noexcept {
+    const std::lock_guard lock{mutex};
+    compact_requested = true;
+    cond.notify_one();
+  }
+
+private:
+  /**
+   * Begin a new record.  Caller must lock the mutex.
+   *
+   * @return the position of the record
+   */
+  std::size_t BeginRecord(uint8_t type);
+
+  /**
+   * Finish the record which was started by BeginRecord().  Caller
+   * must lock the mutex.
+   */
+  void EndRecord(std::size_t position);
+
+  /**
+   * Load the database file and replay the given journals.
+   */
+  void LoadFiles(CloudRecords &records,
+                 std::initializer_list<Path> journals) const;
+
+  void WriteJournal(std::span<const std::byte> src);
+
+  void Compact();
+
+  /* virtual methods from class Thread */
+  void Run() noexcept override;
+};
@@ -2,9 +2,11 @@
 // Copyright The XCSoar Project
 
 #include "Data.hpp"
+#include "Records.hpp"
+#include "Journal.hpp"
 #include "Dump.hpp"
 #include "Sender.hpp"
-#include "Serialiser.hpp"
+#include "Shards.hpp"
 #include "Tracking/SkyLines/Server.hpp"
 #include "Tracking/SkyLines/Protocol.hpp"
 #include "util/ByteOrder.hxx"
@@ -12,16 +14,23 @@
 #include "event/CoarseTimerEvent.hxx"
 #include "event/SignalMonitor.hxx"
 #include "net/IPv4Address.hxx"
-#include "io/FileOutputStream.hxx"
-#include "io/FileReader.hxx"
 #include "util/PrintException.hxx"
 #include "util/Exception.hxx"
 #include "util/Compiler.h"
 #include "util/ScopeExit.hxx"
+#include "util/StringAPI.hxx"
+#include "thread/Thread.hpp"
+#include "thread/Mutex.hxx"
+#include "thread/Cond.hxx"
 
 #include <array>
+#include <forward_list>
 #include <iostream>
 #include <iomanip>
+#include <optional>
+#include <vector>
+
+#include <stdlib.h>
 
 #include <signal.h>
 
@@ -34,59 +43,61 @@ static constexpr std::chrono::steady_clock::duration MAX_THERMAL_AGE = std::chro
 
 static constexpr std::chrono::steady_clock::duration REQUEST_EXPIRY = std::chrono::minutes(5);
 
+static constexpr std::chrono::steady_clock::duration CLIENT_EXPIRY = std::chrono::minutes(10);
+
+/**
+ * How often is the journal folded into the database file?
+ */
+static constexpr std::chrono::steady_clock::duration COMPACT_INTERVAL = std::chrono::minutes(10);
+
 using std::cout;
 using std::cerr;
 using std::endl;
 
-class CloudServer final
-  : public SkyLinesTracking::Server, CloudData
-{
-  const AllocatedPath db_path;
-
-  CoarseTimerEvent save_timer, expire_timer;
+/**
+ * Serialises the log output of the worker threads.
+ */
+static Mutex log_mutex;
+
+/**
+ * Log every received fix?  This is very verbose, and the log mutex
+ * serialises all worker threads.  Set only at startup by the "-v"
+ * option.
+ */
+static bool verbose = false;
+
+/**
+ * Handles the requests received on one socket.  There is one
+ * instance per worker thread; the data is shared in #CloudShards.
+ */
+class CloudServer final : public SkyLinesTracking::Server {
+  CloudShards &shards;
+
+  struct Recipient {
+    StaticSocketAddress address;
+    uint64_t key;
+  };
+
+  /**
+   * The clients which will receive a new traffic or thermal
+   * notification.  They are collected while a shard is locked, and
+   * the datagrams are sent after the lock has been released.  This
+   * is a member only to reuse its allocation.
+   */
+  std::vector<Recipient> recipients;
+
+  /**
+   * The #EventLoop of the main thread, to be stopped on fatal
+   * errors.
+   */
+  EventLoop &main_loop;
 
 public:
-  CloudServer(AllocatedPath &&_db_path, EventLoop &event_loop,
-              SocketAddress bind_address)
-    :SkyLinesTracking::Server(event_loop, bind_address),
-     db_path(std::move(_db_path)),
-     save_timer(event_loop, BIND_THIS_METHOD(OnSaveTimer)),
-     expire_timer(event_loop, BIND_THIS_METHOD(OnExpireTimer))
-  {
-#ifndef _WIN32
-    SignalMonitorRegister(SIGINT, BIND_THIS_METHOD(OnQuitSignal));
-    SignalMonitorRegister(SIGTERM, BIND_THIS_METHOD(OnQuitSignal));
-    SignalMonitorRegister(SIGQUIT, BIND_THIS_METHOD(OnQuitSignal));
-
-    SignalMonitorRegister(SIGHUP, BIND_THIS_METHOD(OnReloadSignal));
-    SignalMonitorRegister(SIGUSR1, BIND_THIS_METHOD(OnDumpSignal));
-#endif
-
-    ScheduleSave();
-  }
-
-  void Load();
-  void Save();
-
-private:
-  void OnSaveTimer() noexcept {
-    Save();
-    ScheduleSave();
-  }
-
-  void ScheduleSave() {
-    save_timer.Schedule(std::chrono::minutes(1));
-  }
-
-  void OnExpireTimer() noexcept {
-    clients.Expire(GetEventLoop().SteadyNow() - std::chrono::minutes(10));
-    if (!clients.empty())
-      ScheduleExpire();
-  }
-
-  void ScheduleExpire() {
-    expire_timer.Schedule(std::chrono::minutes(5));
-  }
+  CloudServer(CloudShards &_shards,
+              EventLoop &event_loop, EventLoop &_main_loop,
+              SocketAddress bind_address, bool reuse_port)
+    :SkyLinesTracking::Server(event_loop, bind_address, reuse_port),
+     shards(_shards), main_loop(_main_loop) {}
 
 protected:
   /* virtual methods from class SkyLinesTracking::Server */
@@ -116,29 +127,21 @@ protected:
 
   void OnSendError(SocketAddress address,
                    std::exception_ptr e) noexcept override {
+    const std::lock_guard lock{log_mutex};
     cerr << "Failed to send to " << address
          << ": " << GetFullMessage(e)
-         << endl;
+         << '\n';
   }
 
   void OnError(std::exception_ptr e) override {
-    cerr << GetFullMessage(e) << endl;
-    GetEventLoop().Break();
-  }
+    {
+      const std::lock_guard lock{log_mutex};
+      cerr << GetFullMessage(e) << '\n';
+    }
 
-#ifndef _WIN32
-  void OnQuitSignal() noexcept {
     GetEventLoop().Break();
+    main_loop.InjectBreak();
   }
-
-  void OnReloadSignal() noexcept {
-    Save();
-  }
-
-  void OnDumpSignal() noexcept {
-    DumpClients();
-  }
-#endif
 };
 
 void
@@ -148,44 +151,45 @@ CloudServer::OnFix(const Client &c,
 {
   (void)time_of_day; // TODO: use this parameter
 
-  CloudClient *client;
+  CloudShards::ClientInfo client;
   if (location.IsValid()) {
-    bool was_empty = clients.empty();
-
-    client = &clients.Make(c.address, c.key, location, altitude);
-
-    cout << "FIX\t"
-         << client->address << '\t'
-         << std::hex << client->key << std::dec << '\t'
-         << client->id << '\t'
-         << client->location << '\t'
-         << client->altitude << 'm'
-         << endl;
-
-    if (was_empty)
-      ScheduleExpire();
-  } else {
-    client = clients.Find(c.key);
-    if (client != nullptr)
-      clients.Refresh(*client, c.address);
-  }
+    client = shards.UpdateClient(c.address, c.key, location, altitude);
+
+    if (verbose) {
+      const std::lock_guard lock{log_mutex};
+      cout << "FIX\t"
+           << SocketAddress(c.address) << '\t'
+           << std::hex << c.key << std::dec << '\t'
+           << client.id << '\t'
+           << client.location << '\t'
+           << client.altitude << "m\n";
+    }
+  } else if (!shards.RefreshClient(c.key, c.address, client))
+    return;
 
   /* send this new traffic location to all interested clients
      immediately */
   const auto now = std::chrono::steady_clock::now();
-  for (const auto &i : clients.QueryWithinRange(location, TRAFFIC_RANGE)) {
-    if (i->key == c.key)
+  recipients.clear();
+  shards.VisitClientsWithinRange(client.location, TRAFFIC_RANGE,
+                                 [&](const CloudClient &i){
+    if (i.key == c.key)
       /* ignore this client's own submissions - he knows them
          already */
-      continue;
+      return true;
 
-    if (now > i->wants_traffic)
+    if (now > i.wants_traffic)
       /* not interested (anymore) */
-      continue;
+      return true;
+
+    recipients.push_back({StaticSocketAddress(i.address), i.key});
+    return true;
+  });
 
-    TrafficResponseSender s(*this, i->address, i->key);
-    s.Add(client->id, 0, //TODO: time?
-          client->location, client->altitude);
+  for (const auto &i : recipients) {
+    TrafficResponseSender s(*this, i.address, i.key);
+    s.Add(client.id, 0, //TODO: time?
+          client.location, client.altitude);
     s.Flush();
   }
 }
@@ -197,36 +201,36 @@ CloudServer::OnTrafficRequest(const Client &c, bool near)
     /* "near" is the only selection flag we know */
     return;
 
-  auto *client = clients.Find(c.key);
-  if (client == nullptr)
+  const auto now = std::chrono::steady_clock::now();
+
+  ::GeoPoint location;
+  if (!shards.WithClient(c.key, [&](CloudClient &client){
+    client.wants_traffic = now + REQUEST_EXPIRY;
+    location = client.location;
+  }))
     /* we don't send our data to clients who didn't sent anything to
        us yet */
     return;
 
-  const auto now = std::chrono::steady_clock::now();
-
-  client->wants_traffic = now + REQUEST_EXPIRY;
-
   const auto min_stamp = now - MAX_TRAFFIC_AGE;
 
   TrafficResponseSender s(*this, c.address, c.key);
 
   unsigned n = 0;
-  for (const auto &traffic : clients.QueryWithinRange(client->location,
-                                                      TRAFFIC_RANGE)) {
-    if (traffic.get() == client)
-      continue;
+  shards.VisitClientsWithinRange(location, TRAFFIC_RANGE,
+                                 [&](const CloudClient &traffic){
+    if (traffic.key == c.key)
+      return true;
 
-    if (traffic->stamp < min_stamp)
+    if (traffic.stamp < min_stamp)
       /* don't send stale traffic, it's probably not there anymore */
-      continue;
+      return true;
 
-    s.Add(traffic->id, 0, //TODO: time?
-          traffic->location, traffic->altitude);
+    s.Add(traffic.id, 0, //TODO: time?
+          traffic.location, traffic.altitude);
 
-    if (++n > 64)
-      break;
-  }
+    return ++n <= 64;
+  });
 
   s.Flush();
 }
@@ -239,21 +243,23 @@ CloudServer::OnWaveSubmit(const Client &c,
                           int top_altitude,
                           double lift)
 {
-  auto *client = clients.Find(c.key);
-  if (client == nullptr)
+  unsigned id;
+  if (!shards.WithClient(c.key, [&](const CloudClient &client){
+    id = client.id;
+  }))
     /* we don't trust the client if he didn't sent anything to us
        yet */
     return;
 
+  const std::lock_guard lock{log_mutex};
   cout << "WAVE\t"
-       << client->address << '\t'
-       << std::hex << client->key << std::dec << '\t'
-       << client->id << '\t'
+       << SocketAddress(c.address) << '\t'
+       << std::hex << c.key << std::dec << '\t'
+       << id << '\t'
        << a << '\t'
        << b << '\t'
        << bottom_altitude << '-' << top_altitude << "m\t"
-       << lift << "m/s"
-       << endl;
+       << lift << "m/s\n";
 }
 
 void
@@ -265,42 +271,52 @@ CloudServer::OnThermalSubmit(const Client &c,
                              int top_altitude,
                              double lift)
 {
-  auto *client = clients.Find(c.key);
-  if (client == nullptr)
+  unsigned id;
+  if (!shards.WithClient(c.key, [&](const CloudClient &client){
+    id = client.id;
+  }))
     /* we don't trust the client if he didn't sent anything to us
        yet */
     return;
 
-  cout << "THERMAL\t"
-       << client->address << '\t'
-       << std::hex << client->key << std::dec << '\t'
-       << client->id << '\t'
-       << top_location << '\t'
-       << bottom_altitude << '-' << top_altitude << "m\t"
-       << lift << "m/s"
-       << endl;
+  {
+    const std::lock_guard lock{log_mutex};
+    cout << "THERMAL\t"
+         << SocketAddress(c.address) << '\t'
+         << std::hex << c.key << std::dec << '\t'
+         << id << '\t'
+         << top_location << '\t'
+         << bottom_altitude << '-' << top_altitude << "m\t"
+         << lift << "m/s\n";
+  }
 
-  const auto &thermal =
-    thermals.Make(c.key,
-                  AGeoPoint(bottom_location, bottom_altitude),
-                  AGeoPoint(top_location, top_altitude),
-                  lift);
+  const auto thermal =
+    shards.AddThermal(c.key,
+                      AGeoPoint(bottom_location, bottom_altitude),
+                      AGeoPoint(top_location, top_altitude),
+                      lift);
 
   /* send this new thermal to all interested clients immediately */
   const auto now = std::chrono::steady_clock::now();
-  for (const auto &i : clients.QueryWithinRange(bottom_location,
-                                                THERMAL_RANGE)) {
-    if (i->key == c.key)
+  recipients.clear();
+  shards.VisitClientsWithinRange(bottom_location, THERMAL_RANGE,
+                                 [&](const CloudClient &i){
+    if (i.key == c.key)
       /* ignore this client's own submissions - he knows them
          already */
-      continue;
+      return true;
 
-    if (now > i->wants_thermals)
+    if (now > i.wants_thermals)
       /* not interested (anymore) */
-      continue;
+      return true;
 
-    ThermalResponseSender s(*this, i->address, i->key);
-    s.Add(thermal.Pack());
+    recipients.push_back({StaticSocketAddress(i.address), i.key});
+    return true;
+  });
+
+  for (const auto &i : recipients) {
+    ThermalResponseSender s(*this, i.address, i.key);
+    s.Add(thermal);
     s.Flush();
   }
 }
@@ -308,92 +324,304 @@ CloudServer::OnThermalSubmit(const Client &c,
 void
 CloudServer::OnThermalRequest(const Client &c)
 {
-  auto *client = clients.Find(c.key);
-  if (client == nullptr)
+  const auto now = std::chrono::steady_clock::now();
+
+  ::GeoPoint location;
+  if (!shards.WithClient(c.key, [&](CloudClient &client){
+    client.wants_thermals = now + REQUEST_EXPIRY;
+    location = client.location;
+  }))
     /* we don't send our data to clients who didn't sent anything to
        us yet */
     return;
 
-  const auto now = std::chrono::steady_clock::now();
-
-  client->wants_thermals = now + REQUEST_EXPIRY;
-
   const auto min_time = now - MAX_THERMAL_AGE;
 
   ThermalResponseSender s(*this, c.address, c.key);
 
   unsigned n = 0;
-  for (const auto &thermal : thermals.QueryWithinRange(client->location,
-                                                       THERMAL_RANGE)) {
-    if (thermal->client_key == c.key)
+  shards.VisitThermalsWithinRange(location, THERMAL_RANGE,
+                                  [&](const CloudThermal &thermal){
+    if (thermal.client_key == c.key)
       /* ignore this client's own submissions - he knows them
          already */
-      continue;
+      return true;
 
-    if (thermal->time < min_time)
+    if (thermal.time < min_time)
       /* don't send old thermals, they're useless */
-      continue;
+      return true;
 
-    s.Add(thermal->Pack());
+    s.Add(thermal.Pack());
 
-    if (++n > 256)
-      break;
-  }
+    return ++n <= 256;
+  });
 
   s.Flush();
 }
 
+/**
+ * A thread which runs a #CloudServer in its own #EventLoop.
+ */
+class CloudWorker final : Thread {
+  CloudShards &shards;
+  EventLoop &main_loop;
+  const AllocatedSocketAddress bind_address;
+  const bool reuse_port;
+
+  /**
+   * Constructed by the worker thread.  It is accessed by the main
+   * thread only after #started has been set.
+   */
+  std::optional<EventLoop> event_loop;
+
+  Mutex mutex;
+  Cond cond;
+
+  /**
+   * Has the worker thread finished its initialisation?  Protected
+   * by #mutex.
+   */
+  bool started = false;
+
+  /**
+   * The initialisation error.  Protected by #mutex.
+   */
+  std::exception_ptr error;
+
+public:
+  CloudWorker(CloudShards &_shards, EventLoop &_main_loop,
+              SocketAddress _bind_address, bool _reuse_port)
+    :Thread("CloudWorker"),
+     shards(_shards), main_loop(_main_loop),
+     bind_address(_bind_address), reuse_port(_reuse_port) {}
+
+  ~CloudWorker() noexcept {
+    if (IsDefined())
+      Stop();
+  }
+
+  /**
+   * Launch the thread and wait until its socket has been bound.
+   *
+   * Throws on error.
+   */
+  void Start();
+
+  void Stop() noexcept {
+    event_loop->InjectBreak();
+    Join();
+  }
+
+private:
+  /* virtual methods from class Thread */
+  void Run() noexcept override;
+};
+
 void
-CloudServer::Load()
+CloudWorker::Start()
 {
-  FileReader fr(db_path);
-  Deserialiser s(fr);
-  CloudData::Load(s);
+  Thread::Start();
+
+  std::unique_lock lock{mutex};
+  cond.wait(lock, [this]{ return started; });
+
+  if (error) {
+    lock.unlock();
+    Join();
+    std::rethrow_exception(error);
+  }
 }
 
 void
-CloudServer::Save()
+CloudWorker::Run() noexcept
 {
-  cout << "Saving data to " << db_path.c_str() << endl;
+  std::optional<CloudServer> server;
 
-  FileOutputStream fos(db_path);
+  try {
+    event_loop.emplace();
+    server.emplace(shards, *event_loop, main_loop,
+                   bind_address, reuse_port);
+  } catch (...) {
+    const std::lock_guard lock{mutex};
+    error = std::current_exception();
+    started = true;
+    cond.notify_one();
+    return;
+  }
 
   {
-    Serialiser s(fos);
-    CloudData::Save(s);
-    s.Flush();
+    const std::lock_guard lock{mutex};
+    started = true;
+    cond.notify_one();
   }
 
-  fos.Commit();
+  event_loop->Run();
+}
+
+/**
+ * The main thread: it owns the data and the worker threads, handles
+ * signals and saves the data periodically.
+ */
+class CloudDaemon final {
+  EventLoop &event_loop;
+
+  CloudJournal journal;
+
+  CloudShards shards;
+
+  CoarseTimerEvent compact_timer, expire_timer;
+
+  std::forward_list<CloudWorker> workers;
+
+public:
+  CloudDaemon(Path db_path, EventLoop &_event_loop, unsigned n_shards)
+    :event_loop(_event_loop),
+     journal(db_path, CLIENT_EXPIRY, MAX_THERMAL_AGE),
+     shards(n_shards, &journal),
+     compact_timer(event_loop, BIND_THIS_METHOD(OnCompactTimer)),
+     expire_timer(event_loop, BIND_THIS_METHOD(OnExpireTimer))
+  {
+#ifndef _WIN32
+    SignalMonitorRegister(SIGINT, BIND_THIS_METHOD(OnQuitSignal));
+    SignalMonitorRegister(SIGTERM, BIND_THIS_METHOD(OnQuitSignal));
+    SignalMonitorRegister(SIGQUIT, BIND_THIS_METHOD(OnQuitSignal));
+
+    SignalMonitorRegister(SIGHUP, BIND_THIS_METHOD(OnReloadSignal));
+    SignalMonitorRegister(SIGUSR1, BIND_THIS_METHOD(OnDumpSignal));
+#endif
+
+    ScheduleCompact();
+    ScheduleExpire();
+  }
+
+  /**
+   * Load the database and replay the journal.
+   *
+   * Throws on error.
+   */
+  void Load() {
+    CloudRecords records;
+    journal.Load(records);
+    shards.Load(std::move(records));
+  }
+
+  /**
+   * Launch the journal thread and the worker threads.  This must be
+   * called after the signal handlers have been registered, so the
+   * threads inherit the signal mask.
+   *
+   * Throws on error.
+   */
+  void Start(SocketAddress bind_address, unsigned n_workers) {
+    journal.Start();
+
+    for (unsigned i = 0; i < n_workers; ++i)
+      workers.emplace_front(shards, event_loop, bind_address,
+                            n_workers > 1).Start();
+  }
+
+  /**
+   * Stop all threads and compact the journal.
+   */
+  void Stop() noexcept {
+    workers.clear();
+    journal.Stop();
+  }
+
+  void DumpClients();
+
+private:
+  void OnCompactTimer() noexcept {
+    journal.RequestCompaction();
+    ScheduleCompact();
+  }
+
+  void ScheduleCompact() {
+    compact_timer.Schedule(COMPACT_INTERVAL);
+  }
+
+  void OnExpireTimer() noexcept {
+    shards.Expire(std::chrono::steady_clock::now() - CLIENT_EXPIRY);
+    ScheduleExpire();
+  }
+
+  void ScheduleExpire() {
+    expire_timer.Schedule(std::chrono::minutes(5));
+  }
+
+#ifndef _WIN32
+  void OnQuitSignal() noexcept {
+    event_loop.Break();
+  }
+
+  void OnReloadSignal() noexcept {
+    journal.RequestCompaction();
+  }
+
+  void OnDumpSignal() noexcept {
+    DumpClients();
+  }
+#endif
+};
+
+void
+CloudDaemon::DumpClients()
+{
+  auto snapshot = std::make_unique<CloudData>();
+  shards.Snapshot(*snapshot);
+
+  const std::lock_guard lock{log_mutex};
+  snapshot->DumpClients();
 }
 
 int
 main(int argc, char **argv)
 try {
-  if (argc != 2) {
-    cerr << "Usage: " << argv[0] << " DBPATH" << endl;
+  const char *const program = argv[0];
+
+  if (argc > 1 && StringIsEqual(argv[1], "-v")) {
+    verbose = true;
+    --argc;
+    ++argv;
+  }
+
+  if (argc < 2 || argc > 3) {
+    cerr << "Usage: " << program << " [-v] DBPATH [THREADS]" << endl;
     return EXIT_FAILURE;
   }
 
   const Path db_path(argv[1]);
 
+  unsigned n_threads = 1;
+  if (argc > 2) {
+    char *endptr;
+    n_threads = strtoul(argv[2], &endptr, 10);
+    if (endptr == argv[2] || *endptr != 0 ||
+        n_threads < 1 || n_threads > 64) {
+      cerr << "Invalid number of threads" << endl;
+      return EXIT_FAILURE;
+    }
+  }
+
   EventLoop event_loop;
   SignalMonitorInit(event_loop);
   AtScopeExit() { SignalMonitorFinish(); };
 
-  CloudServer server(db_path, event_loop,
-                     IPv4Address(CloudServer::GetDefaultPort()));
+  /* more shards than threads, to reduce lock contention */
+  CloudDaemon daemon(db_path, event_loop, n_threads * 4);
 
   try {
-    server.Load();
+    daemon.Load();
   } catch (const std::runtime_error &e) {
     cerr << "Failed to load database" << endl;
     PrintException(e);
   }
 
+  daemon.Start(IPv4Address(CloudServer::GetDefaultPort()), n_threads);
+
   event_loop.Run();
 
-  server.Save();
+  daemon.Stop();
 
   return EXIT_SUCCESS;
 } catch (const std::exception &exception) {
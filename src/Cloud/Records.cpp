@@ -0,0 +1,133 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#include "Records.hpp"
+#include "Serialiser.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+static constexpr uint32_t CLOUD_MAGIC = 0x5753f60f;
+static constexpr uint32_t CLOUD_VERSION = 1;
+
+void
+CloudRecords::Update(CloudClientPtr client)
+{
+  next_id = std::max(next_id, client->id + 1);
+
+  auto [i, inserted] = client_index.try_emplace(client->key, clients.size());
+  if (inserted)
+    clients.emplace_back(std::move(client));
+  else
+    clients[i->second] = std::move(client);
+}
+
+void
+CloudRecords::Add(CloudThermalPtr thermal)
+{
+  const auto &top = thermal->top_location;
+  const ThermalKey key{
+    thermal->client_key,
+    int32_t(std::lround(top.latitude.Degrees() * 1000000)),
+    int32_t(std::lround(top.longitude.Degrees() * 1000000)),
+    int32_t(std::lround(top.altitude)),
+  };
+
+  if (thermal_index.emplace(key).second)
+    thermals.emplace_back(std::move(thermal));
+}
+
+void
+CloudRecords::Expire(std::chrono::steady_clock::time_point clients_before,
+                     std::chrono::steady_clock::time_point thermals_before)
+{
+  std::erase_if(clients, [clients_before](const CloudClientPtr &client){
+    return client->stamp < clients_before;
+  });
+
+  std::erase_if(thermals, [thermals_before](const CloudThermalPtr &thermal){
+    return thermal->time < thermals_before;
+  });
+
+  client_index.clear();
+  for (std::size_t i = 0; i < clients.size(); ++i)
+    client_index.emplace(clients[i]->key, i);
+
+  /* the thermal index is not pruned: expired thermals stay expired
+     when they show up again */
+}
+
+void
+CloudRecords::SortByStamp() noexcept
+{
+  std::sort(clients.begin(), clients.end(), [](const auto &a, const auto &b){
+    return a->stamp < b->stamp;
+  });
+
+  std::sort(thermals.begin(), thermals.end(), [](const auto &a, const auto &b){
+    return a->time < b->time;
+  });
+
+  client_index.clear();
+  for (std::size_t i = 0; i < clients.size(); ++i)
+    client_index.emplace(clients[i]->key, i);
+}
+
+void
+CloudRecords::Load(Deserialiser &s)
+{
+  if (s.Read32() != CLOUD_MAGIC)
+    throw std::runtime_error("Bad magic");
+
+  if (s.Read32() != CLOUD_VERSION)
+    throw std::runtime_error("Bad version");
+
+  next_id = std::max(next_id, unsigned(s.Read32()));
+
+  while (s.Read8() != 0)
+    Update(std::make_shared<CloudClient>(CloudClient::Load(s)));
+
+  s.Read8();
+
+  if (s.Read8() != 0) {
+    s.Read8();
+
+    while (s.Read8() != 0)
+      Add(std::make_shared<CloudThermal>(CloudThermal::Load(s)));
+
+    s.Read8();
+    s.Read8();
+  }
+}
+
+void
+CloudRecords::Save(Serialiser &s) const
+{
+  s.Write32(CLOUD_MAGIC);
+  s.Write32(CLOUD_VERSION);
+
+  /* newest first, like the containers' lists */
+
+  s.Write32(next_id);
+
+  for (auto i = clients.rbegin(); i != clients.rend(); ++i) {
+    s.Write8(1);
+    (*i)->Save(s);
+  }
+
+  s.Write8(0);
+  s.Write8(0);
+
+  s.Write8(1);
+  s.Write8(1);
+
+  for (auto i = thermals.rbegin(); i != thermals.rend(); ++i) {
+    s.Write8(1);
+    (*i)->Save(s);
+  }
+
+  s.Write8(0);
+  s.Write8(0);
+
+  s.Write8(0);
+}
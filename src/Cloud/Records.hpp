@@ -0,0 +1,84 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#pragma once
+
+#include "Client.hpp"
+#include "Thermal.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <set>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+class Serialiser;
+class Deserialiser;
+
+/**
+ * A flat collection of clients and thermals without any index.  This
+ * is the in-memory representation of the database file, used to fold
+ * the change journal into it (see #CloudJournal) and to bulk-load
+ * the containers.
+ *
+ * Applying the same records again (e.g. after a crash during
+ * compaction) does not change the result.
+ */
+class CloudRecords {
+  /**
+   * Maps the client key to its index in #clients.
+   */
+  std::unordered_map<uint64_t, std::size_t> client_index;
+
+  /**
+   * Identifies thermals (client key, location, altitude), to skip
+   * duplicates.
+   */
+  using ThermalKey = std::tuple<uint64_t, int32_t, int32_t, int32_t>;
+  std::set<ThermalKey> thermal_index;
+
+public:
+  unsigned next_id = 1;
+
+  std::vector<CloudClientPtr> clients;
+  std::vector<CloudThermalPtr> thermals;
+
+  /**
+   * Add a client, or replace the existing client with the same key.
+   */
+  void Update(CloudClientPtr client);
+
+  /**
+   * Add a thermal, unless it is already known.
+   */
+  void Add(CloudThermalPtr thermal);
+
+  /**
+   * Remove all clients which have not been refreshed and all thermals
+   * which have been received before the given time stamps.
+   */
+  void Expire(std::chrono::steady_clock::time_point clients_before,
+              std::chrono::steady_clock::time_point thermals_before);
+
+  /**
+   * Sort the objects from old to new, which is the order in which
+   * they need to be inserted into the containers (each insertion
+   * goes to the front of the container's list).
+   */
+  void SortByStamp() noexcept;
+
+  /**
+   * Load a database file.
+   *
+   * Throws on error.
+   */
+  void Load(Deserialiser &s);
+
+  /**
+   * Write a database file.  SortByStamp() must have been called.
+   *
+   * Throws on error.
+   */
+  void Save(Serialiser &s) const;
+};
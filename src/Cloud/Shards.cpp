@@ -0,0 +1,276 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#include "Shards.hpp"
+#include "Data.hpp"
+#include "Records.hpp"
+#include "Journal.hpp"
+#include "Geo/Boost/RangeBox.hpp"
+#include "Math/SpatialHash.hpp"
+#include "Tracking/SkyLines/Protocol.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+CloudShards::CloudShards(unsigned n_shards, CloudJournal *_journal)
+  :journal(_journal)
+{
+  n_shards = std::clamp(n_shards, 1U, MAX_SHARDS);
+
+  shards.reserve(n_shards);
+  for (unsigned i = 0; i < n_shards; ++i)
+    shards.emplace_back(std::make_unique<Shard>());
+}
+
+CloudShards::~CloudShards() noexcept = default;
+
+static int
+ToCell(Angle angle, double cell_size) noexcept
+{
+  return (int)std::floor(angle.Degrees() / cell_size);
+}
+
+unsigned
+CloudShards::GetShardIndex(int x, int y) const noexcept
+{
+  return SpatialHash(x, y) % shards.size();
+}
+
+unsigned
+CloudShards::GetShardIndex(GeoPoint location) const noexcept
+{
+  return GetShardIndex(ToCell(location.longitude, CELL_SIZE),
+                       ToCell(location.latitude, CELL_SIZE));
+}
+
+CloudShards::ShardMask
+CloudShards::GetShardMask(GeoPoint location, double range) const noexcept
+{
+  const ShardMask all = shards.size() >= MAX_SHARDS
+    ? ~ShardMask(0)
+    : (ShardMask(1) << shards.size()) - 1;
+
+  const auto box = BoostRangeBox(location, range);
+  const GeoPoint &sw = box.min_corner(), &ne = box.max_corner();
+  if (sw.longitude > ne.longitude)
+    /* the range crosses the date line; this is rare enough to query
+       all shards */
+    return all;
+
+  const int x0 = ToCell(sw.longitude, CELL_SIZE);
+  const int x1 = ToCell(ne.longitude, CELL_SIZE);
+  const int y0 = ToCell(sw.latitude, CELL_SIZE);
+  const int y1 = ToCell(ne.latitude, CELL_SIZE);
+
+  ShardMask mask = 0;
+  for (int y = y0; y <= y1; ++y) {
+    for (int x = x0; x <= x1; ++x) {
+      mask |= ShardMask(1) << GetShardIndex(x, y);
+      if (mask == all)
+        return mask;
+    }
+  }
+
+  return mask;
+}
+
+CloudClientPtr
+CloudShards::RemoveClient(uint64_t key, unsigned shard_index)
+{
+  auto &shard = *shards[shard_index];
+  const std::lock_guard lock{shard.mutex};
+
+  auto *client = shard.clients.Find(key);
+  if (client == nullptr)
+    return nullptr;
+
+  auto ptr = client->shared_from_this();
+  shard.clients.Remove(*client);
+  return ptr;
+}
+
+CloudShards::ClientInfo
+CloudShards::UpdateClient(SocketAddress address, uint64_t key,
+                          GeoPoint location, int altitude)
+{
+  const unsigned target = GetShardIndex(location);
+
+  auto &stripe = GetStripe(key);
+  const std::lock_guard lock{stripe.mutex};
+
+  CloudClientPtr client;
+
+  if (auto i = stripe.shards.find(key); i != stripe.shards.end()) {
+    if (i->second == target) {
+      auto &shard = *shards[target];
+      const std::lock_guard shard_lock{shard.mutex};
+
+      if (auto *c = shard.clients.Find(key)) {
+        shard.clients.Refresh(*c, address, location, altitude);
+        if (journal != nullptr)
+          journal->Append(*c);
+        return {c->id, c->location, c->altitude};
+      }
+    } else {
+      /* the client has moved to a cell owned by another shard */
+      client = RemoveClient(key, i->second);
+    }
+  }
+
+  if (client) {
+    client->Refresh(address);
+    client->location = location;
+    client->altitude = altitude;
+  } else
+    client = std::make_shared<CloudClient>(address, key, next_id++,
+                                           location, altitude);
+
+  {
+    auto &shard = *shards[target];
+    const std::lock_guard shard_lock{shard.mutex};
+    shard.clients.Insert(*client);
+    if (journal != nullptr)
+      journal->Append(*client);
+  }
+
+  stripe.shards[key] = target;
+  return {client->id, client->location, client->altitude};
+}
+
+bool
+CloudShards::RefreshClient(uint64_t key, SocketAddress address,
+                           ClientInfo &info)
+{
+  auto &stripe = GetStripe(key);
+  const std::lock_guard lock{stripe.mutex};
+
+  auto i = stripe.shards.find(key);
+  if (i == stripe.shards.end())
+    return false;
+
+  auto &shard = *shards[i->second];
+  const std::lock_guard shard_lock{shard.mutex};
+
+  auto *client = shard.clients.Find(key);
+  if (client == nullptr)
+    return false;
+
+  shard.clients.Refresh(*client, address);
+  if (journal != nullptr)
+    journal->Append(*client);
+
+  info = {client->id, client->location, client->altitude};
+  return true;
+}
+
+SkyLinesTracking::Thermal
+CloudShards::AddThermal(uint64_t client_key,
+                        const AGeoPoint &bottom_location,
+                        const AGeoPoint &top_location,
+                        double lift)
+{
+  /* thermals are indexed by their top location, see
+     CloudThermalIndexable */
+  auto &shard = *shards[GetShardIndex(top_location)];
+  const std::lock_guard lock{shard.mutex};
+
+  const auto &thermal = shard.thermals.Make(client_key, bottom_location,
+                                           top_location, lift);
+  if (journal != nullptr)
+    journal->Append(thermal);
+
+  return thermal.Pack();
+}
+
+void
+CloudShards::Expire(std::chrono::steady_clock::time_point before)
+{
+  std::vector<uint64_t> expired;
+
+  for (unsigned i = 0; i < shards.size(); ++i) {
+    auto &shard = *shards[i];
+
+    {
+      const std::lock_guard lock{shard.mutex};
+      for (auto j = shard.clients.rbegin();
+           j != shard.clients.rend() && j->stamp < before; ++j)
+        expired.push_back(j->key);
+
+      shard.clients.Expire(before);
+    }
+
+    /* remove the directory entries, unless the client has reappeared
+       in the meantime */
+    for (const uint64_t key : expired) {
+      auto &stripe = GetStripe(key);
+      const std::lock_guard lock{stripe.mutex};
+
+      auto j = stripe.shards.find(key);
+      if (j == stripe.shards.end() || j->second != i)
+        continue;
+
+      const std::lock_guard shard_lock{shard.mutex};
+      if (shard.clients.Find(key) == nullptr)
+        stripe.shards.erase(j);
+    }
+
+    expired.clear();
+  }
+}
+
+void
+CloudShards::Snapshot(CloudData &data)
+{
+  CloudRecords records;
+
+  for (auto &shard : shards) {
+    const std::lock_guard lock{shard->mutex};
+
+    for (const auto &client : shard->clients)
+      records.clients.emplace_back(std::make_shared<CloudClient>(client));
+
+    for (const auto &thermal : shard->thermals)
+      records.thermals.emplace_back(std::make_shared<CloudThermal>(thermal));
+  }
+
+  /* build the indexes outside of the locks */
+
+  records.SortByStamp();
+
+  data.clients.SetNextId(next_id);
+  data.clients.BulkLoad(records.clients);
+  data.thermals.BulkLoad(records.thermals);
+}
+
+void
+CloudShards::Load(CloudRecords &&records)
+{
+  records.SortByStamp();
+
+  next_id = records.next_id;
+
+  std::vector<std::vector<CloudClientPtr>> clients(shards.size());
+  std::vector<std::vector<CloudThermalPtr>> thermals(shards.size());
+
+  for (auto &client : records.clients) {
+    const unsigned index = GetShardIndex(client->location);
+
+    {
+      auto &stripe = GetStripe(client->key);
+      const std::lock_guard lock{stripe.mutex};
+      stripe.shards[client->key] = index;
+    }
+
+    clients[index].emplace_back(std::move(client));
+  }
+
+  for (auto &thermal : records.thermals)
+    thermals[GetShardIndex(thermal->top_location)].emplace_back(std::move(thermal));
+
+  for (unsigned i = 0; i < shards.size(); ++i) {
+    auto &shard = *shards[i];
+    const std::lock_guard lock{shard.mutex};
+    shard.clients.BulkLoad(clients[i]);
+    shard.thermals.BulkLoad(thermals[i]);
+  }
+}
@@ -0,0 +1,232 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#pragma once
+
+#include "Client.hpp"
+#include "Thermal.hpp"
+#include "thread/Mutex.hxx"
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+struct CloudData;
+class CloudRecords;
+class CloudJournal;
+namespace SkyLinesTracking { struct Thermal; }
+
+/**
+ * A thread-safe variant of #CloudData for the multi-threaded cloud
+ * server.
+ *
+ * Clients and thermals are distributed over several shards by their
+ * location: the world is divided into cells of #CELL_SIZE degrees,
+ * and each cell is hashed to one shard.  Each shard has its own
+ * mutex, so worker threads contend only if they handle nearby
+ * clients.  Queries lock all shards which overlap the query range,
+ * one after another.
+ *
+ * A (striped) directory maps each client key to the shard which
+ * currently owns it.  Lock order: directory stripe before shard;
+ * never more than one shard at a time; the #CloudJournal mutex
+ * last.
+ */
+class CloudShards {
+  /**
+   * The size of one cell [degrees].  This should be larger than the
+   * query ranges, so a typical query touches no more than four
+   * cells.
+   */
+  static constexpr double CELL_SIZE = 1;
+
+  static constexpr unsigned MAX_SHARDS = 64;
+
+  struct Shard {
+    Mutex mutex;
+    CloudClientContainer clients;
+    CloudThermalContainer thermals;
+  };
+
+  using ShardMask = uint64_t;
+  static_assert(MAX_SHARDS <= sizeof(ShardMask) * 8);
+
+  std::vector<std::unique_ptr<Shard>> shards;
+
+  /**
+   * If not nullptr, then all modifications are recorded here.
+   */
+  CloudJournal *const journal;
+
+  static constexpr unsigned N_STRIPES = 16;
+
+  struct DirectoryStripe {
+    Mutex mutex;
+
+    /**
+     * Maps the client key to the index of its shard.
+     */
+    std::unordered_map<uint64_t, unsigned> shards;
+  };
+
+  std::array<DirectoryStripe, N_STRIPES> directory;
+
+  /**
+   * The public id assigned to the next new #CloudClient.
+   */
+  std::atomic<unsigned> next_id{1};
+
+public:
+  /**
+   * A copy of the public attributes of a #CloudClient.
+   */
+  struct ClientInfo {
+    unsigned id;
+    GeoPoint location;
+    int altitude;
+  };
+
+  explicit CloudShards(unsigned n_shards,
+                       CloudJournal *_journal=nullptr);
+  ~CloudShards() noexcept;
+
+  CloudShards(const CloudShards &) = delete;
+  CloudShards &operator=(const CloudShards &) = delete;
+
+  /**
+   * Create a new #CloudClient, or refresh the existing one (and move
+   * it to another shard if necessary).
+   */
+  ClientInfo UpdateClient(SocketAddress address, uint64_t key,
+                          GeoPoint location, int altitude);
+
+  /**
+   * Refresh an existing client which has submitted a fix without a
+   * location.
+   *
+   * @return false if the client is unknown
+   */
+  bool RefreshClient(uint64_t key, SocketAddress address, ClientInfo &info);
+
+  /**
+   * Invoke the given function with the client with the given key,
+   * while its shard is locked.
+   *
+   * @return false if the client is unknown
+   */
+  template<typename F>
+  bool WithClient(uint64_t key, F &&f) {
+    auto &stripe = GetStripe(key);
+    const std::lock_guard lock{stripe.mutex};
+
+    auto i = stripe.shards.find(key);
+    if (i == stripe.shards.end())
+      return false;
+
+    auto &shard = *shards[i->second];
+    const std::lock_guard shard_lock{shard.mutex};
+
+    auto *client = shard.clients.Find(key);
+    if (client == nullptr)
+      return false;
+
+    f(*client);
+    return true;
+  }
+
+  /**
+   * Invoke the given function for each client within the given
+   * range, while its shard is locked.  The function returns false to
+   * stop the iteration.
+   */
+  template<typename F>
+  void VisitClientsWithinRange(GeoPoint location, double range, F &&f) {
+    const ShardMask mask = GetShardMask(location, range);
+    for (unsigned i = 0; i < shards.size(); ++i) {
+      if ((mask & (ShardMask(1) << i)) == 0)
+        continue;
+
+      auto &shard = *shards[i];
+      const std::lock_guard lock{shard.mutex};
+      for (const auto &client : shard.clients.QueryWithinRange(location,
+                                                               range))
+        if (!f(*client))
+          return;
+    }
+  }
+
+  /**
+   * Create a new #CloudThermal.
+   *
+   * @return the packed thermal
+   */
+  SkyLinesTracking::Thermal AddThermal(uint64_t client_key,
+                                       const AGeoPoint &bottom_location,
+                                       const AGeoPoint &top_location,
+                                       double lift);
+
+  /**
+   * Like VisitClientsWithinRange(), but for thermals.
+   */
+  template<typename F>
+  void VisitThermalsWithinRange(GeoPoint location, double range, F &&f) {
+    const ShardMask mask = GetShardMask(location, range);
+    for (unsigned i = 0; i < shards.size(); ++i) {
+      if ((mask & (ShardMask(1) << i)) == 0)
+        continue;
+
+      auto &shard = *shards[i];
+      const std::lock_guard lock{shard.mutex};
+      for (const auto &thermal : shard.thermals.QueryWithinRange(location,
+                                                                 range))
+        if (!f(*thermal))
+          return;
+    }
+  }
+
+  void Expire(std::chrono::steady_clock::time_point before);
+
+  /**
+   * Copy all clients and thermals to the given (empty) #CloudData
+   * object.  Each shard is locked only while its objects are being
+   * copied.
+   */
+  void Snapshot(CloudData &data);
+
+  /**
+   * Move all clients and thermals from the given #CloudRecords
+   * object into the (empty) shards.  This packs each shard's R-trees
+   * in one pass.
+   */
+  void Load(CloudRecords &&records);
+
+private:
+  [[gnu::pure]]
+  DirectoryStripe &GetStripe(uint64_t key) noexcept {
+    return directory[key % N_STRIPES];
+  }
+
+  [[gnu::pure]]
+  unsigned GetShardIndex(int x, int y) const noexcept;
+
+  [[gnu::pure]]
+  unsigned GetShardIndex(GeoPoint location) const noexcept;
+
+  /**
+   * Determine which shards overlap the given range.
+   */
+  [[gnu::pure]]
+  ShardMask GetShardMask(GeoPoint location, double range) const noexcept;
+
+  /**
+   * Remove the client from its current shard.
+   *
+   * Caller must lock the directory stripe.
+   *
+   * @return the client or nullptr if it was not found
+   */
+  CloudClientPtr RemoveClient(uint64_t key, unsigned shard_index);
+};
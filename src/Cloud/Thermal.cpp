@@ -12,6 +12,8 @@
 #include <boost/geometry/algorithms/intersection.hpp>
 #include <boost/geometry/strategies/strategies.hpp>
 
+#include <cassert>
+
 CloudThermalContainer::CloudThermalContainer()
 {
 }
@@ -47,6 +49,17 @@ CloudThermalContainer::Insert(CloudThermal &thermal)
   rtree.insert(thermal.shared_from_this());
 }
 
+void
+CloudThermalContainer::BulkLoad(const std::vector<CloudThermalPtr> &thermals)
+{
+  assert(empty());
+
+  for (const auto &thermal : thermals)
+    list.push_front(*thermal);
+
+  rtree = Tree(thermals.begin(), thermals.end());
+}
+
 void
 CloudThermalContainer::Remove(CloudThermal &thermal)
 {
@@ -92,7 +105,7 @@ CloudThermal
 CloudThermal::Load(Deserialiser &s)
 {
   s.Read8();
-  const unsigned client_key = s.Read64();
+  const uint64_t client_key = s.Read64();
 
   std::chrono::steady_clock::time_point time;
   s >> time;
@@ -109,30 +122,3 @@ CloudThermal::Load(Deserialiser &s)
   thermal.time = time;
   return thermal;
 }
-
-void
-CloudThermalContainer::Save(Serialiser &s) const
-{
-  s.Write8(1);
-
-  for (const auto &thermal : list) {
-    s.Write8(1);
-    thermal.Save(s);
-  }
-
-  s.Write8(0);
-  s.Write8(0);
-}
-
-void
-CloudThermalContainer::Load(Deserialiser &s)
-{
-  s.Read8();
-
-  while (s.Read8() != 0) {
-    auto thermal = std::make_shared<CloudThermal>(CloudThermal::Load(s));
-    Insert(*thermal);
-  }
-
-  s.Read8();
-}
@@ -10,6 +10,7 @@
 #include <boost/range/iterator_range_core.hpp>
 #include <memory>
 #include <chrono>
+#include <vector>
 
 class Serialiser;
 class Deserialiser;
@@ -115,6 +116,14 @@ public:
 
   void Insert(CloudThermal &client);
 
+  /**
+   * Insert many thermals into this (empty) container at once, see
+   * CloudClientContainer::BulkLoad().
+   *
+   * @param thermals the thermals, oldest first
+   */
+  void BulkLoad(const std::vector<CloudThermalPtr> &thermals);
+
   /**
    * Remove a #CloudThermal and its data.  Be careful - the given reference
    * is invalidated, unless the caller holds another #CloudThermalPtr.
@@ -128,7 +137,4 @@ public:
 
   [[gnu::pure]]
   query_iterator_range QueryWithinRange(GeoPoint location, double range) const;
-
-  void Save(Serialiser &s) const;
-  void Load(Deserialiser &s);
 };
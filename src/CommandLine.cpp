@@ -31,6 +31,8 @@ namespace CommandLine {
 #ifdef HAVE_CMDLINE_REPLAY
   const char *replay_path;
 #endif
+
+  const char *frame_profile_path;
 }
 
 void
@@ -70,6 +72,13 @@ CommandLine::Parse(Args &args)
     } else if (StringIsEqual(s, "-replay=", 8)) {
       replay_path = s + 8;
 #endif
+    } else if (StringIsEqual(s, "-frame-profile=", 15)) {
+      s += 15;
+
+      if (StringIsEmpty(s))
+        args.UsageError();
+
+      frame_profile_path = s;
 #ifdef SIMULATOR_AVAILABLE
     } else if (StringIsEqual(s, "-simulator")) {
       global_simulator_flag = true;
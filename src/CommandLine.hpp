@@ -27,6 +27,12 @@ namespace CommandLine {
   extern const char *replay_path;
 #endif
 
+  /**
+   * If set, the #frame_profiler results are written to this file on
+   * shutdown.
+   */
+  extern const char *frame_profile_path;
+
 /**
  * Reads and parses arguments/options from the command line
  * @param CommandLine command line argument string
@@ -138,6 +138,9 @@ GlideComputer::ProcessGPS(bool force)
   // Update the ConditionMonitors
   condition_monitors.Update(Basic(), Calculated(), settings);
 
+  if (idle_by_gps_clock)
+    return idle_gps_clock.CheckAdvance(basic.time, milliseconds(500));
+
   return idle_clock.CheckUpdate(milliseconds(500));
 }
 
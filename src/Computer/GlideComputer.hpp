@@ -6,6 +6,7 @@
 #include "GlideComputerBlackboard.hpp"
 #include "time/PeriodClock.hpp"
 #include "time/DeltaTime.hpp"
+#include "time/GPSClock.hpp"
 #include "GlideComputerAirData.hpp"
 #include "StatsComputer.hpp"
 #include "TaskComputer.hpp"
@@ -46,6 +47,17 @@ class GlideComputer : public GlideComputerBlackboard
 
   PeriodClock idle_clock;
 
+  /**
+   * Replaces #idle_clock if #idle_by_gps_clock is set.
+   */
+  GPSClock idle_gps_clock;
+
+  /**
+   * Schedule ProcessIdle() by the GPS time instead of the wall
+   * clock?  See SetIdleByGPSClock().
+   */
+  bool idle_by_gps_clock = false;
+
   /**
    * This object is used to check whether to update
    * DerivedInfo::trace_history.
@@ -145,6 +157,15 @@ public:
     task_computer.SetContestIncremental(incremental);
   }
 
+  /**
+   * Let ProcessGPS() request ProcessIdle() calls by the GPS time
+   * instead of the wall clock.  This makes the results independent
+   * of the CPU speed, e.g. when replaying faster than real time.
+   */
+  void SetIdleByGPSClock(bool value) noexcept {
+    idle_by_gps_clock = value;
+  }
+
 protected:
   void OnTakeoff();
   void OnLanding();
@@ -6,11 +6,32 @@
 
 DeviceDataEditor::DeviceDataEditor(DeviceBlackboard &_blackboard,
                                    std::size_t idx) noexcept
-  :blackboard(_blackboard), lock(blackboard.mutex),
-   basic(blackboard.SetRealState(idx)) {}
+  :blackboard(_blackboard), slot(blackboard.GetDeviceSlot(idx)),
+   lock(slot.GetMutex()),
+   basic(slot.GetWorking()) {}
 
 void
 DeviceDataEditor::Commit() const noexcept
 {
-  blackboard.ScheduleMerge();
+  CommitLater();
+  Flush();
+}
+
+void
+DeviceDataEditor::CommitLater() const noexcept
+{
+  slot.MarkModified();
+}
+
+void
+DeviceDataEditor::Flush() const noexcept
+{
+  if (slot.Publish())
+    blackboard.ScheduleMerge();
+}
+
+void
+DeviceDataEditor::Expire() const noexcept
+{
+  slot.Expire();
 }
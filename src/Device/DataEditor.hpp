@@ -6,11 +6,19 @@
 #include "thread/Mutex.hxx"
 
 class DeviceBlackboard;
+class DeviceDataSlot;
 struct NMEAInfo;
 
+/**
+ * Edit the data of one device.  This locks only the device's own
+ * #DeviceDataSlot, not the #DeviceBlackboard; Commit() publishes
+ * the modified data to the #MergeThread.
+ */
 class DeviceDataEditor {
   DeviceBlackboard &blackboard;
 
+  DeviceDataSlot &slot;
+
   const std::lock_guard<Mutex> lock;
 
   NMEAInfo &basic;
@@ -19,8 +27,28 @@ public:
   DeviceDataEditor(DeviceBlackboard &blackboard,
                    std::size_t idx) noexcept;
 
+  /**
+   * Publish the modified data to the #MergeThread now.
+   */
   void Commit() const noexcept;
 
+  /**
+   * Mark the data as modified, but leave publishing it to a later
+   * Commit() or Flush() call.  This allows publishing a batch of
+   * NMEA sentences at once.
+   */
+  void CommitLater() const noexcept;
+
+  /**
+   * Publish the data if it was modified by CommitLater().
+   */
+  void Flush() const noexcept;
+
+  /**
+   * Call NMEAInfo::Expire(), but not more than once per second.
+   */
+  void Expire() const noexcept;
+
   NMEAInfo *operator->() const noexcept {
     return &basic;
   }
@@ -21,12 +21,14 @@
 #include "util/StringCompare.hxx"
 #include "util/Exception.hxx"
 #include "Logger/NMEALogger.hpp"
+#include "Logger/SensorLogger.hpp"
 #include "Language/Language.hpp"
 #include "Operation/Operation.hpp"
 #include "Operation/Cancelled.hpp"
 #include "system/Path.hpp"
 #include "../Simulator.hpp"
 #include "Input/InputQueue.hpp"
+#include "Audio/VarioGlue.hpp"
 #include "LogFile.hpp"
 #include "Job/Job.hpp"
 #include "Operation/MessageOperationEnvironment.hpp"
@@ -62,10 +64,12 @@ FlushPortBeforePassThroughSwitch(Port &port, OperationEnvironment &env);
 
 DeviceDescriptor::DeviceDescriptor(DeviceBlackboard &_blackboard,
                                    NMEALogger *_nmea_logger,
+                                   SensorLogger *_sensor_logger,
                                    DeviceFactory &_factory,
                                    unsigned _index,
                                    PortListener *_port_listener) noexcept
   :blackboard(_blackboard), nmea_logger(_nmea_logger),
+   sensor_logger(_sensor_logger),
    factory(_factory),
    index(_index),
    port_listener(_port_listener)
@@ -1095,8 +1099,7 @@ DeviceDescriptor::PutActiveFrequency(RadioFrequency frequency,
 }
 
 bool
-DeviceDescriptor::ExchangeRadioFrequencies(OperationEnvironment &env,
-                                           NMEAInfo &info) noexcept
+DeviceDescriptor::ExchangeRadioFrequencies(OperationEnvironment &env) noexcept
 {
   assert(InMainThread());
 
@@ -1107,15 +1110,33 @@ DeviceDescriptor::ExchangeRadioFrequencies(OperationEnvironment &env,
     /* TODO: postpone until the borrowed device has been returned */
     return false;
 
+  /* the driver works on a copy, because the device's response may be
+     delivered by the I/O thread, which needs the slot mutex to parse
+     it; only the ExternalSettings modified by the driver are applied
+     to the working copy afterwards, so nothing the I/O thread parsed
+     in the meantime gets lost */
+  NMEAInfo info;
+
+  {
+    const auto e = BeginEdit();
+    info = *e;
+  }
+
   try {
     ScopeReturnDevice restore(*this, env);
-    return device->ExchangeRadioFrequencies(env, info);
+    if (!device->ExchangeRadioFrequencies(env, info))
+      return false;
   } catch (OperationCancelled) {
     return false;
   } catch (...) {
     LogError(std::current_exception(), "ExchangeRadioFrequencies() failed");
     return false;
   }
+
+  const auto e = BeginEdit();
+  e->settings.Complement(info.settings);
+  e.Commit();
+  return true;
 }
 
 bool
@@ -1705,6 +1726,19 @@ DeviceDescriptor::PortError(const char *msg) noexcept
     port_listener->PortError(msg);
 }
 
+/**
+ * If the parser has received a new total energy vario value, pass it
+ * to the audio vario right away, without waiting for the
+ * MergeThread.
+ */
+static void
+ForwardVario(unsigned device, Validity old_available,
+             const NMEAInfo &basic) noexcept
+{
+  if (basic.total_energy_vario_available.Modified(old_available))
+    AudioVarioGlue::SetDeviceValue(device, basic.total_energy_vario);
+}
+
 bool
 DeviceDescriptor::DataReceived(std::span<const std::byte> s) noexcept
 {
@@ -1713,25 +1747,32 @@ DeviceDescriptor::DataReceived(std::span<const std::byte> s) noexcept
 
   // Pass data directly to drivers that use binary data protocols
   if (driver != nullptr && device != nullptr && driver->UsesRawData()) {
-    auto basic = blackboard.LockGetDeviceDataUpdateClock(index);
+    const auto e = BeginEdit();
+    NMEAInfo &basic = *e;
+    basic.UpdateClock();
+    e.Expire();
 
     const ExternalSettings old_settings = basic.settings;
+    const Validity old_vario = basic.total_energy_vario_available;
 
-    /* call Device::DataReceived() without holding
-       DeviceBlackboard::mutex to avoid blocking all other threads */
     if (device->DataReceived(s, basic)) {
       if (!config.sync_from_device)
         basic.settings = old_settings;
 
-      blackboard.LockSetDeviceDataScheduleMerge(index, basic);
+      ForwardVario(index, old_vario, basic);
+      e.Commit();
     }
 
     return true;
   }
 
-  if (!IsNMEAOut())
+  if (!IsNMEAOut()) {
     PortLineSplitter::DataReceived(s);
 
+    /* publish all sentences of this chunk at once */
+    BeginEdit().Flush();
+  }
+
   return true;
 }
 
@@ -1744,13 +1785,22 @@ DeviceDescriptor::LineReceived(const char *line) noexcept
       nmea_logger->Log(line);
   }
 
+  if (sensor_logger != nullptr)
+    sensor_logger->LogLine(index, line);
+
   if (dispatcher != nullptr)
     dispatcher->LineReceived(line);
 
   const auto e = BeginEdit();
   e->UpdateClock();
+  /* the working copy is not expired by DeviceBlackboard::Merge(), so
+     do it here before the parser sees it */
+  e.Expire();
+  const Validity old_vario = e->total_energy_vario_available;
   ParseNMEA(line, *e);
-  e.Commit();
+  ForwardVario(index, old_vario, *e);
+  /* published by DataReceived() after the whole chunk */
+  e.CommitLater();
 
   return true;
 }
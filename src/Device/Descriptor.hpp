@@ -43,6 +43,7 @@
 namespace Java { class GlobalCloseable; }
 class DeviceBlackboard;
 class NMEALogger;
+class SensorLogger;
 class GlidePolar;
 struct GeoPoint;
 struct NMEAInfo;
@@ -74,6 +75,7 @@ class DeviceDescriptor final
   DeviceBlackboard &blackboard;
 
   NMEALogger *const nmea_logger;
+  SensorLogger *const sensor_logger;
 
   DeviceFactory &factory;
 
@@ -291,6 +293,7 @@ class DeviceDescriptor final
 public:
   DeviceDescriptor(DeviceBlackboard &_blackboard,
                    NMEALogger *_nmea_logger,
+                   SensorLogger *_sensor_logger,
                    DeviceFactory &_factory,
                    unsigned index, PortListener *port_listener) noexcept;
   ~DeviceDescriptor() noexcept;
@@ -571,8 +574,7 @@ public:
   bool PutActiveFrequency(RadioFrequency frequency,
                           const char *name,
                           OperationEnvironment &env) noexcept;
-  bool ExchangeRadioFrequencies(OperationEnvironment &env,
-                                NMEAInfo &info) noexcept;
+  bool ExchangeRadioFrequencies(OperationEnvironment &env) noexcept;
   bool PutStandbyFrequency(RadioFrequency frequency,
                            const char *name,
                            OperationEnvironment &env) noexcept;
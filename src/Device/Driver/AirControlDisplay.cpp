@@ -221,10 +221,9 @@ ACDDevice::ExchangeRadioFrequencies(OperationEnvironment &env,
 bool
 ACDDevice::ParseNMEA(const char *_line, NMEAInfo &info)
 {
-  if (!VerifyNMEAChecksum(_line))
-    return false;
-
   NMEAInputLine line(_line);
+  if (!line.IsChecksumValid())
+    return false;
 
   if (line.ReadCompare("$PAAVS"))
     return ParsePAAVS(line, info);
@@ -94,10 +94,10 @@ PTFRS(NMEAInputLine &line, NMEAInfo &info)
 bool
 AltairProDevice::ParseNMEA(const char *String, NMEAInfo &info)
 {
-  if (!VerifyNMEAChecksum(String))
+  NMEAInputLine line(String);
+  if (!line.IsChecksumValid())
     return false;
 
-  NMEAInputLine line(String);
   const auto type = line.ReadView();
 
   // no propriatary sentence
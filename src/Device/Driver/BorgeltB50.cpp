@@ -5,7 +5,6 @@
 #include "Device/Driver/CAI302/PocketNav.hpp"
 #include "Device/Driver.hpp"
 #include "Units/System.hpp"
-#include "NMEA/Checksum.hpp"
 #include "NMEA/Info.hpp"
 #include "NMEA/InputLine.hpp"
 
@@ -106,10 +105,9 @@ PBB50(NMEAInputLine &line, NMEAInfo &info)
 bool
 B50Device::ParseNMEA(const char *String, NMEAInfo &info)
 {
-  if (!VerifyNMEAChecksum(String))
-    return false;
-
   NMEAInputLine line(String);
+  if (!line.IsChecksumValid())
+    return false;
 
   const auto type = line.ReadView();
   if (type == "$PBB50"sv)
@@ -5,7 +5,6 @@
 #include "Units/System.hpp"
 #include "NMEA/Info.hpp"
 #include "NMEA/InputLine.hpp"
-#include "NMEA/Checksum.hpp"
 
 using std::string_view_literals::operator""sv;
 
@@ -126,10 +125,9 @@ cai_w(NMEAInputLine &line, NMEAInfo &info)
 bool
 CAI302Device::ParseNMEA(const char *String, NMEAInfo &info)
 {
-  if (!VerifyNMEAChecksum(String))
-    return false;
-
   NMEAInputLine line(String);
+  if (!line.IsChecksumValid())
+    return false;
 
   const auto type = line.ReadView();
   if (type == "$PCAIB"sv)
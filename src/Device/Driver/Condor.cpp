@@ -4,7 +4,6 @@
 #include "Device/Driver/Condor.hpp"
 #include "Device/Driver.hpp"
 #include "Units/System.hpp"
-#include "NMEA/Checksum.hpp"
 #include "NMEA/Info.hpp"
 #include "NMEA/InputLine.hpp"
 
@@ -72,10 +71,9 @@ cLXWP0(NMEAInputLine &line, NMEAInfo &info, bool reciprocal_wind)
 bool
 CondorDevice::ParseNMEA(const char *String, NMEAInfo &info)
 {
-  if (!VerifyNMEAChecksum(String))
-    return false;
-
   NMEAInputLine line(String);
+  if (!line.IsChecksumValid())
+    return false;
 
   const auto type = line.ReadView();
   if (type == "$LXWP0"sv) return cLXWP0(line, info, reciprocal_wind);
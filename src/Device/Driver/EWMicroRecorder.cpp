@@ -12,7 +12,6 @@
 #include "Device/Declaration.hpp"
 #include "NMEA/Info.hpp"
 #include "NMEA/InputLine.hpp"
-#include "NMEA/Checksum.hpp"
 #include "Waypoint/Waypoint.hpp"
 #include "Units/System.hpp"
 #include "time/TimeoutClock.hpp"
@@ -68,10 +67,9 @@ ReadAltitude(NMEAInputLine &line, double &value_r)
 bool
 EWMicroRecorderDevice::ParseNMEA(const char *String, NMEAInfo &info)
 {
-  if (!VerifyNMEAChecksum(String))
-    return false;
-
   NMEAInputLine line(String);
+  if (!line.IsChecksumValid())
+    return false;
 
   const auto type = line.ReadView();
   if (type == "$PGRMZ"sv) {
@@ -3,7 +3,6 @@
 
 #include "Device/Driver/Eye.hpp"
 #include "Device/Driver.hpp"
-#include "NMEA/Checksum.hpp"
 #include "NMEA/Info.hpp"
 #include "NMEA/InputLine.hpp"
 #include "Units/System.hpp"
@@ -27,10 +26,9 @@ protected:
 bool
 EyeDevice::ParseNMEA(const char *_line, NMEAInfo &info)
 {
-  if (!VerifyNMEAChecksum(_line))
-    return false;
-
   NMEAInputLine line(_line);
+  if (!line.IsChecksumValid())
+    return false;
 
   const auto type = line.ReadView();
   if (type == "$PEYA"sv)
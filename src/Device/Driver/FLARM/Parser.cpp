@@ -3,7 +3,6 @@
 
 #include "Device.hpp"
 #include "NMEA/InputLine.hpp"
-#include "NMEA/Checksum.hpp"
 
 #include <string.h>
 
@@ -31,10 +30,9 @@ FlarmDevice::ParsePFLAC(NMEAInputLine &line)
 bool
 FlarmDevice::ParseNMEA(const char *_line, [[maybe_unused]] NMEAInfo &info)
 {
-  if (!VerifyNMEAChecksum(_line))
-    return false;
-
   NMEAInputLine line(_line);
+  if (!line.IsChecksumValid())
+    return false;
 
   const auto type = line.ReadView();
   if (type == "$PFLAC"sv)
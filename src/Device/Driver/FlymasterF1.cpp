@@ -71,10 +71,9 @@ VARIO(NMEAInputLine &line, NMEAInfo &info)
 bool
 FlymasterF1Device::ParseNMEA(const char *String, NMEAInfo &info)
 {
-  if (!VerifyNMEAChecksum(String))
-    return false;
-
   NMEAInputLine line(String);
+  if (!line.IsChecksumValid())
+    return false;
 
   const auto type = line.ReadView();
   if (type == "$VARIO"sv)
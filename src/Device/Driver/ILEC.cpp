@@ -3,7 +3,6 @@
 
 #include "Device/Driver/ILEC.hpp"
 #include "Device/Driver.hpp"
-#include "NMEA/Checksum.hpp"
 #include "NMEA/Info.hpp"
 #include "NMEA/InputLine.hpp"
 
@@ -47,10 +46,9 @@ ParsePDA1(NMEAInputLine &line, NMEAInfo &info)
 bool
 ILECDevice::ParseNMEA(const char *_line, NMEAInfo &info)
 {
-  if (!VerifyNMEAChecksum(_line))
-    return false;
-
   NMEAInputLine line(_line);
+  if (!line.IsChecksumValid())
+    return false;
 
   auto type = line.ReadView();
   if (type == "$PILC"sv) {
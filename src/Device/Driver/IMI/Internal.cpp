@@ -7,7 +7,6 @@
 #include "NMEA/InputLine.hpp"
 #include "Units/Unit.hpp"
 #include "Units/Units.hpp"
-#include "NMEA/Checksum.hpp"
 
 using std::string_view_literals::operator""sv;
 
@@ -47,10 +46,9 @@ ReadAltitude(NMEAInputLine &line, double &value_r)
 bool
 IMIDevice::ParseNMEA(const char *String, NMEAInfo &info)
 {
-  if (!VerifyNMEAChecksum(String))
-    return false;
-
   NMEAInputLine line(String);
+  if (!line.IsChecksumValid())
+    return false;
 
   const auto type = line.ReadView();
   if (type == "$PGRMZ"sv) {
@@ -2,8 +2,8 @@
 // Copyright The XCSoar Project
 
 #include "Internal.hpp"
-#include "NMEA/Checksum.hpp"
 #include "NMEA/InputLine.hpp"
+#include "NMEA/SentenceTable.hpp"
 #include "NMEA/Info.hpp"
 #include "Geo/SpeedVector.hpp"
 #include "RadioFrequency.hpp"
@@ -685,60 +685,60 @@ LXDevice::UpdateDeviceFlags(const DeviceInfo &device_info,
 bool
 LXDevice::ParseNMEA(const char *String, NMEAInfo &info)
 {
-  if (!VerifyNMEAChecksum(String))
-    return false;
-
   NMEAInputLine line(String);
+  if (!line.IsChecksumValid())
+    return false;
 
-  const auto type = line.ReadView();
-  if (type == "$LXWP0"sv)
-    return LXWP0(line, info);
-
-  if (type == "$LXWP1"sv) {
-    DeviceInfo &device_info = mode == Mode::PASS_THROUGH
-      ? info.secondary_device
-      : info.device;
-    LXWP1(line, device_info);
-    UpdateDeviceFlags(device_info, mode == Mode::PASS_THROUGH);
-    return true;
-  }
-
-  if (type == "$LXWP2"sv)
-    return LXWP2(line, info);
-
-  if (type == "$LXWP3"sv)
-    return LXWP3(line, info);
-
-  if (type == "$PLXV0"sv) {
-    is_colibri = false;
-    return PLXV0(line, lxnav_vario_settings, info);
-  }
-
-  if (type == "$PLXVC"sv) {
-    is_colibri = false;
-    PLXVC(line, info, nano_settings, device_declaration, mutex);
-
-    {
-      const std::lock_guard lock{mutex};
-      is_forwarded_nano =
-        IsNanoProduct(info.secondary_device.product);
-      const bool was_vario = IsLXNAVVario();
-      IdDeviceByNameLocked(info.device.product, info.device);
-      if (!was_vario && IsLXNAVVario())
-        vario_just_detected = true;
-    }
-    return true;
-  }
-
-  if (type == "$PLXVF"sv) {
-    is_colibri = false;
-    return PLXVF(line, info);
-  }
-
-  if (type == "$PLXVS"sv) {
-    is_colibri = false;
-    return PLXVS(line, info);
-  }
-
-  return false;
+  using Handler = bool (*)(LXDevice &device,
+                           NMEAInputLine &line, NMEAInfo &info);
+
+  static constexpr NMEASentenceTable<Handler, 8> sentences{{{
+    {"$LXWP0"sv, [](LXDevice &, NMEAInputLine &l, NMEAInfo &i){
+      return LXWP0(l, i);
+    }},
+    {"$LXWP1"sv, [](LXDevice &d, NMEAInputLine &l, NMEAInfo &i){
+      DeviceInfo &device_info = d.mode == Mode::PASS_THROUGH
+        ? i.secondary_device
+        : i.device;
+      LXWP1(l, device_info);
+      d.UpdateDeviceFlags(device_info, d.mode == Mode::PASS_THROUGH);
+      return true;
+    }},
+    {"$LXWP2"sv, [](LXDevice &, NMEAInputLine &l, NMEAInfo &i){
+      return LXWP2(l, i);
+    }},
+    {"$LXWP3"sv, [](LXDevice &, NMEAInputLine &l, NMEAInfo &i){
+      return LXWP3(l, i);
+    }},
+    {"$PLXV0"sv, [](LXDevice &d, NMEAInputLine &l, NMEAInfo &i){
+      d.is_colibri = false;
+      return PLXV0(l, d.lxnav_vario_settings, i);
+    }},
+    {"$PLXVC"sv, [](LXDevice &d, NMEAInputLine &l, NMEAInfo &i){
+      d.is_colibri = false;
+      PLXVC(l, i, d.nano_settings, d.device_declaration, d.mutex);
+
+      {
+        const std::lock_guard lock{d.mutex};
+        d.is_forwarded_nano =
+          IsNanoProduct(i.secondary_device.product);
+        const bool was_vario = d.IsLXNAVVario();
+        d.IdDeviceByNameLocked(i.device.product, i.device);
+        if (!was_vario && d.IsLXNAVVario())
+          d.vario_just_detected = true;
+      }
+      return true;
+    }},
+    {"$PLXVF"sv, [](LXDevice &d, NMEAInputLine &l, NMEAInfo &i){
+      d.is_colibri = false;
+      return PLXVF(l, i);
+    }},
+    {"$PLXVS"sv, [](LXDevice &d, NMEAInputLine &l, NMEAInfo &i){
+      d.is_colibri = false;
+      return PLXVS(l, i);
+    }},
+  }}};
+
+  const auto *handler = sentences.Find(line.ReadView());
+  return handler != nullptr && (*handler)(*this, line, info);
 }
@@ -105,10 +105,9 @@ LXEosDevice::PutBugs(double bugs, OperationEnvironment& env)
 bool
 LXEosDevice::ParseNMEA(const char* String, NMEAInfo& info)
 {
-  if (!VerifyNMEAChecksum(String))
-    return false;
-
   NMEAInputLine line(String);
+  if (!line.IsChecksumValid())
+    return false;
 
   const auto type = line.ReadView();
   if (type == "$LXWP0"sv)
@@ -70,10 +70,10 @@ ReadBearing(NMEAInputLine &line, Angle &value_r)
 bool
 LarusDevice::ParseNMEA(const char *_line, NMEAInfo &info)
 {
-  if (!VerifyNMEAChecksum(_line))
+  NMEAInputLine line(_line);
+  if (!line.IsChecksumValid())
     return false;
 
-  NMEAInputLine line(_line);
   const auto type = line.ReadView();
   if (type.starts_with("$PLAR"sv)) {
     switch (type[5]) {
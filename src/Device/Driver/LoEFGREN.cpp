@@ -3,7 +3,6 @@
 
 #include "Device/Driver/LoEFGREN.hpp"
 #include "Device/Driver.hpp"
-#include "NMEA/Checksum.hpp"
 #include "NMEA/Info.hpp"
 #include "NMEA/InputLine.hpp"
 #include "Units/System.hpp"
@@ -59,10 +58,10 @@ LoEFGRENDevice::ParseNMEA(const char *line, NMEAInfo &info)
   if (line == nullptr)
     return false;
 
-  if (!VerifyNMEAChecksum(line))
+  NMEAInputLine input(line);
+  if (!input.IsChecksumValid())
     return false;
 
-  NMEAInputLine input(line);
   const auto type = input.ReadView();
 
   if (type == "$PLOF"sv)
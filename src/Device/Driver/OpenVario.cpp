@@ -251,10 +251,10 @@ OpenVarioDevice::PutBugs(double bugs, OperationEnvironment &env)
 bool
 OpenVarioDevice::ParseNMEA(const char *_line, NMEAInfo &info)
 {
-  if (!VerifyNMEAChecksum(_line))
+  NMEAInputLine line(_line);
+  if (!line.IsChecksumValid())
     return false;
 
-  NMEAInputLine line(_line);
   if (line.ReadCompare("$POV"))
     return POV(line, info);
 
@@ -143,10 +143,9 @@ VaulterDevice::PutBallast(double fraction, [[maybe_unused]] double overload, Ope
 bool
 VaulterDevice::ParseNMEA(const char *_line, NMEAInfo &info)
 {
-  if (!VerifyNMEAChecksum(_line))
-    return false;
-
   NMEAInputLine line(_line);
+  if (!line.IsChecksumValid())
+    return false;
 
   const auto type = line.ReadView();
   if (type == "$PITV3"sv)
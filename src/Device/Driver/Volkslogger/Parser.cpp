@@ -4,7 +4,6 @@
 #include "Internal.hpp"
 #include "NMEA/Info.hpp"
 #include "NMEA/InputLine.hpp"
-#include "NMEA/Checksum.hpp"
 
 using std::string_view_literals::operator""sv;
 
@@ -44,10 +43,9 @@ vl_PGCS1(NMEAInputLine &line, NMEAInfo &info)
 bool
 VolksloggerDevice::ParseNMEA(const char *String, NMEAInfo &info)
 {
-  if (!VerifyNMEAChecksum(String))
-    return false;
-
   NMEAInputLine line(String);
+  if (!line.IsChecksumValid())
+    return false;
 
   const auto type = line.ReadView();
   if (type == "$PGCS"sv)
@@ -118,10 +118,9 @@ PWES1(NMEAInputLine &line, NMEAInfo &info)
 bool
 WesterboerDevice::ParseNMEA(const char *String, NMEAInfo &info)
 {
-  if (!VerifyNMEAChecksum(String))
-    return false;
-
   NMEAInputLine line(String);
+  if (!line.IsChecksumValid())
+    return false;
 
   const auto type = line.ReadView();
   if (type == "$PWES0"sv)
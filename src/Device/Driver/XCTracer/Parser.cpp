@@ -2,7 +2,6 @@
 // Copyright The XCSoar Project
 
 #include "../XCTracer/Internal.hpp"
-#include "NMEA/Checksum.hpp"
 #include "NMEA/InputLine.hpp"
 #include "NMEA/Info.hpp"
 
@@ -249,10 +248,9 @@ XCTracerDevice::XCTRC(NMEAInputLine &line, NMEAInfo &info)
 bool
 XCTracerDevice::ParseNMEA(const char *string, NMEAInfo &info)
 {
-  if (!VerifyNMEAChecksum(string))
-    return false;
-
   NMEAInputLine line(string);
+  if (!line.IsChecksumValid())
+    return false;
 
   const auto type = line.ReadView();
   if (type == "$LXWP0"sv)
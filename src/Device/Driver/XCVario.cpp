@@ -194,9 +194,10 @@ bool XVCDevice::EnableNMEA([[maybe_unused]] OperationEnvironment &env)
 bool
 XVCDevice::ParseNMEA(const char *String, NMEAInfo &info)
 {
-  if (!VerifyNMEAChecksum(String))
-    return false;
   NMEAInputLine line(String);
+  if (!line.IsChecksumValid())
+    return false;
+
   const auto type = line.ReadView();
   if (type == "$PXCV"sv) {                // cyclic data from device useful for channel supervision
     xcvario_protocol_up = true;
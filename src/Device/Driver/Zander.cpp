@@ -5,7 +5,6 @@
 #include "Device/Driver.hpp"
 #include "NMEA/Info.hpp"
 #include "NMEA/InputLine.hpp"
-#include "NMEA/Checksum.hpp"
 #include "Units/System.hpp"
 #include "util/StringAPI.hxx"
 
@@ -109,10 +108,9 @@ PZAN5(NMEAInputLine &line, NMEAInfo &info)
 bool
 ZanderDevice::ParseNMEA(const char *String, NMEAInfo &info)
 {
-  if (!VerifyNMEAChecksum(String))
-    return false;
-
   NMEAInputLine line(String);
+  if (!line.IsChecksumValid())
+    return false;
 
   const auto type = line.ReadView();
 
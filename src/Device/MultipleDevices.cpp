@@ -12,6 +12,7 @@
 
 MultipleDevices::MultipleDevices(DeviceBlackboard &blackboard,
                                  NMEALogger *nmea_logger,
+                                 SensorLogger *sensor_logger,
                                  DeviceFactory &factory) noexcept
   : blackboard(blackboard)
 {
@@ -20,6 +21,7 @@ MultipleDevices::MultipleDevices(DeviceBlackboard &blackboard,
       new DeviceDispatcher(*this, i);
 
     devices[i] = new DeviceDescriptor(blackboard, nmea_logger,
+                                      sensor_logger,
                                       factory, i, this);
     devices[i]->SetDispatcher(dispatcher);
   }
@@ -167,12 +169,8 @@ MultipleDevices::PutStandbyFrequency(RadioFrequency frequency,
 void
 MultipleDevices::ExchangeRadioFrequencies(OperationEnvironment &env) noexcept
 {
-  for (DeviceDescriptor *i : devices) {
-    NMEAInfo basic = i->GetData();
-    if (i->ExchangeRadioFrequencies(env, basic)) {
-      blackboard.LockSetDeviceDataScheduleMerge(i->GetIndex(), basic);
-    }
-  }
+  for (DeviceDescriptor *i : devices)
+    i->ExchangeRadioFrequencies(env);
 }
 
 void
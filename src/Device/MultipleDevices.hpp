@@ -19,6 +19,7 @@
 #include <list>
 class DeviceBlackboard;
 class NMEALogger;
+class SensorLogger;
 class DeviceFactory;
 class DeviceDescriptor;
 class DeviceDispatcher;
@@ -46,6 +47,7 @@ class MultipleDevices final : PortListener {
 public:
   MultipleDevices(DeviceBlackboard &blackboard,
                   NMEALogger *nmea_logger,
+                  SensorLogger *sensor_logger,
                   DeviceFactory &factory) noexcept;
   ~MultipleDevices() noexcept;
 
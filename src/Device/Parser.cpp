@@ -4,8 +4,8 @@
 #include "Device/Parser.hpp"
 #include "Geo/Geoid.hpp"
 #include "NMEA/Info.hpp"
-#include "NMEA/Checksum.hpp"
 #include "NMEA/InputLine.hpp"
+#include "NMEA/SentenceTable.hpp"
 #include "Units/System.hpp"
 #include "Driver/FLARM/StaticParser.hpp"
 #include "util/CharUtil.hxx"
@@ -35,89 +35,93 @@ NMEAParser::ParseLine(const char *string, NMEAInfo &info)
   if (string[0] != '$')
     return false;
 
-  if (!NMEAChecksum(string))
-    return false;
-
   NMEAInputLine line(string);
+  if (!line.IsChecksumValid())
+    return false;
 
   const auto type = line.ReadView();
   if (type.size() < 6)
     return false;
 
-  if (IsAlphaASCII(type[1]) && IsAlphaASCII(type[2])) {
-    const auto type2 = type.substr(3);
-
-    if (type2 == "GSA"sv)
-      return GSA(line, info);
-
-    if (type2 == "GLL"sv)
-      return GLL(line, info);
-
-    if (type2 == "RMC"sv)
-      return RMC(line, info);
-
-    if (type2 == "GGA"sv)
-      return GGA(line, info);
-
-    if (type2 == "HDM"sv)
-      return HDM(line, info);
-
-    if (type2 == "MWV"sv)
-      return MWV(line, info);
-  }
-
-  // if (proprietary sentence) ...
-  if (type[1] == 'P') {
-    const auto type2 = type.substr(1);
-
+  using Handler = bool (*)(NMEAParser &parser,
+                           NMEAInputLine &line, NMEAInfo &info);
+
+  /* standard sentences, looked up without the talker id */
+  static constexpr NMEASentenceTable<Handler, 6> talker_sentences{{{
+    {"GSA"sv, [](NMEAParser &p, NMEAInputLine &l, NMEAInfo &i){
+      return p.GSA(l, i);
+    }},
+    {"GLL"sv, [](NMEAParser &p, NMEAInputLine &l, NMEAInfo &i){
+      return p.GLL(l, i);
+    }},
+    {"RMC"sv, [](NMEAParser &p, NMEAInputLine &l, NMEAInfo &i){
+      return p.RMC(l, i);
+    }},
+    {"GGA"sv, [](NMEAParser &p, NMEAInputLine &l, NMEAInfo &i){
+      return p.GGA(l, i);
+    }},
+    {"HDM"sv, [](NMEAParser &p, NMEAInputLine &l, NMEAInfo &i){
+      return p.HDM(l, i);
+    }},
+    {"MWV"sv, [](NMEAParser &, NMEAInputLine &l, NMEAInfo &i){
+      return MWV(l, i);
+    }},
+  }}};
+
+  static constexpr NMEASentenceTable<Handler, 9> proprietary_sentences{{{
     // Airspeed and vario sentence
-    if (type2 == "PTAS1"sv)
-      return PTAS1(line, info);
+    {"PTAS1"sv, [](NMEAParser &, NMEAInputLine &l, NMEAInfo &i){
+      return PTAS1(l, i);
+    }},
 
     // FLARM sentences
-    if (type2 == "PFLAE"sv) {
-      ParsePFLAE(line, info.flarm.error, info.clock);
+    {"PFLAE"sv, [](NMEAParser &, NMEAInputLine &l, NMEAInfo &i){
+      ParsePFLAE(l, i.flarm.error, i.clock);
       return true;
-    }
-
-    if (type2 == "PFLAV"sv) {
-      ParsePFLAV(line, info.flarm.version, info.clock);
+    }},
+    {"PFLAV"sv, [](NMEAParser &, NMEAInputLine &l, NMEAInfo &i){
+      ParsePFLAV(l, i.flarm.version, i.clock);
       return true;
-    }
-
-    if (type2 == "PFLAA"sv) {
+    }},
+    {"PFLAA"sv, [](NMEAParser &, NMEAInputLine &l, NMEAInfo &i){
       RangeFilter range;
       range.horizontal=0;
       range.vertical=0;
-      ParsePFLAA(line, info.flarm.traffic, info.clock, range);
+      ParsePFLAA(l, i.flarm.traffic, i.clock, range);
       return true;
-    }
-
-    if (type2 == "PFLAU"sv) {
-      ParsePFLAU(line, info.flarm.status, info.clock);
+    }},
+    {"PFLAU"sv, [](NMEAParser &, NMEAInputLine &l, NMEAInfo &i){
+      ParsePFLAU(l, i.flarm.status, i.clock);
       return true;
-    }
-
-    if (type2 == "PFLAJ"sv) {
-      ParsePFLAJ(line, info.flarm.state, info.clock);
+    }},
+    {"PFLAJ"sv, [](NMEAParser &, NMEAInputLine &l, NMEAInfo &i){
+      ParsePFLAJ(l, i.flarm.state, i.clock);
       return true;
-    }
-
-    if (type2 == "PFLAQ"sv) {
-      ParsePFLAQ(line, info.flarm.progress, info.clock);
+    }},
+    {"PFLAQ"sv, [](NMEAParser &, NMEAInputLine &l, NMEAInfo &i){
+      ParsePFLAQ(l, i.flarm.progress, i.clock);
       return true;
-    }
-
-    if (type2 == "PFLAM"sv) {
-      ParsePFLAM(line);
+    }},
+    {"PFLAM"sv, [](NMEAParser &, NMEAInputLine &l, NMEAInfo &){
+      ParsePFLAM(l);
       return true;
-    }
+    }},
 
     // Garmin altitude sentence
-    if (type2 == "PGRMZ"sv)
-      return RMZ(line, info);
+    {"PGRMZ"sv, [](NMEAParser &p, NMEAInputLine &l, NMEAInfo &i){
+      return p.RMZ(l, i);
+    }},
+  }}};
 
-    return false;
+  if (IsAlphaASCII(type[1]) && IsAlphaASCII(type[2])) {
+    if (const auto *handler = talker_sentences.Find(type.substr(3)))
+      return (*handler)(*this, line, info);
+  }
+
+  // if (proprietary sentence) ...
+  if (type[1] == 'P') {
+    if (const auto *handler = proprietary_sentences.Find(type.substr(1)))
+      return (*handler)(*this, line, info);
   }
 
   return false;
@@ -672,12 +676,6 @@ NMEAParser::RMZ(NMEAInputLine &line, NMEAInfo &info)
   return true;
 }
 
-bool
-NMEAParser::NMEAChecksum(const char *string)
-{
-  return VerifyNMEAChecksum(string);
-}
-
 bool
 NMEAParser::PTAS1(NMEAInputLine &line, NMEAInfo &info)
 {
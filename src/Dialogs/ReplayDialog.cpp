@@ -47,9 +47,9 @@ ReplayControlWidget::Prepare([[maybe_unused]] ContainerWindow &parent,
                              [[maybe_unused]] const PixelRect &rc) noexcept
 {
   AddFile(_("File"),
-          _("Name of file to replay. May be an IGC file (.igc) or a raw NMEA log file (.nmea). Leave blank to run the demo."),
+          _("Name of file to replay. May be an IGC file (.igc), a raw NMEA log file (.nmea) or a sensor log file (.xsr). Leave blank to run the demo."),
           {},
-          "*.nmea\0*.igc\0",
+          "*.nmea\0*.igc\0*.xsr\0",
           true);
   LoadValue(FILE, replay.GetFilename());
 
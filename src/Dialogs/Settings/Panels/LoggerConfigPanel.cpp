@@ -9,6 +9,7 @@
 #include "UIGlobals.hpp"
 #include "Form/DataField/Enum.hpp"
 #include "Logger/NMEALogger.hpp"
+#include "Logger/SensorLogger.hpp"
 #include "UtilsSettings.hpp"
 #include "Components.hpp"
 #include "BackendComponents.hpp"
@@ -23,8 +24,10 @@ enum ControlIndex {
   CrewWeightTemplate,
   LoggerTimeStepCruise,
   LoggerTimeStepCircling,
+  LoggerSyncInterval,
   DisableAutoLogger,
   EnableNMEALogger,
+  SensorLogMode,
   EnableFlightLogger,
   LoggerID,
 };
@@ -46,6 +49,14 @@ static constexpr StaticEnumChoice auto_logger_list[] = {
   nullptr
 };
 
+static constexpr StaticEnumChoice sensor_log_mode_list[] = {
+  { LoggerSettings::SensorLogMode::OFF, N_("Off") },
+  { LoggerSettings::SensorLogMode::SAMPLES, N_("Sensor values") },
+  { LoggerSettings::SensorLogMode::SAMPLES_AND_LINES,
+    N_("Sensor values and device data") },
+  nullptr
+};
+
 void
 LoggerConfigPanel::Prepare(ContainerWindow &parent,
                            const PixelRect &rc) noexcept
@@ -79,6 +90,13 @@ LoggerConfigPanel::Prepare(ContainerWindow &parent,
               seconds{1}, seconds{30}, seconds{1}, logger.time_step_circling);
   SetExpertRow(LoggerTimeStepCircling);
 
+  AddDuration(_("Sync interval"),
+              _("How often the IGC file is written to the storage device. "
+                "After a crash or power failure, the fixes of this period "
+                "may be lost. Zero writes each fix immediately."),
+              seconds{0}, seconds{60}, seconds{1}, logger.sync_interval);
+  SetExpertRow(LoggerSyncInterval);
+
   AddEnum(_("Auto. logger"),
           _("Enables the automatic starting and stopping of logger on takeoff and landing "
             "respectively. Disable when flying paragliders."),
@@ -91,6 +109,13 @@ LoggerConfigPanel::Prepare(ContainerWindow &parent,
              logger.enable_nmea_logger);
   SetExpertRow(EnableNMEALogger);
 
+  AddEnum(_("Sensor logger"),
+          _("Record all sensor values at full rate into a compact binary "
+            "file, which can be replayed later. Optionally, the data "
+            "received from all devices is recorded as well."),
+          sensor_log_mode_list, (unsigned)logger.sensor_log_mode);
+  SetExpertRow(SensorLogMode);
+
   AddBoolean(_("Log book"), _("Logs each start and landing."),
              logger.enable_flight_logger);
   SetExpertRow(EnableFlightLogger);
@@ -122,6 +147,9 @@ LoggerConfigPanel::Save(bool &changed) noexcept
   changed |= SaveValue(LoggerTimeStepCircling, ProfileKeys::LoggerTimeStepCircling,
                        logger.time_step_circling);
 
+  changed |= SaveValue(LoggerSyncInterval, ProfileKeys::LoggerSyncInterval,
+                       logger.sync_interval);
+
   /* GUI label is "Enable Auto Logger" */
   changed |= SaveValueEnum(DisableAutoLogger, ProfileKeys::AutoLogger,
                            logger.auto_logger);
@@ -132,6 +160,14 @@ LoggerConfigPanel::Save(bool &changed) noexcept
   if (logger.enable_nmea_logger && backend_components->nmea_logger != nullptr)
     backend_components->nmea_logger->Enable();
 
+  if (SaveValueEnum(SensorLogMode, ProfileKeys::SensorLogger,
+                    logger.sensor_log_mode)) {
+    changed = true;
+
+    if (backend_components->sensor_logger != nullptr)
+      backend_components->sensor_logger->SetMode(logger.sensor_log_mode);
+  }
+
   if (SaveValue(EnableFlightLogger, ProfileKeys::EnableFlightLogger,
                 logger.enable_flight_logger)) {
     changed = true;
@@ -0,0 +1,62 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#include "ProfilerStatusPanel.hpp"
+#include "Profiler/FrameProfiler.hpp"
+#include "Language/Language.hpp"
+#include "util/StaticString.hxx"
+
+static constexpr double
+ToMilliseconds(uint_least32_t us) noexcept
+{
+  return us / 1000.;
+}
+
+void
+ProfilerStatusPanel::Refresh() noexcept
+{
+  const auto summaries = frame_profiler.GetSummaries();
+
+  StaticString<4096> text;
+  text.clear();
+
+  for (const auto &i : summaries) {
+    const auto &h = i.histogram;
+    if (text.length() + 128 > text.capacity())
+      break;
+
+    text.AppendFormat("%s\n  %.1f / %.1f / %.1f ms (max %.1f, n=%lu)\n",
+                      i.name,
+                      ToMilliseconds(h.p50), ToMilliseconds(h.p95),
+                      ToMilliseconds(h.p99), ToMilliseconds(h.max),
+                      (unsigned long)h.count);
+  }
+
+  if (text.empty())
+    text = _("No data");
+
+  SetMultiLineText(0, text);
+}
+
+void
+ProfilerStatusPanel::Prepare([[maybe_unused]] ContainerWindow &parent,
+                             [[maybe_unused]] const PixelRect &rc) noexcept
+{
+  /* caption of the columns below */
+  AddReadOnly(_("Phase"), nullptr, "p50 / p95 / p99");
+  AddMultiLine();
+}
+
+void
+ProfilerStatusPanel::Show(const PixelRect &rc) noexcept
+{
+  StatusPanel::Show(rc);
+  timer.Schedule(std::chrono::seconds(1));
+}
+
+void
+ProfilerStatusPanel::Hide() noexcept
+{
+  timer.Cancel();
+  StatusPanel::Hide();
+}
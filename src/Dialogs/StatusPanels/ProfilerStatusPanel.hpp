@@ -0,0 +1,26 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#pragma once
+
+#include "StatusPanel.hpp"
+#include "ui/event/PeriodicTimer.hpp"
+
+/**
+ * Shows the timing percentiles collected by #frame_profiler.
+ */
+class ProfilerStatusPanel final : public StatusPanel {
+  UI::PeriodicTimer timer{[this]{ Refresh(); }};
+
+public:
+  explicit ProfilerStatusPanel(const DialogLook &look) noexcept
+    :StatusPanel(look) {}
+
+  /* virtual methods from class StatusPanel */
+  void Refresh() noexcept override;
+
+  /* virtual methods from class Widget */
+  void Prepare(ContainerWindow &parent, const PixelRect &rc) noexcept override;
+  void Show(const PixelRect &rc) noexcept override;
+  void Hide() noexcept override;
+};
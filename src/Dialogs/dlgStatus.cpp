@@ -13,6 +13,7 @@
 #include "StatusPanels/RulesStatusPanel.hpp"
 #include "StatusPanels/SystemStatusPanel.hpp"
 #include "StatusPanels/TimesStatusPanel.hpp"
+#include "StatusPanels/ProfilerStatusPanel.hpp"
 #include "Components.hpp"
 #include "DataComponents.hpp"
 #include "Engine/Waypoint/Waypoints.hpp"
@@ -82,6 +83,9 @@ dlgStatusShowModal(int start_page)
   widget.AddTab(std::make_unique<TimesStatusPanel>(look),
                 _("Times"), TimesIcon);
 
+  widget.AddTab(std::make_unique<ProfilerStatusPanel>(look),
+                _("Timing"));
+
   /* restore previous page */
 
   if (start_page != -1) {
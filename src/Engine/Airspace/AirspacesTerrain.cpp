@@ -4,17 +4,29 @@
 #include "Airspaces.hpp"
 #include "Terrain/RasterTerrain.hpp"
 
+#include <vector>
+
 void
 Airspaces::SetGroundLevels(const RasterTerrain &terrain) noexcept
 {
-  for (auto &v : QueryAll()) {
+  std::vector<const Airspace *> airspaces;
+  std::vector<GeoPoint> centers;
+
+  for (const auto &v : QueryAll()) {
     // If we don't need the ground level we don't have to calculate it
     if (!v.NeedGroundLevel())
       continue;
 
-    FlatGeoPoint c_flat = v.GetCenter();
-    GeoPoint g = task_projection.Unproject(c_flat);
-    v.SetGroundLevel(terrain.GetTerrainHeight(g).GetValueOr0());
+    airspaces.push_back(&v);
+    centers.push_back(task_projection.Unproject(v.GetCenter()));
   }
-}
 
+  if (airspaces.empty())
+    return;
+
+  std::vector<TerrainHeight> heights(centers.size());
+  terrain.GetTerrainHeights(centers, heights);
+
+  for (std::size_t i = 0; i < airspaces.size(); ++i)
+    airspaces[i]->SetGroundLevel(heights[i].GetValueOr0());
+}
@@ -139,4 +139,6 @@ FlarmComputer::Process(FlarmData &flarm, const FlarmData &last_flarm,
         traffic.speed = last_traffic->speed;
     }
   }
+
+  flarm.traffic.UpdateGrid();
 }
@@ -35,7 +35,7 @@ struct FlarmData {
     return status.available || !traffic.IsEmpty();
   }
 
-  constexpr void Clear() noexcept {
+  void Clear() noexcept {
     error.Clear();
     version.Clear();
     hardware.Clear();
@@ -45,7 +45,7 @@ struct FlarmData {
     traffic.Clear();
   }
 
-  constexpr void Complement(const FlarmData &add) noexcept {
+  void Complement(const FlarmData &add) noexcept {
     error.Complement(add.error);
     version.Complement(add.version);
     hardware.Complement(add.hardware);
@@ -55,7 +55,7 @@ struct FlarmData {
     traffic.Complement(add.traffic);
   }
 
-  constexpr void Expire(TimeStamp clock) noexcept {
+  void Expire(TimeStamp clock) noexcept {
     error.Expire(clock);
     version.Expire(clock);
     hardware.Expire(clock);
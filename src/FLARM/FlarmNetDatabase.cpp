@@ -2,9 +2,126 @@
 // Copyright The XCSoar Project
 
 #include "FlarmNetDatabase.hpp"
+#include "io/BufferedOutputStream.hxx"
+#include "io/BufferedReader.hxx"
+#include "util/SpanCast.hxx"
 #include "util/StringAPI.hxx"
 
+#include <algorithm>
 #include <cassert>
+#include <stdexcept>
+#include <type_traits>
+
+#include <string.h>
+
+static_assert(std::is_trivially_copyable_v<FlarmNetRecord>);
+
+/**
+ * The minimum size of the hash tables.
+ */
+static constexpr std::size_t MIN_TABLE_SIZE = 64;
+
+/**
+ * Sanity limit for the number of records in a cache file.
+ */
+static constexpr uint32_t MAX_RECORDS = 1024 * 1024;
+
+struct FlarmNetCacheHeader {
+  static constexpr uint32_t VERSION = 1;
+
+  uint32_t version;
+
+  /**
+   * sizeof(FlarmNetRecord); a cache written by a build with a
+   * different record layout is discarded.
+   */
+  uint32_t record_size;
+
+  uint32_t n_records;
+};
+
+template<std::size_t size>
+[[gnu::pure]]
+static bool
+IsTerminated(const StaticString<size> &s) noexcept
+{
+  return memchr(s.c_str(), 0, s.capacity()) != nullptr;
+}
+
+/**
+ * Are all strings in the given record null-terminated?  This guards
+ * the lookups against corrupt cache files.
+ */
+[[gnu::pure]]
+static bool
+IsTerminated(const FlarmNetRecord &record) noexcept
+{
+  return IsTerminated(record.pilot) && IsTerminated(record.airfield) &&
+    IsTerminated(record.plane_type) && IsTerminated(record.registration) &&
+    IsTerminated(record.callsign);
+}
+
+/**
+ * FNV-1a
+ */
+[[gnu::pure]]
+static uint32_t
+HashCallSign(const char *cn) noexcept
+{
+  uint32_t hash = 2166136261U;
+  for (; *cn != '\0'; ++cn)
+    hash = (hash ^ (unsigned char)*cn) * 16777619U;
+  return hash;
+}
+
+inline std::size_t
+FlarmNetDatabase::GetIdSlot(FlarmId id) const noexcept
+{
+  assert(!id_table.empty());
+
+  return FlarmId::Hash{}(id) & (id_table.size() - 1);
+}
+
+inline std::size_t
+FlarmNetDatabase::GetCallSignBucket(const char *cn) const noexcept
+{
+  assert(!callsign_head.empty());
+
+  return HashCallSign(cn) & (callsign_head.size() - 1);
+}
+
+void
+FlarmNetDatabase::AddToIndex(uint32_t i) noexcept
+{
+  const FlarmNetRecord &record = records[i];
+
+  std::size_t slot = GetIdSlot(record.id);
+  while (id_table[slot] != NO_INDEX)
+    slot = (slot + 1) & (id_table.size() - 1);
+  id_table[slot] = i;
+
+  /* append to the chain, to let FindFirstRecordByCallSign() return
+     the first one in the file */
+  const std::size_t bucket = GetCallSignBucket(record.callsign);
+  callsign_next[i] = NO_INDEX;
+  if (callsign_tail[bucket] == NO_INDEX)
+    callsign_head[bucket] = i;
+  else
+    callsign_next[callsign_tail[bucket]] = i;
+  callsign_tail[bucket] = i;
+}
+
+void
+FlarmNetDatabase::Rehash(std::size_t table_size) noexcept
+{
+  id_table.assign(table_size, NO_INDEX);
+  callsign_head.assign(table_size, NO_INDEX);
+  callsign_tail.assign(table_size, NO_INDEX);
+  callsign_next.resize(records.size());
+
+  for (uint32_t i = 0; i < records.size(); ++i)
+    AddToIndex(i);
+}
 
 void
 FlarmNetDatabase::Insert(const FlarmNetRecord &record) noexcept
@@ -13,31 +130,59 @@ FlarmNetDatabase::Insert(const FlarmNetRecord &record) noexcept
     /* ignore malformed records */
     return;
 
-  map.insert(std::make_pair(record.id, record));
+  if (!id_table.empty() && FindRecordById(record.id) != nullptr)
+    /* duplicate; the first one wins */
+    return;
+
+  records.push_back(record);
+  callsign_next.emplace_back();
+
+  if (records.size() * 2 > id_table.size())
+    Rehash(std::max(id_table.size() * 2, MIN_TABLE_SIZE));
+  else
+    AddToIndex(records.size() - 1);
 }
 
 const FlarmNetRecord *
-FlarmNetDatabase::FindFirstRecordByCallSign(const char *cn) const noexcept
+FlarmNetDatabase::FindRecordById(FlarmId id) const noexcept
 {
-  for (const auto &[id, record] : map) {
-    assert(id.IsDefined());
+  if (id_table.empty())
+    return nullptr;
 
-    if (StringIsEqual(record.callsign, cn))
-      return &record;
+  for (std::size_t slot = GetIdSlot(id);;
+       slot = (slot + 1) & (id_table.size() - 1)) {
+    const uint32_t i = id_table[slot];
+    if (i == NO_INDEX)
+      return nullptr;
+
+    if (records[i].id == id)
+      return &records[i];
   }
+}
 
-  return NULL;
+const FlarmNetRecord *
+FlarmNetDatabase::FindFirstRecordByCallSign(const char *cn) const noexcept
+{
+  const FlarmNetRecord *record;
+  return FindRecordsByCallSign(cn, &record, 1) > 0
+    ? record
+    : nullptr;
 }
 
 unsigned
 FlarmNetDatabase::FindRecordsByCallSign(const char *cn,
                                         const FlarmNetRecord *array[],
-                                        [[maybe_unused]] unsigned size) const noexcept
+                                        unsigned size) const noexcept
 {
+  if (callsign_head.empty())
+    return 0;
+
   unsigned count = 0;
 
-  for (const auto &[id, record] : map) {
-    assert(id.IsDefined());
+  for (uint32_t i = callsign_head[GetCallSignBucket(cn)];
+       i != NO_INDEX && count < size; i = callsign_next[i]) {
+    const FlarmNetRecord &record = records[i];
+    assert(record.id.IsDefined());
 
     if (StringIsEqual(record.callsign, cn))
       array[count++] = &record;
@@ -48,16 +193,65 @@ FlarmNetDatabase::FindRecordsByCallSign(const char *cn,
 
 unsigned
 FlarmNetDatabase::FindIdsByCallSign(const char *cn, FlarmId array[],
-                                    [[maybe_unused]] unsigned size) const noexcept
+                                    unsigned size) const noexcept
 {
+  if (callsign_head.empty())
+    return 0;
+
   unsigned count = 0;
 
-  for (const auto &[id, record] : map) {
-    assert(id.IsDefined());
+  for (uint32_t i = callsign_head[GetCallSignBucket(cn)];
+       i != NO_INDEX && count < size; i = callsign_next[i]) {
+    const FlarmNetRecord &record = records[i];
+    assert(record.id.IsDefined());
 
     if (StringIsEqual(record.callsign, cn))
-      array[count++] = id;
+      array[count++] = record.id;
   }
 
   return count;
 }
+
+void
+FlarmNetDatabase::SaveCache(BufferedOutputStream &os) const
+{
+  FlarmNetCacheHeader header{};
+  header.version = FlarmNetCacheHeader::VERSION;
+  header.record_size = sizeof(FlarmNetRecord);
+  header.n_records = records.size();
+
+  os.Write(ReferenceAsBytes(header));
+  os.Write(std::as_bytes(std::span{records}));
+}
+
+void
+FlarmNetDatabase::LoadCache(BufferedReader &r)
+{
+  Clear();
+
+  const auto header = r.ReadFullT<FlarmNetCacheHeader>();
+  if (header.version != FlarmNetCacheHeader::VERSION ||
+      header.record_size != sizeof(FlarmNetRecord) ||
+      header.n_records > MAX_RECORDS)
+    throw std::runtime_error("Malformed FlarmNet cache header");
+
+  records.resize(header.n_records);
+  r.ReadFull(std::as_writable_bytes(std::span{records}));
+
+  if (!std::all_of(records.begin(), records.end(),
+                   [](const FlarmNetRecord &record){
+                     return IsTerminated(record);
+                   })) {
+    records.clear();
+    throw std::runtime_error("Malformed FlarmNet cache record");
+  }
+
+  /* rebuilding the indexes is cheap compared to parsing the text
+     file, and it cannot be tricked into out-of-bounds accesses by a
+     corrupt cache file */
+  std::size_t table_size = MIN_TABLE_SIZE;
+  while (table_size < records.size() * 2)
+    table_size *= 2;
+
+  Rehash(table_size);
+}
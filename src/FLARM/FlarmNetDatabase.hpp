@@ -6,23 +6,61 @@
 #include "Id.hpp"
 #include "FlarmNetRecord.hpp"
 
-#include <map>
+#include <cstdint>
+#include <vector>
+
+class BufferedOutputStream;
+class BufferedReader;
+
 /**
  * An in-memory representation of the FlarmNet.org database.
+ *
+ * The records are stored in an array in the order they were inserted.
+ * A hash table with linear probing maps FLARM ids to array positions,
+ * and a chained hash table does the same for call signs.  The record
+ * array can be saved to a cache file with SaveCache(), which
+ * LoadCache() reads back without parsing the text file.
  */
 class FlarmNetDatabase {
-  typedef std::map<FlarmId, FlarmNetRecord> RecordMap;
-  RecordMap map;
+  static constexpr uint32_t NO_INDEX = ~uint32_t(0);
+
+  std::vector<FlarmNetRecord> records;
+
+  /**
+   * Maps the FLARM id to the position in #records (or #NO_INDEX).
+   * The size is a power of two, and it is at least twice the number
+   * of records.
+   */
+  std::vector<uint32_t> id_table;
+
+  /**
+   * The first and the last record with the given call sign hash (or
+   * #NO_INDEX).  These have the same size as #id_table.
+   */
+  std::vector<uint32_t> callsign_head, callsign_tail;
+
+  /**
+   * The next record with the same call sign hash, indexed by the
+   * position in #records.
+   */
+  std::vector<uint32_t> callsign_next;
 
 public:
   bool IsEmpty() const noexcept {
-    return map.empty();
+    return records.empty();
   }
 
   void Clear() noexcept {
-    map.clear();
+    records.clear();
+    id_table.clear();
+    callsign_head.clear();
+    callsign_tail.clear();
+    callsign_next.clear();
   }
 
+  /**
+   * Adds a record, unless a record with the same id exists already.
+   */
   void Insert(const FlarmNetRecord &record) noexcept;
 
   /**
@@ -31,12 +69,7 @@ public:
    * @return FLARMNetRecord object
    */
   [[gnu::pure]]
-  const FlarmNetRecord *FindRecordById(FlarmId id) const noexcept {
-    auto i = map.find(id);
-    return i != map.end()
-      ? &i->second
-      : NULL;
-  }
+  const FlarmNetRecord *FindRecordById(FlarmId id) const noexcept;
 
   /**
    * Finds a FLARMNetRecord object based on the given Callsign
@@ -52,13 +85,45 @@ public:
   unsigned FindIdsByCallSign(const char *cn, FlarmId array[],
                              unsigned size) const noexcept;
 
+  /**
+   * Write the records to the given stream.
+   *
+   * Throws on error.
+   */
+  void SaveCache(BufferedOutputStream &os) const;
+
+  /**
+   * Replace the contents of this object with data written by
+   * SaveCache(), and rebuild the indexes.
+   *
+   * Throws on error.
+   */
+  void LoadCache(BufferedReader &r);
+
   [[gnu::pure]]
   auto begin() const noexcept {
-    return map.begin();
+    return records.begin();
   }
 
   [[gnu::pure]]
   auto end() const noexcept {
-    return map.end();
+    return records.end();
   }
+
+private:
+  [[gnu::pure]]
+  std::size_t GetIdSlot(FlarmId id) const noexcept;
+
+  [[gnu::pure]]
+  std::size_t GetCallSignBucket(const char *cn) const noexcept;
+
+  /**
+   * Add the record at the given position to all indexes.
+   */
+  void AddToIndex(uint32_t i) noexcept;
+
+  /**
+   * Resize the tables and rebuild the indexes.
+   */
+  void Rehash(std::size_t table_size) noexcept;
 };
@@ -12,6 +12,7 @@
 #include "MergeThread.hpp"
 #include "LocalPath.hpp"
 #include "io/DataFile.hpp"
+#include "io/FileCache.hpp"
 #include "io/Reader.hxx"
 #include "io/BufferedReader.hxx"
 #include "io/LineReader.hpp"
@@ -24,8 +25,36 @@
 #include "Profile/Keys.hpp"
 #include "time/PeriodClock.hpp"
 
+static const char *const flarmnet_cache_name = "flarmnet";
+
+static bool
+LoadFLARMnetCache(FlarmNetDatabase &db, Path path)
+{
+  if (file_cache == nullptr)
+    return false;
+
+  auto r = file_cache->Load(flarmnet_cache_name, path);
+  if (!r)
+    return false;
+
+  BufferedReader br(*r);
+  db.LoadCache(br);
+  return true;
+}
+
+static void
+SaveFLARMnetCache(const FlarmNetDatabase &db, Path path)
+{
+  auto os = file_cache->Save(flarmnet_cache_name, path);
+  BufferedOutputStream bos(*os);
+  db.SaveCache(bos);
+  bos.Flush();
+  os->Commit();
+}
+
 /**
- * Loads the FLARMnet file
+ * Loads the FLARMnet file, or its binary copy from the #FileCache
+ * if that is still up to date
  */
 static void
 LoadFLARMnet(FlarmNetDatabase &db) noexcept
@@ -35,9 +64,28 @@ try {
     return;
   }
 
+  try {
+    if (LoadFLARMnetCache(db, path)) {
+      LogString("FLARMnet loaded from cache");
+      return;
+    }
+  } catch (...) {
+    db.Clear();
+    LogError(std::current_exception(), "Failed to load FLARMnet cache");
+  }
+
   unsigned num_records = FlarmNetReader::LoadFile(path, db);
-  if (num_records > 0)
+  if (num_records > 0) {
     LogFormat("FLARMnet IDs found: %u", num_records);
+
+    if (file_cache != nullptr) {
+      try {
+        SaveFLARMnetCache(db, path);
+      } catch (...) {
+        LogError(std::current_exception(), "Failed to save FLARMnet cache");
+      }
+    }
+  }
 } catch (...) {
   LogError(std::current_exception());
 }
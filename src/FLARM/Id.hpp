@@ -3,6 +3,7 @@
 
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
 #include <compare> // for the defaulted spaceship operator
 
@@ -37,4 +38,16 @@ public:
 
   static FlarmId Parse(const char *input, char **endptr_r) noexcept;
   const char *Format(char *buffer) const noexcept;
+
+  /**
+   * A hash function for unordered containers.  The result has 32
+   * bits, and its upper bits are mixed well, so they can be used
+   * directly to address a hash table whose size is a power of two.
+   */
+  struct Hash {
+    constexpr std::size_t operator()(FlarmId id) const noexcept {
+      /* Fibonacci hashing */
+      return uint32_t(id.value * 0x9e3779b1U);
+    }
+  };
 };
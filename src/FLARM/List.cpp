@@ -3,6 +3,126 @@
 
 #include "List.hpp"
 
+#include <cassert>
+
+void
+TrafficList::Complement(const TrafficList &add) noexcept
+{
+  if (add.modified.Modified(modified))
+    modified = add.modified;
+
+  if (add.new_traffic.Modified(new_traffic))
+    new_traffic = add.new_traffic;
+
+  if (list.empty() && !add.list.empty()) {
+    /* don't bother merging the two lists, we can simply memcpy()
+       it, including the indexes */
+    list = add.list;
+    id_table = add.id_table;
+    grid_head = add.grid_head;
+    grid_next = add.grid_next;
+    grid_valid = add.grid_valid;
+    return;
+  }
+
+  // Add unique traffic from 'add' list
+  for (auto &traffic : add.list) {
+    if (FindTraffic(traffic.id) == nullptr) {
+      FlarmTraffic *new_traffic = AllocateTraffic(traffic.id);
+      if (new_traffic == nullptr)
+        return;
+      *new_traffic = traffic;
+    }
+  }
+}
+
+void
+TrafficList::Expire(TimeStamp clock) noexcept
+{
+  modified.Expire(clock, std::chrono::minutes(5));
+  new_traffic.Expire(clock, std::chrono::minutes(1));
+
+  for (unsigned i = list.size(); i-- > 0;)
+    if (!list[i].Refresh(clock))
+      RemoveTraffic(i);
+}
+
+FlarmTraffic *
+TrafficList::AllocateTraffic(FlarmId id) noexcept
+{
+  assert(FindTraffic(id) == nullptr);
+
+  if (list.full())
+    return nullptr;
+
+  const unsigned i = list.size();
+  FlarmTraffic &traffic = list.append();
+  traffic.Clear();
+  traffic.id = id;
+
+  unsigned slot = GetHomeSlot(id);
+  while (id_table[slot] != NO_INDEX)
+    slot = NextSlot(slot);
+  id_table[slot] = i;
+
+  grid_valid = false;
+  return &traffic;
+}
+
+void
+TrafficList::RemoveTraffic(unsigned i) noexcept
+{
+  assert(i < list.size());
+
+  /* remove the id from the hash table, shifting following entries
+     of the probe sequence back into the gap */
+  unsigned gap = FindSlot(list[i].id);
+  assert(gap != NO_INDEX);
+  assert(id_table[gap] == i);
+
+  for (unsigned slot = NextSlot(gap); id_table[slot] != NO_INDEX;
+       slot = NextSlot(slot)) {
+    const unsigned home = GetHomeSlot(list[id_table[slot]].id);
+
+    /* may this entry move to the gap, i.e. is its home slot not
+       between the gap and its current slot (cyclically)? */
+    if (((slot - home) & (ID_TABLE_SIZE - 1)) >=
+        ((slot - gap) & (ID_TABLE_SIZE - 1))) {
+      id_table[gap] = id_table[slot];
+      gap = slot;
+    }
+  }
+
+  id_table[gap] = NO_INDEX;
+
+  /* move the last item to the gap in the list */
+  const unsigned last = list.size() - 1;
+  if (i != last) {
+    const unsigned slot = FindSlot(list[last].id);
+    assert(slot != NO_INDEX);
+    id_table[slot] = i;
+  }
+
+  list.quick_remove(i);
+  grid_valid = false;
+}
+
+void
+TrafficList::UpdateGrid() noexcept
+{
+  grid_head.fill(NO_INDEX);
+
+  for (unsigned i = 0; i < list.size(); ++i) {
+    const auto &traffic = list[i];
+    auto &head = grid_head[ToGridCell(traffic.relative_north) * GRID_SIZE +
+                           ToGridCell(traffic.relative_east)];
+    grid_next[i] = head;
+    head = i;
+  }
+
+  grid_valid = true;
+}
+
 const FlarmTraffic *
 TrafficList::FindMaximumAlert() const noexcept
 {
@@ -24,6 +144,15 @@ TrafficList::FindMaximumAlert() const noexcept
 bool
 TrafficList::InCloseRange() const noexcept
 {
-  return std::any_of(list.begin(), list.end(), [](const auto &traffic)
-    { return traffic.distance < (RoughDistance)4000; });
+  bool found = false;
+  VisitWithinRange(4000, [&found](const FlarmTraffic &traffic){
+    if (traffic.distance < (RoughDistance)4000) {
+      found = true;
+      return false;
+    }
+
+    return true;
+  });
+
+  return found;
 }
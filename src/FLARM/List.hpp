@@ -7,14 +7,67 @@
 #include "NMEA/Validity.hpp"
 #include "util/TrivialArray.hxx"
 
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdint>
 #include <type_traits>
 
+#ifndef FLARM_MAX_TRAFFIC
+#define FLARM_MAX_TRAFFIC 32
+#endif
+
 /**
  * This class keeps track of the traffic objects received from a
- * FLARM.
+ * FLARM (or another traffic source such as an ADS-B receiver).
+ *
+ * The traffic objects are stored in an array, and two indexes refer
+ * to them by their position: a hash table for looking up a FLARM id
+ * and a grid over the relative positions for range queries.  Both
+ * consist of small integers only, so this object remains trivially
+ * copyable and a plain copy (e.g. to another blackboard) includes
+ * valid indexes.
+ *
+ * Code which adds or removes traffic objects or modifies
+ * FlarmTraffic::id must use the methods of this class, which keep the
+ * hash table up to date.  The grid is only valid after
+ * UpdateGrid(); structural modifications invalidate it, and range
+ * queries fall back to a linear search until it is rebuilt.
  */
 struct TrafficList {
-  static constexpr size_t MAX_COUNT = 25;
+  /**
+   * The maximum number of traffic objects.  Every #NMEAInfo copy
+   * includes this array, so it is kept small by default; builds which
+   * expect many ADS-B and OGN targets may raise it with the
+   * MAX_TRAFFIC make option.
+   */
+  static constexpr size_t MAX_COUNT = FLARM_MAX_TRAFFIC;
+
+  /**
+   * The number of slots in #id_table, a power of two.  The load
+   * factor does not exceed 0.5.
+   */
+  static constexpr unsigned ID_TABLE_BITS = std::bit_width(2 * MAX_COUNT - 1);
+  static constexpr unsigned ID_TABLE_SIZE = 1U << ID_TABLE_BITS;
+  static_assert(ID_TABLE_SIZE >= 2 * MAX_COUNT);
+
+  /**
+   * The edge length of one grid cell [m].
+   */
+  static constexpr double GRID_CELL_SIZE = 2000;
+
+  /**
+   * The number of cells on each axis of the grid, which is centered
+   * on the own aircraft.  Traffic outside of the grid is kept in the
+   * nearest border cell.
+   */
+  static constexpr unsigned GRID_SIZE = 16;
+
+  /**
+   * Marks an empty slot in #id_table and the end of a grid chain.
+   */
+  static constexpr uint16_t NO_INDEX = 0xffff;
+  static_assert(MAX_COUNT < NO_INDEX);
 
   /**
    * Time stamp of the latest modification to this object.
@@ -29,10 +82,35 @@ struct TrafficList {
   /** Flarm traffic information */
   TrivialArray<FlarmTraffic, MAX_COUNT> list;
 
-  constexpr void Clear() noexcept {
+  /**
+   * A hash table with linear probing which maps the FLARM id to the
+   * position in #list (or #NO_INDEX).
+   */
+  std::array<uint16_t, ID_TABLE_SIZE> id_table;
+
+  /**
+   * The position of the first traffic object in each grid cell (or
+   * #NO_INDEX).  Only valid if #grid_valid is set.
+   */
+  std::array<uint16_t, GRID_SIZE * GRID_SIZE> grid_head;
+
+  /**
+   * The position of the next traffic object in the same grid cell,
+   * indexed by the position in #list.
+   */
+  std::array<uint16_t, MAX_COUNT> grid_next;
+
+  /**
+   * Does the grid match the current list and relative positions?
+   */
+  bool grid_valid;
+
+  void Clear() noexcept {
     modified.Clear();
     new_traffic.Clear();
     list.clear();
+    id_table.fill(NO_INDEX);
+    grid_valid = false;
   }
 
   constexpr bool IsEmpty() const noexcept {
@@ -43,39 +121,9 @@ struct TrafficList {
    * Adds data from the specified object, unless already present in
    * this one.
    */
-  constexpr void Complement(const TrafficList &add) noexcept {
-    if (add.modified.Modified(modified))
-      modified = add.modified;
+  void Complement(const TrafficList &add) noexcept;
 
-    if (add.new_traffic.Modified(new_traffic))
-      new_traffic = add.new_traffic;
-
-    if (list.empty() && !add.list.empty()) {
-      /* don't bother merging the two lists, we can simply memcpy()
-         it */
-      list = add.list;
-      return;
-    }
-
-    // Add unique traffic from 'add' list
-    for (auto &traffic : add.list) {
-      if (FindTraffic(traffic.id) == nullptr) {
-        FlarmTraffic * new_traffic = AllocateTraffic();
-        if (new_traffic == nullptr)
-          return;
-        *new_traffic = traffic;
-      }
-    }
-  }
-
-  constexpr void Expire(TimeStamp clock) noexcept {
-    modified.Expire(clock, std::chrono::minutes(5));
-    new_traffic.Expire(clock, std::chrono::minutes(1));
-
-    for (unsigned i = list.size(); i-- > 0;)
-      if (!list[i].Refresh(clock))
-        list.quick_remove(i);
-  }
+  void Expire(TimeStamp clock) noexcept;
 
   constexpr unsigned GetActiveTrafficCount() const noexcept {
     return list.size();
@@ -87,12 +135,11 @@ struct TrafficList {
    * @param id FLARM id
    * @return the FLARM_TRAFFIC pointer, NULL if not found
    */
-  constexpr FlarmTraffic *FindTraffic(FlarmId id) noexcept {
-    for (auto &traffic : list)
-      if (traffic.id == id)
-        return &traffic;
-
-    return NULL;
+  FlarmTraffic *FindTraffic(FlarmId id) noexcept {
+    const unsigned slot = FindSlot(id);
+    return slot != NO_INDEX
+      ? &list[id_table[slot]]
+      : nullptr;
   }
 
   /**
@@ -101,12 +148,11 @@ struct TrafficList {
    * @param id FLARM id
    * @return the FLARM_TRAFFIC pointer, NULL if not found
    */
-  constexpr const FlarmTraffic *FindTraffic(FlarmId id) const noexcept {
-    for (const auto &traffic : list)
-      if (traffic.id == id)
-        return &traffic;
-
-    return NULL;
+  const FlarmTraffic *FindTraffic(FlarmId id) const noexcept {
+    const unsigned slot = FindSlot(id);
+    return slot != NO_INDEX
+      ? &list[id_table[slot]]
+      : nullptr;
   }
 
   /**
@@ -140,15 +186,13 @@ struct TrafficList {
   }
 
   /**
-   * Allocates a new FLARM_TRAFFIC object from the array.
+   * Allocates a new FLARM_TRAFFIC object from the array.  The object
+   * is cleared, and its id is set.  The caller must ensure that the
+   * id is not yet in the list.
    *
    * @return the FLARM_TRAFFIC pointer, NULL if the array is full
    */
-  constexpr FlarmTraffic *AllocateTraffic() noexcept {
-    return list.full()
-      ? NULL
-      : &list.append();
-  }
+  FlarmTraffic *AllocateTraffic(FlarmId id) noexcept;
 
   /**
    * Search for the previous traffic in the ordered list.
@@ -193,10 +237,81 @@ struct TrafficList {
     return t - list.begin();
   }
 
+  /**
+   * Rebuild the grid from FlarmTraffic::relative_north and
+   * FlarmTraffic::relative_east.  Call this after these (and
+   * FlarmTraffic::distance) have been updated.
+   */
+  void UpdateGrid() noexcept;
+
+  /**
+   * Invoke the given function for each traffic object whose
+   * FlarmTraffic::distance is not larger than the given range.  The
+   * function returns false to stop the iteration.
+   */
+  template<typename F>
+  void VisitWithinRange(double range, F &&f) const {
+    if (!grid_valid) {
+      for (const auto &traffic : list)
+        if (double(traffic.distance) <= range && !f(traffic))
+          return;
+      return;
+    }
+
+    const unsigned min = ToGridCell(-range), max = ToGridCell(range);
+    for (unsigned y = min; y <= max; ++y) {
+      for (unsigned x = min; x <= max; ++x) {
+        for (unsigned i = grid_head[y * GRID_SIZE + x]; i != NO_INDEX;
+             i = grid_next[i]) {
+          const auto &traffic = list[i];
+          if (double(traffic.distance) <= range && !f(traffic))
+            return;
+        }
+      }
+    }
+  }
+
   /**
    * Is set if traffic is present and closer than 4Km.
    */
+  [[gnu::pure]]
   bool InCloseRange() const noexcept;
+
+private:
+  static constexpr unsigned GetHomeSlot(FlarmId id) noexcept {
+    return uint32_t(FlarmId::Hash{}(id)) >> (32 - ID_TABLE_BITS);
+  }
+
+  static constexpr unsigned NextSlot(unsigned slot) noexcept {
+    return (slot + 1) & (ID_TABLE_SIZE - 1);
+  }
+
+  /**
+   * @return the #id_table slot which refers to the given id or
+   * #NO_INDEX if the id is not in the list
+   */
+  [[gnu::pure]]
+  unsigned FindSlot(FlarmId id) const noexcept {
+    for (unsigned slot = GetHomeSlot(id);; slot = NextSlot(slot)) {
+      const unsigned i = id_table[slot];
+      if (i == NO_INDEX)
+        return NO_INDEX;
+
+      if (list[i].id == id)
+        return slot;
+    }
+  }
+
+  /**
+   * Remove the item at the given position from #list and from
+   * #id_table.  The last item is moved to its position.
+   */
+  void RemoveTraffic(unsigned i) noexcept;
+
+  static constexpr unsigned ToGridCell(double relative) noexcept {
+    const int cell = int(relative / GRID_CELL_SIZE + GRID_SIZE / 2.);
+    return std::clamp(cell, 0, int(GRID_SIZE) - 1);
+  }
 };
 
 static_assert(std::is_trivial<TrafficList>::value, "type is not trivial");
@@ -0,0 +1,227 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#include "AsyncIGCWriter.hpp"
+#include "IGCWriter.hpp"
+#include "NMEA/Info.hpp"
+
+#include <algorithm>
+#include <cassert>
+
+AsyncIGCWriter::AsyncIGCWriter(IGCWriter &_writer,
+                               std::chrono::steady_clock::duration _sync_interval)
+  :Thread("IGCWriter"),
+   writer(_writer), sync_interval(_sync_interval)
+{
+  fix.Clear();
+
+  Start();
+}
+
+AsyncIGCWriter::~AsyncIGCWriter() noexcept
+{
+  if (IsDefined()) {
+    try {
+      Stop();
+    } catch (...) {
+    }
+  }
+}
+
+AsyncIGCWriter::Record &
+AsyncIGCWriter::Prepare() noexcept
+{
+  if (Record *record = queue.Prepare())
+    return *record;
+
+  /* the writer thread cannot keep up with us (very slow storage
+     device?); block instead of losing records */
+  std::unique_lock lock{mutex};
+  Record *record;
+  while ((record = queue.Prepare()) == nullptr) {
+    wake = true;
+    cond.notify_one();
+    drained_cond.wait(lock);
+  }
+
+  return *record;
+}
+
+void
+AsyncIGCWriter::Wake() noexcept
+{
+  const std::lock_guard lock{mutex};
+  wake = true;
+  cond.notify_one();
+}
+
+void
+AsyncIGCWriter::Commit() noexcept
+{
+  queue.Push();
+
+  /* usually, the writer thread wakes up on its own once per sync
+     interval; don't bother it (and don't touch the mutex) unless the
+     queue fills up */
+  if (sync_interval <= std::chrono::steady_clock::duration::zero() ||
+      queue.size() == QUEUE_SIZE / 2)
+    Wake();
+}
+
+void
+AsyncIGCWriter::LogPoint(const NMEAInfo &gps_info) noexcept
+{
+  if (!fix.Apply(gps_info))
+    return;
+
+  Record &record = Prepare();
+  record.type = Record::Type::FIX;
+  record.fix = fix;
+  record.epe = gps_info.location_available
+    ? (int)IGCWriter::GetEPE(gps_info.gps)
+    : 0;
+  record.satellites = IGCWriter::GetSIU(gps_info.gps);
+  Commit();
+}
+
+void
+AsyncIGCWriter::LogEvent(const NMEAInfo &gps_info, const char *event) noexcept
+{
+  Record &record = Prepare();
+  record.type = Record::Type::EVENT;
+  record.time = gps_info.date_time_utc;
+  record.text = event;
+  Commit();
+
+  // tech_spec_gnss.pdf says we need a B record immediately after an E record
+  LogPoint(gps_info);
+}
+
+void
+AsyncIGCWriter::LoggerNote(const char *text) noexcept
+{
+  Record &record = Prepare();
+  record.type = Record::Type::NOTE;
+  record.text = text;
+  Commit();
+}
+
+void
+AsyncIGCWriter::LogEmptyFRecord(const BrokenTime &time) noexcept
+{
+  Record &record = Prepare();
+  record.type = Record::Type::EMPTY_F_RECORD;
+  record.time = time;
+  Commit();
+}
+
+void
+AsyncIGCWriter::LogFRecord(const BrokenTime &time,
+                           const int *satellite_ids) noexcept
+{
+  Record &record = Prepare();
+  record.type = Record::Type::F_RECORD;
+  record.time = time;
+  std::copy_n(satellite_ids, record.satellite_ids.size(),
+              record.satellite_ids.begin());
+  Commit();
+}
+
+void
+AsyncIGCWriter::Stop()
+{
+  assert(IsDefined());
+
+  {
+    const std::lock_guard lock{mutex};
+    stop = true;
+    cond.notify_one();
+  }
+
+  Join();
+
+  assert(queue.empty());
+
+  if (error)
+    std::rethrow_exception(error);
+}
+
+inline void
+AsyncIGCWriter::Write(const Record &record)
+{
+  switch (record.type) {
+  case Record::Type::FIX:
+    writer.LogPoint(record.fix, record.epe, record.satellites);
+    break;
+
+  case Record::Type::EVENT:
+    writer.LogEvent(record.time, record.text.c_str());
+    break;
+
+  case Record::Type::NOTE:
+    writer.LoggerNote(record.text.c_str());
+    break;
+
+  case Record::Type::F_RECORD:
+    writer.LogFRecord(record.time, record.satellite_ids.data());
+    break;
+
+  case Record::Type::EMPTY_F_RECORD:
+    writer.LogEmptyFRecord(record.time);
+    break;
+  }
+}
+
+void
+AsyncIGCWriter::WriteQueued() noexcept
+{
+  bool written = false;
+
+  while (const Record *record = queue.Front()) {
+    if (!error) {
+      try {
+        Write(*record);
+        written = true;
+      } catch (...) {
+        error = std::current_exception();
+      }
+    }
+
+    queue.Pop();
+  }
+
+  if (written && !error) {
+    try {
+      writer.Sync();
+    } catch (...) {
+      error = std::current_exception();
+    }
+  }
+}
+
+void
+AsyncIGCWriter::Run() noexcept
+{
+  std::unique_lock lock{mutex};
+
+  while (true) {
+    if (!wake && !stop) {
+      if (sync_interval > std::chrono::steady_clock::duration::zero())
+        cond.wait_for(lock, sync_interval);
+      else
+        cond.wait(lock);
+    }
+
+    wake = false;
+    const bool stopping = stop;
+
+    lock.unlock();
+    WriteQueued();
+    lock.lock();
+
+    drained_cond.notify_one();
+
+    if (stopping)
+      break;
+  }
+}
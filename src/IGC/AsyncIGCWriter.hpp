@@ -0,0 +1,169 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#pragma once
+
+#include "IGCFix.hpp"
+#include "NMEA/GPSState.hpp"
+#include "thread/Thread.hpp"
+#include "thread/Mutex.hxx"
+#include "thread/Cond.hxx"
+#include "thread/SPSCQueue.hpp"
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <exception>
+#include <string>
+
+class IGCWriter;
+struct NMEAInfo;
+
+/**
+ * Feeds an #IGCWriter from a dedicated thread, so the caller (the
+ * calculation thread) never waits for formatting, G record hashing
+ * or the storage device.
+ *
+ * Records are passed through a lock-free queue.  The writer thread
+ * wakes up once per sync interval, writes all pending records and
+ * syncs the file; a crash loses at most the records of one interval.
+ *
+ * The header and the declaration are written synchronously to the
+ * #IGCWriter before this object is constructed, and the G record is
+ * written after Stop().
+ *
+ * All public methods must be called from the same thread.
+ */
+class AsyncIGCWriter final : Thread {
+  struct Record {
+    enum class Type : uint8_t {
+      FIX,
+      EVENT,
+      NOTE,
+      F_RECORD,
+      EMPTY_F_RECORD,
+    } type;
+
+    /**
+     * The time of the #EVENT and F records.
+     */
+    BrokenTime time;
+
+    IGCFix fix;
+    int epe, satellites;
+
+    std::array<int, GPSState::MAXSATELLITES> satellite_ids;
+
+    /**
+     * The #EVENT or #NOTE text.  Its length is not limited here; the
+     * #IGCWriter applies the same limits as to direct calls.  The
+     * string stays in the queue slot, so its buffer is reused by the
+     * following records.
+     */
+    std::string text;
+  };
+
+  /**
+   * Enough for one minute of 1 Hz fixes.
+   */
+  static constexpr std::size_t QUEUE_SIZE = 64;
+
+  IGCWriter &writer;
+
+  /**
+   * Sync the file after this duration.  Zero means "after each
+   * record".
+   */
+  const std::chrono::steady_clock::duration sync_interval;
+
+  SPSCQueue<Record, QUEUE_SIZE> queue;
+
+  /**
+   * The producer's copy of the last fix, see IGCFix::Apply().
+   */
+  IGCFix fix;
+
+  Mutex mutex;
+
+  /**
+   * Wakes up the writer thread.
+   */
+  Cond cond;
+
+  /**
+   * Signalled by the writer thread after it has emptied the queue.
+   */
+  Cond drained_cond;
+
+  /**
+   * Shall the writer thread empty the queue now?  Protected by
+   * #mutex.
+   */
+  bool wake = false;
+
+  /**
+   * Shall the writer thread exit after emptying the queue?
+   * Protected by #mutex.
+   */
+  bool stop = false;
+
+  /**
+   * The first error which occurred in the writer thread.  All
+   * further records are discarded.  Owned by the writer thread until
+   * it has exited.
+   */
+  std::exception_ptr error;
+
+public:
+  /**
+   * Launch the writer thread.
+   *
+   * Throws on error.
+   */
+  AsyncIGCWriter(IGCWriter &_writer,
+                 std::chrono::steady_clock::duration _sync_interval);
+
+  ~AsyncIGCWriter() noexcept;
+
+  AsyncIGCWriter(const AsyncIGCWriter &) = delete;
+  AsyncIGCWriter &operator=(const AsyncIGCWriter &) = delete;
+
+  void LogPoint(const NMEAInfo &gps_info) noexcept;
+  void LogEvent(const NMEAInfo &gps_info, const char *event) noexcept;
+  void LoggerNote(const char *text) noexcept;
+
+  void LogEmptyFRecord(const BrokenTime &time) noexcept;
+  void LogFRecord(const BrokenTime &time, const int *satellite_ids) noexcept;
+
+  /**
+   * Write all pending records, sync the file and stop the thread.
+   * After that, the #IGCWriter may be used directly again.
+   *
+   * Throws the first error which occurred while writing.
+   */
+  void Stop();
+
+private:
+  /**
+   * Obtain a free queue slot.  If the queue is full, wait for the
+   * writer thread to empty it.
+   */
+  Record &Prepare() noexcept;
+
+  /**
+   * Publish the record obtained with Prepare().
+   */
+  void Commit() noexcept;
+
+  void Wake() noexcept;
+
+  void Write(const Record &record);
+
+  /**
+   * Write and pop all queued records, and sync the file.
+   */
+  void WriteQueued() noexcept;
+
+  /* virtual methods from class Thread */
+  void Run() noexcept override;
+};
@@ -11,6 +11,14 @@ struct IGCExtension {
   uint16_t start, finish;
 
   char code[4];
+
+  /**
+   * The index of this code in the parser's table of supported
+   * extensions, or -1 if it is not supported.  Set by
+   * IGCParseExtensions(), so the "B" record parser doesn't need to
+   * compare strings.
+   */
+  int8_t known;
 };
 
 struct IGCExtensions : public TrivialArray<IGCExtension, 16> {
@@ -12,6 +12,10 @@
 #include "util/StringAPI.hxx"
 #include "util/StringCompare.hxx"
 
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
 #include <stdlib.h>
 
 using std::string_view_literals::operator""sv;
@@ -113,6 +117,47 @@ CheckThreeAlphaNumeric(const char *src)
     IsAlphaNumericASCII(src[2]);
 }
 
+static constexpr struct {
+  char code[4];
+
+  /**
+   * The #IGCFix attribute which receives the value.
+   */
+  int16_t IGCFix::*value;
+
+  /**
+   * Parse only this many leading digits of the column (see
+   * ParseExtensionValueN()); 0 means the whole column.
+   */
+  unsigned digits;
+} known_extensions[] = {
+  { "ENL", &IGCFix::enl, 0 },
+  { "RPM", &IGCFix::rpm, 0 },
+  { "HDM", &IGCFix::hdm, 0 },
+  { "HDT", &IGCFix::hdt, 0 },
+  { "TRM", &IGCFix::trm, 0 },
+  { "TRT", &IGCFix::trt, 0 },
+  { "GSP", &IGCFix::gsp, 3 },
+  { "IAS", &IGCFix::ias, 3 },
+  { "TAS", &IGCFix::tas, 3 },
+  { "SIU", &IGCFix::siu, 0 },
+};
+
+/**
+ * @return the index in #known_extensions, or -1 if the code is not
+ * supported
+ */
+[[gnu::pure]]
+static int8_t
+FindKnownExtension(const char *code) noexcept
+{
+  for (std::size_t i = 0; i < std::size(known_extensions); ++i)
+    if (StringIsEqual(code, known_extensions[i].code))
+      return i;
+
+  return -1;
+}
+
 bool
 IGCParseExtensions(const char *buffer, IGCExtensions &extensions)
 {
@@ -151,6 +196,7 @@ IGCParseExtensions(const char *buffer, IGCExtensions &extensions)
     x.finish = finish;
     memcpy(x.code, buffer, 3);
     x.code[3] = 0;
+    x.known = FindKnownExtension(x.code);
 
     buffer += 3;
   }
@@ -158,6 +204,55 @@ IGCParseExtensions(const char *buffer, IGCExtensions &extensions)
   return true;
 }
 
+/**
+ * Decode a fixed-width unsigned decimal number.  Stops at the first
+ * character which is not a digit, therefore it never reads past the
+ * null terminator of a shorter string.
+ *
+ * @return the value, or -1 on error
+ */
+template<std::size_t n>
+[[gnu::always_inline]]
+static constexpr int
+ParseDigits(const char *p) noexcept
+{
+  int value = 0;
+
+  for (std::size_t i = 0; i < n; ++i) {
+    const unsigned digit = (unsigned char)p[i] - '0';
+    if (digit > 9)
+      return -1;
+
+    value = value * 10 + (int)digit;
+  }
+
+  return value;
+}
+
+/**
+ * Decode a 5 character altitude column, which may be negative
+ * ("-0012").
+ */
+static constexpr bool
+ParseAltitude(const char *p, int &value_r) noexcept
+{
+  if (*p == '-') {
+    const int value = ParseDigits<4>(p + 1);
+    if (value < 0)
+      return false;
+
+    value_r = -value;
+    return true;
+  }
+
+  const int value = ParseDigits<5>(p);
+  if (value < 0)
+    return false;
+
+  value_r = value;
+  return true;
+}
+
 /**
  * Parse an unsigned integer from the given string range
  * (null-termination is not necessary).
@@ -199,7 +294,7 @@ static void
 ParseExtensionValueN(const char *p, const char *end, size_t n,
                      int16_t &value_r)
 {
-  if (n > (size_t)(p - end))
+  if (n > (size_t)(end - p))
     /* string is too short */
     return;
 
@@ -208,95 +303,67 @@ ParseExtensionValueN(const char *p, const char *end, size_t n,
     value_r = value;
 }
 
-bool
-IGCParseFix(const char *buffer, const IGCExtensions &extensions, IGCFix &fix)
+/**
+ * Parse the extension columns of a "B" record.
+ *
+ * @param length the length of the line (excluding the line
+ * terminator)
+ */
+static void
+ParseExtensionFields(const char *line, std::size_t length,
+                     const IGCExtensions &extensions, IGCFix &fix) noexcept
 {
-  if (*buffer != 'B')
-    return false;
-
-  BrokenTime time;
-  if (!IGCParseTime(buffer + 1, time))
-    return false;
-
-  char valid_char;
-  int gps_altitude, pressure_altitude;
-
-  if (sscanf(buffer + 24, "%c%05d%05d",
-             &valid_char, &pressure_altitude, &gps_altitude) != 3)
-    return false;
-
-  if (valid_char == 'A')
-    fix.gps_valid = true;
-  else if (valid_char == 'V')
-    fix.gps_valid = false;
-  else
-    return false;
-
-  fix.gps_altitude = gps_altitude;
-  fix.pressure_altitude = pressure_altitude;
-
-  if (!IGCParseLocation(buffer + 7, fix.location))
-    return false;
-
-  fix.time = time;
-
   fix.ClearExtensions();
 
-  const size_t line_length = strlen(buffer);
-  for (auto i = extensions.begin(), end = extensions.end(); i != end; ++i) {
-    const IGCExtension &extension = *i;
+  for (const IGCExtension &extension : extensions) {
+    if (extension.known < 0)
+      /* not supported */
+      continue;
+
     assert(extension.start > 0);
     assert(extension.finish >= extension.start);
 
-    if (extension.finish > line_length)
+    if (extension.finish > length)
       /* exceeds the input line length */
       continue;
 
-    const char *start = buffer + extension.start - 1;
-    const char *finish = buffer + extension.finish;
-
-    if (StringIsEqual(extension.code, "ENL"))
-      ParseExtensionValue(start, finish, fix.enl);
-    else if (StringIsEqual(extension.code, "RPM"))
-      ParseExtensionValue(start, finish, fix.rpm);
-    else if (StringIsEqual(extension.code, "HDM"))
-      ParseExtensionValue(start, finish, fix.hdm);
-    else if (StringIsEqual(extension.code, "HDT"))
-      ParseExtensionValue(start, finish, fix.hdt);
-    else if (StringIsEqual(extension.code, "TRM"))
-      ParseExtensionValue(start, finish, fix.trm);
-    else if (StringIsEqual(extension.code, "TRT"))
-      ParseExtensionValue(start, finish, fix.trt);
-    else if (StringIsEqual(extension.code, "GSP"))
-      ParseExtensionValueN(start, finish, 3, fix.gsp);
-    else if (StringIsEqual(extension.code, "IAS"))
-      ParseExtensionValueN(start, finish, 3, fix.ias);
-    else if (StringIsEqual(extension.code, "TAS"))
-      ParseExtensionValueN(start, finish, 3, fix.tas);
-    else if (StringIsEqual(extension.code, "SIU"))
-      ParseExtensionValue(start, finish, fix.siu);
-  }
+    const auto &known = known_extensions[extension.known];
+    const char *start = line + extension.start - 1;
+    const char *finish = line + extension.finish;
 
-  return true;
+    if (known.digits == 0)
+      ParseExtensionValue(start, finish, fix.*known.value);
+    else
+      ParseExtensionValueN(start, finish, known.digits, fix.*known.value);
+  }
 }
 
-bool
-IGCParseLocation(const char *buffer, GeoPoint &location)
+[[gnu::always_inline]]
+static inline bool
+ParseLocationColumns(const char *buffer, GeoPoint &location) noexcept
 {
-  unsigned lat_degrees, lat_minutes, lon_degrees, lon_minutes;
-  char lat_char, lon_char;
+  const int lat_degrees = ParseDigits<2>(buffer);
+  if (lat_degrees < 0 || lat_degrees >= 90)
+    return false;
+
+  const int lat_minutes = ParseDigits<5>(buffer + 2);
+  if (lat_minutes < 0 || lat_minutes >= 60000)
+    return false;
 
-  if (sscanf(buffer, "%02u%05u%c%03u%05u%c",
-             &lat_degrees, &lat_minutes, &lat_char,
-             &lon_degrees, &lon_minutes, &lon_char) != 6)
+  const char lat_char = buffer[7];
+  if (lat_char != 'N' && lat_char != 'S')
     return false;
 
-  if (lat_degrees >= 90 || lat_minutes >= 60000 ||
-      (lat_char != 'N' && lat_char != 'S'))
+  const int lon_degrees = ParseDigits<3>(buffer + 8);
+  if (lon_degrees < 0 || lon_degrees >= 180)
     return false;
 
-  if (lon_degrees >= 180 || lon_minutes >= 60000 ||
-      (lon_char != 'E' && lon_char != 'W'))
+  const int lon_minutes = ParseDigits<5>(buffer + 11);
+  if (lon_minutes < 0 || lon_minutes >= 60000)
+    return false;
+
+  const char lon_char = buffer[16];
+  if (lon_char != 'E' && lon_char != 'W')
     return false;
 
   location.latitude = Angle::Degrees(lat_degrees +
@@ -312,24 +379,156 @@ IGCParseLocation(const char *buffer, GeoPoint &location)
   return true;
 }
 
-bool
-IGCParseTime(const char *buffer, BrokenTime &time)
+[[gnu::always_inline]]
+static inline bool
+ParseTimeColumns(const char *buffer, BrokenTime &time) noexcept
 {
-  unsigned hour, minute, second;
+  const int hour = ParseDigits<2>(buffer);
+  if (hour < 0)
+    return false;
 
-  if (sscanf(buffer, "%02u%02u%02u", &hour, &minute, &second) != 3)
+  const int minute = ParseDigits<2>(buffer + 2);
+  if (minute < 0)
+    return false;
+
+  const int second = ParseDigits<2>(buffer + 4);
+  if (second < 0)
     return false;
 
   time = BrokenTime(hour, minute, second);
   return time.IsPlausible();
 }
 
+/**
+ * The length of the fixed-layout part of a "B" record: "B", time (6),
+ * location (17), validity (1), pressure and GPS altitude (5 each).
+ */
+static constexpr std::size_t IGC_FIX_LENGTH = 35;
+
+/**
+ * The "I" record specifies the extension columns with two digits, so
+ * no extension ends beyond this column.
+ */
+static constexpr std::size_t MAX_EXTENSION_FINISH = 99;
+
+/**
+ * Parse the fixed-layout part of a "B" record, i.e. the first
+ * #IGC_FIX_LENGTH characters.  Like ParseDigits(), this stops at the
+ * first mismatch and never reads past the null terminator of a shorter
+ * string.
+ */
+static bool
+ParseFixColumns(const char *buffer, IGCFix &fix) noexcept
+{
+  if (buffer[0] != 'B')
+    return false;
+
+  BrokenTime time;
+  if (!ParseTimeColumns(buffer + 1, time))
+    return false;
+
+  if (!ParseLocationColumns(buffer + 7, fix.location))
+    return false;
+
+  if (buffer[24] == 'A')
+    fix.gps_valid = true;
+  else if (buffer[24] == 'V')
+    fix.gps_valid = false;
+  else
+    return false;
+
+  if (!ParseAltitude(buffer + 25, fix.pressure_altitude) ||
+      !ParseAltitude(buffer + 30, fix.gps_altitude))
+    return false;
+
+  fix.time = time;
+  return true;
+}
+
+bool
+IGCParseFix(const char *buffer, const IGCExtensions &extensions, IGCFix &fix)
+{
+  if (!ParseFixColumns(buffer, fix))
+    return false;
+
+  const std::size_t line_length = extensions.empty()
+    ? 0
+    : strnlen(buffer, MAX_EXTENSION_FINISH);
+  ParseExtensionFields(buffer, line_length, extensions, fix);
+
+  return true;
+}
+
+std::size_t
+IGCParseFixes(std::string_view src, std::vector<IGCFix> &fixes)
+{
+  const std::size_t old_size = fixes.size();
+
+  /* each "B" record occupies at least IGC_FIX_LENGTH characters plus
+     the line terminator, so this is an upper bound */
+  fixes.reserve(old_size + src.size() / (IGC_FIX_LENGTH + 1));
+
+  IGCExtensions extensions;
+  extensions.clear();
+
+  while (!src.empty()) {
+    std::string_view line = src;
+    if (const auto newline = src.find('\n');
+        newline != std::string_view::npos) {
+      line = src.substr(0, newline);
+      src.remove_prefix(newline + 1);
+    } else
+      src = {};
+
+    if (!line.empty() && line.back() == '\r')
+      line.remove_suffix(1);
+
+    if (line.size() >= IGC_FIX_LENGTH && line.front() == 'B') {
+      IGCFix &fix = fixes.emplace_back();
+      if (ParseFixColumns(line.data(), fix))
+        ParseExtensionFields(line.data(), line.size(), extensions, fix);
+      else
+        fixes.pop_back();
+    } else if (!line.empty() && line.front() == 'I') {
+      /* "I" records are rare; copy to a null-terminated buffer for
+         IGCParseExtensions() */
+      char buffer[128];
+      const std::size_t length = std::min(line.size(), sizeof(buffer) - 1);
+      memcpy(buffer, line.data(), length);
+      buffer[length] = 0;
+
+      IGCParseExtensions(buffer, extensions);
+    }
+  }
+
+  return fixes.size() - old_size;
+}
+
+bool
+IGCParseLocation(const char *buffer, GeoPoint &location)
+{
+  return ParseLocationColumns(buffer, location);
+}
+
+bool
+IGCParseTime(const char *buffer, BrokenTime &time)
+{
+  return ParseTimeColumns(buffer, time);
+}
+
 static bool
 IGCParseDate(const char *buffer, BrokenDate &date)
 {
-  unsigned day, month, year;
+  const int day = ParseDigits<2>(buffer);
+  if (day < 0)
+    return false;
+
+  const int month = ParseDigits<2>(buffer + 2);
+  if (month < 0)
+    return false;
 
-  if (sscanf(buffer, "%02u%02u%02u", &day, &month, &year) != 3)
+  const int year = ParseDigits<2>(buffer + 4);
+  if (year < 0)
     return false;
 
   date = BrokenDate(year + 2000, month, day);
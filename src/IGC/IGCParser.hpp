@@ -3,6 +3,10 @@
 
 #pragma once
 
+#include <cstddef>
+#include <string_view>
+#include <vector>
+
 struct IGCFix;
 struct IGCHeader;
 struct IGCExtensions;
@@ -52,6 +56,21 @@ IGCParseLocation(const char *buffer, GeoPoint &location);
 bool
 IGCParseFix(const char *buffer, const IGCExtensions &extensions, IGCFix &fix);
 
+/**
+ * Parse all "B" records of an IGC file which has been loaded into
+ * memory (e.g. with #FileMapping) and append them to the given
+ * vector.  Each "I" record applies to the "B" records following it.
+ * All other records and malformed "B" records are skipped.
+ *
+ * This is faster than calling IGCParseFix() for each line: it needs
+ * no line buffer and no strlen() per line.
+ *
+ * @param src the file contents (need not be null-terminated)
+ * @return the number of fixes which were appended
+ */
+std::size_t
+IGCParseFixes(std::string_view src, std::vector<IGCFix> &fixes);
+
 /**
  * Parse a time in IGC file format (HHMMSS).
  *
@@ -192,7 +192,6 @@ IGCWriter::LogPoint(const IGCFix &fix, int epe, int satellites)
           epe, satellites);
 
   WriteLine(b_record);
-  Flush();
 }
 
 void
@@ -207,11 +206,11 @@ IGCWriter::LogPoint(const NMEAInfo& gps_info)
 void
 IGCWriter::LogEvent(const BrokenTime &time, const char *event)
 {
-  char e_record[30];
-  sprintf(e_record, "E%02d%02d%02d%s",
-          time.hour, time.minute, time.second, event);
+  char e_record[16];
+  sprintf(e_record, "E%02d%02d%02d",
+          time.hour, time.minute, time.second);
 
-  WriteLine(e_record);
+  WriteLine(e_record, event);
 }
 
 void
@@ -37,6 +37,17 @@ public:
     buffered.Flush();
   }
 
+  /**
+   * Flush the buffer and wait until all data has reached the
+   * storage device.
+   *
+   * Throws on error.
+   */
+  void Sync() {
+    buffered.Flush();
+    file.Sync();
+  }
+
   void Sign();
 
 private:
@@ -50,11 +61,12 @@ private:
 
   static const char *GetHFFXARecord();
   static const char *GetIRecord();
+
+public:
   static double GetEPE(const GPSState &gps);
   /** Satellites in use if logger fix quality is a valid gps */
   static int GetSIU(const GPSState &gps);
 
-public:
   /**
    * @param logger_id the ID of the logger, consisting of exactly 3
    * alphanumeric characters (plain ASCII)
@@ -80,9 +92,8 @@ public:
   void LogEvent(const IGCFix &fix, int epe, int satellites, const char *event);
   void LogEvent(const NMEAInfo &gps_info, const char *event);
 
+  void LogEvent(const BrokenTime &time, const char *event = "");
+
   void LogEmptyFRecord(const BrokenTime &time);
   void LogFRecord(const BrokenTime &time, const int *satellite_ids);
-
-protected:
-  void LogEvent(const BrokenTime &time, const char *event = "");
 };
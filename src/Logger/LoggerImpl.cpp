@@ -12,6 +12,7 @@
 #include "Formatter/IGCFilenameFormatter.hpp"
 #include "Interface.hpp"
 #include "IGC/IGCWriter.hpp"
+#include "IGC/AsyncIGCWriter.hpp"
 #include "util/CharUtil.hxx"
 
 #include <algorithm>
@@ -64,12 +65,21 @@ LoggerImpl::StopLogger([[maybe_unused]] const NMEAInfo &gps_info)
   if (writer == nullptr)
     return;
 
-  writer->Flush();
+  try {
+    if (async_writer != nullptr)
+      async_writer->Stop();
+
+    writer->Flush();
+
+    if (!simulator)
+      writer->Sign();
 
-  if (!simulator)
-    writer->Sign();
+    writer->Sync();
+  } catch (...) {
+    LogError(std::current_exception());
+  }
 
-  writer->Flush();
+  async_writer.reset();
 
   LogFormat("Stopped logger: %s", filename.c_str());
 
@@ -96,8 +106,8 @@ LoggerImpl::LogEvent(const NMEAInfo &gps_info, const char *event)
   if (gps_info.location_available && !gps_info.gps.real)
     simulator = true;
 
-  if (writer != nullptr)
-    writer->LogEvent(gps_info, event);
+  if (async_writer != nullptr)
+    async_writer->LogEvent(gps_info, event);
 }
 
 void
@@ -106,7 +116,7 @@ LoggerImpl::LogPoint(const NMEAInfo &gps_info)
   if (!gps_info.alive || !gps_info.time_available)
     return;
 
-  if (writer == nullptr) {
+  if (async_writer == nullptr) {
     LogPointToBuffer(gps_info);
     return;
   }
@@ -180,12 +190,13 @@ LoggerImpl::WritePoint(const NMEAInfo &gps_info)
   if (!simulator && frecord.Update(gps_info.gps, gps_info.time,
                                    !gps_info.location_available)) {
     if (gps_info.gps.satellite_ids_available)
-      writer->LogFRecord(gps_info.date_time_utc, gps_info.gps.satellite_ids);
+      async_writer->LogFRecord(gps_info.date_time_utc,
+                               gps_info.gps.satellite_ids);
     else
-      writer->LogEmptyFRecord(gps_info.date_time_utc);
+      async_writer->LogEmptyFRecord(gps_info.date_time_utc);
   }
 
-  writer->LogPoint(gps_info);
+  async_writer->LogPoint(gps_info);
 }
 
 bool
@@ -232,8 +243,8 @@ LoggerImpl::StartLogger(const NMEAInfo &gps_info,
 void
 LoggerImpl::LoggerNote(const char *text)
 {
-  if (writer != nullptr)
-    writer->LoggerNote(text);
+  if (async_writer != nullptr)
+    async_writer->LoggerNote(text);
 }
 
 [[gnu::pure]]
@@ -290,6 +301,15 @@ LoggerImpl::StartLogger(const NMEAInfo &gps_info,
 
     writer->EndDeclaration();
   }
+
+  try {
+    /* from here on, all records are written by the writer thread */
+    async_writer = std::make_unique<AsyncIGCWriter>(*writer,
+                                                    settings.sync_interval);
+  } catch (...) {
+    LogError(std::current_exception());
+    writer.reset();
+  }
 }
 
 void
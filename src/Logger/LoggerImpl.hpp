@@ -16,6 +16,7 @@ struct NMEAInfo;
 struct LoggerSettings;
 struct Declaration;
 class IGCWriter;
+class AsyncIGCWriter;
 
 /**
  * Implementation of logger
@@ -74,6 +75,12 @@ private:
   AllocatedPath filename;
   std::unique_ptr<IGCWriter> writer;
 
+  /**
+   * Writes the fixes to #writer in a separate thread.  It exists
+   * after the header has been written.
+   */
+  std::unique_ptr<AsyncIGCWriter> async_writer;
+
   OverwritingRingBuffer<PreTakeoffBuffer, PRETAKEOFF_BUFFER_MAX> pre_takeoff_buffer;
 
   LoggerFRecord frecord;
@@ -0,0 +1,487 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#include "SensorLog.hpp"
+#include "io/BufferedOutputStream.hxx"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <stdexcept>
+
+namespace SensorLog {
+
+enum class Tag : uint8_t {
+  SAMPLE = 1,
+  SAMPLE_MASK,
+  LINE,
+  KEYFRAME,
+  INDEX,
+};
+
+static constexpr char MAGIC[4] = {'X', 'C', 'S', 'R'};
+static constexpr uint8_t VERSION = 1;
+static constexpr std::size_t HEADER_SIZE = 8;
+
+static constexpr char FOOTER_MAGIC[4] = {'X', 'S', 'R', 'I'};
+
+/**
+ * The footer consists of the (little-endian 64 bit) offset of the
+ * index frame and #FOOTER_MAGIC.
+ */
+static constexpr std::size_t FOOTER_SIZE = 12;
+
+/**
+ * Big enough for any frame except for lines and the index.
+ */
+using FrameBuffer = std::array<std::byte, 16 + 10 * (N_FIELDS + 2)>;
+
+static constexpr uint64_t
+ZigZag(int64_t value) noexcept
+{
+  return (uint64_t(value) << 1) ^ uint64_t(value >> 63);
+}
+
+static constexpr int64_t
+UnZigZag(uint64_t value) noexcept
+{
+  return int64_t(value >> 1) ^ -int64_t(value & 1);
+}
+
+/**
+ * Appends LEB128 variable-length integers to a buffer.
+ */
+class Encoder {
+  std::byte *const begin;
+  std::byte *p;
+
+public:
+  explicit Encoder(std::byte *_begin) noexcept
+    :begin(_begin), p(_begin) {}
+
+  void Byte(uint8_t value) noexcept {
+    *p++ = std::byte{value};
+  }
+
+  void Varint(uint64_t value) noexcept {
+    while (value >= 0x80) {
+      Byte(uint8_t(value) | 0x80);
+      value >>= 7;
+    }
+
+    Byte(uint8_t(value));
+  }
+
+  std::span<const std::byte> Finish() const noexcept {
+    return {begin, p};
+  }
+};
+
+/**
+ * Parses the data written by #Encoder.  All methods return false if
+ * the data is truncated, and throw if it is malformed.
+ */
+class Decoder {
+  std::span<const std::byte> data;
+  std::size_t position;
+
+public:
+  Decoder(std::span<const std::byte> _data, std::size_t _position) noexcept
+    :data(_data), position(_position) {}
+
+  std::size_t GetPosition() const noexcept {
+    return position;
+  }
+
+  bool Byte(uint8_t &value) noexcept {
+    if (position >= data.size())
+      return false;
+
+    value = uint8_t(data[position++]);
+    return true;
+  }
+
+  bool Varint(uint64_t &value) {
+    value = 0;
+    for (unsigned shift = 0; shift < 64; shift += 7) {
+      uint8_t b;
+      if (!Byte(b))
+        return false;
+
+      value |= uint64_t(b & 0x7f) << shift;
+      if ((b & 0x80) == 0)
+        return true;
+    }
+
+    throw std::runtime_error("Malformed integer in sensor log");
+  }
+
+  bool Bytes(std::size_t size, std::span<const std::byte> &value) noexcept {
+    if (data.size() - position < size)
+      return false;
+
+    value = data.subspan(position, size);
+    position += size;
+    return true;
+  }
+};
+
+Writer::Writer(BufferedOutputStream &_os)
+  :os(_os)
+{
+  last.Clear();
+
+  std::array<std::byte, HEADER_SIZE> header{};
+  std::memcpy(header.data(), MAGIC, sizeof(MAGIC));
+  header[sizeof(MAGIC)] = std::byte{VERSION};
+  Write(header);
+}
+
+inline void
+Writer::Write(std::span<const std::byte> src)
+{
+  os.Write(src);
+  position += src.size();
+}
+
+uint64_t
+Writer::BeginFrame(uint64_t clock, bool &keyframe)
+{
+  if (clock < last_clock)
+    /* frames from different threads may arrive slightly out of
+       order; keep the clock monotonic */
+    clock = last_clock;
+
+  keyframe = need_keyframe || clock - keyframe_clock >= KEYFRAME_INTERVAL;
+
+  if (keyframe) {
+    index.push_back({clock, position});
+
+    FrameBuffer buffer;
+    Encoder e(buffer.data());
+    e.Byte(uint8_t(Tag::KEYFRAME));
+    e.Varint(clock);
+    Write(e.Finish());
+
+    last.Clear(clock);
+    last_clock = keyframe_clock = clock;
+    need_keyframe = false;
+  }
+
+  const uint64_t delta = clock - last_clock;
+  last_clock = clock;
+  return delta;
+}
+
+bool
+Writer::WriteSample(const Sample &sample)
+{
+  bool keyframe;
+  const uint64_t delta = BeginFrame(sample.clock, keyframe);
+
+  uint32_t changed = 0;
+  for (unsigned i = 0; i < N_FIELDS; ++i)
+    if ((sample.present & (uint32_t(1) << i)) &&
+        sample.values[i] != last.values[i])
+      changed |= uint32_t(1) << i;
+
+  FrameBuffer buffer;
+  Encoder e(buffer.data());
+
+  if (sample.present != last.present) {
+    e.Byte(uint8_t(Tag::SAMPLE_MASK));
+    e.Varint(delta);
+    e.Varint(sample.present);
+  } else {
+    e.Byte(uint8_t(Tag::SAMPLE));
+    e.Varint(delta);
+  }
+
+  e.Varint(changed);
+
+  for (unsigned i = 0; i < N_FIELDS; ++i) {
+    if (changed & (uint32_t(1) << i)) {
+      e.Varint(ZigZag(int64_t(sample.values[i]) - last.values[i]));
+      last.values[i] = sample.values[i];
+    }
+  }
+
+  last.present = sample.present;
+  last.clock = sample.clock;
+
+  Write(e.Finish());
+  return keyframe;
+}
+
+bool
+Writer::WriteLine(uint64_t clock, unsigned device, std::string_view line)
+{
+  assert(device < 0x100);
+
+  bool keyframe;
+  const uint64_t delta = BeginFrame(clock, keyframe);
+
+  FrameBuffer buffer;
+  Encoder e(buffer.data());
+  e.Byte(uint8_t(Tag::LINE));
+  e.Varint(delta);
+  e.Byte(uint8_t(device));
+  e.Varint(line.size());
+  Write(e.Finish());
+  Write(std::as_bytes(std::span{line}));
+
+  return keyframe;
+}
+
+void
+Writer::Finish()
+{
+  const uint64_t index_offset = position;
+
+  FrameBuffer buffer;
+  Encoder header(buffer.data());
+  header.Byte(uint8_t(Tag::INDEX));
+  header.Varint(index.size());
+  Write(header.Finish());
+
+  IndexEntry previous{0, 0};
+  for (const auto &i : index) {
+    Encoder e(buffer.data());
+    e.Varint(i.clock - previous.clock);
+    e.Varint(i.offset - previous.offset);
+    Write(e.Finish());
+    previous = i;
+  }
+
+  std::array<std::byte, FOOTER_SIZE> footer;
+  for (unsigned i = 0; i < 8; ++i)
+    footer[i] = std::byte(index_offset >> (i * 8));
+  std::memcpy(footer.data() + 8, FOOTER_MAGIC, sizeof(FOOTER_MAGIC));
+  Write(footer);
+}
+
+Reader::Reader(std::span<const std::byte> _data)
+  :data(_data)
+{
+  if (data.size() < HEADER_SIZE ||
+      std::memcmp(data.data(), MAGIC, sizeof(MAGIC)) != 0)
+    throw std::runtime_error("Not a sensor log");
+
+  if (uint8_t(data[sizeof(MAGIC)]) != VERSION)
+    throw std::runtime_error("Unsupported sensor log version");
+
+  if (!LoadIndex())
+    ScanIndex();
+
+  Reset();
+}
+
+void
+Reader::Reset() noexcept
+{
+  position = HEADER_SIZE;
+  clock = 0;
+  sample.Clear();
+  device = 0;
+  line = {};
+}
+
+bool
+Reader::LoadIndex() noexcept
+{
+  if (data.size() < HEADER_SIZE + FOOTER_SIZE)
+    return false;
+
+  const auto footer = data.last(FOOTER_SIZE);
+  if (std::memcmp(footer.data() + 8, FOOTER_MAGIC,
+                  sizeof(FOOTER_MAGIC)) != 0)
+    return false;
+
+  uint64_t index_offset = 0;
+  for (unsigned i = 0; i < 8; ++i)
+    index_offset |= uint64_t(footer[i]) << (i * 8);
+
+  if (index_offset < HEADER_SIZE ||
+      index_offset >= data.size() - FOOTER_SIZE)
+    return false;
+
+  const auto index_data = data.first(data.size() - FOOTER_SIZE);
+
+  try {
+    Decoder d(index_data, index_offset);
+    uint8_t tag;
+    uint64_t n;
+    if (!d.Byte(tag) || tag != uint8_t(Tag::INDEX) || !d.Varint(n) ||
+        n > index_data.size())
+      return false;
+
+    index.clear();
+    index.reserve(n);
+
+    IndexEntry i{0, 0};
+    for (uint64_t j = 0; j < n; ++j) {
+      uint64_t clock_delta, offset_delta;
+      if (!d.Varint(clock_delta) || !d.Varint(offset_delta))
+        return false;
+
+      i.clock += clock_delta;
+      i.offset += offset_delta;
+      if (i.offset >= index_offset)
+        return false;
+
+      index.push_back(i);
+    }
+  } catch (...) {
+    return false;
+  }
+
+  end = index_offset;
+  return true;
+}
+
+void
+Reader::ScanIndex()
+{
+  index.clear();
+  end = data.size();
+  Reset();
+
+  while (true) {
+    const std::size_t frame_offset = position;
+    Tag tag;
+    if (!DecodeFrame(tag))
+      break;
+
+    if (tag == Tag::KEYFRAME)
+      index.push_back({clock, frame_offset});
+  }
+
+  /* a truncated frame at the end is ignored from now on */
+  end = position;
+}
+
+bool
+Reader::DecodeFrame(Tag &tag)
+{
+  if (position >= end)
+    return false;
+
+  Decoder d(data.first(end), position);
+
+  uint8_t tag_byte;
+  if (!d.Byte(tag_byte))
+    return false;
+
+  tag = Tag(tag_byte);
+
+  uint64_t value;
+
+  switch (tag) {
+  case Tag::KEYFRAME:
+    if (!d.Varint(value))
+      return false;
+
+    sample.Clear(value);
+    clock = value;
+    break;
+
+  case Tag::SAMPLE:
+  case Tag::SAMPLE_MASK: {
+    uint64_t delta;
+    if (!d.Varint(delta))
+      return false;
+
+    uint64_t present = sample.present;
+    if (tag == Tag::SAMPLE_MASK && !d.Varint(present))
+      return false;
+
+    uint64_t changed;
+    if (!d.Varint(changed))
+      return false;
+
+    if (present >> N_FIELDS || changed & ~present)
+      throw std::runtime_error("Malformed sample in sensor log");
+
+    /* decode into a copy, so a truncated frame leaves the state
+       alone */
+    Sample next = sample;
+    next.clock = clock + delta;
+    next.present = uint32_t(present);
+
+    for (unsigned i = 0; i < N_FIELDS; ++i) {
+      if (changed & (uint32_t(1) << i)) {
+        if (!d.Varint(value))
+          return false;
+
+        next.values[i] = int32_t(next.values[i] + UnZigZag(value));
+      }
+    }
+
+    sample = next;
+    clock = next.clock;
+    break;
+  }
+
+  case Tag::LINE: {
+    uint64_t delta, length;
+    uint8_t device_byte;
+    std::span<const std::byte> bytes;
+    if (!d.Varint(delta) || !d.Byte(device_byte) || !d.Varint(length) ||
+        !d.Bytes(length, bytes))
+      return false;
+
+    clock += delta;
+    device = device_byte;
+    line = {(const char *)bytes.data(), bytes.size()};
+    break;
+  }
+
+  case Tag::INDEX:
+    /* the index of an unfinished file (the footer is missing) */
+    return false;
+
+  default:
+    throw std::runtime_error("Malformed frame in sensor log");
+  }
+
+  position = d.GetPosition();
+  return true;
+}
+
+Reader::Frame
+Reader::Next()
+{
+  while (true) {
+    Tag tag;
+    if (!DecodeFrame(tag))
+      return Frame::END;
+
+    switch (tag) {
+    case Tag::SAMPLE:
+    case Tag::SAMPLE_MASK:
+      return Frame::SAMPLE;
+
+    case Tag::LINE:
+      return Frame::LINE;
+
+    default:
+      break;
+    }
+  }
+}
+
+void
+Reader::Seek(uint64_t _clock) noexcept
+{
+  auto i = std::upper_bound(index.begin(), index.end(), _clock,
+                            [](uint64_t c, const IndexEntry &e){
+                              return c < e.clock;
+                            });
+
+  Reset();
+
+  if (i != index.begin())
+    position = std::prev(i)->offset;
+}
+
+} // namespace SensorLog
@@ -0,0 +1,328 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string_view>
+#include <vector>
+
+class BufferedOutputStream;
+
+/**
+ * A compact binary recording of sensor data ("*.xsr").
+ *
+ * After an 8 byte header, the file consists of frames.  Each frame
+ * starts with a tag byte, followed by the clock (milliseconds) as a
+ * variable-length delta to the previous frame:
+ *
+ * - #Tag::SAMPLE, #Tag::SAMPLE_MASK: a #Sample; only the fields
+ *   which have changed since the previous sample are stored, as
+ *   zig-zag encoded deltas.  SAMPLE_MASK additionally contains the
+ *   new mask of present fields.
+ *
+ * - #Tag::LINE: one line received from a device.
+ *
+ * - #Tag::KEYFRAME: the absolute clock; all delta state is reset.
+ *   Decoding can start at any keyframe.
+ *
+ * - #Tag::INDEX: the clock and the offset of all keyframes, followed
+ *   by a footer which points to it.  It is written when the
+ *   recording is finished; without it (e.g. after a crash), the
+ *   reader rebuilds the index by scanning the file.
+ */
+namespace SensorLog {
+
+enum class Field : uint8_t {
+  /** milliseconds since midnight UTC */
+  TIME,
+
+  /** year * 10000 + month * 100 + day */
+  DATE,
+
+  /** 1e-7 degrees */
+  LATITUDE,
+  LONGITUDE,
+
+  /** centimeters */
+  GPS_ALTITUDE,
+
+  /** #FixQuality */
+  FIX_QUALITY,
+
+  SATELLITES_USED,
+
+  /** 1/100 */
+  HDOP,
+
+  /** cm/s */
+  GROUND_SPEED,
+
+  /** 1/100 degrees */
+  TRACK,
+
+  /** 1/10 Pa */
+  STATIC_PRESSURE,
+  PITOT_PRESSURE,
+  DYNAMIC_PRESSURE,
+
+  /** centimeters */
+  BARO_ALTITUDE,
+  PRESSURE_ALTITUDE,
+
+  /** cm/s */
+  NONCOMP_VARIO,
+  TOTAL_ENERGY_VARIO,
+  NETTO_VARIO,
+  INDICATED_AIRSPEED,
+  TRUE_AIRSPEED,
+
+  /** 1/100 degrees */
+  BANK_ANGLE,
+  PITCH_ANGLE,
+  HEADING,
+
+  /** 1/1000 g */
+  G_LOAD,
+
+  /** 1/100 Kelvin */
+  TEMPERATURE,
+
+  COUNT
+};
+
+static constexpr std::size_t N_FIELDS = std::size_t(Field::COUNT);
+static_assert(N_FIELDS <= 32);
+
+enum class Tag : uint8_t;
+
+/**
+ * A snapshot of the sensor values, in fixed-point integer units (see
+ * #Field).
+ */
+struct Sample {
+  /**
+   * A monotonic clock [ms].
+   */
+  uint64_t clock;
+
+  /**
+   * A bit mask of the fields which are available.
+   */
+  uint32_t present;
+
+  std::array<int32_t, N_FIELDS> values;
+
+  static constexpr uint32_t Bit(Field field) noexcept {
+    return uint32_t(1) << unsigned(field);
+  }
+
+  constexpr void Clear(uint64_t _clock=0) noexcept {
+    clock = _clock;
+    present = 0;
+    values = {};
+  }
+
+  constexpr bool Has(Field field) const noexcept {
+    return present & Bit(field);
+  }
+
+  constexpr int32_t Get(Field field) const noexcept {
+    return values[unsigned(field)];
+  }
+
+  constexpr void Set(Field field, int32_t value) noexcept {
+    present |= Bit(field);
+    values[unsigned(field)] = value;
+  }
+
+  constexpr bool operator==(const Sample &) const noexcept = default;
+};
+
+struct IndexEntry {
+  uint64_t clock;
+
+  /**
+   * The file offset of the keyframe.
+   */
+  uint64_t offset;
+};
+
+/**
+ * Encodes frames into a #BufferedOutputStream.
+ */
+class Writer {
+  BufferedOutputStream &os;
+
+  /**
+   * The number of bytes written so far.
+   */
+  uint64_t position = 0;
+
+  uint64_t last_clock = 0;
+
+  /**
+   * The clock of the most recent keyframe.
+   */
+  uint64_t keyframe_clock = 0;
+
+  /**
+   * The previous sample; the next one is stored as a delta to this
+   * one.
+   */
+  Sample last;
+
+  bool need_keyframe = true;
+
+  std::vector<IndexEntry> index;
+
+public:
+  /**
+   * Write a keyframe at least this often [ms].
+   */
+  static constexpr uint64_t KEYFRAME_INTERVAL = 10000;
+
+  /**
+   * Writes the file header.
+   *
+   * Throws on error.
+   */
+  explicit Writer(BufferedOutputStream &_os);
+
+  /**
+   * Frames must be written in clock order; an older clock is
+   * replaced with the clock of the previous frame.
+   *
+   * Throws on error.
+   *
+   * @return true if a keyframe was written before the sample; the
+   * caller may use this as a hint to flush the stream
+   */
+  bool WriteSample(const Sample &sample);
+
+  /**
+   * Throws on error.
+   *
+   * @return true if a keyframe was written before the line
+   */
+  bool WriteLine(uint64_t clock, unsigned device, std::string_view line);
+
+  /**
+   * Write the index and the footer.  After that, no more frames
+   * may be written.
+   *
+   * Throws on error.
+   */
+  void Finish();
+
+  const std::vector<IndexEntry> &GetIndex() const noexcept {
+    return index;
+  }
+
+private:
+  /**
+   * Write a keyframe if needed, and return the clock delta to be
+   * stored in the next frame.
+   */
+  uint64_t BeginFrame(uint64_t clock, bool &keyframe);
+
+  void Write(std::span<const std::byte> src);
+};
+
+/**
+ * Decodes frames from a memory buffer (e.g. a #FileMapping).
+ */
+class Reader {
+  std::span<const std::byte> data;
+
+  /**
+   * The offset of the next frame.
+   */
+  std::size_t position;
+
+  /**
+   * The end of the frames (excluding the index).
+   */
+  std::size_t end;
+
+  std::vector<IndexEntry> index;
+
+  uint64_t clock;
+
+  Sample sample;
+
+  unsigned device;
+  std::string_view line;
+
+public:
+  enum class Frame : uint8_t {
+    /**
+     * No more frames (or a truncated frame at the end of a file
+     * which was not finished properly).
+     */
+    END,
+
+    SAMPLE,
+    LINE,
+  };
+
+  /**
+   * Throws if this is not a sensor log.
+   */
+  explicit Reader(std::span<const std::byte> _data);
+
+  /**
+   * Decode the next sample or line.
+   *
+   * Throws on malformed data.
+   */
+  Frame Next();
+
+  /**
+   * Continue reading at the last keyframe before (or at) the given
+   * clock.  The following Next() calls may still return frames older
+   * than that.
+   */
+  void Seek(uint64_t clock) noexcept;
+
+  const std::vector<IndexEntry> &GetIndex() const noexcept {
+    return index;
+  }
+
+  uint64_t GetClock() const noexcept {
+    return clock;
+  }
+
+  /**
+   * Returns the sample decoded by the last Next() call which
+   * returned #Frame::SAMPLE.
+   */
+  const Sample &GetSample() const noexcept {
+    return sample;
+  }
+
+  unsigned GetDevice() const noexcept {
+    return device;
+  }
+
+  std::string_view GetLine() const noexcept {
+    return line;
+  }
+
+private:
+  bool LoadIndex() noexcept;
+  void ScanIndex();
+  void Reset() noexcept;
+
+  /**
+   * Decode the frame at #position.
+   *
+   * @return false if there are no more (complete) frames
+   */
+  bool DecodeFrame(Tag &tag);
+};
+
+} // namespace SensorLog
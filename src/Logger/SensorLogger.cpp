@@ -0,0 +1,134 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#include "Logger/SensorLogger.hpp"
+#include "Logger/SensorLog.hpp"
+#include "io/FileOutputStream.hxx"
+#include "io/BufferedOutputStream.hxx"
+#include "LocalPath.hpp"
+#include "LogFile.hpp"
+#include "time/BrokenDateTime.hpp"
+#include "system/FileUtil.hpp"
+#include "system/Path.hpp"
+#include "util/StaticString.hxx"
+
+#include <chrono>
+
+SensorLogger::SensorLogger() noexcept = default;
+
+SensorLogger::~SensorLogger() noexcept
+{
+  Finish();
+}
+
+inline void
+SensorLogger::Start()
+{
+  if (writer != nullptr)
+    return;
+
+  BrokenDateTime dt = BrokenDateTime::NowUTC();
+  assert(dt.IsPlausible());
+
+  const auto logs_path = MakeLocalPath("logs");
+
+  /* a sensor log cannot be appended to; if the logger was restarted
+     within the same second, add a suffix */
+  StaticString<64> name;
+  AllocatedPath path = nullptr;
+  for (unsigned i = 0; i < 100; ++i) {
+    name.Format("%04u-%02u-%02u_%02u-%02u-%02u",
+                dt.year, dt.month, dt.day,
+                dt.hour, dt.minute, dt.second);
+    if (i > 0)
+      name.AppendFormat("_%u", i);
+    name.append(".xsr");
+
+    path = AllocatedPath::Build(logs_path, name);
+    if (!File::Exists(path))
+      break;
+  }
+
+  file = std::make_unique<FileOutputStream>(path,
+                                            FileOutputStream::Mode::CREATE_VISIBLE);
+  buffered = std::make_unique<BufferedOutputStream>(*file);
+  writer = std::make_unique<SensorLog::Writer>(*buffered);
+}
+
+void
+SensorLogger::Finish() noexcept
+{
+  const std::lock_guard lock{mutex};
+
+  if (writer != nullptr) {
+    try {
+      writer->Finish();
+      buffered->Flush();
+    } catch (...) {
+      LogError(std::current_exception(), "Failed to finish sensor log");
+    }
+  }
+
+  writer.reset();
+  buffered.reset();
+  file.reset();
+}
+
+void
+SensorLogger::SetMode(Mode _mode) noexcept
+{
+  mode.store(_mode, std::memory_order_relaxed);
+
+  if (_mode == Mode::OFF)
+    Finish();
+}
+
+void
+SensorLogger::Abort() noexcept
+{
+  LogError(std::current_exception(), "Failed to write sensor log");
+
+  mode.store(Mode::OFF, std::memory_order_relaxed);
+  writer.reset();
+  buffered.reset();
+  file.reset();
+}
+
+void
+SensorLogger::LogLine(unsigned device, const char *line) noexcept
+{
+  if (mode.load(std::memory_order_relaxed) != Mode::SAMPLES_AND_LINES)
+    return;
+
+  using namespace std::chrono;
+  const auto clock =
+    duration_cast<milliseconds>(steady_clock::now().time_since_epoch());
+
+  const std::lock_guard lock{mutex};
+
+  try {
+    Start();
+    if (writer->WriteLine(clock.count(), device, line))
+      buffered->Flush();
+  } catch (...) {
+    Abort();
+  }
+}
+
+void
+SensorLogger::LogSample(const SensorLog::Sample &sample) noexcept
+{
+  if (!IsEnabled())
+    return;
+
+  const std::lock_guard lock{mutex};
+
+  try {
+    Start();
+    if (writer->WriteSample(sample))
+      /* flush once per keyframe */
+      buffered->Flush();
+  } catch (...) {
+    Abort();
+  }
+}
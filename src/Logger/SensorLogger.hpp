@@ -0,0 +1,64 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#pragma once
+
+#include "Logger/Settings.hpp"
+#include "thread/Mutex.hxx"
+
+#include <atomic>
+#include <memory>
+
+class FileOutputStream;
+class BufferedOutputStream;
+namespace SensorLog { class Writer; struct Sample; }
+
+/**
+ * Records the merged sensor data (and optionally the lines received
+ * from all devices) at full rate into a binary #SensorLog file.
+ *
+ * The file is flushed with each keyframe, i.e. a crash loses at most
+ * SensorLog::Writer::KEYFRAME_INTERVAL of data.
+ */
+class SensorLogger {
+  using Mode = LoggerSettings::SensorLogMode;
+
+  Mutex mutex;
+  std::unique_ptr<FileOutputStream> file;
+  std::unique_ptr<BufferedOutputStream> buffered;
+  std::unique_ptr<SensorLog::Writer> writer;
+
+  std::atomic<Mode> mode{Mode::OFF};
+
+public:
+  SensorLogger() noexcept;
+  ~SensorLogger() noexcept;
+
+  bool IsEnabled() const noexcept {
+    return mode.load(std::memory_order_relaxed) != Mode::OFF;
+  }
+
+  /**
+   * Start or stop recording.  Switching it off finishes the current
+   * file.
+   */
+  void SetMode(Mode _mode) noexcept;
+
+  /**
+   * Record one line received from a device (only in
+   * #Mode::SAMPLES_AND_LINES).
+   */
+  void LogLine(unsigned device, const char *line) noexcept;
+
+  void LogSample(const SensorLog::Sample &sample) noexcept;
+
+private:
+  void Start();
+  void Finish() noexcept;
+
+  /**
+   * Log the current exception and stop recording.  Caller must lock
+   * the mutex.
+   */
+  void Abort() noexcept;
+};
@@ -0,0 +1,256 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#include "SensorSample.hpp"
+#include "NMEA/Info.hpp"
+
+#include <chrono>
+#include <cmath>
+
+using SensorLog::Field;
+using SensorLog::Sample;
+
+static int32_t
+Round(double value, double factor) noexcept
+{
+  return int32_t(std::lround(value * factor));
+}
+
+static void
+Set(Sample &sample, Field field, double value, double factor) noexcept
+{
+  sample.Set(field, Round(value, factor));
+}
+
+static void
+SetAngle(Sample &sample, Field field, Angle value) noexcept
+{
+  Set(sample, field, value.Degrees(), 100);
+}
+
+static void
+SetPressure(Sample &sample, Field field, AtmosphericPressure value) noexcept
+{
+  Set(sample, field, value.GetPascal(), 10);
+}
+
+Sample
+MakeSensorSample(const NMEAInfo &basic) noexcept
+{
+  using namespace std::chrono;
+
+  Sample sample;
+  sample.Clear(duration_cast<milliseconds>(basic.clock.ToDuration()).count());
+
+  if (basic.time_available)
+    Set(sample, Field::TIME, basic.time.ToDuration().count(), 1000);
+
+  if (basic.date_time_utc.IsDatePlausible())
+    sample.Set(Field::DATE, basic.date_time_utc.year * 10000 +
+               basic.date_time_utc.month * 100 + basic.date_time_utc.day);
+
+  if (basic.location_available) {
+    Set(sample, Field::LATITUDE, basic.location.latitude.Degrees(), 1e7);
+    Set(sample, Field::LONGITUDE, basic.location.longitude.Degrees(), 1e7);
+
+    if (basic.gps.hdop >= 0)
+      Set(sample, Field::HDOP, basic.gps.hdop, 100);
+  }
+
+  if (basic.gps_altitude_available)
+    Set(sample, Field::GPS_ALTITUDE, basic.gps_altitude, 100);
+
+  if (basic.gps.fix_quality_available)
+    sample.Set(Field::FIX_QUALITY, int32_t(basic.gps.fix_quality));
+
+  if (basic.gps.satellites_used_available)
+    sample.Set(Field::SATELLITES_USED, basic.gps.satellites_used);
+
+  if (basic.ground_speed_available)
+    Set(sample, Field::GROUND_SPEED, basic.ground_speed, 100);
+
+  if (basic.track_available)
+    SetAngle(sample, Field::TRACK, basic.track);
+
+  if (basic.static_pressure_available)
+    SetPressure(sample, Field::STATIC_PRESSURE, basic.static_pressure);
+
+  if (basic.pitot_pressure_available)
+    SetPressure(sample, Field::PITOT_PRESSURE, basic.pitot_pressure);
+
+  if (basic.dyn_pressure_available)
+    SetPressure(sample, Field::DYNAMIC_PRESSURE, basic.dyn_pressure);
+
+  if (basic.baro_altitude_available)
+    Set(sample, Field::BARO_ALTITUDE, basic.baro_altitude, 100);
+
+  if (basic.pressure_altitude_available)
+    Set(sample, Field::PRESSURE_ALTITUDE, basic.pressure_altitude, 100);
+
+  if (basic.noncomp_vario_available)
+    Set(sample, Field::NONCOMP_VARIO, basic.noncomp_vario, 100);
+
+  if (basic.total_energy_vario_available)
+    Set(sample, Field::TOTAL_ENERGY_VARIO, basic.total_energy_vario, 100);
+
+  if (basic.netto_vario_available)
+    Set(sample, Field::NETTO_VARIO, basic.netto_vario, 100);
+
+  if (basic.airspeed_available && basic.airspeed_real) {
+    Set(sample, Field::INDICATED_AIRSPEED, basic.indicated_airspeed, 100);
+    Set(sample, Field::TRUE_AIRSPEED, basic.true_airspeed, 100);
+  }
+
+  if (basic.attitude.bank_angle_available)
+    SetAngle(sample, Field::BANK_ANGLE, basic.attitude.bank_angle);
+
+  if (basic.attitude.pitch_angle_available)
+    SetAngle(sample, Field::PITCH_ANGLE, basic.attitude.pitch_angle);
+
+  if (basic.attitude.heading_available)
+    SetAngle(sample, Field::HEADING, basic.attitude.heading);
+
+  if (basic.acceleration.available && basic.acceleration.real)
+    Set(sample, Field::G_LOAD, basic.acceleration.g_load, 1000);
+
+  if (basic.temperature_available)
+    Set(sample, Field::TEMPERATURE, basic.temperature.ToKelvin(), 100);
+
+  return sample;
+}
+
+static constexpr double
+Get(const Sample &sample, Field field, double factor) noexcept
+{
+  return sample.Get(field) / factor;
+}
+
+static constexpr Angle
+GetAngle(const Sample &sample, Field field) noexcept
+{
+  return Angle::Degrees(Get(sample, field, 100));
+}
+
+static constexpr AtmosphericPressure
+GetPressure(const Sample &sample, Field field) noexcept
+{
+  return AtmosphericPressure::Pascal(Get(sample, field, 10));
+}
+
+/**
+ * Mark the value valid if the sample has it, or invalid if not.
+ *
+ * @return true if the sample has the value
+ */
+static bool
+Update(Validity &validity, const Sample &sample, Field field,
+       TimeStamp clock) noexcept
+{
+  if (!sample.Has(field)) {
+    validity.Clear();
+    return false;
+  }
+
+  validity.Update(clock);
+  return true;
+}
+
+void
+ApplySensorSample(const Sample &sample, NMEAInfo &data) noexcept
+{
+  const TimeStamp clock = data.clock;
+
+  if (sample.Has(Field::TIME))
+    data.ProvideTime(TimeStamp{FloatDuration{Get(sample, Field::TIME, 1000)}});
+  else
+    data.time_available.Clear();
+
+  if (sample.Has(Field::DATE)) {
+    const int32_t date = sample.Get(Field::DATE);
+    const BrokenDate d(date / 10000, (date / 100) % 100, date % 100);
+    if (d.IsPlausible())
+      data.ProvideDate(d);
+  }
+
+  if (Update(data.location_available, sample, Field::LATITUDE, clock)) {
+    data.location = GeoPoint(Angle::Degrees(Get(sample, Field::LONGITUDE, 1e7)),
+                             Angle::Degrees(Get(sample, Field::LATITUDE, 1e7)));
+    data.gps.hdop = sample.Has(Field::HDOP)
+      ? Get(sample, Field::HDOP, 100)
+      : -1;
+  }
+
+  if (Update(data.gps_altitude_available, sample, Field::GPS_ALTITUDE, clock))
+    data.gps_altitude = Get(sample, Field::GPS_ALTITUDE, 100);
+
+  if (Update(data.gps.fix_quality_available, sample, Field::FIX_QUALITY, clock))
+    data.gps.fix_quality = FixQuality(sample.Get(Field::FIX_QUALITY));
+
+  if (Update(data.gps.satellites_used_available, sample,
+             Field::SATELLITES_USED, clock))
+    data.gps.satellites_used = sample.Get(Field::SATELLITES_USED);
+
+  if (Update(data.ground_speed_available, sample, Field::GROUND_SPEED, clock))
+    data.ground_speed = Get(sample, Field::GROUND_SPEED, 100);
+
+  if (Update(data.track_available, sample, Field::TRACK, clock))
+    data.track = GetAngle(sample, Field::TRACK);
+
+  if (Update(data.static_pressure_available, sample,
+             Field::STATIC_PRESSURE, clock))
+    data.static_pressure = GetPressure(sample, Field::STATIC_PRESSURE);
+
+  if (Update(data.pitot_pressure_available, sample,
+             Field::PITOT_PRESSURE, clock))
+    data.pitot_pressure = GetPressure(sample, Field::PITOT_PRESSURE);
+
+  if (Update(data.dyn_pressure_available, sample,
+             Field::DYNAMIC_PRESSURE, clock))
+    data.dyn_pressure = GetPressure(sample, Field::DYNAMIC_PRESSURE);
+
+  if (Update(data.baro_altitude_available, sample,
+             Field::BARO_ALTITUDE, clock))
+    data.baro_altitude = Get(sample, Field::BARO_ALTITUDE, 100);
+
+  if (Update(data.pressure_altitude_available, sample,
+             Field::PRESSURE_ALTITUDE, clock))
+    data.pressure_altitude = Get(sample, Field::PRESSURE_ALTITUDE, 100);
+
+  if (Update(data.noncomp_vario_available, sample,
+             Field::NONCOMP_VARIO, clock))
+    data.noncomp_vario = Get(sample, Field::NONCOMP_VARIO, 100);
+
+  if (Update(data.total_energy_vario_available, sample,
+             Field::TOTAL_ENERGY_VARIO, clock))
+    data.total_energy_vario = Get(sample, Field::TOTAL_ENERGY_VARIO, 100);
+
+  if (Update(data.netto_vario_available, sample, Field::NETTO_VARIO, clock))
+    data.netto_vario = Get(sample, Field::NETTO_VARIO, 100);
+
+  if (sample.Has(Field::INDICATED_AIRSPEED) &&
+      sample.Has(Field::TRUE_AIRSPEED))
+    data.ProvideBothAirspeeds(Get(sample, Field::INDICATED_AIRSPEED, 100),
+                              Get(sample, Field::TRUE_AIRSPEED, 100));
+  else
+    data.airspeed_available.Clear();
+
+  if (Update(data.attitude.bank_angle_available, sample,
+             Field::BANK_ANGLE, clock))
+    data.attitude.bank_angle = GetAngle(sample, Field::BANK_ANGLE);
+
+  if (Update(data.attitude.pitch_angle_available, sample,
+             Field::PITCH_ANGLE, clock))
+    data.attitude.pitch_angle = GetAngle(sample, Field::PITCH_ANGLE);
+
+  if (Update(data.attitude.heading_available, sample, Field::HEADING, clock))
+    data.attitude.heading = GetAngle(sample, Field::HEADING);
+
+  if (sample.Has(Field::G_LOAD))
+    data.acceleration.ProvideGLoad(Get(sample, Field::G_LOAD, 1000));
+  else
+    data.acceleration.Reset();
+
+  if (Update(data.temperature_available, sample, Field::TEMPERATURE, clock))
+    data.temperature =
+      Temperature::FromKelvin(Get(sample, Field::TEMPERATURE, 100));
+}
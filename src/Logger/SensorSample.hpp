@@ -0,0 +1,23 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#pragma once
+
+#include "SensorLog.hpp"
+
+struct NMEAInfo;
+
+/**
+ * Convert the sensor values of a #NMEAInfo to a #SensorLog::Sample.
+ */
+[[gnu::pure]]
+SensorLog::Sample
+MakeSensorSample(const NMEAInfo &basic) noexcept;
+
+/**
+ * Copy the values of a #SensorLog::Sample to a #NMEAInfo, and clear
+ * the values which are not present in the sample.  The caller is
+ * responsible for setting NMEAInfo::clock before.
+ */
+void
+ApplySensorSample(const SensorLog::Sample &sample, NMEAInfo &data) noexcept;
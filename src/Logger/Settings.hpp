@@ -21,12 +21,36 @@ struct LoggerSettings {
    */
   bool enable_nmea_logger;
 
+  /**
+   * What shall the #SensorLogger record?
+   */
+  enum class SensorLogMode : uint8_t {
+    OFF,
+
+    /**
+     * The merged sensor values.
+     */
+    SAMPLES,
+
+    /**
+     * The merged sensor values and all lines received from devices.
+     */
+    SAMPLES_AND_LINES,
+  } sensor_log_mode;
+
   /** Logger interval in cruise mode */
   std::chrono::duration<unsigned> time_step_cruise;
 
   /** Logger interval in circling mode */
   std::chrono::duration<unsigned> time_step_circling;
 
+  /**
+   * The IGC file is synced to the storage device after this
+   * duration; a crash loses at most the fixes of this period.  Zero
+   * means after each fix.
+   */
+  std::chrono::duration<unsigned> sync_interval;
+
   enum class AutoLogger: uint8_t {
     ON,
     START_ONLY,
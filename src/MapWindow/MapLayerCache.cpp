@@ -0,0 +1,77 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#include "MapLayerCache.hpp"
+#include "Projection/WindowProjection.hpp"
+
+#ifdef ENABLE_OPENGL
+#include "ui/opengl/System.hpp"
+#endif
+
+#include <cassert>
+
+bool
+MapLayerCache::Check(const WindowProjection &projection) const noexcept
+{
+  assert(projection.IsValid());
+
+  return buffer.IsDefined() &&
+    buffer.GetSize() == projection.GetScreenSize() &&
+    compare_projection.Compare(projection);
+}
+
+Canvas &
+MapLayerCache::Begin(Canvas &canvas,
+                     const WindowProjection &projection) noexcept
+{
+  assert(canvas.IsDefined());
+  assert(projection.IsValid());
+
+#ifdef ENABLE_OPENGL
+  if (!buffer.IsDefined())
+    buffer.Create(canvas);
+
+  scissor = glIsEnabled(GL_SCISSOR_TEST);
+  if (scissor)
+    glDisable(GL_SCISSOR_TEST);
+
+  buffer.Begin(canvas);
+#else
+  const auto size = projection.GetScreenSize();
+  if (buffer.IsDefined())
+    buffer.Resize(size);
+  else
+    buffer.Create(canvas, size);
+#endif
+
+  compare_projection = CompareProjection(projection);
+  return buffer;
+}
+
+void
+MapLayerCache::Commit(Canvas &canvas) noexcept
+{
+  assert(buffer.IsDefined());
+  assert(compare_projection.IsDefined());
+
+#ifdef ENABLE_OPENGL
+  buffer.Commit(canvas);
+
+  if (scissor)
+    glEnable(GL_SCISSOR_TEST);
+#else
+  CopyTo(canvas);
+#endif
+}
+
+void
+MapLayerCache::CopyTo(Canvas &canvas) noexcept
+{
+  assert(buffer.IsDefined());
+
+#ifdef ENABLE_OPENGL
+  buffer.CopyTo(canvas);
+#else
+  canvas.Copy(buffer);
+#endif
+}
@@ -0,0 +1,81 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#pragma once
+
+#include "Projection/CompareProjection.hpp"
+#include "ui/canvas/BufferCanvas.hpp"
+
+class Canvas;
+class WindowProjection;
+
+/**
+ * Keeps the output of a group of opaque map layers in an off-screen
+ * buffer.  As long as the projection and the layers' inputs (which
+ * are tracked by the caller) have not changed, the buffer is copied
+ * to the screen instead of rendering the layers again.
+ *
+ * Usage:
+ *
+ *   if (!inputs_changed && cache.Check(projection)) {
+ *     cache.CopyTo(canvas);
+ *   } else {
+ *     Canvas &buffer = cache.Begin(canvas, projection);
+ *     ... draw to buffer ...
+ *     cache.Commit(canvas);
+ *   }
+ */
+class MapLayerCache {
+  CompareProjection compare_projection;
+  BufferCanvas buffer;
+
+#ifdef ENABLE_OPENGL
+  /**
+   * Was GL_SCISSOR_TEST enabled when Begin() was called?  It is
+   * disabled while drawing into the frame buffer, because the
+   * scissor rectangle is in screen coordinates.
+   */
+  bool scissor;
+#endif
+
+public:
+  void Invalidate() noexcept {
+    compare_projection.Clear();
+  }
+
+  /**
+   * Invalidate the cache and free the buffer.
+   */
+  void Destroy() noexcept {
+    Invalidate();
+    buffer.Destroy();
+  }
+
+  /**
+   * Check if the cache can be used.
+   *
+   * @return true if the buffer contains the layers for the given
+   * projection; the caller may skip to CopyTo()
+   */
+  [[gnu::pure]]
+  bool Check(const WindowProjection &projection) const noexcept;
+
+  /**
+   * Begin drawing to the cache.  Render to the returned #Canvas, and
+   * call Commit() when you're done.
+   */
+  Canvas &Begin(Canvas &canvas,
+                const WindowProjection &projection) noexcept;
+
+  /**
+   * Finish drawing to the cache, and copy the result to the given
+   * #Canvas.
+   */
+  void Commit(Canvas &canvas) noexcept;
+
+  /**
+   * Copy the cached layers to the given #Canvas.  Check() must have
+   * returned true.
+   */
+  void CopyTo(Canvas &canvas) noexcept;
+};
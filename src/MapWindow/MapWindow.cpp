@@ -9,6 +9,7 @@
 #include "Terrain/RasterTerrain.hpp"
 #include "Weather/Rasp/RaspRenderer.hpp"
 #include "Computer/GlideComputer.hpp"
+#include "Profiler/FrameProfiler.hpp"
 
 #ifdef ENABLE_OPENGL
 #include "ui/canvas/opengl/Scissor.hpp"
@@ -39,6 +40,7 @@ void
 MapWindow::SetOverlay(std::unique_ptr<MapOverlay> &&_overlay) noexcept
 {
   overlay = std::move(_overlay);
+  ++overlay_serial;
 }
 
 #endif
@@ -59,6 +61,7 @@ MapWindow::FlushCaches() noexcept
   if (rasp_renderer)
     rasp_renderer->Flush();
   airspace_renderer.Flush();
+  ground_cache.Invalidate();
 }
 
 /**
@@ -83,9 +86,12 @@ MapWindow::ReadBlackboard(const MoreData &nmea_info,
 unsigned
 MapWindow::UpdateTopography(unsigned max_update) noexcept
 {
-  if (topography != nullptr && GetMapSettings().topography_enabled)
+  if (topography != nullptr && GetMapSettings().topography_enabled) {
+    static const auto phase =
+      frame_profiler.RegisterPhase("TopographyStore::ScanVisibility");
+    const ScopeProfile profile(phase);
     return topography->ScanVisibility(visible_projection, max_update);
-  else
+  } else
     return 0;
 }
 
@@ -95,6 +101,10 @@ MapWindow::UpdateTerrain() noexcept
   if (terrain == nullptr)
     return false;
 
+  static const auto phase =
+    frame_profiler.RegisterPhase("RasterTerrain::UpdateTiles");
+  const ScopeProfile profile(phase);
+
   GeoPoint location = visible_projection.GetGeoScreenCenter();
   auto radius = visible_projection.GetScreenWidthMeters() / 2;
 
@@ -142,6 +152,8 @@ MapWindow::SetTopography(TopographyStore *_topography) noexcept
   topography_renderer = topography != nullptr
     ? new CachedTopographyRenderer(*topography, look.topography)
     : nullptr;
+
+  ground_cache.Invalidate();
 }
 
 void
@@ -149,6 +161,7 @@ MapWindow::SetTerrain(RasterTerrain *_terrain) noexcept
 {
   terrain = _terrain;
   background.SetTerrain(_terrain);
+  ground_cache.Invalidate();
 }
 
 void
@@ -156,4 +169,5 @@ MapWindow::SetRasp(const std::shared_ptr<RaspStore> &_rasp_store) noexcept
 {
   rasp_renderer.reset();
   rasp_store = _rasp_store;
+  ground_cache.Invalidate();
 }
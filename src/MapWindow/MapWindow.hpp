@@ -9,6 +9,7 @@
 #ifndef ENABLE_OPENGL
 #include "ui/canvas/BufferCanvas.hpp"
 #endif
+#include "MapLayerCache.hpp"
 #include "Renderer/LabelBlock.hpp"
 #include "Screen/StopWatch.hpp"
 #include "MapWindowBlackboard.hpp"
@@ -18,6 +19,7 @@
 #include "Renderer/TrailRenderer.hpp"
 #include "Weather/Features.hpp"
 #include "Tracking/SkyLines/Features.hpp"
+#include "util/Serial.hpp"
 
 #include <memory>
 
@@ -114,6 +116,11 @@ protected:
 
 #ifdef ENABLE_OPENGL
   std::unique_ptr<MapOverlay> overlay;
+
+  /**
+   * Incremented by SetOverlay().
+   */
+  Serial overlay_serial;
 #endif
 
   const TrafficLook &traffic_look;
@@ -126,6 +133,32 @@ protected:
 
   TrailRenderer trail_renderer;
 
+  /**
+   * Everything which determines the contents of the "ground" layers
+   * (terrain, RASP, topography and overlay) besides the projection.
+   */
+  struct GroundLayerInputs {
+    Serial terrain, rasp;
+#ifdef ENABLE_OPENGL
+    Serial overlay;
+#endif
+    unsigned topography = 0;
+    bool terrain_visible = false, rasp_visible = false;
+    bool topography_enabled = false;
+
+    bool operator==(const GroundLayerInputs &) const noexcept = default;
+  };
+
+  /**
+   * The ground layers are opaque and independent of the aircraft
+   * state, so they are rendered into this off-screen buffer and only
+   * redrawn when the projection or their #GroundLayerInputs have
+   * changed.  The layers above (airspace, task, trail, traffic, ...)
+   * are painted over a copy of it.
+   */
+  MapLayerCache ground_cache;
+  GroundLayerInputs ground_inputs;
+
   ProtectedTaskManager *task = nullptr;
   const ProtectedRoutePlanner *route_planner = nullptr;
   GlideComputer *glide_computer = nullptr;
@@ -164,7 +197,7 @@ protected:
    * The #StopWatch used to benchmark the DrawThread,
    * i.e. OnPaintBuffer().
    */
-  ScreenStopWatch draw_sw;
+  ScreenStopWatch draw_sw{"MapWindow::Render"};
 
   friend class DrawThread;
 
@@ -332,11 +365,33 @@ protected:
   void OnPaintBuffer(Canvas& canvas) noexcept override;
 
 private:
+  /**
+   * Renders the ground layers (terrain, RASP, topography and
+   * overlay), or copies them from #ground_cache if nothing has
+   * changed.
+   */
+  void RenderGround(Canvas &canvas) noexcept;
+
+  /**
+   * Prepare the terrain image.
+   *
+   * @return true if there is terrain to be drawn
+   */
+  bool GenerateTerrain() noexcept;
+
   /**
    * Renders the terrain background
    * @param canvas The drawing canvas
+   * @param visible draw the image prepared by GenerateTerrain()?
+   */
+  void RenderTerrain(Canvas &canvas, bool visible) noexcept;
+
+  /**
+   * Update the #RaspRenderer and prepare its image.
+   *
+   * @return true if RenderRasp() shall be called
    */
-  void RenderTerrain(Canvas &canvas) noexcept;
+  bool GenerateRasp() noexcept;
 
   void RenderRasp(Canvas &canvas) noexcept;
 
@@ -60,6 +60,8 @@ MapWindow::OnDestroy() noexcept
   SetTerrain(nullptr);
   SetRasp(nullptr);
 
+  ground_cache.Destroy();
+
 #ifndef ENABLE_OPENGL
   buffer_canvas.Destroy();
 #endif
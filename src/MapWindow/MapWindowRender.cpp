@@ -7,6 +7,7 @@
 #include "Weather/Rasp/RaspRenderer.hpp"
 #include "Weather/Rasp/RaspCache.hpp"
 #include "Topography/CachedTopographyRenderer.hpp"
+#include "Topography/TopographyStore.hpp"
 #include "Renderer/AircraftRenderer.hpp"
 #include "Renderer/WaveRenderer.hpp"
 #include "Operation/Operation.hpp"
@@ -24,19 +25,28 @@ MapWindow::RenderTrackBearing(Canvas &canvas,
   DrawTrackBearing(canvas, aircraft_pos, false);
 }
 
-inline void
-MapWindow::RenderTerrain(Canvas &canvas) noexcept
+inline bool
+MapWindow::GenerateTerrain() noexcept
 {
   background.SetShadingAngle(render_projection, GetMapSettings().terrain,
                              Calculated());
-  background.Draw(canvas, render_projection, GetMapSettings().terrain);
+  return background.Generate(render_projection, GetMapSettings().terrain);
 }
 
 inline void
-MapWindow::RenderRasp(Canvas &canvas) noexcept
+MapWindow::RenderTerrain(Canvas &canvas, bool visible) noexcept
+{
+  canvas.ClearWhite();
+
+  if (visible)
+    background.DrawImage(canvas, render_projection);
+}
+
+inline bool
+MapWindow::GenerateRasp() noexcept
 {
   if (rasp_store == nullptr)
-    return;
+    return false;
 
   const WeatherUIState &state = GetUIState().weather;
   if (rasp_renderer && state.map != (int)rasp_renderer->GetParameter()) {
@@ -45,10 +55,13 @@ MapWindow::RenderRasp(Canvas &canvas) noexcept
 #endif
 
     rasp_renderer.reset();
+
+    /* the new renderer's serial may collide with the old one's */
+    ground_cache.Invalidate();
   }
 
   if (state.map < 0)
-    return;
+    return false;
 
   if (!rasp_renderer) {
 #ifndef ENABLE_OPENGL
@@ -65,8 +78,13 @@ MapWindow::RenderRasp(Canvas &canvas) noexcept
   }
 
   const auto &terrain_settings = GetMapSettings().terrain;
-  if (rasp_renderer->Generate(render_projection, terrain_settings))
-    rasp_renderer->Draw(canvas, render_projection);
+  return rasp_renderer->Generate(render_projection, terrain_settings);
+}
+
+inline void
+MapWindow::RenderRasp(Canvas &canvas) noexcept
+{
+  rasp_renderer->Draw(canvas, render_projection);
 }
 
 inline void
@@ -92,6 +110,58 @@ MapWindow::RenderOverlays([[maybe_unused]] Canvas &canvas) noexcept
 #endif
 }
 
+inline void
+MapWindow::RenderGround(Canvas &canvas) noexcept
+{
+  draw_sw.Mark("GenerateTerrain");
+
+  GroundLayerInputs inputs;
+  inputs.terrain_visible = GenerateTerrain();
+  if (inputs.terrain_visible)
+    inputs.terrain = background.GetSerial();
+
+  draw_sw.Mark("GenerateRasp");
+  inputs.rasp_visible = GenerateRasp();
+  if (inputs.rasp_visible)
+    inputs.rasp = rasp_renderer->GetSerial();
+
+  inputs.topography_enabled = topography_renderer != nullptr &&
+    GetMapSettings().topography_enabled;
+  if (inputs.topography_enabled)
+    inputs.topography = topography->GetSerial();
+
+#ifdef ENABLE_OPENGL
+  inputs.overlay = overlay_serial;
+#endif
+
+  if (inputs == ground_inputs && ground_cache.Check(render_projection)) {
+    /* nothing has changed since the previous frame */
+    draw_sw.Mark("CopyGround");
+    ground_cache.CopyTo(canvas);
+    return;
+  }
+
+  ground_inputs = inputs;
+
+  Canvas &buffer = ground_cache.Begin(canvas, render_projection);
+
+  draw_sw.Mark("RenderTerrain");
+  RenderTerrain(buffer, inputs.terrain_visible);
+
+  if (inputs.rasp_visible) {
+    draw_sw.Mark("RenderRasp");
+    RenderRasp(buffer);
+  }
+
+  draw_sw.Mark("RenderTopography");
+  RenderTopography(buffer);
+
+  draw_sw.Mark("RenderOverlays");
+  RenderOverlays(buffer);
+
+  ground_cache.Commit(canvas);
+}
+
 inline void
 MapWindow::RenderFinalGlideShading(Canvas &canvas) noexcept
 {
@@ -189,17 +259,7 @@ MapWindow::Render(Canvas &canvas, const PixelRect &rc) noexcept
   //////////////////////////////////////////////// items on ground
 
   // Render terrain, groundline and topography
-  draw_sw.Mark("RenderTerrain");
-  RenderTerrain(canvas);
-
-  draw_sw.Mark("RenderRasp");
-  RenderRasp(canvas);
-
-  draw_sw.Mark("RenderTopography");
-  RenderTopography(canvas);
-
-  draw_sw.Mark("RenderOverlays");
-  RenderOverlays(canvas);
+  RenderGround(canvas);
 
   draw_sw.Mark("DrawNOAAStations");
   RenderNOAAStations(canvas);
@@ -96,14 +96,20 @@ MapWindow::DrawFLARMTraffic(Canvas &canvas,
   canvas.Select(*traffic_look.font);
 
   // Circle through the FLARM targets
-  for (const auto &traffic : flarm.list) {
-    if (!traffic.location_available)
-      continue;
-
-  // No position traffic (relative_east=0) does not make sense in map display
-    if (traffic.relative_east)
-      DrawFlarmTraffic(canvas, projection, traffic_look, false,
-                       aircraft_pos, traffic);
+  if (Basic().location_available) {
+    /* only the targets which may be visible; with many (ADS-B)
+       targets, this skips most of them */
+    const double range =
+      Basic().location.DistanceS(projection.GetGeoScreenCenter()) +
+      projection.GetScreenDistanceMeters();
+
+    flarm.VisitWithinRange(range, [&](const FlarmTraffic &traffic){
+      // No position traffic (relative_east=0) does not make sense in map display
+      if (traffic.location_available && traffic.relative_east)
+        DrawFlarmTraffic(canvas, projection, traffic_look, false,
+                         aircraft_pos, traffic);
+      return true;
+    });
   }
 
   if (const auto &fading = GetFadingFlarmTraffic(); !fading.empty()) {
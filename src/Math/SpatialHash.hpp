@@ -0,0 +1,18 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#pragma once
+
+/**
+ * Hash the coordinates of a grid cell.  The two large primes are
+ * the ones proposed by Teschner et al., "Optimized Spatial Hashing
+ * for Collision Detection of Deformable Objects" (2003); they spread
+ * neighbouring cells well over the buckets even if the bucket count
+ * is a power of two.  The caller reduces the result modulo its
+ * bucket count.
+ */
+constexpr unsigned
+SpatialHash(int x, int y) noexcept
+{
+  return unsigned(x) * 73856093u ^ unsigned(y) * 19349663u;
+}
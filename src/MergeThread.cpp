@@ -7,9 +7,13 @@
 #include "NMEA/MoreData.hpp"
 #include "Audio/VarioGlue.hpp"
 #include "Device/MultipleDevices.hpp"
+#include "Profiler/FrameProfiler.hpp"
+#include "Logger/SensorLogger.hpp"
+#include "Logger/SensorSample.hpp"
 
 MergeThread::MergeThread(DeviceBlackboard &_device_blackboard,
-                         MultipleDevices *_devices) noexcept
+                         MultipleDevices *_devices,
+                         SensorLogger *_sensor_logger) noexcept
   :WorkerThread("MergeThread",
 #ifdef KOBO
                 /* throttle more on the Kobo, because the EPaper
@@ -22,7 +26,8 @@ MergeThread::MergeThread(DeviceBlackboard &_device_blackboard,
 #endif
                 std::chrono::milliseconds{10}),
    device_blackboard(_device_blackboard),
-   devices(_devices)
+   devices(_devices),
+   sensor_logger(_sensor_logger)
 {
   last_fix.Reset();
   last_any.Reset();
@@ -50,11 +55,19 @@ MergeThread::Process() noexcept
 void
 MergeThread::Tick() noexcept
 {
+  static const auto phase = frame_profiler.RegisterPhase("MergeThread::Tick");
+  const ScopeProfile profile(phase);
+
   bool gps_updated, calculated_updated;
 
+  const bool log_sensors = sensor_logger != nullptr &&
+    sensor_logger->IsEnabled();
+  SensorLog::Sample sample;
+
 #ifdef HAVE_PCM_PLAYER
   bool vario_available;
   double vario;
+  int vario_device;
 #endif
 
   {
@@ -80,8 +93,15 @@ MergeThread::Tick() noexcept
 #ifdef HAVE_PCM_PLAYER
     vario_available = basic.brutto_vario_available;
     vario = vario_available ? basic.brutto_vario : 0;
+    vario_device = device_blackboard.GetVarioDeviceIndex();
 #endif
 
+    /* convert now, but write later, after releasing the mutex */
+    if (log_sensors && !basic.gps.replay)
+      sample = MakeSensorSample(basic);
+    else
+      sample.Clear();
+
     /* update last_any in every iteration */
     last_any = basic;
 
@@ -93,12 +113,28 @@ MergeThread::Tick() noexcept
   }
 
 #ifdef HAVE_PCM_PLAYER
-  if (vario_available)
-    AudioVarioGlue::SetValue(vario);
-  else
-    AudioVarioGlue::NoValue();
+  /* a device which provides the total energy vario feeds the audio
+     vario directly (see DeviceDescriptor::LineReceived()); this
+     thread only submits the value when switching to another source,
+     because its copy may be older than the device's latest one */
+  if (AudioVarioGlue::SelectDevice(vario_device) || vario_device < 0) {
+    if (vario_available)
+      AudioVarioGlue::SetValue(vario);
+    else
+      AudioVarioGlue::NoValue();
+  }
+
+  if (const auto latency = AudioVarioGlue::ConsumeLatency()) {
+    static const auto latency_phase =
+      frame_profiler.RegisterPhase("AudioVario::Latency");
+    frame_profiler.Record(latency_phase,
+                          FrameProfiler::Clock::now() - *latency, *latency);
+  }
 #endif
 
+  if (sample.present != 0)
+    sensor_logger->LogSample(sample);
+
   if (gps_updated)
     TriggerGPSUpdate();
 
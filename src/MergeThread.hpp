@@ -10,6 +10,7 @@
 
 class DeviceBlackboard;
 class MultipleDevices;
+class SensorLogger;
 
 /**
  * The MergeThread collects new data from the DeviceBlackboard, merges
@@ -20,6 +21,8 @@ class MergeThread final : public WorkerThread {
 
   MultipleDevices *const devices;
 
+  SensorLogger *const sensor_logger;
+
   /**
    * The previous values at the time of the last GPS fix (last
    * LocationAvailable modification).
@@ -37,7 +40,8 @@ class MergeThread final : public WorkerThread {
 
 public:
   MergeThread(DeviceBlackboard &_device_blackboard,
-              MultipleDevices *_devices) noexcept;
+              MultipleDevices *_devices,
+              SensorLogger *_sensor_logger) noexcept;
 
   /**
    * This method is called during XCSoar startup, for the initial run
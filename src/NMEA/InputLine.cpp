@@ -5,15 +5,136 @@
 #include "Units/System.hpp"
 #include "Geo/SpeedVector.hpp"
 #include "Math/Angle.hpp"
+#include "util/ByteOrder.hxx"
+#include "util/CharUtil.hxx"
+
+#include <bit>
+#include <optional>
 
 #include <string.h>
 
+/**
+ * Copy the byte into all eight bytes of a 64 bit word.
+ */
+static constexpr uint64_t
+Broadcast(uint8_t ch) noexcept
+{
+  return UINT64_C(0x0101010101010101) * ch;
+}
+
+/**
+ * Returns a mask with the most significant bit set in each byte of
+ * the word which equals the given character.  Unlike the well-known
+ * "haszero()" trick, this one has no false positives.
+ */
+static constexpr uint64_t
+MatchBytes(uint64_t word, uint8_t ch) noexcept
+{
+  constexpr uint64_t low7 = Broadcast(0x7f);
+  const uint64_t x = word ^ Broadcast(ch);
+  return ~(((x & low7) + low7) | x | low7);
+}
+
+/**
+ * XOR all bytes of the word.
+ */
+static constexpr uint8_t
+FoldXor(uint64_t word) noexcept
+{
+  word ^= word >> 32;
+  word ^= word >> 16;
+  word ^= word >> 8;
+  return static_cast<uint8_t>(word);
+}
+
+static_assert(MatchBytes(0x2c002c2a2c2c412c, ',') == 0x8000800080800080);
+static_assert(FoldXor(0x0102040810204080) == 0xff);
+
+[[gnu::pure]]
+static std::optional<uint8_t>
+ParseChecksum(std::string_view s) noexcept
+{
+  if (s.empty())
+    return std::nullopt;
+
+  unsigned value = 0;
+  for (const char ch : s) {
+    if (IsDigitASCII(ch))
+      value = value * 16 + (ch - '0');
+    else if (ch >= 'a' && ch <= 'f')
+      value = value * 16 + (ch - 'a' + 10);
+    else if (ch >= 'A' && ch <= 'F')
+      value = value * 16 + (ch - 'A' + 10);
+    else
+      return std::nullopt;
+
+    if (value >= 0x100)
+      return std::nullopt;
+  }
+
+  return value;
+}
+
 NMEAInputLine::NMEAInputLine(const char* line) noexcept
   :CSVLine(line)
 {
-  const char* asterisk = strchr(line, '*');
-  if (asterisk != NULL)
-    end = asterisk;
+  const std::size_t length = end - start;
+  std::size_t i = 0;
+
+  /* the checksum does not include the dollar sign (or the
+     exclamation mark used by CAI302) */
+  if (length > 0 && (start[0] == '$' || start[0] == '!'))
+    i = 1;
+
+  bool complete = true;
+
+  /* fast path: process eight bytes at a time until the first
+     asterisk */
+  uint64_t xor_words = 0;
+  for (; i + sizeof(uint64_t) <= length; i += sizeof(uint64_t)) {
+    uint64_t word;
+    memcpy(&word, start + i, sizeof(word));
+    word = FromLE64(word);
+
+    if (MatchBytes(word, '*') != 0)
+      break;
+
+    xor_words ^= word;
+
+    for (uint64_t commas = MatchBytes(word, ','); commas != 0;
+         commas &= commas - 1)
+      complete &= AddSeparator(i + std::countr_zero(commas) / 8);
+  }
+
+  /* the rest (usually just the checksum) byte by byte; the checksum
+     is the one after the last asterisk, but columns end at the first
+     one */
+  uint8_t checksum = FoldXor(xor_words);
+  const char *first_asterisk = nullptr, *last_asterisk = nullptr;
+  uint8_t expected_checksum = 0;
+
+  for (; i < length; ++i) {
+    const char ch = start[i];
+    if (ch == '*') {
+      if (first_asterisk == nullptr)
+        first_asterisk = start + i;
+      last_asterisk = start + i;
+      expected_checksum = checksum;
+    } else if (ch == ',' && first_asterisk == nullptr)
+      complete &= AddSeparator(i);
+
+    checksum ^= static_cast<uint8_t>(ch);
+  }
+
+  separators_complete = complete;
+
+  if (first_asterisk != nullptr)
+    end = first_asterisk;
+
+  if (last_asterisk != nullptr) {
+    const auto received = ParseChecksum({last_asterisk + 1, start + length});
+    checksum_valid = received && *received == expected_checksum;
+  }
 }
 
 bool
@@ -10,11 +10,26 @@ class Angle;
 
 /**
  * A helper class which can dissect a NMEA input line.
+ *
+ * The constructor scans the line once, eight bytes at a time: it
+ * calculates the checksum and records the positions of all commas,
+ * so reading a column does not need to search for its end.
  */
 class NMEAInputLine: public CSVLine {
+  bool checksum_valid = false;
+
 public:
   explicit NMEAInputLine(const char* line) noexcept;
 
+  /**
+   * Does the line end with an asterisk followed by a checksum which
+   * matches the line contents?  This is equivalent to
+   * VerifyNMEAChecksum(), but without another pass over the line.
+   */
+  bool IsChecksumValid() const noexcept {
+    return checksum_valid;
+  }
+
   /**
    * Parses non-negative floating-point angle value in degrees.
    */
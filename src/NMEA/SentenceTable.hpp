@@ -0,0 +1,96 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+/**
+ * A table which maps NMEA sentence names to handlers.  It is built
+ * at compile time with a perfect hash function, so looking up a
+ * sentence costs one hash and one string comparison, independent of
+ * the number of entries.
+ *
+ * @param Handler the handler type, usually a function pointer
+ * @param N the number of entries
+ */
+template<typename Handler, std::size_t N>
+class NMEASentenceTable {
+  static_assert(N > 0 && N < 0x80);
+
+public:
+  struct Entry {
+    std::string_view name;
+    Handler handler;
+  };
+
+private:
+  static constexpr std::size_t SIZE = std::bit_ceil(N * 2);
+
+  std::array<Entry, N> entries;
+
+  /**
+   * Maps the hash to an index into #entries plus one; zero means the
+   * slot is empty.
+   */
+  std::array<uint_least8_t, SIZE> slots{};
+
+  uint_least32_t seed = 0;
+
+  static constexpr uint_least32_t Hash(std::string_view name,
+                                       uint_least32_t seed) noexcept {
+    /* FNV-1a, with the seed mixed into the offset basis */
+    uint_least32_t hash = 2166136261u ^ seed;
+    for (const char ch : name)
+      hash = (hash ^ static_cast<uint_least8_t>(ch)) * 16777619u;
+    return hash ^ (hash >> 15);
+  }
+
+  constexpr bool TryBuild(uint_least32_t _seed) noexcept {
+    slots = {};
+
+    for (std::size_t i = 0; i < N; ++i) {
+      auto &slot = slots[Hash(entries[i].name, _seed) & (SIZE - 1)];
+      if (slot != 0)
+        return false;
+
+      slot = i + 1;
+    }
+
+    seed = _seed;
+    return true;
+  }
+
+public:
+  consteval NMEASentenceTable(const std::array<Entry, N> &_entries)
+    :entries(_entries) {
+    for (uint_least32_t s = 0;; ++s) {
+      /* no seed found: this throw makes compilation fail */
+      if (s > 0x10000)
+        throw "No perfect hash found";
+
+      if (TryBuild(s))
+        break;
+    }
+  }
+
+  /**
+   * Look up a handler.
+   *
+   * @return the handler or nullptr if this sentence name is not
+   * known
+   */
+  [[gnu::pure]]
+  constexpr const Handler *Find(std::string_view name) const noexcept {
+    const auto slot = slots[Hash(name, seed) & (SIZE - 1)];
+    if (slot == 0)
+      return nullptr;
+
+    const auto &entry = entries[slot - 1];
+    return entry.name == name ? &entry.handler : nullptr;
+  }
+};
@@ -49,6 +49,7 @@ Profile::Load(const ProfileMap &map, LoggerSettings &settings)
 {
   map.Get(ProfileKeys::LoggerTimeStepCruise, settings.time_step_cruise);
   map.Get(ProfileKeys::LoggerTimeStepCircling, settings.time_step_circling);
+  map.Get(ProfileKeys::LoggerSyncInterval, settings.sync_interval);
 
   if (!map.GetEnum(ProfileKeys::AutoLogger, settings.auto_logger)) {
     // Legacy
@@ -65,6 +66,7 @@ Profile::Load(const ProfileMap &map, LoggerSettings &settings)
   map.Get(ProfileKeys::CrewWeightTemplate, settings.crew_mass_template);
   map.Get(ProfileKeys::EnableFlightLogger, settings.enable_flight_logger);
   map.Get(ProfileKeys::EnableNMEALogger, settings.enable_nmea_logger);
+  map.GetEnum(ProfileKeys::SensorLogger, settings.sensor_log_mode);
 }
 
 void
@@ -176,6 +176,7 @@ constexpr std::string_view EnableNavBaroAltitude = "EnableNavBaroAltitude";
 
 constexpr std::string_view LoggerTimeStepCruise = "LoggerTimeStepCruise";
 constexpr std::string_view LoggerTimeStepCircling = "LoggerTimeStepCircling";
+constexpr std::string_view LoggerSyncInterval = "LoggerSyncInterval";
 
 constexpr std::string_view SafetyMacCready = "SafetyMacCready";
 constexpr std::string_view AbortTaskMode = "AbortTaskMode";
@@ -209,6 +210,7 @@ constexpr std::string_view AutoLogger = "AutoLogger";
 constexpr std::string_view DisableAutoLogger = "DisableAutoLogger";
 constexpr std::string_view EnableFlightLogger = "EnableFlightLogger";
 constexpr std::string_view EnableNMEALogger = "EnableNMEALogger";
+constexpr std::string_view SensorLogger = "SensorLogger";
 constexpr std::string_view MapFile = "MapFile"; // pL
 constexpr std::string_view BallastSecsToEmpty = "BallastSecsToEmpty";
 constexpr std::string_view DialogFont = "DialogFont";
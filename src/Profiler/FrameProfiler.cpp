@@ -0,0 +1,211 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#include "FrameProfiler.hpp"
+#include "io/BufferedOutputStream.hxx"
+#include "io/FileOutputStream.hxx"
+#include "system/Path.hpp"
+#include "util/StringAPI.hxx"
+
+#include <algorithm>
+#include <atomic>
+
+FrameProfiler frame_profiler;
+
+/**
+ * Returns a small number identifying the calling thread, for the
+ * "tid" attribute of trace events.
+ */
+static unsigned
+GetThreadNumber() noexcept
+{
+  static std::atomic<unsigned> next_thread_number{1};
+  thread_local const unsigned thread_number = next_thread_number++;
+  return thread_number;
+}
+
+FrameProfiler::FrameProfiler() noexcept = default;
+FrameProfiler::~FrameProfiler() noexcept = default;
+
+void
+FrameProfiler::EnableTrace() noexcept
+{
+  const std::lock_guard lock{events_mutex};
+
+  if (!events) {
+    events = std::make_unique<Event[]>(MAX_EVENTS);
+    trace_enabled.store(true, std::memory_order_relaxed);
+  }
+}
+
+FrameProfiler::PhaseId
+FrameProfiler::RegisterPhase(const char *name) noexcept
+{
+  const std::lock_guard lock{register_mutex};
+
+  const unsigned n = n_phases.load(std::memory_order_relaxed);
+  for (unsigned i = 0; i < n; ++i)
+    if (StringIsEqual(phases[i].name, name))
+      return i;
+
+  if (n >= MAX_PHASES)
+    return INVALID_PHASE;
+
+  phases[n].name = name;
+  n_phases.store(n + 1, std::memory_order_release);
+  return n;
+}
+
+void
+FrameProfiler::Record(PhaseId id, Clock::time_point start,
+                      Clock::duration duration) noexcept
+{
+  using std::chrono::duration_cast;
+  using std::chrono::microseconds;
+
+  if (id >= MAX_PHASES)
+    return;
+
+  const uint_least32_t us = std::min<microseconds::rep>(
+    duration_cast<microseconds>(duration).count(), UINT32_MAX);
+
+  Phase &phase = phases[id];
+
+  {
+    const std::lock_guard lock{phase.mutex};
+    phase.histogram.Add(us);
+  }
+
+  if (trace_enabled.load(std::memory_order_relaxed)) {
+    const std::lock_guard lock{events_mutex};
+
+    Event &e = events[next_event];
+    next_event = (next_event + 1) % MAX_EVENTS;
+    if (n_events < MAX_EVENTS)
+      ++n_events;
+
+    e.phase = id;
+    e.start = duration_cast<microseconds>(start - origin).count();
+    e.duration = us;
+    e.thread = GetThreadNumber();
+  }
+}
+
+FrameProfiler::SummaryList
+FrameProfiler::GetSummaries() const noexcept
+{
+  SummaryList result;
+
+  const unsigned n = n_phases.load(std::memory_order_acquire);
+  for (unsigned i = 0; i < n; ++i) {
+    const Phase &phase = phases[i];
+    const std::lock_guard lock{phase.mutex};
+    result.append({phase.name, phase.histogram.GetSummary()});
+  }
+
+  return result;
+}
+
+/**
+ * Write a JSON string literal, escaping quotes, backslashes and
+ * control characters.
+ */
+static void
+WriteJSONString(BufferedOutputStream &os, const char *s)
+{
+  os.Write('"');
+
+  for (; *s != 0; ++s) {
+    const char ch = *s;
+    if (ch == '"' || ch == '\\') {
+      os.Write('\\');
+      os.Write(ch);
+    } else if ((unsigned char)ch < 0x20)
+      os.Fmt("\\u{:04x}", (unsigned)ch);
+    else
+      os.Write(ch);
+  }
+
+  os.Write('"');
+}
+
+static void
+WritePhases(BufferedOutputStream &os,
+            const FrameProfiler::SummaryList &summaries)
+{
+  os.Write('{');
+
+  bool first = true;
+  for (const auto &i : summaries) {
+    if (!first)
+      os.Write(',');
+    first = false;
+
+    WriteJSONString(os, i.name);
+
+    const auto &h = i.histogram;
+    os.Fmt(":{{\"count\":{},\"p50_us\":{},\"p95_us\":{},"
+           "\"p99_us\":{},\"max_us\":{}}}",
+           h.count, h.p50, h.p95, h.p99, h.max);
+  }
+
+  os.Write('}');
+}
+
+void
+FrameProfiler::WriteJSON(BufferedOutputStream &os) const
+{
+  os.Write("{\"phases\":");
+  WritePhases(os, GetSummaries());
+  os.Write("}\n");
+}
+
+void
+FrameProfiler::WriteChromeTrace(BufferedOutputStream &os) const
+{
+  const auto summaries = GetSummaries();
+
+  os.Write("{\"traceEvents\":[");
+
+  {
+    const std::lock_guard lock{events_mutex};
+
+    /* oldest event first */
+    const unsigned first = (next_event + MAX_EVENTS - n_events) % MAX_EVENTS;
+    for (unsigned i = 0; i < n_events; ++i) {
+      const Event &e = events[(first + i) % MAX_EVENTS];
+      if (i > 0)
+        os.Write(',');
+      os.Write("\n{\"name\":");
+      WriteJSONString(os, phases[e.phase].name);
+      os.Fmt(",\"ph\":\"X\",\"ts\":{},\"dur\":{},"
+             "\"pid\":1,\"tid\":{}}}",
+             e.start, e.duration, e.thread);
+    }
+  }
+
+  os.Write("\n],\"displayTimeUnit\":\"ms\",\"phases\":");
+  WritePhases(os, summaries);
+  os.Write("}\n");
+}
+
+bool
+FrameProfiler::IsTracePath(Path path) noexcept
+{
+  return path.EndsWithIgnoreCase(".trace.json");
+}
+
+void
+FrameProfiler::Save(Path path) const
+{
+  FileOutputStream file(path);
+  BufferedOutputStream os(file);
+
+  if (IsTracePath(path))
+    WriteChromeTrace(os);
+  else
+    WriteJSON(os);
+
+  os.Flush();
+  file.Commit();
+}
@@ -0,0 +1,215 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#pragma once
+
+#include "RollingHistogram.hpp"
+#include "thread/Mutex.hxx"
+#include "util/StaticArray.hxx"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+
+class BufferedOutputStream;
+class Path;
+
+/**
+ * Collects timing samples of named phases (map render layers,
+ * calculation ticks, terrain/topography loads) from all threads.
+ * It keeps a rolling histogram for each phase, and optionally a ring
+ * buffer of individual events which can be exported in the Chrome
+ * trace format.
+ *
+ * Each call site registers its phase once with RegisterPhase() and
+ * then records samples with the returned #PhaseId, which needs no
+ * lookup and locks only that phase.
+ */
+class FrameProfiler {
+public:
+  using Clock = std::chrono::steady_clock;
+
+  static constexpr unsigned MAX_PHASES = 64;
+
+  /**
+   * Identifies a phase registered with RegisterPhase().
+   */
+  using PhaseId = unsigned;
+
+  /**
+   * Returned by RegisterPhase() if there are too many phases;
+   * Record() ignores samples with this id.
+   */
+  static constexpr PhaseId INVALID_PHASE = MAX_PHASES;
+
+  /**
+   * The number of samples per phase in the percentile window.
+   */
+  static constexpr unsigned WINDOW = 256;
+
+  /**
+   * The number of events kept for the trace.
+   */
+  static constexpr unsigned MAX_EVENTS = 16384;
+
+  struct PhaseSummary {
+    const char *name;
+
+    /**
+     * Durations in microseconds.
+     */
+    RollingHistogram<WINDOW>::Summary histogram;
+  };
+
+  using SummaryList = StaticArray<PhaseSummary, MAX_PHASES>;
+
+private:
+  struct Phase {
+    const char *name;
+
+    /**
+     * Protects #histogram.
+     */
+    mutable Mutex mutex;
+
+    RollingHistogram<WINDOW> histogram;
+  };
+
+  struct Event {
+    PhaseId phase;
+
+    /**
+     * Start time and duration in microseconds, relative to #origin.
+     */
+    uint_least64_t start;
+    uint_least32_t duration;
+
+    unsigned thread;
+  };
+
+  const Clock::time_point origin = Clock::now();
+
+  /**
+   * Serialises RegisterPhase() calls.
+   */
+  Mutex register_mutex;
+
+  std::array<Phase, MAX_PHASES> phases;
+
+  /**
+   * The number of initialised elements in #phases.  It is only
+   * incremented (with "release" semantics) after the new element has
+   * been initialised.
+   */
+  std::atomic<unsigned> n_phases{0};
+
+  /**
+   * Protects #events, #n_events and #next_event.
+   */
+  mutable Mutex events_mutex;
+
+  /**
+   * Was EnableTrace() called?  Allows Record() to skip
+   * #events_mutex if not.
+   */
+  std::atomic_bool trace_enabled{false};
+
+  /**
+   * Ring buffer of events; only allocated if EnableTrace() was
+   * called.
+   */
+  std::unique_ptr<Event[]> events;
+  unsigned n_events = 0, next_event = 0;
+
+public:
+  FrameProfiler() noexcept;
+  ~FrameProfiler() noexcept;
+
+  FrameProfiler(const FrameProfiler &) = delete;
+  FrameProfiler &operator=(const FrameProfiler &) = delete;
+
+  /**
+   * Start recording individual events for WriteChromeTrace().
+   */
+  void EnableTrace() noexcept;
+
+  /**
+   * Look up the phase with the given name, and create it if it does
+   * not exist yet.  Call sites with the same name share one phase.
+   * This method is thread-safe, but it is slow; call it only once
+   * per call site.
+   *
+   * @param name the name of the phase; must be a string literal
+   * @return the phase id or #INVALID_PHASE if there are too many
+   * phases
+   */
+  PhaseId RegisterPhase(const char *name) noexcept;
+
+  /**
+   * Add a sample.  This method is thread-safe.
+   */
+  void Record(PhaseId phase, Clock::time_point start,
+              Clock::duration duration) noexcept;
+
+  [[gnu::pure]]
+  SummaryList GetSummaries() const noexcept;
+
+  /**
+   * Write the histograms of all phases as a JSON object.
+   */
+  void WriteJSON(BufferedOutputStream &os) const;
+
+  /**
+   * Write the recorded events in the Chrome trace event format (JSON
+   * object format), which can be loaded by chrome://tracing and
+   * Perfetto.  The histograms are included as an extra attribute.
+   */
+  void WriteChromeTrace(BufferedOutputStream &os) const;
+
+  /**
+   * Shall Save() write the Chrome trace format to this file?  That
+   * is the case if the name ends with ".trace.json".
+   */
+  [[gnu::pure]]
+  static bool IsTracePath(Path path) noexcept;
+
+  /**
+   * Write WriteJSON() or (if IsTracePath()) WriteChromeTrace() to a
+   * file.
+   *
+   * Throws on error.
+   */
+  void Save(Path path) const;
+};
+
+/**
+ * The profiler used by XCSoar's threads.
+ */
+extern FrameProfiler frame_profiler;
+
+/**
+ * Measures the lifetime of this object and records it in
+ * #frame_profiler.  Usage:
+ *
+ *   static const auto phase = frame_profiler.RegisterPhase("Foo");
+ *   const ScopeProfile profile(phase);
+ */
+class ScopeProfile {
+  const FrameProfiler::PhaseId phase;
+  const FrameProfiler::Clock::time_point start;
+
+public:
+  [[nodiscard]]
+  explicit ScopeProfile(FrameProfiler::PhaseId _phase) noexcept
+    :phase(_phase), start(FrameProfiler::Clock::now()) {}
+
+  ~ScopeProfile() noexcept {
+    frame_profiler.Record(phase, start,
+                          FrameProfiler::Clock::now() - start);
+  }
+
+  ScopeProfile(const ScopeProfile &) = delete;
+  ScopeProfile &operator=(const ScopeProfile &) = delete;
+};
@@ -0,0 +1,90 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+
+/**
+ * Remembers the last #N samples of a duration and calculates
+ * percentiles over them.  Adding a sample is O(1); the percentiles
+ * are only calculated on demand.
+ */
+template<unsigned N>
+class RollingHistogram {
+  static_assert(N > 0);
+
+  std::array<uint_least32_t, N> samples;
+
+  /**
+   * The number of valid elements in #samples.
+   */
+  unsigned size = 0;
+
+  /**
+   * The position in #samples which will be overwritten next.
+   */
+  unsigned next = 0;
+
+  /**
+   * The number of samples ever added, including those which have
+   * already been overwritten.
+   */
+  uint_least64_t total = 0;
+
+public:
+  struct Summary {
+    /**
+     * The number of samples ever added.
+     */
+    uint_least64_t count;
+
+    uint_least32_t p50, p95, p99, max;
+  };
+
+  bool empty() const noexcept {
+    return size == 0;
+  }
+
+  void Clear() noexcept {
+    size = next = 0;
+    total = 0;
+  }
+
+  void Add(uint_least32_t value) noexcept {
+    samples[next] = value;
+    next = (next + 1) % N;
+    if (size < N)
+      ++size;
+    ++total;
+  }
+
+  /**
+   * Calculate the percentiles of the samples in the window, using
+   * the "nearest rank" method.
+   */
+  [[gnu::pure]]
+  Summary GetSummary() const noexcept {
+    Summary s{total, 0, 0, 0, 0};
+    if (size == 0)
+      return s;
+
+    std::array<uint_least32_t, N> sorted;
+    std::copy_n(samples.begin(), size, sorted.begin());
+    std::sort(sorted.begin(), sorted.begin() + size);
+
+    const auto rank = [&sorted, n = size](unsigned percent){
+      /* ceil(percent / 100 * n), one-based */
+      const unsigned r = (percent * n + 99) / 100;
+      return sorted[r > 0 ? r - 1 : 0];
+    };
+
+    s.p50 = rank(50);
+    s.p95 = rank(95);
+    s.p99 = rank(99);
+    s.max = sorted[size - 1];
+    return s;
+  }
+};
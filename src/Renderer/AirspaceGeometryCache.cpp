@@ -0,0 +1,155 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#ifdef ENABLE_OPENGL
+
+#include "AirspaceGeometryCache.hpp"
+#include "Engine/Airspace/Airspaces.hpp"
+#include "Engine/Airspace/AbstractAirspace.hpp"
+#include "ui/canvas/Pen.hpp"
+#include "ui/canvas/opengl/Buffer.hpp"
+#include "ui/canvas/opengl/Geo.hpp"
+#include "ui/canvas/opengl/Shaders.hpp"
+#include "ui/canvas/opengl/Program.hpp"
+#include "ui/canvas/opengl/Triangulate.hpp"
+#include "ui/canvas/opengl/VertexPointer.hpp"
+
+#include <glm/gtc/type_ptr.hpp>
+
+#include <cassert>
+
+AirspaceGeometryCache::AirspaceGeometryCache() noexcept = default;
+AirspaceGeometryCache::~AirspaceGeometryCache() noexcept = default;
+
+void
+AirspaceGeometryCache::Update(const Airspaces &airspaces) noexcept
+{
+  if (buffer == nullptr)
+    buffer = std::make_unique<GLArrayBuffer>();
+  else if (airspaces.GetSerial() == serial)
+    return;
+
+  serial = airspaces.GetSerial();
+  polygons.clear();
+  vertices.clear();
+
+  for (const auto &i : airspaces.QueryAll()) {
+    const AbstractAirspace &airspace = i.GetAirspace();
+    if (airspace.GetShape() != AbstractAirspace::Shape::POLYGON)
+      continue;
+
+    const auto &points = airspace.GetPoints();
+    if (points.size() < 3 || points.size() >= 0x10000)
+      /* GLushort indices cannot address more vertices; this
+         airspace will be drawn the traditional way */
+      continue;
+
+    Polygon &polygon = polygons[&airspace];
+    polygon.reference = airspace.GetReferenceLocation();
+    polygon.offset = vertices.size();
+    polygon.n_vertices = points.size();
+
+    for (const auto &p : points) {
+      const GeoPoint delta = p.GetLocation() - polygon.reference;
+      vertices.emplace_back(delta.longitude.Native(),
+                            delta.latitude.Native());
+    }
+  }
+
+  buffer->Load(vertices.size() * sizeof(vertices.front()), vertices.data());
+}
+
+bool
+AirspaceGeometryCache::Prepare(const AbstractAirspace &airspace) noexcept
+{
+  const auto i = polygons.find(&airspace);
+  if (i == polygons.end())
+    return false;
+
+  Polygon &polygon = i->second;
+  if (!polygon.triangulated) {
+    polygon.triangulated = true;
+
+    polygon.triangles.resize(3 * (polygon.n_vertices - 2));
+    const unsigned n = PolygonToTriangles(vertices.data() + polygon.offset,
+                                          polygon.n_vertices,
+                                          polygon.triangles.data(), 0);
+    polygon.triangles.resize(n);
+    polygon.triangles.shrink_to_fit();
+  }
+
+  return !polygon.triangles.empty();
+}
+
+inline const AirspaceGeometryCache::Polygon &
+AirspaceGeometryCache::Get(const AbstractAirspace &airspace) const noexcept
+{
+  const auto i = polygons.find(&airspace);
+  assert(i != polygons.end());
+  assert(!i->second.triangles.empty());
+  return i->second;
+}
+
+/**
+ * Set up the OpenGL state for drawing one cached polygon, and restore
+ * it afterwards.
+ */
+class ScopeCachedPolygon {
+  ScopeVertexPointer vp;
+
+public:
+  ScopeCachedPolygon(GLArrayBuffer &buffer,
+                     const Projection &projection,
+                     const GeoPoint &reference, unsigned offset) noexcept {
+    OpenGL::solid_shader->Use();
+
+    glUniformMatrix4fv(OpenGL::solid_modelview, 1, GL_FALSE,
+                       glm::value_ptr(ToGLM(projection, reference)));
+
+    buffer.Bind();
+    const FloatPoint2D *const base = nullptr;
+    vp.Update(base + offset);
+  }
+
+  ~ScopeCachedPolygon() noexcept {
+    GLArrayBuffer::Unbind();
+
+    glUniformMatrix4fv(OpenGL::solid_modelview, 1, GL_FALSE,
+                       glm::value_ptr(glm::mat4(1)));
+  }
+
+  ScopeCachedPolygon(const ScopeCachedPolygon &) = delete;
+  ScopeCachedPolygon &operator=(const ScopeCachedPolygon &) = delete;
+};
+
+void
+AirspaceGeometryCache::DrawFill(const Projection &projection,
+                                const AbstractAirspace &airspace,
+                                Color color) const noexcept
+{
+  const Polygon &polygon = Get(airspace);
+  const ScopeCachedPolygon scope(*buffer, projection,
+                                 polygon.reference, polygon.offset);
+
+  color.Bind();
+  glDrawElements(GL_TRIANGLES, polygon.triangles.size(), GL_UNSIGNED_SHORT,
+                 polygon.triangles.data());
+}
+
+void
+AirspaceGeometryCache::DrawOutline(const Projection &projection,
+                                   const AbstractAirspace &airspace,
+                                   const Pen &pen) const noexcept
+{
+  assert(pen.GetWidth() <= 2);
+
+  const Polygon &polygon = Get(airspace);
+  const ScopeCachedPolygon scope(*buffer, projection,
+                                 polygon.reference, polygon.offset);
+
+  pen.Bind();
+  glDrawArrays(GL_LINE_LOOP, 0, polygon.n_vertices);
+  pen.Unbind();
+}
+
+#endif /* ENABLE_OPENGL */
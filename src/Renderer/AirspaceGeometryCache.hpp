@@ -0,0 +1,103 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#pragma once
+
+#include "Geo/GeoPoint.hpp"
+#include "Math/Point2D.hpp"
+#include "ui/opengl/System.hpp"
+#include "util/Serial.hpp"
+
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+class AbstractAirspace;
+class Airspaces;
+class GLArrayBuffer;
+class Projection;
+class Pen;
+class Color;
+
+/**
+ * Keeps the borders of all polygon airspaces in an OpenGL vertex
+ * buffer and caches their triangulation.  The vertices are stored
+ * relative to the airspace's reference location and projected by the
+ * vertex shader (see ToGLM()), just like #TopographyFileRenderer
+ * does, so panning and zooming does not touch them on the CPU.
+ */
+class AirspaceGeometryCache {
+  struct Polygon {
+    GeoPoint reference;
+
+    /**
+     * The position of the first vertex in the vertex buffer.
+     */
+    unsigned offset;
+
+    unsigned n_vertices;
+
+    /**
+     * Triangle indices relative to #offset; empty if
+     * triangulation has not been attempted yet or has failed.
+     */
+    std::vector<GLushort> triangles;
+
+    bool triangulated = false;
+  };
+
+  std::unique_ptr<GLArrayBuffer> buffer;
+
+  /**
+   * A copy of the vertices in the buffer, used for the
+   * triangulation.
+   */
+  std::vector<FloatPoint2D> vertices;
+
+  std::unordered_map<const AbstractAirspace *, Polygon> polygons;
+
+  Serial serial;
+
+public:
+  AirspaceGeometryCache() noexcept;
+  ~AirspaceGeometryCache() noexcept;
+
+  AirspaceGeometryCache(const AirspaceGeometryCache &) = delete;
+  AirspaceGeometryCache &operator=(const AirspaceGeometryCache &) = delete;
+
+  /**
+   * Rebuild the vertex buffer if the #Airspaces object has been
+   * modified since the last call.
+   */
+  void Update(const Airspaces &airspaces) noexcept;
+
+  /**
+   * Prepare the specified airspace for DrawFill() and
+   * DrawOutline().  The triangulation is done only on the first
+   * call.
+   *
+   * @return false if the airspace cannot be drawn from the cache
+   * (not a polygon, too many vertices or triangulation failed)
+   */
+  bool Prepare(const AbstractAirspace &airspace) noexcept;
+
+  /**
+   * Fill the airspace with the specified color.  Prepare() must
+   * have returned true.
+   */
+  void DrawFill(const Projection &projection,
+                const AbstractAirspace &airspace,
+                Color color) const noexcept;
+
+  /**
+   * Draw the outline of the airspace with a thin (up to 2 pixels)
+   * pen.  Prepare() must have returned true.
+   */
+  void DrawOutline(const Projection &projection,
+                   const AbstractAirspace &airspace,
+                   const Pen &pen) const noexcept;
+
+private:
+  [[gnu::pure]]
+  const Polygon &Get(const AbstractAirspace &airspace) const noexcept;
+};
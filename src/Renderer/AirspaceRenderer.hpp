@@ -7,7 +7,9 @@
 #include "util/StaticArray.hxx"
 #include "Geo/GeoPoint.hpp"
 
-#ifndef ENABLE_OPENGL
+#ifdef ENABLE_OPENGL
+#include "AirspaceGeometryCache.hpp"
+#else
 #include "TransparentRendererCache.hpp"
 #include "util/Serial.hpp"
 #endif
@@ -32,7 +34,13 @@ class AirspaceRenderer
 
   StaticArray<GeoPoint,32> intersections;
 
-#ifndef ENABLE_OPENGL
+#ifdef ENABLE_OPENGL
+  /**
+   * The airspace polygons in a vertex buffer object, so they don't
+   * need to be projected and triangulated on the CPU each frame.
+   */
+  AirspaceGeometryCache geometry;
+#else
   /**
    * This object caches the airspace fill.  This avoids drawing it
    * again and again each frame when nothing has changed.
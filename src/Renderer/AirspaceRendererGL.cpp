@@ -19,17 +19,22 @@
 class AirspaceVisitorRenderer final
   : protected MapCanvas
 {
+  AirspaceGeometryCache &geometry;
   const AirspaceLook &look;
   const AirspaceWarningCopy &warning_manager;
   const AirspaceRendererSettings &settings;
 
+  const Pen black_pen{1, COLOR_BLACK};
+
 public:
   AirspaceVisitorRenderer(Canvas &_canvas, const WindowProjection &_projection,
+                          AirspaceGeometryCache &_geometry,
                           const AirspaceLook &_look,
                           const AirspaceWarningCopy &_warnings,
                           const AirspaceRendererSettings &_settings)
     :MapCanvas(_canvas, _projection,
                _projection.GetScreenBounds().Scale(1.1)),
+     geometry(_geometry),
      look(_look), warning_manager(_warnings), settings(_settings)
   {
     glStencilMask(0xff);
@@ -82,8 +87,18 @@ private:
 
   void VisitPolygon(const AirspacePolygon &airspace) {
 	AirspaceClass as_type_or_class = settings.classes[airspace.GetTypeOrClass()].display ? airspace.GetTypeOrClass() : airspace.GetClass();
-    if (!PreparePolygon(airspace.GetPoints()))
-      return;
+
+    /* draw from the vertex buffer if possible; PreparePolygon() is
+       only needed for the thick lines which are converted to
+       triangles in screen coordinates */
+    const bool cached = geometry.Prepare(airspace);
+    bool prepared = false;
+    if (!cached) {
+      if (!PreparePolygon(airspace.GetPoints()))
+        return;
+
+      prepared = true;
+    }
 
     const AirspaceClassRendererSettings &class_settings =
       settings.classes[as_type_or_class];
@@ -99,6 +114,9 @@ private:
       const GLEnable<GL_STENCIL_TEST> stencil;
 
       if (!fill_airspace) {
+        if (!prepared && !(prepared = PreparePolygon(airspace.GetPoints())))
+          return;
+
         // set stencil for filling (bit 0)
         SetFillStencil();
         DrawPrepared();
@@ -109,7 +127,11 @@ private:
       {
         SetupInterior(airspace, !fill_airspace);
         const GLEnable<GL_BLEND> blend;
-        DrawPrepared();
+        if (cached)
+          geometry.DrawFill(projection, airspace,
+                            GetFillColor(airspace));
+        else
+          DrawPrepared();
       }
 
       if (!fill_airspace) {
@@ -121,8 +143,12 @@ private:
     }
 
     // draw outline
-    if (SetupOutline(airspace))
-      DrawPrepared();
+    if (const Pen *pen = SetupOutline(airspace)) {
+      if (cached && pen->GetWidth() <= 2)
+        geometry.DrawOutline(projection, airspace, *pen);
+      else if (prepared || PreparePolygon(airspace.GetPoints()))
+        DrawPrepared();
+    }
   }
 
 public:
@@ -139,17 +165,23 @@ public:
   }
 
 private:
-  bool SetupOutline(const AbstractAirspace &airspace) {
+  /**
+   * @return the outline pen (which has been selected) or nullptr if
+   * no outline shall be drawn
+   */
+  const Pen *SetupOutline(const AbstractAirspace &airspace) {
     AirspaceClass as_type_or_class = settings.classes[airspace.GetTypeOrClass()].display ? airspace.GetTypeOrClass() : airspace.GetClass();
 
+    const Pen *pen;
     if (settings.black_outline)
-      canvas.SelectBlackPen();
+      pen = &black_pen;
     else if (settings.classes[as_type_or_class].border_width == 0)
       // Don't draw outlines if border_width == 0
-      return false;
+      return nullptr;
     else
-      canvas.Select(look.classes[as_type_or_class].border_pen);
+      pen = &look.classes[as_type_or_class].border_pen;
 
+    canvas.Select(*pen);
     canvas.SelectHollowBrush();
 
     // set bit 1 in stencil buffer, where an outline is drawn
@@ -157,14 +189,18 @@ private:
     glStencilMask(2);
     glStencilOp(GL_KEEP, GL_KEEP, GL_REPLACE);
 
-    return true;
+    return pen;
   }
 
-  void SetupInterior(const AbstractAirspace &airspace,
-                     bool check_fillstencil = false) {
+  Color GetFillColor(const AbstractAirspace &airspace) const {
 	AirspaceClass as_type_or_class = settings.classes[airspace.GetTypeOrClass()].display ? airspace.GetTypeOrClass() : airspace.GetClass();
     const AirspaceClassLook &class_look = look.classes[as_type_or_class];
 
+    return class_look.fill_color.WithAlpha(90);
+  }
+
+  void SetupInterior(const AbstractAirspace &airspace,
+                     bool check_fillstencil = false) {
     // restrict drawing area and don't paint over previously drawn outlines
     if (check_fillstencil)
       glStencilFunc(GL_EQUAL, 1, 3);
@@ -172,7 +208,7 @@ private:
       glStencilFunc(GL_EQUAL, 0, 2);
     glStencilOp(GL_KEEP, GL_KEEP, GL_KEEP);
 
-    canvas.Select(Brush(class_look.fill_color.WithAlpha(90)));
+    canvas.Select(Brush(GetFillColor(airspace)));
     canvas.SelectNullPen();
   }
 
@@ -200,17 +236,22 @@ private:
 class AirspaceFillRenderer final
   : protected MapCanvas
 {
+  AirspaceGeometryCache &geometry;
   const AirspaceLook &look;
   const AirspaceWarningCopy &warning_manager;
   const AirspaceRendererSettings &settings;
 
+  const Pen black_pen{1, COLOR_BLACK};
+
 public:
   AirspaceFillRenderer(Canvas &_canvas, const WindowProjection &_projection,
+                       AirspaceGeometryCache &_geometry,
                        const AirspaceLook &_look,
                        const AirspaceWarningCopy &_warnings,
                        const AirspaceRendererSettings &_settings)
     :MapCanvas(_canvas, _projection,
                _projection.GetScreenBounds().Scale(1.1)),
+     geometry(_geometry),
      look(_look), warning_manager(_warnings), settings(_settings)
   {
     glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
@@ -232,18 +273,31 @@ private:
   }
 
   void VisitPolygon(const AirspacePolygon &airspace) {
-    if (!PreparePolygon(airspace.GetPoints()))
-      return;
+    const bool cached = geometry.Prepare(airspace);
+    bool prepared = false;
+    if (!cached) {
+      if (!PreparePolygon(airspace.GetPoints()))
+        return;
+
+      prepared = true;
+    }
 
     if (!warning_manager.IsAcked(airspace) && SetupInterior(airspace)) {
       // fill interior without overpainting any previous outlines
       GLEnable<GL_BLEND> blend;
-      DrawPrepared();
+      if (cached)
+        geometry.DrawFill(projection, airspace, GetFillColor(airspace));
+      else
+        DrawPrepared();
     }
 
     // draw outline
-    if (SetupOutline(airspace))
-      DrawPrepared();
+    if (const Pen *pen = SetupOutline(airspace)) {
+      if (cached && pen->GetWidth() <= 2)
+        geometry.DrawOutline(projection, airspace, *pen);
+      else if (prepared || PreparePolygon(airspace.GetPoints()))
+        DrawPrepared();
+    }
   }
 
 public:
@@ -260,30 +314,40 @@ public:
   }
 
 private:
-  bool SetupOutline(const AbstractAirspace &airspace) {
+  /**
+   * @return the outline pen (which has been selected) or nullptr if
+   * no outline shall be drawn
+   */
+  const Pen *SetupOutline(const AbstractAirspace &airspace) {
     AirspaceClass as_type_or_class = settings.classes[airspace.GetTypeOrClass()].display ? airspace.GetTypeOrClass() : airspace.GetClass();
 
+    const Pen *pen;
     if (settings.black_outline)
-      canvas.SelectBlackPen();
+      pen = &black_pen;
     else if (settings.classes[as_type_or_class].border_width == 0)
       // Don't draw outlines if border_width == 0
-      return false;
+      return nullptr;
     else
-      canvas.Select(look.classes[as_type_or_class].border_pen);
+      pen = &look.classes[as_type_or_class].border_pen;
 
+    canvas.Select(*pen);
     canvas.SelectHollowBrush();
 
-    return true;
+    return pen;
   }
 
-  bool SetupInterior(const AbstractAirspace &airspace) {
+  Color GetFillColor(const AbstractAirspace &airspace) const {
 	AirspaceClass as_type_or_class = settings.classes[airspace.GetTypeOrClass()].display ? airspace.GetTypeOrClass() : airspace.GetClass();
+    const AirspaceClassLook &class_look = look.classes[as_type_or_class];
+
+    return class_look.fill_color.WithAlpha(48);
+  }
+
+  bool SetupInterior(const AbstractAirspace &airspace) {
     if (settings.fill_mode == AirspaceRendererSettings::FillMode::NONE)
       return false;
 
-    const AirspaceClassLook &class_look = look.classes[as_type_or_class];
-
-    canvas.Select(Brush(class_look.fill_color.WithAlpha(48)));
+    canvas.Select(Brush(GetFillColor(airspace)));
     canvas.SelectNullPen();
 
     return true;
@@ -297,20 +361,24 @@ AirspaceRenderer::DrawInternal(Canvas &canvas,
                                const AirspaceWarningCopy &awc,
                                const AirspacePredicate &visible)
 {
+  geometry.Update(*airspaces);
+
   const auto range =
     airspaces->QueryWithinRange(projection.GetGeoScreenCenter(),
                                 projection.GetScreenDistanceMeters());
 
   if (settings.fill_mode == AirspaceRendererSettings::FillMode::ALL ||
       settings.fill_mode == AirspaceRendererSettings::FillMode::NONE) {
-    AirspaceFillRenderer renderer(canvas, projection, look, awc, settings);
+    AirspaceFillRenderer renderer(canvas, projection, geometry,
+                                  look, awc, settings);
     for (const auto &i : range) {
       const AbstractAirspace &airspace = i.GetAirspace();
       if (visible(airspace))
         renderer.Visit(airspace);
     }
   } else {
-    AirspaceVisitorRenderer renderer(canvas, projection, look, awc, settings);
+    AirspaceVisitorRenderer renderer(canvas, projection, geometry,
+                                     look, awc, settings);
     for (const auto &i : range) {
       const AbstractAirspace &airspace = i.GetAirspace();
       if (visible(airspace))
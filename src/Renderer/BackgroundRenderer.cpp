@@ -7,6 +7,8 @@
 #include "ui/canvas/Canvas.hpp"
 #include "NMEA/Derived.hpp"
 
+#include <cassert>
+
 BackgroundRenderer::BackgroundRenderer() noexcept = default;
 BackgroundRenderer::~BackgroundRenderer() noexcept = default;
 
@@ -31,23 +33,48 @@ BackgroundRenderer::Draw(Canvas& canvas,
 {
   canvas.ClearWhite();
 
-  if (terrain_settings.enable && terrain != nullptr) {
-    if (!renderer) {
-      // defer creation until first draw because
-      // the buffer size, smoothing etc is set by the
-      // loaded terrain properties
-      renderer.reset(new TerrainRenderer(*terrain));
+  if (Generate(proj, terrain_settings))
+    DrawImage(canvas, proj);
+}
+
+bool
+BackgroundRenderer::Generate(const WindowProjection &proj,
+                             const TerrainRendererSettings &terrain_settings) noexcept
+{
+  if (!terrain_settings.enable || terrain == nullptr)
+    return false;
+
+  if (!renderer) {
+    // defer creation until first draw because
+    // the buffer size, smoothing etc is set by the
+    // loaded terrain properties
+    renderer.reset(new TerrainRenderer(*terrain));
 
 #ifdef ENABLE_OPENGL
-      if (full_resolution)
-        renderer->SetQuantisationPixels(1);
+    if (full_resolution)
+      renderer->SetQuantisationPixels(1);
 #endif
-    }
-
-    renderer->SetSettings(terrain_settings);
-    if (renderer->Generate(proj, shading_angle))
-      renderer->Draw(canvas, proj);
   }
+
+  renderer->SetSettings(terrain_settings);
+  return renderer->Generate(proj, shading_angle);
+}
+
+Serial
+BackgroundRenderer::GetSerial() const noexcept
+{
+  assert(renderer);
+
+  return renderer->GetSerial();
+}
+
+void
+BackgroundRenderer::DrawImage(Canvas &canvas,
+                              const WindowProjection &proj) const noexcept
+{
+  assert(renderer);
+
+  renderer->Draw(canvas, proj);
 }
 
 void
@@ -4,6 +4,7 @@
 #pragma once
 
 #include "Math/Angle.hpp"
+#include "util/Serial.hpp"
 
 #include <memory>
 
@@ -53,6 +54,31 @@ public:
             const WindowProjection& proj,
             const TerrainRendererSettings &terrain_settings) noexcept;
 
+  /**
+   * Prepare the terrain image for DrawImage().  This is the first
+   * half of Draw(), for callers which want to know whether the image
+   * has changed (see GetSerial()) before painting it.
+   *
+   * @return true if there is a terrain image to be drawn
+   */
+  bool Generate(const WindowProjection &proj,
+                const TerrainRendererSettings &terrain_settings) noexcept;
+
+  /**
+   * Returns a serial for the terrain image.  It changes each time
+   * Generate() renders a new image.  Only valid after Generate() has
+   * returned true.
+   */
+  [[gnu::pure]]
+  Serial GetSerial() const noexcept;
+
+  /**
+   * Draw the image prepared by Generate(), without clearing the
+   * #Canvas first.
+   */
+  void DrawImage(Canvas &canvas,
+                 const WindowProjection &proj) const noexcept;
+
   void SetShadingAngle(const WindowProjection &projection,
                        const TerrainRendererSettings &settings,
                        const DerivedInfo &calculated) noexcept;
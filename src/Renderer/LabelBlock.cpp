@@ -4,10 +4,10 @@
 #include "LabelBlock.hpp"
 
 inline bool
-LabelBlock::Bucket::Check(const PixelRect rc) const noexcept
+LabelBlock::Check(const PixelRect rc, unsigned bucket) const noexcept
 {
-  for (auto i = blocks.begin(), end = blocks.end(); i != end; ++i)
-    if (i->OverlapsWith(rc))
+  for (const unsigned i : buckets[bucket])
+    if (blocks[i].OverlapsWith(rc))
       return false;
 
   return true;
@@ -16,28 +16,36 @@ LabelBlock::Bucket::Check(const PixelRect rc) const noexcept
 void
 LabelBlock::reset() noexcept
 {
+  blocks.clear();
+
   for (auto &i : buckets)
-    i.Clear();
+    i.clear();
 }
 
 bool
 LabelBlock::check(const PixelRect rc) noexcept
 {
-  unsigned top = rc.top >> BUCKET_SHIFT;
-  unsigned bottom = rc.bottom >> BUCKET_SHIFT;
-
-  if (top >= BUCKET_COUNT)
-    top = BUCKET_COUNT - 1;
-
-  if (bottom < BUCKET_COUNT && !buckets[bottom].Check(rc))
-    return false;
-
-  if (top < bottom && !buckets[top].Check(rc))
-    return false;
-
-  buckets[top].Add(rc);
-  if (bottom < BUCKET_COUNT && top != bottom)
-    buckets[bottom].Add(rc);
+  const int x0 = rc.left >> CELL_SHIFT, x1 = rc.right >> CELL_SHIFT;
+  const int y0 = rc.top >> CELL_SHIFT, y1 = rc.bottom >> CELL_SHIFT;
+
+  for (int y = y0; y <= y1; ++y)
+    for (int x = x0; x <= x1; ++x)
+      if (!Check(rc, Hash(x, y)))
+        return false;
+
+  const unsigned index = blocks.size();
+  blocks.push_back(rc);
+
+  for (int y = y0; y <= y1; ++y) {
+    for (int x = x0; x <= x1; ++x) {
+      auto &bucket = buckets[Hash(x, y)];
+
+      /* a large rectangle may hash several cells to the same
+         bucket */
+      if (bucket.empty() || bucket.back() != index)
+        bucket.push_back(index);
+    }
+  }
 
   return true;
 }
@@ -4,43 +4,53 @@
 #pragma once
 
 #include "ui/dim/Rect.hpp"
-#include "util/StaticArray.hxx"
+#include "Math/SpatialHash.hpp"
+
+#include <array>
+#include <vector>
 
 /**
  * Simple code to prevent text writing over map city names.
+ *
+ * The rectangles are kept in a spatial hash: the screen is divided
+ * into square cells, and each rectangle is listed in the buckets of
+ * all cells it overlaps.  A check only needs to look at the
+ * rectangles in the same cells.
  */
 class LabelBlock {
-  static constexpr unsigned SCREEN_HEIGHT = 4096;
-  static constexpr unsigned BUCKET_SIZE = 64;
-  static constexpr unsigned BUCKET_SHIFT = 7;
-  static constexpr unsigned BUCKET_HEIGHT = 1 << BUCKET_SHIFT;
-  static constexpr unsigned BUCKET_COUNT = SCREEN_HEIGHT / BUCKET_HEIGHT;
-
   /**
-   * A bucket is responsible for hit tests in one horizontal section
-   * of the screen.
+   * The size of a cell is 2^CELL_SHIFT pixels.
    */
-  class Bucket {
-    typedef StaticArray<PixelRect, BUCKET_SIZE> BlockArray;
-    BlockArray blocks;
+  static constexpr unsigned CELL_SHIFT = 6;
+
+  static constexpr unsigned BUCKET_COUNT = 256;
 
-  public:
-    void Clear() noexcept {
-      blocks.clear();
-    }
+  /**
+   * All rectangles added since the last reset().
+   */
+  std::vector<PixelRect> blocks;
 
-    [[gnu::pure]]
-    bool Check(const PixelRect rc) const noexcept;
+  /**
+   * Each bucket contains the indices (in #blocks) of the rectangles
+   * overlapping the cells which are hashed to it.
+   */
+  std::array<std::vector<unsigned>, BUCKET_COUNT> buckets;
 
-    void Add(const PixelRect rc) noexcept {
-      if (!blocks.full())
-        blocks.append(rc);
-    }
-  };
+  static constexpr unsigned Hash(int x, int y) noexcept {
+    return SpatialHash(x, y) % BUCKET_COUNT;
+  }
 
-  Bucket buckets[BUCKET_COUNT];
+  [[gnu::pure]]
+  bool Check(const PixelRect rc, unsigned bucket) const noexcept;
 
 public:
+  /**
+   * Check if the rectangle overlaps with a rectangle which was added
+   * previously.  If not, it is added.
+   *
+   * @return true if the rectangle does not overlap and was added
+   */
   bool check(const PixelRect rc) noexcept;
+
   void reset() noexcept;
 };
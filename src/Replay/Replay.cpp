@@ -4,6 +4,7 @@
 #include "Replay.hpp"
 #include "IgcReplay.hpp"
 #include "NmeaReplay.hpp"
+#include "SensorReplay.hpp"
 #include "DemoReplayGlue.hpp"
 #include "io/FileLineReader.hpp"
 #include "Blackboard/DeviceBlackboard.hpp"
@@ -54,6 +55,8 @@ Replay::Start(Path _path)
 
     cli = new CatmullRomInterpolator(FloatDuration{0.98});
     cli->Reset();
+  } else if (path.EndsWithIgnoreCase(".xsr")) {
+    replay = new SensorReplay(path);
   } else {
     replay = new NmeaReplay(std::make_unique<FileLineReaderA>(path),
                             CommonInterface::GetSystemSettings().devices[0]);
@@ -0,0 +1,44 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#include "Replay/SensorReplay.hpp"
+#include "Logger/SensorSample.hpp"
+#include "NMEA/Info.hpp"
+#include "system/Path.hpp"
+
+SensorReplay::SensorReplay(Path path)
+  :mapping(path), reader(mapping)
+{
+  clock.Reset();
+}
+
+bool
+SensorReplay::Update(NMEAInfo &data)
+{
+  while (true) {
+    switch (reader.Next()) {
+    case SensorLog::Reader::Frame::END:
+      return false;
+
+    case SensorLog::Reader::Frame::LINE:
+      continue;
+
+    case SensorLog::Reader::Frame::SAMPLE:
+      break;
+    }
+
+    const auto &sample = reader.GetSample();
+
+    const TimeStamp time = sample.Has(SensorLog::Field::TIME)
+      ? TimeStamp{FloatDuration{sample.Get(SensorLog::Field::TIME) / 1000.}}
+      : TimeStamp::Undefined();
+
+    data.clock = clock.NextClock(time);
+    ApplySensorSample(sample, data);
+
+    data.gps.real = false;
+    data.gps.replay = true;
+    data.alive.Update(data.clock);
+    return true;
+  }
+}
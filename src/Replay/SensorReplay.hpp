@@ -0,0 +1,32 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#pragma once
+
+#include "AbstractReplay.hpp"
+#include "Logger/SensorLog.hpp"
+#include "io/FileMapping.hpp"
+#include "time/ReplayClock.hpp"
+
+class Path;
+
+/**
+ * Replays a file recorded by #SensorLogger.  The recorded device
+ * lines are skipped; the samples contain the parsed values already.
+ */
+class SensorReplay: public AbstractReplay
+{
+  FileMapping mapping;
+
+  SensorLog::Reader reader;
+
+  ReplayClock clock;
+
+public:
+  /**
+   * Throws on error.
+   */
+  explicit SensorReplay(Path path);
+
+  bool Update(NMEAInfo &data) override;
+};
@@ -5,7 +5,6 @@
 
 #ifdef STOP_WATCH
 
-#include "util/StaticArray.hxx"
 #include "LogFile.hpp"
 
 #ifdef HAVE_POSIX
@@ -18,16 +17,116 @@
 
 #endif /* STOP_WATCH */
 
+#include "Profiler/FrameProfiler.hpp"
+#include "util/StaticArray.hxx"
+
 #ifdef ENABLE_OPENGL
 #include "ui/opengl/System.hpp"
 #endif
 
 /**
  * A stop watch which measures the time needed to perform an
- * operation, and writes it to the log file.  It is a no-op if the
- * macro STOP_WATCH is not defined.
+ * operation.  The duration of each phase is always recorded in
+ * #frame_profiler; if the macro STOP_WATCH is defined, it is also
+ * written to the log file (after waiting for the GPU to finish).
  */
 class ScreenStopWatch {
+  /**
+   * The phase under which the total duration is recorded.
+   */
+  const FrameProfiler::PhaseId frame_phase;
+
+  /**
+   * Maps the Mark() texts to #FrameProfiler phases.  Each frame
+   * usually calls Mark() with the same texts in the same order, so
+   * the entry at #mark_index is checked first.
+   */
+  struct CachedPhase {
+    const char *text;
+    FrameProfiler::PhaseId id;
+  };
+
+  StaticArray<CachedPhase, 32> phase_cache;
+
+  /**
+   * The number of Mark() calls in the current frame.
+   */
+  unsigned mark_index = 0;
+
+  /**
+   * Is a frame being measured?
+   */
+  bool running = false;
+
+  FrameProfiler::PhaseId phase;
+
+  FrameProfiler::Clock::time_point frame_start, phase_start;
+
+  FrameProfiler::PhaseId LookupPhase(const char *text) noexcept {
+    const unsigned i = mark_index++;
+    if (i < phase_cache.size() && phase_cache[i].text == text)
+      return phase_cache[i].id;
+
+    for (const auto &c : phase_cache)
+      if (c.text == text)
+        return c.id;
+
+    const CachedPhase c{text, frame_profiler.RegisterPhase(text)};
+    if (i < phase_cache.size())
+      phase_cache[i] = c;
+    else if (!phase_cache.full())
+      phase_cache.append(c);
+    return c.id;
+  }
+
+  void EndPhase(FrameProfiler::Clock::time_point now) noexcept {
+    if (running)
+      frame_profiler.Record(phase, phase_start, now - phase_start);
+    else
+      frame_start = now;
+  }
+
+public:
+  /**
+   * @param name the name under which the total duration is
+   * recorded; must be a string literal
+   */
+  explicit ScreenStopWatch(const char *name) noexcept
+    :frame_phase(frame_profiler.RegisterPhase(name)) {}
+
+  /**
+   * @param text the name of the phase which begins now; must be a
+   * string literal
+   */
+  void Mark(const char *text) noexcept {
+#ifdef STOP_WATCH
+    StopWatchMark(text);
+#endif
+
+    const auto now = FrameProfiler::Clock::now();
+    EndPhase(now);
+    phase = LookupPhase(text);
+    phase_start = now;
+    running = true;
+  }
+
+  void Finish() noexcept {
+#ifdef STOP_WATCH
+    StopWatchFinish();
+#endif
+
+    mark_index = 0;
+
+    if (!running)
+      return;
+
+    const auto now = FrameProfiler::Clock::now();
+    EndPhase(now);
+    frame_profiler.Record(frame_phase, frame_start, now - frame_start);
+    running = false;
+  }
+
+private:
 #ifdef STOP_WATCH
   typedef uint64_t clock_stamp_t;
   typedef uint64_t cpu_stamp_t;
@@ -102,13 +201,12 @@ private:
 #endif /* !HAVE_POSIX */
   }
 
-public:
-  void Mark(const char *text) {
+  void StopWatchMark(const char *text) {
     FlushScreen();
     markers.append().Set(text);
   }
 
-  void Finish() {
+  void StopWatchFinish() {
     if (markers.empty())
       return;
 
@@ -132,10 +230,5 @@ public:
 
     markers.clear();
   }
-
-#else /* !STOP_WATCH */
-public:
-  void Mark([[maybe_unused]] const char *text) {}
-  void Finish() {}
-#endif /* !STOP_WATCH */
+#endif /* STOP_WATCH */
 };
@@ -34,6 +34,7 @@
 #include "FLARM/Glue.hpp"
 #include "Logger/Logger.hpp"
 #include "Logger/NMEALogger.hpp"
+#include "Logger/SensorLogger.hpp"
 #include "Logger/GlueFlightLogger.hpp"
 #include "Waypoint/WaypointDetailsReader.hpp"
 #include "Blackboard/DeviceBlackboard.hpp"
@@ -65,6 +66,7 @@
 #include "net/client/tim/Glue.hpp"
 #include "Hardware/DisplayDPI.hpp"
 #include "Hardware/DisplayGlue.hpp"
+#include "Profiler/FrameProfiler.hpp"
 #include "util/Compiler.h"
 #include "NMEA/Aircraft.hpp"
 #include "Waypoint/Waypoints.hpp"
@@ -267,6 +269,10 @@ Startup(UI::Display &display)
   InitializeAppleServices();
 #endif
 
+  if (CommandLine::frame_profile_path != nullptr &&
+      FrameProfiler::IsTracePath(Path(CommandLine::frame_profile_path)))
+    frame_profiler.EnableTrace();
+
   // Creates the main window
 
   UI::TopWindowStyle style;
@@ -408,6 +414,7 @@ Startup(UI::Display &display)
 
   backend_components->igc_logger = std::make_unique<Logger>();
   backend_components->nmea_logger = std::make_unique<NMEALogger>();
+  backend_components->sensor_logger = std::make_unique<SensorLogger>();
 
   // Initialize DeviceBlackboard
   device_factory = new DeviceFactory{
@@ -420,6 +427,7 @@ Startup(UI::Display &display)
 
   backend_components->devices = std::make_unique<MultipleDevices>(*backend_components->device_blackboard,
                                                                   backend_components->nmea_logger.get(),
+                                                                  backend_components->sensor_logger.get(),
                                                                   *device_factory);
 
   // Initialize main blackboard data
@@ -480,7 +488,7 @@ Startup(UI::Display &display)
   {
     LogFormat("Loading topography");
     operation.SetText(_("Loading Topography File..."));
-    LoadConfiguredTopography(*data_components->topography);
+    LoadConfiguredTopography(*data_components->topography, file_cache);
     operation.SetProgressPosition(256);
   }
 
@@ -491,7 +499,7 @@ Startup(UI::Display &display)
     sub_env.SetText(_("Loading Waypoints..."));
     WaypointGlue::LoadWaypoints(*data_components->waypoints,
                                 data_components->terrain.get(),
-                                sub_env);
+                                file_cache, sub_env);
   }
 
   // Read and parse the airfield info file
@@ -616,6 +624,8 @@ Startup(UI::Display &display)
   if (computer_settings.logger.enable_nmea_logger)
     backend_components->nmea_logger->Enable();
 
+  backend_components->sensor_logger->SetMode(computer_settings.logger.sensor_log_mode);
+
   LogString("ProgramStarted");
 
   // Give focus to the map
@@ -756,6 +766,14 @@ Shutdown()
   LogString("delete MapWindow");
   main_window->Deinitialise();
 
+  if (CommandLine::frame_profile_path != nullptr) {
+    try {
+      frame_profiler.Save(Path(CommandLine::frame_profile_path));
+    } catch (...) {
+      LogError(std::current_exception(), "Failed to save frame profile");
+    }
+  }
+
   // Stop sound
   AudioVarioGlue::Deinitialise();
 
@@ -786,6 +804,7 @@ Shutdown()
 
   if (backend_components != nullptr) {
     backend_components->nmea_logger.reset();
+    backend_components->sensor_logger.reset();
 
     if (backend_components->protected_task_manager) {
       backend_components->protected_task_manager->SetRoutePlanner(nullptr);
@@ -7,6 +7,7 @@
 
 #include <algorithm>
 #include <cassert>
+#include <vector>
 
 void
 RasterMap::UpdateProjection() noexcept
@@ -28,6 +29,20 @@ RasterMap::GetHeight(const GeoPoint &location) const noexcept
   return raster_tile_cache.GetHeight(pt);
 }
 
+void
+RasterMap::GetHeights(std::span<const GeoPoint> locations,
+                      std::span<TerrainHeight> heights) const noexcept
+{
+  assert(locations.size() == heights.size());
+
+  std::vector<RasterLocation> pts;
+  pts.reserve(locations.size());
+  for (const auto &i : locations)
+    pts.push_back(projection.ProjectCoarse(i));
+
+  raster_tile_cache.GetHeights(pts, heights);
+}
+
 TerrainHeight
 RasterMap::GetInterpolatedHeight(const GeoPoint &location) const noexcept
 {
@@ -89,6 +89,17 @@ public:
   [[gnu::pure]]
   TerrainHeight GetHeight(const GeoPoint &location) const noexcept;
 
+  /**
+   * Determine the non-interpolated heights at many locations at
+   * once.  This is faster than calling GetHeight() for each of them,
+   * because the lookups are ordered by terrain tile.
+   *
+   * @param heights the destination array; must have the same size
+   * as #locations
+   */
+  void GetHeights(std::span<const GeoPoint> locations,
+                  std::span<TerrainHeight> heights) const noexcept;
+
   /**
    * Determine the interpolated height at the specified location.
    */
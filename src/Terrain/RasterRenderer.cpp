@@ -237,6 +237,7 @@ RasterRenderer::GenerateImage(bool do_shading,
     GenerateUnshadedImage(height_scale, contour_height_scale);
 
   image->SetDirty();
+  ++serial;
 }
 
 void
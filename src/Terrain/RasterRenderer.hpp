@@ -4,6 +4,7 @@
 #pragma once
 
 #include "Terrain/HeightMatrix.hpp"
+#include "util/Serial.hpp"
 
 #ifdef ENABLE_OPENGL
 #include "Geo/GeoBounds.hpp"
@@ -63,6 +64,11 @@ class RasterRenderer {
 
   RawColor *color_table = nullptr;
 
+  /**
+   * Incremented by each GenerateImage() call.
+   */
+  Serial serial;
+
 public:
   RasterRenderer() noexcept;
   ~RasterRenderer() noexcept;
@@ -132,6 +138,14 @@ public:
                      const Angle sunazimuth,
                      bool do_contour) noexcept;
 
+  /**
+   * Returns a serial for the current image.  It changes each time
+   * GenerateImage() is called.
+   */
+  Serial GetSerial() const noexcept {
+    return serial;
+  }
+
   const RawBitmap &GetImage() const noexcept {
     return *image;
   }
@@ -9,6 +9,7 @@
 #include "io/ZipArchive.hpp"
 
 #include <memory>
+#include <span>
 
 class Path;
 class FileCache;
@@ -59,6 +60,18 @@ public:
     return lease->GetHeight(location);
   }
 
+  /**
+   * Look up the terrain heights of many locations with only one
+   * lock.
+   *
+   * @see RasterMap::GetHeights()
+   */
+  void GetTerrainHeights(std::span<const GeoPoint> locations,
+                         std::span<TerrainHeight> heights) const noexcept {
+    Lease lease(*this);
+    lease->GetHeights(locations, heights);
+  }
+
   GeoPoint GetTerrainCenter() const noexcept {
     return map.GetMapCenter();
   }
@@ -15,6 +15,7 @@ extern "C" {
 
 #include <string.h>
 #include <algorithm>
+#include <vector>
 
 static void
 CopyOverviewRow(TerrainHeight *gcc_restrict dest, const jas_seqent_t *gcc_restrict src,
@@ -177,6 +178,33 @@ RasterTileCache::GetInterpolatedHeight(RasterLocation l) const noexcept
   return overview.GetInterpolated({RasterTraits::ToOverview(l.x), RasterTraits::ToOverview(l.y)});
 }
 
+void
+RasterTileCache::GetHeights(std::span<const RasterLocation> locations,
+                            std::span<TerrainHeight> heights) const noexcept
+{
+  assert(locations.size() == heights.size());
+
+  /* sort the lookups by tile index; out-of-range locations get the
+     highest key and are moved to the end */
+  std::vector<std::pair<unsigned, unsigned>> order;
+  order.reserve(locations.size());
+
+  for (unsigned i = 0; i < locations.size(); ++i) {
+    const auto p = locations[i];
+    const unsigned key = p.x < size.x && p.y < size.y
+      ? (p.y / tile_size.y) * tiles.GetWidth() + p.x / tile_size.x
+      : unsigned(-1);
+    order.emplace_back(key, i);
+  }
+
+  std::sort(order.begin(), order.end());
+
+  for (const auto &[key, i] : order)
+    heights[i] = key != unsigned(-1)
+      ? GetHeight(locations[i])
+      : TerrainHeight::Invalid();
+}
+
 void
 RasterTileCache::SetSize(UnsignedPoint2D _size,
                          Point2D<uint_least16_t> _tile_size,
@@ -13,6 +13,7 @@
 #include <cassert>
 #include <cstdint>
 #include <optional>
+#include <span>
 
 static constexpr unsigned  RASTER_SLOPE_FACT = 12;
 
@@ -150,6 +151,20 @@ public:
   [[gnu::pure]]
   TerrainHeight GetInterpolatedHeight(RasterLocation p) const noexcept;
 
+  /**
+   * Determine the non-interpolated heights at many pixel locations
+   * at once.  The lookups are ordered by tile, so each tile (and the
+   * overview) is visited in one sweep instead of in the (random)
+   * order of the input.
+   *
+   * @param locations the pixel positions within the map; may be out
+   * of range
+   * @param heights the destination array; must have the same size
+   * as #locations
+   */
+  void GetHeights(std::span<const RasterLocation> locations,
+                  std::span<TerrainHeight> heights) const noexcept;
+
   /**
    * Scan a straight line and fill the buffer with the specified
    * number of samples along the line.
@@ -79,6 +79,14 @@ public:
   bool Generate(const WindowProjection &map_projection,
                 const Angle sunazimuth);
 
+  /**
+   * Returns a serial which changes each time Generate() renders a
+   * new image.
+   */
+  Serial GetSerial() const {
+    return raster_renderer.GetSerial();
+  }
+
   void Draw(Canvas &canvas, const WindowProjection &projection) const {
     raster_renderer.Draw(canvas, projection);
   }
@@ -44,6 +44,16 @@ public:
     return obj.status;
   }
 
+  /**
+   * Read only the bounds of a shape.
+   *
+   * @return false if this is a NULL or empty shape, or if the record
+   * could not be read
+   */
+  bool ReadBounds(std::size_t i, rectObj &bounds) noexcept {
+    return msSHPReadBounds(obj.hSHP, i, &bounds) == MS_SUCCESS;
+  }
+
   /**
    * Throws on error.
    */
@@ -0,0 +1,218 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#include "ShapeTileIndex.hpp"
+#include "io/BufferedOutputStream.hxx"
+#include "io/BufferedReader.hxx"
+#include "util/SpanCast.hxx"
+
+#include <algorithm>
+#include <numeric>
+#include <stdexcept>
+
+#include <string.h>
+
+namespace {
+
+struct IndexHeader {
+  static constexpr uint32_t VERSION = 1;
+
+  uint32_t version;
+  uint32_t n_shapes;
+  rectObj bounds;
+};
+
+/**
+ * Sanity limit; anything larger is considered a corrupt index file.
+ */
+static constexpr uint32_t MAX_IDS = 64 * 1024 * 1024;
+
+/**
+ * Maps coordinates to cells of one level.
+ */
+class CellMapper {
+  double min_x, min_y, cell_width, cell_height;
+  unsigned size;
+
+public:
+  CellMapper(const rectObj &bounds, unsigned _size) noexcept
+    :min_x(bounds.minx), min_y(bounds.miny),
+     cell_width((bounds.maxx - bounds.minx) / _size),
+     cell_height((bounds.maxy - bounds.miny) / _size),
+     size(_size) {}
+
+  bool Fits(const rectObj &rect) const noexcept {
+    return rect.maxx - rect.minx <= cell_width &&
+      rect.maxy - rect.miny <= cell_height;
+  }
+
+  [[gnu::pure]]
+  static unsigned ToCell(double value, double min, double cell_size,
+                         unsigned size) noexcept {
+    if (!(cell_size > 0) || value <= min)
+      return 0;
+
+    return std::min(unsigned((value - min) / cell_size), size - 1);
+  }
+
+  [[gnu::pure]]
+  ShapeTileIndex::CellRange GetRange(const rectObj &rect) const noexcept {
+    return {
+      ToCell(rect.minx, min_x, cell_width, size),
+      ToCell(rect.miny, min_y, cell_height, size),
+      ToCell(rect.maxx, min_x, cell_width, size) + 1,
+      ToCell(rect.maxy, min_y, cell_height, size) + 1,
+    };
+  }
+};
+
+} // anonymous namespace
+
+static constexpr bool
+IsValid(const rectObj &rect) noexcept
+{
+  return rect.minx <= rect.maxx && rect.miny <= rect.maxy;
+}
+
+static constexpr bool
+Overlaps(const rectObj &a, const rectObj &b) noexcept
+{
+  return a.minx <= b.maxx && a.maxx >= b.minx &&
+    a.miny <= b.maxy && a.maxy >= b.miny;
+}
+
+/**
+ * Choose the finest level whose cells are large enough for the given
+ * shape, so it is listed in at most 2x2 cells.  Shapes which are too
+ * large for all levels go to the coarsest one.
+ */
+[[gnu::pure]]
+static unsigned
+ChooseLevel(const rectObj &file_bounds, const rectObj &rect) noexcept
+{
+  for (unsigned level = ShapeTileIndex::N_LEVELS - 1; level > 0; --level)
+    if (CellMapper(file_bounds, ShapeTileIndex::LEVEL_SIZES[level]).Fits(rect))
+      return level;
+
+  return 0;
+}
+
+void
+ShapeTileIndex::Build(const rectObj &file_bounds,
+                      std::span<const rectObj> shape_bounds) noexcept
+{
+  bounds = file_bounds;
+  n_shapes = shape_bounds.size();
+
+  /* first pass: count the shapes in each cell */
+
+  for (unsigned level = 0; level < N_LEVELS; ++level) {
+    const unsigned n_cells = LEVEL_SIZES[level] * LEVEL_SIZES[level];
+    levels[level].offsets.assign(n_cells + 1, 0);
+    levels[level].ids.clear();
+  }
+
+  const auto ForEachCell = [this, shape_bounds](auto &&f){
+    for (std::size_t i = 0; i < shape_bounds.size(); ++i) {
+      const rectObj &rect = shape_bounds[i];
+      if (!IsValid(rect))
+        continue;
+
+      const unsigned level = ChooseLevel(bounds, rect);
+      const unsigned size = LEVEL_SIZES[level];
+      const auto range = CellMapper(bounds, size).GetRange(rect);
+      for (unsigned y = range.y0; y < range.y1; ++y)
+        for (unsigned x = range.x0; x < range.x1; ++x)
+          f(level, y * size + x, i);
+    }
+  };
+
+  ForEachCell([this](unsigned level, std::size_t cell, std::size_t){
+    ++levels[level].offsets[cell + 1];
+  });
+
+  for (auto &l : levels) {
+    std::partial_sum(l.offsets.begin(), l.offsets.end(), l.offsets.begin());
+    l.ids.resize(l.offsets.back());
+  }
+
+  /* second pass: fill the cells; "fill" is the write position of
+     each cell, which ends up at the start of the next cell */
+
+  std::array<std::vector<uint32_t>, N_LEVELS> fill;
+  for (unsigned level = 0; level < N_LEVELS; ++level)
+    fill[level].assign(levels[level].offsets.begin(),
+                       std::prev(levels[level].offsets.end()));
+
+  ForEachCell([this, &fill](unsigned level, std::size_t cell, std::size_t i){
+    levels[level].ids[fill[level][cell]++] = i;
+  });
+}
+
+ShapeTileIndex::CellRanges
+ShapeTileIndex::GetCells(const rectObj &rect) const noexcept
+{
+  CellRanges result{};
+  if (!IsDefined() || !Overlaps(rect, bounds))
+    return result;
+
+  for (unsigned level = 0; level < N_LEVELS; ++level)
+    result[level] = CellMapper(bounds, LEVEL_SIZES[level]).GetRange(rect);
+
+  return result;
+}
+
+void
+ShapeTileIndex::Save(BufferedOutputStream &os) const
+{
+  IndexHeader header;
+  memset(&header, 0, sizeof(header));
+  header.version = IndexHeader::VERSION;
+  header.n_shapes = n_shapes;
+  header.bounds = bounds;
+  os.Write(ReferenceAsBytes(header));
+
+  for (const auto &l : levels) {
+    os.WriteT(uint32_t(l.ids.size()));
+    os.Write(std::as_bytes(std::span{l.offsets}));
+    os.Write(std::as_bytes(std::span{l.ids}));
+  }
+}
+
+void
+ShapeTileIndex::Load(BufferedReader &r, const rectObj &file_bounds,
+                     std::size_t _n_shapes)
+{
+  const auto header = r.ReadFullT<IndexHeader>();
+  if (header.version != IndexHeader::VERSION)
+    throw std::runtime_error("Topography index version mismatch");
+
+  if (header.n_shapes != _n_shapes ||
+      memcmp(&header.bounds, &file_bounds, sizeof(file_bounds)) != 0)
+    throw std::runtime_error("Topography index does not match shapefile");
+
+  std::array<Level, N_LEVELS> new_levels;
+  for (unsigned level = 0; level < N_LEVELS; ++level) {
+    auto &l = new_levels[level];
+    const unsigned n_cells = LEVEL_SIZES[level] * LEVEL_SIZES[level];
+
+    const auto n_ids = r.ReadFullT<uint32_t>();
+    if (n_ids > MAX_IDS)
+      throw std::runtime_error("Malformed topography index");
+
+    l.offsets.resize(n_cells + 1);
+    r.ReadFull(std::as_writable_bytes(std::span{l.offsets}));
+    l.ids.resize(n_ids);
+    r.ReadFull(std::as_writable_bytes(std::span{l.ids}));
+
+    if (l.offsets.front() != 0 || l.offsets.back() != n_ids ||
+        !std::is_sorted(l.offsets.begin(), l.offsets.end()) ||
+        std::any_of(l.ids.begin(), l.ids.end(),
+                    [&header](uint32_t id){ return id >= header.n_shapes; }))
+      throw std::runtime_error("Malformed topography index");
+  }
+
+  bounds = header.bounds;
+  n_shapes = header.n_shapes;
+  levels = std::move(new_levels);
+}
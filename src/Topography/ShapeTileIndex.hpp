@@ -0,0 +1,117 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#pragma once
+
+#include "shapelib/mapserver.h"
+
+#include <array>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+class BufferedReader;
+class BufferedOutputStream;
+
+/**
+ * A spatial index of the shapes in a shapefile.  The bounds of the
+ * file are divided into grids of cells at a few levels, and each
+ * shape is listed in the cells of the finest level whose cells are
+ * not smaller than the shape.
+ *
+ * This allows #TopographyFile to track which cells enter and leave
+ * the visible area, instead of scanning all records of the file each
+ * time the visible area changes.
+ */
+class ShapeTileIndex {
+public:
+  static constexpr unsigned N_LEVELS = 3;
+
+  /**
+   * The number of cells in each row and column of each level.
+   */
+  static constexpr std::array<unsigned, N_LEVELS> LEVEL_SIZES{8, 32, 128};
+
+  /**
+   * A rectangle of cells in one level.  The upper bounds are
+   * exclusive.
+   */
+  struct CellRange {
+    unsigned x0 = 0, y0 = 0, x1 = 0, y1 = 0;
+
+    constexpr bool empty() const noexcept {
+      return x0 >= x1 || y0 >= y1;
+    }
+
+    constexpr bool Contains(unsigned x, unsigned y) const noexcept {
+      return x >= x0 && x < x1 && y >= y0 && y < y1;
+    }
+
+    constexpr bool operator==(const CellRange &) const noexcept = default;
+  };
+
+  using CellRanges = std::array<CellRange, N_LEVELS>;
+
+private:
+  struct Level {
+    /**
+     * The shapes in cell (x,y) are ids[offsets[i]] to
+     * ids[offsets[i+1]-1], where i=y*size+x.
+     */
+    std::vector<uint32_t> offsets, ids;
+  };
+
+  rectObj bounds;
+
+  uint32_t n_shapes = 0;
+
+  std::array<Level, N_LEVELS> levels;
+
+public:
+  bool IsDefined() const noexcept {
+    return !levels.front().offsets.empty();
+  }
+
+  /**
+   * Build the index.
+   *
+   * @param file_bounds the bounds of the shapefile
+   * @param shape_bounds the bounds of each shape; shapes with
+   * invalid bounds (minx > maxx) are not indexed
+   */
+  void Build(const rectObj &file_bounds,
+             std::span<const rectObj> shape_bounds) noexcept;
+
+  /**
+   * Determine the cells (of all levels) overlapping the given
+   * rectangle.
+   */
+  [[gnu::pure]]
+  CellRanges GetCells(const rectObj &rect) const noexcept;
+
+  /**
+   * Returns the ids of the shapes listed in the specified cell.
+   */
+  [[gnu::pure]]
+  std::span<const uint32_t> GetShapes(unsigned level,
+                                      unsigned x, unsigned y) const noexcept {
+    const auto &l = levels[level];
+    const std::size_t i = y * LEVEL_SIZES[level] + x;
+    return std::span{l.ids}.subspan(l.offsets[i],
+                                    l.offsets[i + 1] - l.offsets[i]);
+  }
+
+  /**
+   * Throws on error.
+   */
+  void Save(BufferedOutputStream &os) const;
+
+  /**
+   * Load an index written by Save().
+   *
+   * Throws on error, including a version mismatch and an index which
+   * does not match the given shapefile properties.
+   */
+  void Load(BufferedReader &r, const rectObj &file_bounds,
+            std::size_t n_shapes);
+};
@@ -5,12 +5,24 @@
 #include "Topography/XShape.hpp"
 #include "Convert.hpp"
 #include "Projection/WindowProjection.hpp"
+#include "io/FileCache.hpp"
+#include "io/FileOutputStream.hxx"
+#include "io/BufferedOutputStream.hxx"
+#include "io/BufferedReader.hxx"
+#include "io/Reader.hxx"
+#include "LogFile.hpp"
 #include "util/ScopeExit.hxx"
 
+#ifdef ENABLE_OPENGL
+#include "Geo/FAISphere.hpp"
+#endif
+
 #include <zzip/lib.h>
 
 #include <algorithm>
+#include <concepts>
 #include <stdexcept>
+#include <vector>
 
 TopographyFile::TopographyFile(zzip_dir *_dir, const char *filename,
                                double _threshold,
@@ -46,6 +58,10 @@ TopographyFile::TopographyFile(zzip_dir *_dir, const char *filename,
 
   shapes.ResizeDiscard(n_shapes);
 
+#ifdef ENABLE_OPENGL
+  SetLayoutScale(1);
+#endif
+
   if (dir != nullptr)
     ++dir->refcount;
 
@@ -60,17 +76,8 @@ TopographyFile::~TopographyFile() noexcept
   }
 }
 
-void
-TopographyFile::ClearCache() noexcept
-{
-  for (auto &i : shapes)
-    i.shape.reset();
-
-  list.clear();
-}
-
-static std::unique_ptr<XShape>
-LoadShape(ShapeFile &file, GeoPoint &center, std::size_t i, int label_field)
+std::unique_ptr<XShape>
+TopographyFile::LoadShape(std::size_t i)
 {
   shapeObj shape;
   msInitShape(&shape);
@@ -84,6 +91,63 @@ LoadShape(ShapeFile &file, GeoPoint &center, std::size_t i, int label_field)
   return std::make_unique<XShape>(shape, center, label);
 }
 
+void
+TopographyFile::BuildTileIndex()
+{
+  const std::size_t n = file.size();
+  std::vector<rectObj> bounds(n);
+  for (std::size_t i = 0; i < n; ++i)
+    if (!file.ReadBounds(i, bounds[i]))
+      /* mark as invalid, this shape will not be indexed */
+      bounds[i] = {0, 0, -1, -1};
+
+  tile_index.Build(file.GetBounds(), bounds);
+}
+
+void
+TopographyFile::LoadTileIndex(FileCache &cache, const char *cache_name,
+                              Path original_path) noexcept
+{
+  try {
+    if (auto r = cache.Load(cache_name, original_path)) {
+      BufferedReader br{*r};
+      tile_index.Load(br, file.GetBounds(), file.size());
+      return;
+    }
+  } catch (...) {
+    LogError(std::current_exception(), "Failed to load topography index");
+    cache.Flush(cache_name);
+  }
+
+  try {
+    BuildTileIndex();
+
+    auto os = cache.Save(cache_name, original_path);
+    WithBufferedOutputStream(*os, [this](BufferedOutputStream &bos){
+      tile_index.Save(bos);
+    });
+    os->Commit();
+  } catch (...) {
+    LogError(std::current_exception(), "Failed to save topography index");
+    cache.Flush(cache_name);
+  }
+}
+
+/**
+ * Invoke a function for each cell which is in range "a", but not in
+ * range "b".
+ */
+static void
+ForEachCellNotIn(const ShapeTileIndex::CellRange &a,
+                 const ShapeTileIndex::CellRange &b,
+                 std::invocable<unsigned, unsigned> auto f)
+{
+  for (unsigned y = a.y0; y < a.y1; ++y)
+    for (unsigned x = a.x0; x < a.x1; ++x)
+      if (!b.Contains(x, y))
+        f(x, y);
+}
+
 bool
 TopographyFile::Update(const WindowProjection &map_projection)
 {
@@ -97,69 +161,103 @@ TopographyFile::Update(const WindowProjection &map_projection)
     /* the cache is still fresh */
     return false;
 
+  if (!tile_index.IsDefined())
+    BuildTileIndex();
+
   cache_bounds = screenRect.Scale(2);
 
-  // Test which shapes are inside the given bounds and save the
-  // status to file.status
-  switch (file.WhichShapes(dir, ConvertRect(cache_bounds))) {
-  case MS_FAILURE:
-    ClearCache();
-    throw std::runtime_error{"Failed to update shapefile"};
+  /* determine which shapes become visible and which ones become
+     invisible, by looking only at the cells entering and leaving
+     the cache bounds */
 
-  case MS_DONE:
-    /* screen is outside of map bounds */
-    return false;
+  const auto new_cells = tile_index.GetCells(ConvertRect(cache_bounds));
+
+  std::vector<uint32_t> entering, leaving;
+
+  for (unsigned level = 0; level < ShapeTileIndex::N_LEVELS; ++level) {
+    ForEachCellNotIn(new_cells[level], cached_cells[level],
+                     [&](unsigned x, unsigned y){
+      for (const uint32_t i : tile_index.GetShapes(level, x, y))
+        if (shapes[i].refs++ == 0)
+          entering.push_back(i);
+    });
+  }
 
-  case MS_SUCCESS:
-    break;
+  for (unsigned level = 0; level < ShapeTileIndex::N_LEVELS; ++level) {
+    ForEachCellNotIn(cached_cells[level], new_cells[level],
+                     [&](unsigned x, unsigned y){
+      for (const uint32_t i : tile_index.GetShapes(level, x, y))
+        if (--shapes[i].refs == 0)
+          leaving.push_back(i);
+    });
   }
 
-  const auto status = file.GetStatus();
-  assert(status != nullptr);
-
-  // Iterate through the shapefile entries
-  auto prev = list.before_begin();
-  auto it = shapes.begin();
-  for (std::size_t i = 0; i < file.size(); ++i, ++it) {
-    if (!msGetBit(status, i)) {
-      // If the shape is outside the bounds
-      // delete the shape from the cache
-      if (it->shape != nullptr) {
-        assert(&*std::next(prev) == &*it);
-
-        /* remove from linked list (protected) */
-        {
-          const std::lock_guard lock{mutex};
-          list.erase_after(prev);
-          ++serial;
-        }
-
-        /* now it's unreachable, and we can delete the XShape without
-           holding a lock */
-        it->shape.reset();
-      }
-    } else {
-      // is inside the bounds
-      if (it->shape == nullptr) {
-        assert(&*std::next(prev) != &*it);
-
-        // shape isn't cached yet -> cache the shape
-        it->shape = LoadShape(file, center, i, label_field);
-
-        /* insert into linked list (protected) */
-        {
-          const std::lock_guard lock{mutex};
-          prev = list.insert_after(prev, *it);
-          ++serial;
-        }
-      } else {
-        ++prev;
-        assert(&*prev == &*it);
-      }
+  cached_cells = new_cells;
+
+  /* load the new shapes without holding the lock, so the renderer is
+     not blocked while the shapefile is being decoded; read them in
+     file order to avoid seeking back and forth */
+
+  std::sort(entering.begin(), entering.end());
+
+#ifdef ENABLE_OPENGL
+  const unsigned thinning_level =
+    GetThinningLevel(map_projection.GetMapScale());
+#endif
+
+  std::vector<std::pair<uint32_t, std::unique_ptr<const XShape>>> loaded;
+  std::exception_ptr error;
+  for (const uint32_t i : entering) {
+    if (shapes[i].refs == 0 || shapes[i].shape != nullptr)
+      /* has already left again, or was loaded by LoadAll() */
+      continue;
+
+    try {
+      auto shape = LoadShape(i);
+#ifdef ENABLE_OPENGL
+      /* triangulate and thin out the level needed for the current
+         map scale here in the loader thread; the other levels are
+         built by the renderer when the user zooms */
+      shape->PrepareIndices(thinning_level,
+                            min_shape_distance[thinning_level]);
+#endif
+      loaded.emplace_back(i, std::move(shape));
+    } catch (...) {
+      /* skip this shape, but report the error after the others
+         have been published */
+      if (!error)
+        error = std::current_exception();
     }
   }
 
-  assert(std::next(prev) == list.end());
+  /* the shapes which are no longer visible; they are deleted after
+     the lock has been released */
+  std::vector<std::unique_ptr<const XShape>> removed;
+
+  /* publish the changes to the linked list (protected) */
+  {
+    const std::lock_guard lock{mutex};
+
+    for (const uint32_t i : leaving) {
+      auto &envelope = shapes[i];
+      if (envelope.refs > 0 || envelope.shape == nullptr)
+        continue;
+
+      list.erase(list.iterator_to(envelope));
+      removed.emplace_back(std::move(envelope.shape));
+    }
+
+    for (auto &[i, shape] : loaded) {
+      shapes[i].shape = std::move(shape);
+      list.push_back(shapes[i]);
+    }
+
+    if (!loaded.empty() || !removed.empty())
+      ++serial;
+  }
+
+  if (error)
+    std::rethrow_exception(error);
 
   return true;
 }
@@ -167,24 +265,15 @@ TopographyFile::Update(const WindowProjection &map_projection)
 void
 TopographyFile::LoadAll()
 {
-  // Iterate through the shapefile entries
-  auto prev = list.before_begin();
-  auto it = shapes.begin();
-  for (std::size_t i = 0; i < file.size(); ++i, ++it) {
-    if (it->shape == nullptr) {
-      assert(&*std::next(prev) != &*it);
+  for (std::size_t i = 0; i < file.size(); ++i) {
+    auto &envelope = shapes[i];
+    if (envelope.shape == nullptr) {
       // shape isn't cached yet -> cache the shape
-      it->shape = LoadShape(file, center, i, label_field);
-      // update list pointer
-      prev = list.insert_after(prev, *it);
-    } else {
-      ++prev;
-      assert(&*prev == &*it);
+      envelope.shape = LoadShape(i);
+      list.push_back(envelope);
     }
   }
 
-  assert(std::next(prev) == list.end());
-
   ++serial;
 }
 
@@ -215,6 +304,14 @@ TopographyFile::GetThinningLevel(double map_scale) const noexcept
   return 0;
 }
 
+void
+TopographyFile::SetLayoutScale(unsigned layout_scale) noexcept
+{
+  for (unsigned level = 0; level < min_shape_distance.size(); ++level)
+    min_shape_distance[level] = ShapeScalar(GetMinimumPointDistance(level))
+      / (layout_scale * FAISphere::REARTH);
+}
+
 unsigned
 TopographyFile::GetMinimumPointDistance(unsigned level) const noexcept
 {
@@ -4,28 +4,38 @@
 #pragma once
 
 #include "ShapeFile.hpp"
+#include "ShapeTileIndex.hpp"
 #include "Geo/GeoBounds.hpp"
 #include "util/AllocatedArray.hxx"
-#include "util/IntrusiveForwardList.hxx"
+#include "util/IntrusiveList.hxx"
 #include "util/Serial.hpp"
 #include "ui/canvas/PortableColor.hpp"
 #include "ResourceId.hpp"
 #include "thread/Mutex.hxx"
 
 #ifdef ENABLE_OPENGL
-#include "XShapePoint.hpp"
+#include "XShape.hpp"
 #endif
 
+#include <array>
 #include <cassert>
 #include <memory>
 
 class WindowProjection;
 class XShape;
+class FileCache;
+class Path;
 struct zzip_dir;
 
 class TopographyFile {
-  struct ShapeEnvelope final : IntrusiveForwardListHook {
+  struct ShapeEnvelope final : IntrusiveListHook<> {
     std::unique_ptr<const XShape> shape;
+
+    /**
+     * The number of cells in #cached_cells which list this shape.
+     * The shape is loaded while this is non-zero.
+     */
+    unsigned refs = 0;
   };
 
   /**
@@ -44,7 +54,7 @@ class TopographyFile {
 
   AllocatedArray<ShapeEnvelope> shapes;
 
-  using ShapeList = IntrusiveForwardList<ShapeEnvelope>;
+  using ShapeList = IntrusiveList<ShapeEnvelope>;
   ShapeList list;
 
   const int label_field;
@@ -80,9 +90,29 @@ class TopographyFile {
    */
   GeoBounds cache_bounds = GeoBounds::Invalid();
 
+  /**
+   * Locates the shapes of a region without scanning all records.
+   * Initialized by LoadTileIndex() or by the first Update() call.
+   */
+  ShapeTileIndex tile_index;
+
+  /**
+   * The cells of #tile_index overlapping #cache_bounds.  Their shapes
+   * are loaded.
+   */
+  ShapeTileIndex::CellRanges cached_cells{};
+
+#ifdef ENABLE_OPENGL
+  /**
+   * The minimum distance between points of each thinning level in
+   * #ShapePoint coordinates.  Calculated by SetLayoutScale().
+   */
+  std::array<ShapeScalar, XShape::THINNING_LEVELS> min_shape_distance;
+#endif
+
 public:
   /**
-   * Protects #serial, #shapes, #first.
+   * Protects #serial, #shapes, #list.
    * The caller is responsible for locking it.
    */
   mutable Mutex mutex;
@@ -242,8 +272,34 @@ public:
    */
   [[gnu::pure]]
   unsigned GetMinimumPointDistance(unsigned level) const noexcept;
+
+  /**
+   * @return minimum distance between points in #ShapePoint
+   * coordinates, adjusted to the display scale
+   */
+  ShapeScalar GetMinimumShapeDistance(unsigned level) const noexcept {
+    return min_shape_distance[level];
+  }
+
+  /**
+   * Set the display scale (i.e. the value of Layout::Scale(1)) which
+   * is used for GetMinimumShapeDistance().  This must be called
+   * before shapes are loaded.
+   */
+  void SetLayoutScale(unsigned layout_scale) noexcept;
 #endif
 
+  /**
+   * Load the spatial index from the cache, or build it and store it
+   * in the cache.  Errors are logged.
+   *
+   * @param cache_name a name identifying this file in the cache
+   * @param original_path the file which contains this shapefile; the
+   * cache is discarded when it gets modified
+   */
+  void LoadTileIndex(FileCache &cache, const char *cache_name,
+                     Path original_path) noexcept;
+
   /**
    * Throws on error.
    *
@@ -259,5 +315,18 @@ public:
   void LoadAll();
 
 protected:
-  void ClearCache() noexcept;
+  /**
+   * Read the bounds of all shapes and build #tile_index.
+   *
+   * Throws on error.
+   */
+  void BuildTileIndex();
+
+  /**
+   * Load a shape from the shapefile.  This is expensive and should
+   * not be called while holding the mutex.
+   *
+   * Throws on error.
+   */
+  std::unique_ptr<XShape> LoadShape(std::size_t i);
 };
@@ -13,7 +13,6 @@
 #include "shapelib/mapserver.h"
 #include "util/AllocatedArray.hxx"
 #include "Geo/GeoClip.hpp"
-#include "Geo/FAISphere.hpp"
 
 #ifdef ENABLE_OPENGL
 #include "ui/canvas/opengl/VertexPointer.hpp"
@@ -27,10 +26,10 @@
 #include <glm/gtc/type_ptr.hpp>
 #endif
 
-#include <string>
+#include <string_view>
 #include <algorithm>
 #include <numeric>
-#include <set>
+#include <unordered_set>
 
 TopographyFileRenderer::TopographyFileRenderer(const TopographyFile &_file,
                                                const TopographyLook &_look) noexcept
@@ -175,9 +174,7 @@ TopographyFileRenderer::Paint(Canvas &canvas,
 
 #ifdef ENABLE_OPENGL
   const unsigned level = file.GetThinningLevel(map_scale);
-  const ShapeScalar min_distance =
-    ShapeScalar(file.GetMinimumPointDistance(level))
-    / (Layout::Scale(1) * FAISphere::REARTH);
+  const ShapeScalar min_distance = file.GetMinimumShapeDistance(level);
 
   glUniformMatrix4fv(OpenGL::solid_modelview, 1, GL_FALSE,
                      glm::value_ptr(ToGLM(projection, file.GetCenter())));
@@ -370,7 +367,9 @@ TopographyFileRenderer::PaintLabels(Canvas &canvas,
 
   int iskip = file.GetSkipSteps(map_scale);
 
-  std::set<std::string> drawn_labels;
+  /* the label strings are owned by the XShape objects, which are
+     protected by the mutex */
+  std::unordered_set<std::string_view> drawn_labels;
 
   // Iterate over all shapes in the file
   for (const XShape *shape_p : visible_labels) {
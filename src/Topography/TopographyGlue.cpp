@@ -6,7 +6,7 @@
 #include "Language/Language.hpp"
 #include "Profile/Profile.hpp"
 #include "LogFile.hpp"
-#include "io/MapFile.hpp"
+#include "Screen/Layout.hpp"
 #include "io/ZipArchive.hpp"
 #include "io/ZipLineReader.hpp"
 #include "system/Path.hpp"
@@ -16,14 +16,19 @@
  * the same ZIP file.
  */
 static bool
-LoadConfiguredTopographyZip(TopographyStore &store)
+LoadConfiguredTopographyZip(TopographyStore &store, FileCache *cache)
 try {
-  auto archive = OpenMapFile();
-  if (!archive)
+  const auto path = Profile::GetPath(ProfileKeys::MapFile);
+  if (path == nullptr)
     return false;
 
-  ZipLineReaderA reader(archive->get(), "topology.tpl");
-  store.Load(reader, nullptr, archive->get());
+  ZipArchive archive{path};
+
+  ZipLineReaderA reader(archive.get(), "topology.tpl");
+#ifdef ENABLE_OPENGL
+  store.SetLayoutScale(Layout::Scale(1u));
+#endif
+  store.Load(reader, nullptr, archive.get(), cache, path);
   return true;
 } catch (...) {
   LogError(std::current_exception(), "No topography in map file");
@@ -31,7 +36,7 @@ try {
 }
 
 bool
-LoadConfiguredTopography(TopographyStore &store)
+LoadConfiguredTopography(TopographyStore &store, FileCache *cache)
 {
-  return LoadConfiguredTopographyZip(store);
+  return LoadConfiguredTopographyZip(store, cache);
 }
@@ -4,6 +4,11 @@
 #pragma once
 
 class TopographyStore;
+class FileCache;
 
+/**
+ * @param cache an optional cache for the spatial indexes of the
+ * shapefiles
+ */
 bool
-LoadConfiguredTopography(TopographyStore &store);
+LoadConfiguredTopography(TopographyStore &store, FileCache *cache);
@@ -5,6 +5,7 @@
 #include "Index.hpp"
 #include "util/StringAPI.hxx"
 #include "util/StringCompare.hxx"
+#include "util/CharUtil.hxx"
 #include "io/LineReader.hpp"
 #include "system/ConvertPathName.hpp"
 #include "system/Path.hpp"
@@ -13,9 +14,23 @@
 #include "LogFile.hpp"
 
 #include <cstdint>
+#include <string>
 
 #include <windef.h> // for MAX_PATH
 
+/**
+ * Generate the #FileCache name for the spatial index of the given
+ * shapefile.
+ */
+static std::string
+MakeIndexCacheName(std::string_view shape_name) noexcept
+{
+  std::string name{"topography-"};
+  for (const char ch : shape_name)
+    name.push_back(IsAlphaNumericASCII(ch) ? ch : '_');
+  return name;
+}
+
 TopographyStore::TopographyStore() noexcept {}
 TopographyStore::~TopographyStore() noexcept = default;
 
@@ -67,7 +82,8 @@ TopographyStore::LoadAll() noexcept
 
 void
 TopographyStore::Load(NLineReader &reader,
-                      Path directory, struct zzip_dir *zdir) noexcept
+                      Path directory, struct zzip_dir *zdir,
+                      FileCache *cache, Path original_path) noexcept
 {
   Reset();
 
@@ -109,6 +125,13 @@ TopographyStore::Load(NLineReader &reader,
                               entry->shape_field,
                               entry->icon, entry->big_icon, entry->ultra_icon,
                               entry->pen_width);
+#ifdef ENABLE_OPENGL
+      i->SetLayoutScale(layout_scale);
+#endif
+
+      if (cache != nullptr && original_path != nullptr)
+        i->LoadTileIndex(*cache, MakeIndexCacheName(entry->name).c_str(),
+                         original_path);
     } catch (...) {
       LogError(std::current_exception());
     }
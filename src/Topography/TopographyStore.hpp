@@ -4,11 +4,12 @@
 #pragma once
 
 #include "TopographyFile.hpp"
+#include "system/Path.hpp"
 #include "util/NonCopyable.hpp"
 
 #include <forward_list>
 
-class Path;
+class FileCache;
 class WindowProjection;
 class NLineReader;
 struct zzip_dir;
@@ -24,6 +25,13 @@ class TopographyStore : private NonCopyable {
    */
   unsigned serial = 0;
 
+#ifdef ENABLE_OPENGL
+  /**
+   * @see TopographyFile::SetLayoutScale()
+   */
+  unsigned layout_scale = 1;
+#endif
+
 public:
   TopographyStore() noexcept;
   ~TopographyStore() noexcept;
@@ -64,7 +72,28 @@ public:
    */
   void LoadAll() noexcept;
 
+#ifdef ENABLE_OPENGL
+  /**
+   * Set the display scale for all files loaded by Load().  Call this
+   * before Load().
+   *
+   * @see TopographyFile::SetLayoutScale()
+   */
+  void SetLayoutScale(unsigned _layout_scale) noexcept {
+    layout_scale = _layout_scale;
+  }
+#endif
+
+  /**
+   * @param cache if not nullptr, then the spatial index of each
+   * shapefile is stored in this cache
+   * @param original_path the file containing the shapefiles (e.g. the
+   * map file); the cached indexes are discarded when it gets
+   * modified
+   */
   void Load(NLineReader &reader,
-            Path directory, struct zzip_dir *zdir = nullptr) noexcept;
+            Path directory, struct zzip_dir *zdir = nullptr,
+            FileCache *cache = nullptr,
+            Path original_path = nullptr) noexcept;
   void Reset() noexcept;
 };
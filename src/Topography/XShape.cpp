@@ -216,4 +216,23 @@ XShape::GetIndices(int thinning_level, ShapeScalar min_distance) const noexcept
   return {indices[thinning_level], index_count[thinning_level].get()};
 }
 
+void
+XShape::PrepareIndices(unsigned thinning_level,
+                       ShapeScalar min_distance) noexcept
+{
+  if (num_lines == 0)
+    /* malformed shape, nothing to draw */
+    return;
+
+  if (type == MS_SHAPE_LINE) {
+    if (thinning_level == 0)
+      /* level 0 lines are drawn without indices */
+      return;
+  } else if (type != MS_SHAPE_POLYGON)
+    return;
+
+  if (indices[thinning_level] == nullptr)
+    BuildIndices(thinning_level, min_distance);
+}
+
 #endif // ENABLE_OPENGL
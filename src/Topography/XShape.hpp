@@ -21,10 +21,14 @@ struct GeoPoint;
 
 class XShape {
   static constexpr std::size_t MAX_LINES = 32;
+
+public:
 #ifdef ENABLE_OPENGL
   static constexpr std::size_t THINNING_LEVELS = 4;
 #endif
 
+private:
+
   GeoBounds bounds;
 
   uint8_t type;
@@ -109,6 +113,15 @@ public:
   [[gnu::pure]]
   Indices GetIndices(int thinning_level,
                      ShapeScalar min_distance) const noexcept;
+
+  /**
+   * Build the indices of one thinning level in advance, so
+   * GetIndices() does not need to triangulate in the rendering
+   * thread.  The other levels are still built on demand.  This must
+   * be called before the object is published to other threads.
+   */
+  void PrepareIndices(unsigned thinning_level,
+                      ShapeScalar min_distance) noexcept;
 #endif
 
   const GeoBounds &get_bounds() const noexcept {
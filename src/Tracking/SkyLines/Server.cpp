@@ -10,13 +10,30 @@
 #include "net/UniqueSocketDescriptor.hxx"
 #include "util/CRC16CCITT.hpp"
 
+#ifdef __linux__
+#include "net/MsgHdr.hxx"
+#endif
+
+#include <algorithm>
+#include <cassert>
+#include <stdexcept>
+
 static UniqueSocketDescriptor
-CreateBindUDP(SocketAddress address)
+CreateBindUDP(SocketAddress address, bool reuse_port)
 {
   UniqueSocketDescriptor s;
   if (!s.Create(address.GetFamily(), SOCK_DGRAM, 0))
     throw MakeSocketError("Failed to create socket");
 
+  if (reuse_port) {
+#ifdef __linux__
+    if (!s.SetReusePort())
+      throw MakeSocketError("Failed to set SO_REUSEPORT");
+#else
+    throw std::runtime_error("SO_REUSEPORT is not supported");
+#endif
+  }
+
   if (!s.Bind(address))
     throw MakeSocketError("Failed to connect socket");
 
@@ -26,9 +43,12 @@ CreateBindUDP(SocketAddress address)
 namespace SkyLinesTracking {
 
 Server::Server(EventLoop &event_loop,
-               SocketAddress server_address)
+               SocketAddress server_address, bool reuse_port)
   :socket(event_loop, BIND_THIS_METHOD(OnSocketReady),
-          CreateBindUDP(server_address).Release())
+          CreateBindUDP(server_address, reuse_port).Release()),
+   flush_event(event_loop, BIND_THIS_METHOD(FlushSendQueue)),
+   receive_buffer(std::make_unique<DatagramBatch>()),
+   send_queue(std::make_unique<DatagramBatch>())
 {
   socket.ScheduleRead();
 }
@@ -38,17 +58,106 @@ Server::~Server()
   socket.Close();
 }
 
+void
+Server::SendNow(SocketAddress address,
+                std::span<const std::byte> buffer) noexcept
+{
+  if (socket.GetSocket().WriteNoWait(buffer, address) < 0)
+    OnSendError(address,
+                std::make_exception_ptr(MakeSocketError("Failed to send")));
+}
+
 void
 Server::SendBuffer(SocketAddress address,
                    std::span<const std::byte> buffer) noexcept
 {
-  try {
-    ssize_t nbytes = socket.GetSocket().WriteNoWait(buffer);
-    if (nbytes < 0)
-      throw MakeSocketError("Failed to send");
-  } catch (...) {
-    OnSendError(address, std::current_exception());
+  if (buffer.size() > MAX_DATAGRAM_SIZE) {
+    SendNow(address, buffer);
+    return;
+  }
+
+  if (n_queued == send_queue->size()) {
+    FlushSendQueue();
+
+    if (n_queued == send_queue->size()) {
+      /* the socket buffer is still full */
+      OnSendError(address, std::make_exception_ptr(
+                    std::runtime_error("Send queue is full")));
+      return;
+    }
   }
+
+  auto &datagram = (*send_queue)[n_queued++];
+  datagram.address = address;
+  datagram.size = buffer.size();
+  std::copy(buffer.begin(), buffer.end(), datagram.data.begin());
+
+  flush_event.Schedule();
+}
+
+void
+Server::FlushSendQueue() noexcept
+{
+  flush_event.Cancel();
+
+  auto &queue = *send_queue;
+
+#ifdef __linux__
+  std::array<struct iovec, BATCH_SIZE> iov;
+  std::array<struct mmsghdr, BATCH_SIZE> msgs;
+
+  for (std::size_t i = 0; i < n_queued; ++i) {
+    const auto payload = queue[i].GetPayload();
+    iov[i] = {payload.data(), payload.size()};
+    msgs[i].msg_hdr = MakeMsgHdr(SocketAddress{queue[i].address},
+                                 {&iov[i], 1}, {});
+  }
+
+  std::size_t i = 0;
+  while (i < n_queued) {
+    int n = sendmmsg(socket.GetSocket().Get(), &msgs[i], n_queued - i,
+                     MSG_DONTWAIT|MSG_NOSIGNAL);
+    if (n > 0) {
+      i += n;
+      continue;
+    }
+
+    const auto e = GetSocketError();
+    if (IsSocketErrorSendWouldBlock(e))
+      /* the socket buffer is full; try again when the socket
+         becomes writable */
+      break;
+
+    /* the datagram at this position has failed; report it and go
+       on with the next one */
+    OnSendError(queue[i].address,
+                std::make_exception_ptr(MakeSocketError(e, "Failed to send")));
+    ++i;
+  }
+#else
+  std::size_t i = 0;
+  for (; i < n_queued; ++i) {
+    if (socket.GetSocket().WriteNoWait(queue[i].GetPayload(),
+                                       queue[i].address) >= 0)
+      continue;
+
+    const auto e = GetSocketError();
+    if (IsSocketErrorSendWouldBlock(e))
+      break;
+
+    OnSendError(queue[i].address,
+                std::make_exception_ptr(MakeSocketError(e, "Failed to send")));
+  }
+#endif
+
+  /* keep the datagrams which were not sent yet */
+  std::move(queue.begin() + i, queue.begin() + n_queued, queue.begin());
+  n_queued -= i;
+
+  if (n_queued > 0)
+    socket.ScheduleWrite();
+  else
+    socket.CancelWrite();
 }
 
 void
@@ -162,25 +271,96 @@ Server::OnDatagramReceived(Client &&client,
   }
 }
 
+std::size_t
+Server::ReceiveBatch(std::size_t max)
+{
+  assert(max <= BATCH_SIZE);
+
+  auto &batch = *receive_buffer;
+
+#ifdef __linux__
+  std::array<struct iovec, BATCH_SIZE> iov;
+  std::array<struct mmsghdr, BATCH_SIZE> msgs;
+
+  for (std::size_t i = 0; i < max; ++i) {
+    iov[i] = {batch[i].data.data(), batch[i].data.size()};
+    msgs[i].msg_hdr = MakeMsgHdr(batch[i].address, {&iov[i], 1}, {});
+  }
+
+  int n = recvmmsg(socket.GetSocket().Get(), msgs.data(), max,
+                   MSG_DONTWAIT, nullptr);
+  if (n < 0) {
+    const auto e = GetSocketError();
+    if (IsSocketErrorReceiveWouldBlock(e))
+      return 0;
+
+    throw MakeSocketError(e, "Failed to receive");
+  }
+
+  for (std::size_t i = 0; i < std::size_t(n); ++i) {
+    batch[i].address.SetSize(msgs[i].msg_hdr.msg_namelen);
+    batch[i].size = msgs[i].msg_hdr.msg_flags & MSG_TRUNC
+      /* too large for our buffer; drop it (by pretending it's
+         empty) instead of parsing a truncated datagram */
+      ? 0
+      : msgs[i].msg_len;
+  }
+
+  return n;
+#else
+  for (std::size_t i = 0; i < max; ++i) {
+    ssize_t nbytes = socket.GetSocket().ReadNoWait(batch[i].data,
+                                                   batch[i].address);
+    if (nbytes < 0) {
+      const auto e = GetSocketError();
+      if (IsSocketErrorReceiveWouldBlock(e))
+        return i;
+
+      throw MakeSocketError(e, "Failed to receive");
+    }
+
+    /* a datagram which fills the whole buffer may have been
+       truncated; drop it (by pretending it's empty) */
+    batch[i].size = std::size_t(nbytes) < batch[i].data.size()
+      ? nbytes
+      : 0;
+  }
+
+  return max;
+#endif
+}
+
 void
-Server::OnSocketReady(unsigned) noexcept
+Server::OnSocketReady(unsigned events) noexcept
 try {
-  // TODO: use recvmmsg() on Linux
+  if (events & SocketEvent::WRITE)
+    /* the socket buffer has room again for the datagrams which
+       FlushSendQueue() could not send */
+    FlushSendQueue();
+
+  for (std::size_t budget = RECEIVE_BUDGET; budget > 0;) {
+    const std::size_t max = std::min(budget, BATCH_SIZE);
+    const std::size_t n = ReceiveBatch(max);
+
+    for (std::size_t i = 0; i < n; ++i) {
+      auto &datagram = (*receive_buffer)[i];
 
-  Client client;
-  socklen_t address_size = sizeof(client.address);
-  char buffer[4096];
+      Client client;
+      client.address = datagram.address;
 
-  ssize_t nbytes = recvfrom(socket.GetSocket().Get(), buffer, sizeof(buffer),
-                            MSG_DONTWAIT,
-                            client.address, &address_size);
-  if (nbytes < 0)
-    throw MakeSocketError("Failed to receive");
+      const auto payload = datagram.GetPayload();
+      OnDatagramReceived(std::move(client), payload.data(), payload.size());
+    }
 
-  client.address.SetSize(address_size);
-  // TODO: set client.key
+    /* send all responses to this batch with one system call */
+    FlushSendQueue();
 
-  OnDatagramReceived(std::move(client), buffer, nbytes);
+    if (n < max)
+      /* the socket is drained */
+      break;
+
+    budget -= n;
+  }
 } catch (...) {
   socket.Close();
   OnError(std::current_exception());
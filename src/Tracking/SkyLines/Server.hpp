@@ -4,12 +4,15 @@
 #pragma once
 
 #include "event/SocketEvent.hxx"
+#include "event/DeferEvent.hxx"
 #include "net/StaticSocketAddress.hxx"
 #include "util/SpanCast.hxx"
 
+#include <array>
 #include <chrono>
 #include <cstdint>
 #include <exception>
+#include <memory>
 #include <span>
 
 struct GeoPoint;
@@ -21,10 +24,57 @@ namespace SkyLinesTracking {
  *
  * To use this class, derive your class from it and implement the
  * virtual methods.
+ *
+ * Datagrams are received and sent in batches (with recvmmsg() and
+ * sendmmsg() on Linux).  Responses passed to SendBuffer() are queued
+ * and flushed after the current batch of requests has been handled.
  */
 class Server {
+public:
+  /**
+   * The largest datagram which can be received or queued.
+   */
+  static constexpr std::size_t MAX_DATAGRAM_SIZE = 2048;
+
+private:
+  /**
+   * The maximum number of datagrams per system call.
+   */
+  static constexpr std::size_t BATCH_SIZE = 64;
+
+  /**
+   * The maximum number of datagrams handled in one OnSocketReady()
+   * call; after that, other events get a chance to run.
+   */
+  static constexpr std::size_t RECEIVE_BUDGET = 4 * BATCH_SIZE;
+
+  struct Datagram {
+    StaticSocketAddress address;
+    std::size_t size;
+    std::array<std::byte, MAX_DATAGRAM_SIZE> data;
+
+    std::span<std::byte> GetPayload() noexcept {
+      return {data.data(), size};
+    }
+  };
+
+  using DatagramBatch = std::array<Datagram, BATCH_SIZE>;
+
   SocketEvent socket;
 
+  /**
+   * Flushes the #send_queue if SendBuffer() was called outside of
+   * OnSocketReady().
+   */
+  DeferEvent flush_event;
+
+  const std::unique_ptr<DatagramBatch> receive_buffer, send_queue;
+
+  /**
+   * The number of datagrams in #send_queue.
+   */
+  std::size_t n_queued = 0;
+
 public:
   struct Client {
     StaticSocketAddress address;
@@ -32,7 +82,14 @@ public:
   };
 
 public:
-  Server(EventLoop &event_loop, SocketAddress server_address);
+  /**
+   * Throws on error.
+   *
+   * @param reuse_port set SO_REUSEPORT, to allow several instances
+   * (one per thread) to share the port
+   */
+  Server(EventLoop &event_loop, SocketAddress server_address,
+         bool reuse_port=false);
 
   ~Server();
 
@@ -50,6 +107,11 @@ public:
     return socket.GetEventLoop();
   }
 
+  /**
+   * Queue a datagram.  It will be sent with the next batch.  If the
+   * queue is full and cannot be flushed, the datagram is dropped
+   * and OnSendError() is called.
+   */
   void SendBuffer(SocketAddress address,
                   std::span<const std::byte> buffer) noexcept;
 
@@ -58,7 +120,26 @@ public:
     SendBuffer(address, ReferenceAsBytes(packet));
   }
 
+  /**
+   * Send all queued datagrams now.  Those which do not fit into the
+   * socket buffer remain queued until the socket becomes writable.
+   */
+  void FlushSendQueue() noexcept;
+
 private:
+  void SendNow(SocketAddress address,
+               std::span<const std::byte> buffer) noexcept;
+
+  /**
+   * Receive up to #max datagrams into #receive_buffer without
+   * blocking.
+   *
+   * Throws on error.
+   *
+   * @return the number of datagrams received
+   */
+  std::size_t ReceiveBatch(std::size_t max);
+
   void OnDatagramReceived(Client &&client, void *data, size_t length);
   void OnSocketReady(unsigned events) noexcept;
 
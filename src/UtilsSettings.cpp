@@ -124,7 +124,7 @@ SettingsLeave(const UISettings &old_ui_settings)
   if (WaypointFileChanged || AirfieldFileChanged) {
     // re-load waypoints
     WaypointGlue::LoadWaypoints(way_points, data_components->terrain.get(),
-                                operation);
+                                file_cache, operation);
 
     try {
       WaypointDetails::ReadFileFromProfile(way_points, operation);
@@ -158,7 +158,7 @@ SettingsLeave(const UISettings &old_ui_settings)
 
     auto &topography = *data_components->topography;
     topography.Reset();
-    LoadConfiguredTopography(topography);
+    LoadConfiguredTopography(topography, file_cache);
     main_window.SetTopography(&topography);
   }
 
@@ -4,6 +4,8 @@
 #include "Factory.hpp"
 #include "Terrain/RasterTerrain.hpp"
 
+#include <vector>
+
 bool
 WaypointFactory::FallbackElevation(Waypoint &waypoint) const noexcept
 {
@@ -19,3 +21,32 @@ WaypointFactory::FallbackElevation(Waypoint &waypoint) const noexcept
 
   return false;
 }
+
+void
+WaypointFactory::FallbackElevations(std::span<Waypoint> waypoints) const noexcept
+{
+  if (terrain == nullptr)
+    return;
+
+  std::vector<Waypoint *> missing;
+  std::vector<GeoPoint> locations;
+  for (auto &i : waypoints) {
+    if (!i.has_elevation) {
+      missing.push_back(&i);
+      locations.push_back(i.location);
+    }
+  }
+
+  if (missing.empty())
+    return;
+
+  std::vector<TerrainHeight> heights(locations.size());
+  terrain->GetTerrainHeights(locations, heights);
+
+  for (std::size_t i = 0; i < missing.size(); ++i) {
+    if (!heights[i].IsSpecial()) {
+      missing[i]->elevation = heights[i].GetValue();
+      missing[i]->has_elevation = true;
+    }
+  }
+}
@@ -5,6 +5,8 @@
 
 #include "Engine/Waypoint/Waypoint.hpp"
 
+#include <span>
+
 class RasterTerrain;
 
 /**
@@ -24,6 +26,15 @@ public:
                            const RasterTerrain *_terrain=nullptr) noexcept
     :origin(_origin), file_num(_file_num), terrain(_terrain) {}
 
+  /**
+   * Return a copy of this object which does not look up terrain
+   * elevations.  This is used to obtain parser results which do not
+   * depend on the terrain file.
+   */
+  WaypointFactory WithoutTerrain() const noexcept {
+    return WaypointFactory{origin, file_num};
+  }
+
   [[gnu::pure]]
   Waypoint Create(const GeoPoint &location) const noexcept {
     Waypoint w(location);
@@ -42,4 +53,12 @@ public:
    * set, false if no fallback was found
    */
   bool FallbackElevation(Waypoint &waypoint) const noexcept;
+
+  /**
+   * Apply FallbackElevation() to all waypoints in the list which
+   * have no elevation.  This is faster than calling
+   * FallbackElevation() for each of them, because the terrain is
+   * locked only once and the lookups are ordered by terrain tile.
+   */
+  void FallbackElevations(std::span<Waypoint> waypoints) const noexcept;
 };
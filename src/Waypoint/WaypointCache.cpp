@@ -0,0 +1,230 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#include "WaypointCache.hpp"
+#include "Factory.hpp"
+#include "Engine/Waypoint/Waypoint.hpp"
+#include "io/BufferedOutputStream.hxx"
+#include "io/BufferedReader.hxx"
+#include "util/SpanCast.hxx"
+
+#include <cstdint>
+#include <iterator> // for std::distance()
+#include <stdexcept>
+
+#include <string.h>
+
+namespace {
+
+struct CacheHeader {
+  static constexpr uint32_t VERSION = 2;
+
+  uint32_t version;
+  uint32_t n_waypoints;
+};
+
+/**
+ * The fixed-size part of a cached #Waypoint.  It is followed by the
+ * variable-length strings.
+ */
+struct CacheRecord {
+  GeoPoint location;
+  double elevation;
+  uint32_t original_id;
+  Runway runway;
+  RadioFrequency radio_frequency;
+
+  /**
+   * The enum and bool attributes are stored as plain integers, to be
+   * able to validate them before converting them back.
+   */
+  uint8_t flags;
+  uint8_t type;
+  uint8_t has_elevation;
+};
+
+/**
+ * Bits of CacheRecord::flags.
+ */
+enum : uint8_t {
+  FLAG_TURN_POINT = 0x1,
+  FLAG_HOME = 0x2,
+  FLAG_START_POINT = 0x4,
+  FLAG_FINISH_POINT = 0x8,
+  FLAG_WATCHED = 0x10,
+  FLAG_ALL = 0x1f,
+};
+
+/**
+ * Sanity limits; anything larger is considered a corrupt cache file.
+ */
+static constexpr uint32_t MAX_WAYPOINTS = 1024 * 1024;
+static constexpr uint32_t MAX_STRING_LENGTH = 1024 * 1024;
+
+} // anonymous namespace
+
+static constexpr uint8_t
+PackFlags(Waypoint::Flags flags) noexcept
+{
+  return (flags.turn_point ? FLAG_TURN_POINT : 0) |
+    (flags.home ? FLAG_HOME : 0) |
+    (flags.start_point ? FLAG_START_POINT : 0) |
+    (flags.finish_point ? FLAG_FINISH_POINT : 0) |
+    (flags.watched ? FLAG_WATCHED : 0);
+}
+
+static constexpr Waypoint::Flags
+UnpackFlags(uint8_t flags) noexcept
+{
+  Waypoint::Flags result;
+  result.turn_point = flags & FLAG_TURN_POINT;
+  result.home = flags & FLAG_HOME;
+  result.start_point = flags & FLAG_START_POINT;
+  result.finish_point = flags & FLAG_FINISH_POINT;
+  result.watched = flags & FLAG_WATCHED;
+  return result;
+}
+
+static void
+WriteString(BufferedOutputStream &os, std::string_view s)
+{
+  const uint32_t length = s.size();
+  os.WriteT(length);
+  os.Write(s);
+}
+
+static void
+WriteStringList(BufferedOutputStream &os,
+                const std::forward_list<std::string> &list)
+{
+  const uint32_t n = std::distance(list.begin(), list.end());
+  os.WriteT(n);
+  for (const auto &i : list)
+    WriteString(os, i);
+}
+
+static void
+SaveWaypoint(BufferedOutputStream &os, const Waypoint &wp)
+{
+  CacheRecord record;
+
+  /* zero-fill all implicit padding bytes (to make valgrind happy) */
+  memset(static_cast<void *>(&record), 0, sizeof(record));
+
+  record.location = wp.location;
+  record.elevation = wp.elevation;
+  record.original_id = wp.original_id;
+  record.runway = wp.runway;
+  record.radio_frequency = wp.radio_frequency;
+  record.flags = PackFlags(wp.flags);
+  record.type = static_cast<uint8_t>(wp.type);
+  record.has_elevation = wp.has_elevation;
+
+  os.Write(ReferenceAsBytes(record));
+
+  WriteString(os, wp.shortname);
+  WriteString(os, wp.name);
+  WriteString(os, wp.comment);
+  WriteString(os, wp.details);
+  WriteStringList(os, wp.files_embed);
+
+#ifdef HAVE_RUN_FILE
+  WriteStringList(os, wp.files_external);
+#else
+  os.WriteT(uint32_t(0));
+#endif
+}
+
+void
+SaveWaypointCache(BufferedOutputStream &os,
+                  std::span<const Waypoint> waypoints)
+{
+  CacheHeader header;
+  memset(&header, 0, sizeof(header));
+  header.version = CacheHeader::VERSION;
+  header.n_waypoints = waypoints.size();
+  os.Write(ReferenceAsBytes(header));
+
+  for (const auto &i : waypoints)
+    SaveWaypoint(os, i);
+}
+
+static std::string
+ReadString(BufferedReader &r)
+{
+  const auto length = r.ReadFullT<uint32_t>();
+  if (length > MAX_STRING_LENGTH)
+    throw std::runtime_error("Malformed waypoint cache string");
+
+  std::string s(length, '\0');
+  r.ReadFull(std::as_writable_bytes(std::span{s.data(), s.size()}));
+  return s;
+}
+
+static std::forward_list<std::string>
+ReadStringList(BufferedReader &r)
+{
+  std::forward_list<std::string> list;
+  auto n = r.ReadFullT<uint32_t>();
+
+  auto i = list.before_begin();
+  for (; n > 0; --n)
+    i = list.insert_after(i, ReadString(r));
+
+  return list;
+}
+
+static Waypoint
+LoadWaypoint(BufferedReader &r, const WaypointFactory &factory)
+{
+  const auto record = r.ReadFullT<CacheRecord>();
+  if (!record.location.Check())
+    throw std::runtime_error("Malformed waypoint cache location");
+
+  if ((record.flags & ~FLAG_ALL) != 0 ||
+      record.type > static_cast<uint8_t>(Waypoint::Type::PGLANDING) ||
+      record.has_elevation > 1)
+    throw std::runtime_error("Malformed waypoint cache record");
+
+  Waypoint wp = factory.Create(record.location);
+  wp.elevation = record.elevation;
+  wp.original_id = record.original_id;
+  wp.runway = record.runway;
+  wp.radio_frequency = record.radio_frequency;
+  wp.flags = UnpackFlags(record.flags);
+  wp.type = static_cast<Waypoint::Type>(record.type);
+  wp.has_elevation = record.has_elevation != 0;
+
+  wp.shortname = ReadString(r);
+  wp.name = ReadString(r);
+  wp.comment = ReadString(r);
+  wp.details = ReadString(r);
+  wp.files_embed = ReadStringList(r);
+
+#ifdef HAVE_RUN_FILE
+  wp.files_external = ReadStringList(r);
+#else
+  ReadStringList(r);
+#endif
+
+  return wp;
+}
+
+std::vector<Waypoint>
+LoadWaypointCache(BufferedReader &r, const WaypointFactory &factory)
+{
+  const auto header = r.ReadFullT<CacheHeader>();
+  if (header.version != CacheHeader::VERSION)
+    throw std::runtime_error("Waypoint cache version mismatch");
+
+  if (header.n_waypoints > MAX_WAYPOINTS)
+    throw std::runtime_error("Malformed waypoint cache header");
+
+  std::vector<Waypoint> waypoints;
+  waypoints.reserve(header.n_waypoints);
+
+  for (unsigned i = 0; i < header.n_waypoints; ++i)
+    waypoints.emplace_back(LoadWaypoint(r, factory));
+
+  return waypoints;
+}
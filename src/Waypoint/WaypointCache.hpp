@@ -0,0 +1,34 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#pragma once
+
+#include <span>
+#include <vector>
+
+struct Waypoint;
+class WaypointFactory;
+class BufferedReader;
+class BufferedOutputStream;
+
+/**
+ * Write the specified waypoints to a binary cache file.  The
+ * attributes assigned by the #WaypointFactory (origin, file number)
+ * are not stored, because they depend on the configuration and not
+ * on the file contents.
+ *
+ * Throws on error.
+ */
+void
+SaveWaypointCache(BufferedOutputStream &os,
+                  std::span<const Waypoint> waypoints);
+
+/**
+ * Load waypoints from a binary cache file written by
+ * SaveWaypointCache().  Each #Waypoint is created by the given
+ * #WaypointFactory.
+ *
+ * Throws on error (including a version mismatch).
+ */
+std::vector<Waypoint>
+LoadWaypointCache(BufferedReader &r, const WaypointFactory &factory);
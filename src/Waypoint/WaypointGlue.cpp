@@ -25,11 +25,12 @@ LoadWaypointFile(Waypoints &waypoints, Path path,
                  WaypointOrigin origin,
                  uint8_t file_num,
                  const RasterTerrain *terrain,
+                 FileCache *cache,
                  ProgressListener &progress) noexcept
 try {
   ReadWaypointFile(path, file_type, waypoints,
                    WaypointFactory(origin, file_num, terrain),
-                   progress);
+                   progress, cache);
   return true;
 } catch (...) {
   LogFmt("Failed to read waypoint file: {}", path);
@@ -42,11 +43,12 @@ LoadWaypointFile(Waypoints &waypoints, Path path,
                  WaypointOrigin origin,
                  uint8_t file_num,
                  const RasterTerrain *terrain,
+                 FileCache *cache,
                  ProgressListener &progress) noexcept
 try {
-  ReadWaypointFile(path, waypoints,
+  ReadWaypointFile(path, DetermineWaypointFileType(path), waypoints,
                    WaypointFactory(origin, file_num, terrain),
-                   progress);
+                   progress, cache);
   return true;
 } catch (...) {
   LogFmt("Failed to read waypoint file: {}", path);
@@ -74,7 +76,7 @@ try {
 
 bool
 LoadWaypoints(Waypoints &way_points, const RasterTerrain *terrain,
-              ProgressListener &progress)
+              FileCache *cache, ProgressListener &progress)
 {
   bool found = false;
 
@@ -87,7 +89,7 @@ LoadWaypoints(Waypoints &way_points, const RasterTerrain *terrain,
   uint8_t file_num = 0;
   for (const auto &path : paths) {
     found |= LoadWaypointFile(way_points, path, WaypointOrigin::PRIMARY,
-                              file_num++, terrain, progress);
+                              file_num++, terrain, cache, progress);
   }
 
   // ### WATCHED WAYPOINT/THIRD FILE ###
@@ -96,7 +98,7 @@ LoadWaypoints(Waypoints &way_points, const RasterTerrain *terrain,
   file_num = 0;
   for (const auto &path : paths) {
     found |= LoadWaypointFile(way_points, path, WaypointOrigin::WATCHED,
-                              file_num++, terrain, progress);
+                              file_num++, terrain, cache, progress);
   }
 
   // ### MAP/FOURTH FILE ###
@@ -123,7 +125,7 @@ LoadWaypoints(Waypoints &way_points, const RasterTerrain *terrain,
   //Load user.cup
   LoadWaypointFile(way_points, LocalPath("user.cup"),
                    WaypointFileType::SEEYOU,
-                   WaypointOrigin::USER, 0, terrain, progress);
+                   WaypointOrigin::USER, 0, terrain, cache, progress);
   // Optimise the waypoint list after attaching new waypoints
   way_points.Optimise();
 
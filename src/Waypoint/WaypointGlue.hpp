@@ -7,6 +7,7 @@
 
 class Waypoints;
 class RasterTerrain;
+class FileCache;
 class ProgressListener;
 struct PlacesOfInterestSettings;
 struct TeamCodeSettings;
@@ -86,10 +87,13 @@ SaveHome(ProfileMap &profile,
  * specified waypoint list
  * @param way_points The waypoint list to fill
  * @param terrain RasterTerrain (for automatic waypoint height)
+ * @param cache an optional #FileCache which stores the parsed
+ * waypoint files
  */
 bool
 LoadWaypoints(Waypoints &way_points,
               const RasterTerrain *terrain,
+              FileCache *cache,
               ProgressListener &progress);
 
 /**
@@ -9,8 +9,13 @@
 #include "WaypointReaderOzi.hpp"
 #include "WaypointReaderCompeGPS.hpp"
 #include "WaypointFileType.hpp"
+#include "WaypointCache.hpp"
+#include "Engine/Waypoint/Waypoints.hpp"
 #include "system/Path.hpp"
+#include "io/FileCache.hpp"
 #include "io/FileReader.hxx"
+#include "io/FileOutputStream.hxx"
+#include "io/BufferedOutputStream.hxx"
 #include "io/CupxArchive.hpp"
 #include "io/MemoryReader.hxx"
 #include "io/ZipReader.hpp"
@@ -18,8 +23,11 @@
 #include "io/BufferedReader.hxx"
 
 #include "util/Compiler.h"
+#include "util/HexFormat.hxx"
 
 #include <memory>
+#include <optional>
+#include <vector>
 
 static WaypointReaderBase *
 CreateWaypointReader(WaypointFileType type, WaypointFactory factory)
@@ -56,7 +64,7 @@ CreateWaypointReader(WaypointFileType type, WaypointFactory factory)
 static void
 ReadWaypointFile(Reader &file_reader, WaypointFileType file_type,
                  uint_least64_t total_size,
-                 Waypoints &way_points, WaypointFactory factory,
+                 std::vector<Waypoint> &way_points, WaypointFactory factory,
                  ProgressListener &progress)
 {
   ProgressReader progress_reader{file_reader, total_size, progress};
@@ -80,9 +88,9 @@ ReadWaypointFile(Reader &file_reader, WaypointFileType file_type,
   }
 }
 
-void
+static void
 ReadWaypointFile(Path path, WaypointFileType file_type,
-                 Waypoints &way_points,
+                 std::vector<Waypoint> &way_points,
                  WaypointFactory factory, ProgressListener &progress)
 {
   if (file_type == WaypointFileType::CUPX) {
@@ -102,6 +110,101 @@ ReadWaypointFile(Path path, WaypointFileType file_type,
                    way_points, factory, progress);
 }
 
+static void
+AppendWaypoints(Waypoints &way_points, std::vector<Waypoint> &&src) noexcept
+{
+  for (auto &i : src)
+    way_points.Append(std::move(i));
+}
+
+void
+ReadWaypointFile(Path path, WaypointFileType file_type,
+                 Waypoints &way_points,
+                 WaypointFactory factory, ProgressListener &progress)
+{
+  std::vector<Waypoint> parsed;
+  ReadWaypointFile(path, file_type, parsed, factory, progress);
+  AppendWaypoints(way_points, std::move(parsed));
+}
+
+/**
+ * Generate a cache file name which is unique for the given waypoint
+ * file path.
+ */
+static std::string
+MakeWaypointCacheName(Path path) noexcept
+{
+  /* FNV-1a */
+  uint32_t hash = 2166136261u;
+  for (const char *p = path.c_str(); *p != 0; ++p)
+    hash = (hash ^ (uint8_t)*p) * 16777619u;
+
+  char buffer[] = "waypoints-00000000";
+  HexFormatUint32Fixed(buffer + 10, hash);
+  return buffer;
+}
+
+/**
+ * @return the cached waypoints (possibly an empty list), or
+ * std::nullopt if there is no valid cache file
+ */
+static std::optional<std::vector<Waypoint>>
+LoadWaypointCache(FileCache &cache, const char *cache_name, Path path,
+                  const WaypointFactory &factory) noexcept
+try {
+  auto r = cache.Load(cache_name, path);
+  if (!r)
+    return std::nullopt;
+
+  BufferedReader br{*r};
+  return LoadWaypointCache(br, factory);
+} catch (...) {
+  cache.Flush(cache_name);
+  return std::nullopt;
+}
+
+static void
+SaveWaypointCache(FileCache &cache, const char *cache_name, Path path,
+                  std::span<const Waypoint> waypoints) noexcept
+try {
+  auto os = cache.Save(cache_name, path);
+  WithBufferedOutputStream(*os, [waypoints](BufferedOutputStream &bos){
+    SaveWaypointCache(bos, waypoints);
+  });
+  os->Commit();
+} catch (...) {
+  cache.Flush(cache_name);
+}
+
+void
+ReadWaypointFile(Path path, WaypointFileType file_type,
+                 Waypoints &way_points,
+                 WaypointFactory factory, ProgressListener &progress,
+                 FileCache *cache)
+{
+  std::string cache_name;
+  std::optional<std::vector<Waypoint>> cached;
+
+  if (cache != nullptr) {
+    cache_name = MakeWaypointCacheName(path);
+    cached = LoadWaypointCache(*cache, cache_name.c_str(), path, factory);
+  }
+
+  std::vector<Waypoint> waypoints;
+  if (cached) {
+    waypoints = std::move(*cached);
+  } else {
+    /* without terrain elevation fallbacks, which are applied below */
+    ReadWaypointFile(path, file_type, waypoints, factory.WithoutTerrain(),
+                     progress);
+    if (cache != nullptr)
+      SaveWaypointCache(*cache, cache_name.c_str(), path, waypoints);
+  }
+
+  factory.FallbackElevations(waypoints);
+  AppendWaypoints(way_points, std::move(waypoints));
+}
+
 void
 ReadWaypointFile(Path path, Waypoints &way_points,
                  WaypointFactory factory, ProgressListener &progress)
@@ -116,6 +219,8 @@ ReadWaypointFile(struct zzip_dir *dir, const char *path,
                  WaypointFactory factory, ProgressListener &progress)
 {
   ZipReader file_reader{dir, path};
+  std::vector<Waypoint> parsed;
   ReadWaypointFile(file_reader, file_type, file_reader.GetSize(),
-                   way_points, factory, progress);
+                   parsed, factory, progress);
+  AppendWaypoints(way_points, std::move(parsed));
 }
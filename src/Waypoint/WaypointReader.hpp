@@ -11,6 +11,7 @@ class Path;
 class Waypoints;
 class WaypointFactory;
 class ProgressListener;
+class FileCache;
 
 /**
  * Throws on error.
@@ -20,6 +21,20 @@ ReadWaypointFile(Path path, WaypointFileType file_type,
                  Waypoints &way_points,
                  WaypointFactory factory, ProgressListener &progress);
 
+/**
+ * Like the above, but use the given #FileCache (if not nullptr) to
+ * skip parsing when the file has not been modified since the last
+ * call.  Terrain elevation fallbacks are applied in one batch after
+ * loading, so the cache does not depend on the terrain file.
+ *
+ * Throws on error.
+ */
+void
+ReadWaypointFile(Path path, WaypointFileType file_type,
+                 Waypoints &way_points,
+                 WaypointFactory factory, ProgressListener &progress,
+                 FileCache *cache);
+
 /**
  * Throws on error.
  */
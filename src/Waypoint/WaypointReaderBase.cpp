@@ -5,7 +5,8 @@
 #include "io/BufferedReader.hxx"
 
 void
-WaypointReaderBase::Parse(Waypoints &way_points, BufferedReader &reader)
+WaypointReaderBase::Parse(std::vector<Waypoint> &way_points,
+                          BufferedReader &reader)
 {
   // Read through the lines of the file
   char *line;
@@ -5,7 +5,8 @@
 
 #include "Factory.hpp"
 
-class Waypoints;
+#include <vector>
+
 class BufferedReader;
 
 class WaypointReaderBase
@@ -25,7 +26,7 @@ public:
    * @param way_points The waypoint list to fill
    * @return True if the waypoint file parsing was okay, False otherwise
    */
-  void Parse(Waypoints &way_points, BufferedReader &reader);
+  void Parse(std::vector<Waypoint> &way_points, BufferedReader &reader);
 
 protected:
   /**
@@ -36,5 +37,6 @@ protected:
    * @return True if the line was parsed correctly or ignored, False if
    * parsing error occured
    */
-  virtual bool ParseLine(const char *line, Waypoints &way_points) = 0;
+  virtual bool ParseLine(const char *line,
+                         std::vector<Waypoint> &way_points) = 0;
 };
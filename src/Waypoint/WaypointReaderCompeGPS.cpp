@@ -2,10 +2,12 @@
 // Copyright The XCSoar Project
 
 #include "WaypointReaderCompeGPS.hpp"
-#include "Waypoint/Waypoints.hpp"
 #include "Geo/UTM.hpp"
+#include "util/StringCompare.hxx"
 #include "util/StringSplit.hxx"
 
+#include <string.h>
+
 static bool
 ParseAngle(const char *&src, Angle &angle) noexcept
 {
@@ -119,7 +121,7 @@ ParseAltitude(const char *&src, double &dest) noexcept
 }
 
 bool
-WaypointReaderCompeGPS::ParseLine(const char *line, Waypoints &waypoints)
+WaypointReaderCompeGPS::ParseLine(const char *line, std::vector<Waypoint> &waypoints)
 {
   /*
    * G  WGS 84
@@ -208,7 +210,7 @@ WaypointReaderCompeGPS::ParseLine(const char *line, Waypoints &waypoints)
   // Parse waypoint name
   waypoint.comment.assign(string_converter.Convert(line));
 
-  waypoints.Append(std::move(waypoint));
+  waypoints.emplace_back(std::move(waypoint));
   return true;
 }
 
@@ -2,11 +2,12 @@
 // Copyright The XCSoar Project
 
 #include "WaypointReaderFS.hpp"
-#include "Waypoint/Waypoints.hpp"
 #include "Geo/UTM.hpp"
+#include "util/StringCompare.hxx"
 #include "util/StringStrip.hxx"
 
 #include <stdlib.h>
+#include <string.h>
 
 static bool
 ParseAngle(const char *src, Angle &angle) noexcept
@@ -110,7 +111,7 @@ ParseAltitude(const char *src, double &dest) noexcept
 }
 
 bool
-WaypointReaderFS::ParseLine(const char *line, Waypoints &way_points)
+WaypointReaderFS::ParseLine(const char *line, std::vector<Waypoint> &way_points)
 {
   //$FormatGEO
   //ACONCAGU  S 32 39 12.00    W 070 00 42.00  6962  Aconcagua
@@ -160,7 +161,7 @@ WaypointReaderFS::ParseLine(const char *line, Waypoints &way_points)
   if (len > (is_utm ? 38 : 47))
     new_waypoint.comment = std::string{string_converter.Convert(line + (is_utm ? 38 : 47))};
 
-  way_points.Append(std::move(new_waypoint));
+  way_points.emplace_back(std::move(new_waypoint));
   return true;
 }
 
@@ -175,7 +175,8 @@ ParseStyle(std::string_view src, Waypoint::Type &type)
   return true;
 }
 
-bool ParseSeeYou(WaypointFactory factory, Waypoints &waypoints, BufferedReader &reader) {
+bool ParseSeeYou(WaypointFactory factory, std::vector<Waypoint> &waypoints,
+                 BufferedReader &reader) {
   StringConverter string_converter;
 
   // 2018: name, code, country, lat, lon, elev, style, rwydir, rwylen, freq, desc
@@ -347,8 +348,18 @@ bool ParseSeeYou(WaypointFactory factory, Waypoints &waypoints, BufferedReader &
         new_waypoint.files_embed.emplace_front(string_converter.Convert(i));
       }
     }
-    waypoints.Append(std::move(new_waypoint));
+    waypoints.emplace_back(std::move(new_waypoint));
   }
 
   return tasks;
 }
+
+bool ParseSeeYou(WaypointFactory factory, Waypoints &waypoints, BufferedReader &reader) {
+  std::vector<Waypoint> parsed;
+  const bool tasks = ParseSeeYou(factory, parsed, reader);
+
+  for (auto &i : parsed)
+    waypoints.Append(std::move(i));
+
+  return tasks;
+}
@@ -5,6 +5,8 @@
 
 #include "Factory.hpp"
 
+#include <vector>
+
 class Waypoints;
 class BufferedReader;
 
@@ -14,4 +16,12 @@ class BufferedReader;
  *
  * Throws on error.
  */
+bool ParseSeeYou(WaypointFactory factory, std::vector<Waypoint> &waypoints,
+                 BufferedReader &reader);
+
+/**
+ * Like the above, but append the waypoints to a #Waypoints container.
+ *
+ * Throws on error.
+ */
 bool ParseSeeYou(WaypointFactory factory, Waypoints &waypoints, BufferedReader &reader);
@@ -3,11 +3,11 @@
 
 #include "WaypointReaderWinPilot.hpp"
 #include "Units/System.hpp"
-#include "Waypoint/Waypoints.hpp"
 #include "util/NumberParser.hxx"
 #include "util/StringSplit.hxx"
 
 #include <math.h>
+#include <string.h>
 
 static std::string_view
 NextColumn(std::string_view &line) noexcept
@@ -198,7 +198,7 @@ ParseFlags(std::string_view src, Waypoint &dest)
 }
 
 bool
-WaypointReaderWinPilot::ParseLine(const char *line, Waypoints &waypoints)
+WaypointReaderWinPilot::ParseLine(const char *line, std::vector<Waypoint> &waypoints)
 {
   // If (end-of-file)
   if (line[0] == '\0')
@@ -253,6 +253,6 @@ WaypointReaderWinPilot::ParseLine(const char *line, Waypoints &waypoints)
   new_waypoint.comment = std::string{string_converter.Convert(comment)};
   ParseRunwayDirection(comment, new_waypoint.runway);
 
-  waypoints.Append(std::move(new_waypoint));
+  waypoints.emplace_back(std::move(new_waypoint));
   return true;
 }
@@ -2,10 +2,10 @@
 // Copyright The XCSoar Project
 
 #include "WaypointReaderZander.hpp"
-#include "Waypoint/Waypoints.hpp"
 #include "util/StringStrip.hxx"
 
 #include <stdlib.h>
+#include <string.h>
 
 static bool
 ParseString(StringConverter &string_converter,
@@ -130,7 +130,7 @@ ParseFlagsFromDescription(const char *src, Waypoint &dest) noexcept
 }
 
 bool
-WaypointReaderZander::ParseLine(const char *line, Waypoints &way_points)
+WaypointReaderZander::ParseLine(const char *line, std::vector<Waypoint> &way_points)
 {
   // If (end-of-file or comment)
   if (line[0] == '\0' || line[0] == '*')
@@ -177,6 +177,6 @@ WaypointReaderZander::ParseLine(const char *line, Waypoints &way_points)
     if (len < 36 || !ParseFlagsFromDescription(line + 35, new_waypoint))
       new_waypoint.flags.turn_point = true;
 
-  way_points.Append(std::move(new_waypoint));
+  way_points.emplace_back(std::move(new_waypoint));
   return true;
 }
@@ -15,5 +15,5 @@ public:
 
 protected:
   /* virtual methods from class WaypointReaderBase */
-  bool ParseLine(const char *line, Waypoints &way_points) override;
+  bool ParseLine(const char *line, std::vector<Waypoint> &way_points) override;
 };
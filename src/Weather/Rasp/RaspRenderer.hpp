@@ -72,6 +72,14 @@ public:
   bool Generate(const WindowProjection &projection,
                 const TerrainRendererSettings &settings);
 
+  /**
+   * Returns a serial which changes each time Generate() renders a
+   * new image.
+   */
+  Serial GetSerial() const {
+    return raster_renderer.GetSerial();
+  }
+
   void Draw(Canvas &canvas, const WindowProjection &projection) const {
     raster_renderer.Draw(canvas, projection, true);
   }
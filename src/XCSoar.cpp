@@ -52,6 +52,9 @@ static const char *const Usage = "\n"
   "  -fly            bypass startup-screen, use fly mode directly\n"
 #endif
   "  -profile=fname  load profile from file fname\n"
+  "  -frame-profile=fname\n"
+  "                  write render/calculation timing statistics to fname\n"
+  "                  on exit (Chrome trace format if it ends with .trace.json)\n"
   "  -WIDTHxHEIGHT   use screen resolution WIDTH x HEIGHT\n"
   "  -portrait       use a 480x640 screen resolution\n"
   "  -square         use a 480x480 screen resolution\n"
@@ -18,16 +18,33 @@ EndOfLine(const char *line) noexcept
 }
 
 CSVLine::CSVLine(const char *line) noexcept
-  :data(line), end(EndOfLine(line)) {}
+  :data(line), end(EndOfLine(line)), start(line) {}
+
+inline const char *
+CSVLine::FindSeparator() noexcept
+{
+  /* skip index entries which were already consumed, e.g. by
+     ReadChecked() which moves #data without calling ReadView() */
+  for (; next_separator < n_separators; ++next_separator) {
+    const char *p = start + separators[next_separator];
+    if (p >= data)
+      return p < end ? p : nullptr;
+  }
+
+  if (separators_complete)
+    return nullptr;
+
+  return static_cast<const char *>(memchr(data, ',', end - data));
+}
 
 std::string_view
 CSVLine::ReadView() noexcept
 {
-  const char* _separator = strchr(data, ',');
+  const char *_separator = FindSeparator();
 
   const char *s = data;
   std::size_t length;
-  if (_separator != nullptr && _separator < end) {
+  if (_separator != nullptr) {
     length = _separator - data;
     data = _separator + 1;
   } else {
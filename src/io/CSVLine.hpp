@@ -3,7 +3,9 @@
 
 #pragma once
 
+#include <array>
 #include <cstddef>
+#include <cstdint>
 #include <string_view>
 
 /**
@@ -13,6 +15,56 @@ class CSVLine {
 protected:
   const char *data, *end;
 
+  /**
+   * The maximum number of separator positions which can be stored
+   * in #separators.
+   */
+  static constexpr std::size_t MAX_SEPARATORS = 64;
+
+  /**
+   * The beginning of the line; #separators are relative to this.
+   */
+  const char *start;
+
+  /**
+   * The number of valid elements in #separators.
+   */
+  uint_least8_t n_separators = 0;
+
+  /**
+   * The index of the first element in #separators which may still
+   * be ahead of #data.
+   */
+  uint_least8_t next_separator = 0;
+
+  /**
+   * If true, then #separators contains all separators of the line
+   * and ReadView() does not need to scan for more.
+   */
+  bool separators_complete = false;
+
+  /**
+   * Positions of the separators (relative to #start), collected in
+   * advance by a derived class.  If this index is not complete,
+   * ReadView() falls back to scanning the line after the last known
+   * separator.
+   */
+  std::array<uint_least16_t, MAX_SEPARATORS> separators;
+
+  /**
+   * Add a separator position to the index.  Must be called in
+   * ascending order.
+   *
+   * @return false if the index is full
+   */
+  bool AddSeparator(std::size_t position) noexcept {
+    if (n_separators >= MAX_SEPARATORS || position > UINT_LEAST16_MAX)
+      return false;
+
+    separators[n_separators++] = position;
+    return true;
+  }
+
 public:
   explicit CSVLine(const char *line) noexcept;
 
@@ -24,6 +76,16 @@ public:
     return data >= end;
   }
 
+private:
+  /**
+   * Find the next separator at or after #data.
+   *
+   * @return the separator or nullptr if this is the last column
+   */
+  const char *FindSeparator() noexcept;
+
+public:
+
   /**
    * Read one column and return its contents as a std::string_view.
    */
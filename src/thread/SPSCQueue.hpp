@@ -0,0 +1,98 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+
+/**
+ * A bounded lock-free queue for exactly one producer thread and
+ * exactly one consumer thread.  Neither side ever blocks; the caller
+ * decides what to do when the queue is full or empty.
+ *
+ * The capacity must be a power of two.
+ */
+template<typename T, std::size_t N>
+class SPSCQueue {
+  static_assert(N > 0 && (N & (N - 1)) == 0,
+                "Capacity must be a power of two");
+
+  std::array<T, N> items;
+
+  /**
+   * The number of items ever pushed.  Written only by the producer.
+   */
+  alignas(64) std::atomic<std::size_t> head{0};
+
+  /**
+   * The number of items ever popped.  Written only by the consumer.
+   */
+  alignas(64) std::atomic<std::size_t> tail{0};
+
+public:
+  static constexpr std::size_t capacity() noexcept {
+    return N;
+  }
+
+  /**
+   * The number of items in the queue.  This is only a snapshot when
+   * called while the other thread is active.
+   */
+  std::size_t size() const noexcept {
+    return head.load(std::memory_order_acquire) -
+      tail.load(std::memory_order_acquire);
+  }
+
+  bool empty() const noexcept {
+    return size() == 0;
+  }
+
+  /**
+   * Obtain the slot for the next item, to be filled in-place and
+   * then published with Push().  May only be called by the producer.
+   *
+   * @return nullptr if the queue is full
+   */
+  T *Prepare() noexcept {
+    const std::size_t h = head.load(std::memory_order_relaxed);
+    if (h - tail.load(std::memory_order_acquire) >= N)
+      return nullptr;
+
+    return &items[h % N];
+  }
+
+  /**
+   * Publish the slot returned by Prepare().
+   */
+  void Push() noexcept {
+    const std::size_t h = head.load(std::memory_order_relaxed);
+    assert(h - tail.load(std::memory_order_relaxed) < N);
+    head.store(h + 1, std::memory_order_release);
+  }
+
+  /**
+   * Obtain the oldest item.  May only be called by the consumer.
+   *
+   * @return nullptr if the queue is empty
+   */
+  T *Front() noexcept {
+    const std::size_t t = tail.load(std::memory_order_relaxed);
+    if (t == head.load(std::memory_order_acquire))
+      return nullptr;
+
+    return &items[t % N];
+  }
+
+  /**
+   * Release the item returned by Front(), making its slot available
+   * to the producer again.
+   */
+  void Pop() noexcept {
+    const std::size_t t = tail.load(std::memory_order_relaxed);
+    assert(t != head.load(std::memory_order_relaxed));
+    tail.store(t + 1, std::memory_order_release);
+  }
+};
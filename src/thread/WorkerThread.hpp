@@ -74,6 +74,17 @@ public:
     trigger_cond.notify_one();
   }
 
+  /**
+   * Call Tick() in the current thread.  This is only allowed while
+   * the thread is not running; it allows driving several worker
+   * threads in lock step, e.g. for a headless replay.
+   */
+  void SynchronousTick() noexcept {
+    assert(!IsDefined());
+
+    Tick();
+  }
+
 protected:
   virtual void Run() noexcept;
 
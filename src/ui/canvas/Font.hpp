@@ -22,6 +22,9 @@ class GLTexture;
 #endif
 
 #ifdef USE_FREETYPE
+#include <cstdint>
+#include <memory>
+
 typedef struct FT_FaceRec_ *FT_Face;
 #endif
 
@@ -119,6 +122,48 @@ public:
   }
 #endif
 
+#ifdef USE_FREETYPE
+  /**
+   * A single glyph rendered to an 8 bit alpha bitmap.
+   */
+  struct RasterizedGlyph {
+    std::unique_ptr<uint8_t[]> data;
+    PixelSize size;
+
+    /**
+     * The position of the bitmap relative to the pen position; #top
+     * is relative to the top of the line.
+     */
+    int left, top;
+
+    /**
+     * The horizontal pen advance.
+     */
+    int advance;
+  };
+
+  /**
+   * @return the glyph index of the given character or 0 if the font
+   * has no such glyph
+   */
+  [[gnu::pure]]
+  unsigned GetGlyphIndex(unsigned ch) const noexcept;
+
+  /**
+   * @return the kerning between two glyphs in pixels
+   */
+  [[gnu::pure]]
+  int GetKerning(unsigned previous_index, unsigned index) const noexcept;
+
+  /**
+   * Render one glyph.  The bitmap and its position match what
+   * Render() draws for this glyph.
+   *
+   * @return false if the glyph could not be loaded
+   */
+  bool RasterizeGlyph(unsigned index, RasterizedGlyph &glyph) const noexcept;
+#endif
+
   unsigned GetHeight() const noexcept {
     return height;
   }
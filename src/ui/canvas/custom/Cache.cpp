@@ -10,6 +10,9 @@
 #ifdef ENABLE_OPENGL
 #include "ui/canvas/opengl/Texture.hpp"
 #include "ui/canvas/opengl/Debug.hpp"
+#ifdef USE_FREETYPE
+#include "ui/canvas/opengl/GlyphAtlas.hpp"
+#endif
 #else
 #include "thread/Mutex.hxx"
 #endif
@@ -264,4 +267,8 @@ TextCache::Flush() noexcept
 
   size_cache.Clear();
   text_cache.Clear();
+
+#if defined(ENABLE_OPENGL) && defined(USE_FREETYPE)
+  GlyphAtlas::Flush();
+#endif
 }
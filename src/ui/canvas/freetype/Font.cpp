@@ -389,3 +389,76 @@ Font::Render(std::string_view text, const PixelSize size,
                   x, y);
     });
 }
+
+unsigned
+Font::GetGlyphIndex(unsigned ch) const noexcept
+{
+#ifndef ENABLE_OPENGL
+  const std::lock_guard lock{freetype_mutex};
+#endif
+
+  return FT_Get_Char_Index(face, ch);
+}
+
+int
+Font::GetKerning(unsigned previous_index, unsigned index) const noexcept
+{
+  if (!FT_HAS_KERNING(face) || previous_index == 0 || index == 0)
+    return 0;
+
+#ifndef ENABLE_OPENGL
+  const std::lock_guard lock{freetype_mutex};
+#endif
+
+  FT_Vector delta;
+  if (FT_Get_Kerning(face, previous_index, index, ft_kerning_default,
+                     &delta))
+    return 0;
+
+  return delta.x >> 6;
+}
+
+bool
+Font::RasterizeGlyph(unsigned index, RasterizedGlyph &glyph) const noexcept
+{
+#ifndef ENABLE_OPENGL
+  const std::lock_guard lock{freetype_mutex};
+#endif
+
+  if (FT_Load_Glyph(face, index, load_flags))
+    return false;
+
+  const FT_GlyphSlot slot = face->glyph;
+  const FT_Glyph_Metrics &metrics = slot->metrics;
+
+  glyph.left = FT_FLOOR(metrics.horiBearingX);
+  glyph.top = int(ascent_height) - FT_FLOOR(metrics.horiBearingY);
+  glyph.advance = FT_CEIL(metrics.horiAdvance);
+  glyph.size = {};
+  glyph.data.reset();
+
+  /* like RenderGlyph(), a rendering failure leaves a blank glyph
+     which still advances the pen */
+  if (FT_Render_Glyph(slot, render_mode))
+    return true;
+
+  FT_Bitmap bitmap = slot->bitmap;
+  if (IsMono())
+    ConvertMono(bitmap, slot->bitmap);
+
+  if (bitmap.width > 0 && bitmap.rows > 0) {
+    glyph.size = {bitmap.width, bitmap.rows};
+    glyph.data.reset(new uint8_t[BufferSize(glyph.size)]);
+
+    uint8_t *dest = glyph.data.get();
+    const uint8_t *src = bitmap.buffer;
+    for (unsigned y = 0; y < bitmap.rows;
+         ++y, dest += bitmap.width, src += bitmap.pitch)
+      std::copy_n(src, bitmap.width, dest);
+  }
+
+  if (IsMono())
+    delete[] bitmap.buffer;
+
+  return true;
+}
@@ -10,7 +10,9 @@
 #include "NEON.hpp"
 #endif
 
-#ifdef __MMX__
+#ifdef __SSE2__
+#include "SSE2.hpp"
+#elif defined(__MMX__)
 #include "MMX.hpp"
 #endif
 
@@ -103,6 +105,46 @@ struct TransparentPixelOperations<GreyscalePixelTraits>
 
 #endif
 
+#ifdef __SSE2__
+
+template<>
+struct BitOrPixelOperations<GreyscalePixelTraits>
+  : SelectOptimisedPixelOperations<SSE2BitOrPixelOperations<GreyscalePixelTraits>, 16,
+                                   PortableBitOrPixelOperations<GreyscalePixelTraits>> {
+};
+
+template<>
+struct TransparentPixelOperations<GreyscalePixelTraits>
+  : public SelectOptimisedPixelOperations<SSE2Transparent8PixelOperations, 16,
+                                          PortableTransparentPixelOperations<GreyscalePixelTraits>> {
+  typedef typename PixelTraits::color_type color_type;
+
+  explicit constexpr TransparentPixelOperations(const color_type key)
+    :SelectOptimisedPixelOperations(key) {}
+};
+
+#ifndef GREYSCALE
+
+template<>
+struct BitOrPixelOperations<BGRAPixelTraits>
+  : SelectOptimisedPixelOperations<SSE2BitOrPixelOperations<BGRAPixelTraits>, 4,
+                                   PortableBitOrPixelOperations<BGRAPixelTraits>> {
+};
+
+template<>
+struct TransparentPixelOperations<BGRAPixelTraits>
+  : public SelectOptimisedPixelOperations<SSE2Transparent32PixelOperations, 4,
+                                          PortableTransparentPixelOperations<BGRAPixelTraits>> {
+  typedef typename PixelTraits::color_type color_type;
+
+  explicit constexpr TransparentPixelOperations(const color_type key)
+    :SelectOptimisedPixelOperations(key) {}
+};
+
+#endif /* !GREYSCALE */
+
+#endif /* __SSE2__ */
+
 template<AnyPixelTraits PixelTraits>
 class AlphaPixelOperations
   : public PortableAlphaPixelOperations<PixelTraits> {
@@ -124,7 +166,34 @@ public:
 
 #endif
 
-#ifdef __MMX__
+#ifdef __SSE2__
+
+template<>
+class AlphaPixelOperations<GreyscalePixelTraits>
+  : public SelectOptimisedPixelOperations<SSE2Alpha8PixelOperations, 16,
+                                          PortableAlphaPixelOperations<GreyscalePixelTraits>> {
+public:
+  explicit constexpr AlphaPixelOperations(const uint8_t alpha)
+    :SelectOptimisedPixelOperations(alpha) {}
+};
+
+#ifndef GREYSCALE
+
+template<>
+class AlphaPixelOperations<BGRAPixelTraits>
+  : public SelectOptimisedPixelOperations<SSE2Alpha32PixelOperations, 4,
+                                          PortableAlphaPixelOperations<BGRAPixelTraits>> {
+public:
+  using typename SelectOptimisedPixelOperations::PixelTraits;
+  using typename SelectOptimisedPixelOperations::SourcePixelTraits;
+
+  explicit constexpr AlphaPixelOperations(const uint8_t alpha)
+    :SelectOptimisedPixelOperations(alpha) {}
+};
+
+#endif /* !GREYSCALE */
+
+#elif defined(__MMX__)
 
 template<>
 class AlphaPixelOperations<GreyscalePixelTraits>
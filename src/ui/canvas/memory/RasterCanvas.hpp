@@ -10,7 +10,12 @@
 #include "ui/dim/Point.hpp"
 #include "util/AllocatedArray.hxx"
 
+#ifdef __SSE2__
+#include "SSE2.hpp"
+#endif
+
 #include <cassert>
+#include <type_traits>
 
 /*
   line_masks:
@@ -839,6 +844,21 @@ public:
       src_size &= 0xf;
       dest_size = src_size * 2;
     }
+#elif defined(__SSE2__)
+    if constexpr (std::is_same_v<PixelOperations,
+                                 PixelTraitsOperations<PixelTraits>> &&
+                  std::is_same_v<SPT, PixelTraits>) {
+      if (dest_size == src_size * 2) {
+        /* SSE2-optimised special case for plain copies */
+        const unsigned n = SSE2PixelsTwice::CopyPixels(dest, src, src_size);
+
+        /* use the portable version for the remainder */
+        src = SPT::Next(src, n);
+        dest = PixelTraits::Next(dest, n * 2);
+        src_size -= n;
+        dest_size = src_size * 2;
+      }
+    }
 #endif
 
     unsigned j = 0;
@@ -0,0 +1,328 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#pragma once
+
+#include "PixelTraits.hpp"
+#include "ui/canvas/PortableColor.hpp"
+
+#ifndef __SSE2__
+#error SSE2 required
+#endif
+
+#include <emmintrin.h>
+
+/*
+ * All kernels in this file produce exactly the same pixels as their
+ * portable counterparts in PixelOperations.hpp; TestPixelOperations
+ * verifies that.  They process only whole vectors; the remainder is
+ * left to the portable implementation by
+ * #SelectOptimisedPixelOperations.
+ */
+
+namespace SSE2 {
+
+[[gnu::always_inline]]
+static inline __m128i
+Load(const void *p) noexcept
+{
+  return _mm_loadu_si128((const __m128i *)p);
+}
+
+[[gnu::always_inline]]
+static inline void
+Store(void *p, __m128i v) noexcept
+{
+  _mm_storeu_si128((__m128i *)p, v);
+}
+
+/**
+ * Blend eight 16 bit channels: (p * (256 - alpha) + q * alpha) / 256.
+ * This equals PixelAlphaOperation's "p + (q - p) * alpha / 256"
+ * (rounding towards negative infinity), and no intermediate result
+ * exceeds 16 bits.
+ */
+[[gnu::always_inline]]
+static inline __m128i
+AlphaBlend8(__m128i p, __m128i q_alpha, __m128i inverse_alpha) noexcept
+{
+  return _mm_srli_epi16(_mm_add_epi16(_mm_mullo_epi16(p, inverse_alpha),
+                                      q_alpha),
+                        8);
+}
+
+/**
+ * Blend 16 bytes with 16 bytes which have already been multiplied
+ * with alpha (as two vectors of 16 bit channels).
+ */
+[[gnu::always_inline]]
+static inline __m128i
+AlphaBlendPremultiplied16(__m128i p, __m128i q_alpha_lo, __m128i q_alpha_hi,
+                          __m128i inverse_alpha) noexcept
+{
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i lo = AlphaBlend8(_mm_unpacklo_epi8(p, zero),
+                                 q_alpha_lo, inverse_alpha);
+  const __m128i hi = AlphaBlend8(_mm_unpackhi_epi8(p, zero),
+                                 q_alpha_hi, inverse_alpha);
+  return _mm_packus_epi16(lo, hi);
+}
+
+[[gnu::always_inline]]
+static inline __m128i
+AlphaBlend16(__m128i p, __m128i q,
+             __m128i alpha, __m128i inverse_alpha) noexcept
+{
+  const __m128i zero = _mm_setzero_si128();
+  return AlphaBlendPremultiplied16(p,
+                                   _mm_mullo_epi16(_mm_unpacklo_epi8(q, zero),
+                                                   alpha),
+                                   _mm_mullo_epi16(_mm_unpackhi_epi8(q, zero),
+                                                   alpha),
+                                   inverse_alpha);
+}
+
+/**
+ * Replace the bytes selected by #mask with the ones from #p.
+ */
+[[gnu::always_inline]]
+static inline __m128i
+Keep(__m128i result, __m128i p, __m128i mask) noexcept
+{
+  return _mm_or_si128(_mm_andnot_si128(mask, result),
+                      _mm_and_si128(mask, p));
+}
+
+/**
+ * Alpha-blend #n bytes (a multiple of 16).
+ *
+ * @param keep_mask bytes which shall not be modified (e.g. the
+ * alpha channel of BGRA pixels)
+ */
+[[gnu::always_inline]]
+static inline void
+AlphaCopy(uint8_t *gcc_restrict p, const uint8_t *gcc_restrict q,
+          unsigned n, uint8_t alpha, __m128i keep_mask) noexcept
+{
+  const __m128i v_alpha = _mm_set1_epi16(alpha);
+  const __m128i inverse_alpha = _mm_set1_epi16(256 - alpha);
+
+  for (unsigned i = 0; i < n / 16; ++i, p += 16, q += 16) {
+    const __m128i pv = Load(p);
+    Store(p, Keep(AlphaBlend16(pv, Load(q), v_alpha, inverse_alpha),
+                  pv, keep_mask));
+  }
+}
+
+/**
+ * Alpha-blend a constant color into #n bytes (a multiple of 16).
+ *
+ * @param color_alpha the color channels multiplied with alpha, as
+ * 16 bit integers; the pattern repeats every 16 bytes
+ */
+[[gnu::always_inline]]
+static inline void
+AlphaFill(uint8_t *p, unsigned n, uint8_t alpha,
+          __m128i color_alpha, __m128i keep_mask) noexcept
+{
+  const __m128i inverse_alpha = _mm_set1_epi16(256 - alpha);
+
+  for (unsigned i = 0; i < n / 16; ++i, p += 16) {
+    const __m128i pv = Load(p);
+    Store(p, Keep(AlphaBlendPremultiplied16(pv, color_alpha, color_alpha,
+                                            inverse_alpha),
+                  pv, keep_mask));
+  }
+}
+
+} // namespace SSE2
+
+/**
+ * Implementation of AlphaPixelOperations using Intel SSE2
+ * instructions.
+ */
+class SSE2Alpha8PixelOperations {
+  uint8_t alpha;
+
+public:
+  using PixelTraits = GreyscalePixelTraits;
+  using SourcePixelTraits = GreyscalePixelTraits;
+
+  explicit constexpr SSE2Alpha8PixelOperations(uint8_t _alpha)
+    :alpha(_alpha) {}
+
+  [[gnu::hot]] [[gnu::flatten]] [[gnu::nonnull]]
+  void FillPixels(Luminosity8 *p, unsigned n, Luminosity8 c) const {
+    SSE2::AlphaFill((uint8_t *)p, n, alpha,
+                    _mm_set1_epi16(short(c.GetLuminosity() * alpha)),
+                    _mm_setzero_si128());
+  }
+
+  [[gnu::hot]] [[gnu::flatten]]
+  void CopyPixels(Luminosity8 *gcc_restrict p,
+                  const Luminosity8 *gcc_restrict q, unsigned n) const {
+    SSE2::AlphaCopy((uint8_t *)p, (const uint8_t *)q, n, alpha,
+                    _mm_setzero_si128());
+  }
+};
+
+#ifndef GREYSCALE
+
+/**
+ * Implementation of AlphaPixelOperations<BGRAPixelTraits> using
+ * Intel SSE2 instructions.  Like the portable version, it leaves
+ * the alpha channel of the destination alone.
+ */
+class SSE2Alpha32PixelOperations {
+  uint8_t alpha;
+
+  [[gnu::const]]
+  static __m128i AlphaChannelMask() noexcept {
+    /* x86 is little-endian: the alpha byte is the most significant
+       one */
+    return _mm_set1_epi32(int(0xff000000));
+  }
+
+public:
+  using PixelTraits = BGRAPixelTraits;
+  using SourcePixelTraits = BGRAPixelTraits;
+
+  explicit constexpr SSE2Alpha32PixelOperations(uint8_t _alpha)
+    :alpha(_alpha) {}
+
+  [[gnu::hot]] [[gnu::flatten]] [[gnu::nonnull]]
+  void FillPixels(BGRA8Color *p, unsigned n, BGRA8Color c) const {
+    /* two pixels per 16 bit vector, in memory order */
+    const __m128i color = _mm_setr_epi16(c.Blue(), c.Green(), c.Red(), 0,
+                                         c.Blue(), c.Green(), c.Red(), 0);
+    SSE2::AlphaFill((uint8_t *)p, n * 4, alpha,
+                    _mm_mullo_epi16(color, _mm_set1_epi16(alpha)),
+                    AlphaChannelMask());
+  }
+
+  [[gnu::hot]] [[gnu::flatten]]
+  void CopyPixels(BGRA8Color *gcc_restrict p,
+                  const BGRA8Color *gcc_restrict q, unsigned n) const {
+    SSE2::AlphaCopy((uint8_t *)p, (const uint8_t *)q, n * 4, alpha,
+                    AlphaChannelMask());
+  }
+};
+
+#endif /* !GREYSCALE */
+
+/**
+ * Implementation of BitOrPixelOperations using Intel SSE2
+ * instructions.  This works with all pixel formats.
+ */
+template<AnyPixelTraits PT>
+class SSE2BitOrPixelOperations {
+public:
+  using PixelTraits = PT;
+  using SourcePixelTraits = PT;
+
+  [[gnu::hot]] [[gnu::flatten]]
+  void CopyPixels(typename PT::rpointer p, typename PT::const_rpointer q,
+                  unsigned n) const {
+    uint8_t *p2 = (uint8_t *)p;
+    const uint8_t *q2 = (const uint8_t *)q;
+    const unsigned n_bytes = n * sizeof(*p);
+
+    for (unsigned i = 0; i < n_bytes / 16; ++i, p2 += 16, q2 += 16)
+      SSE2::Store(p2, _mm_or_si128(SSE2::Load(p2), SSE2::Load(q2)));
+  }
+};
+
+/**
+ * Implementation of TransparentPixelOperations using Intel SSE2
+ * instructions.
+ */
+class SSE2Transparent8PixelOperations {
+  uint8_t key;
+
+public:
+  using PixelTraits = GreyscalePixelTraits;
+  using SourcePixelTraits = GreyscalePixelTraits;
+
+  explicit constexpr SSE2Transparent8PixelOperations(Luminosity8 _key)
+    :key(_key.GetLuminosity()) {}
+
+  [[gnu::hot]] [[gnu::flatten]]
+  void CopyPixels(Luminosity8 *gcc_restrict p,
+                  const Luminosity8 *gcc_restrict q, unsigned n) const {
+    const __m128i v_key = _mm_set1_epi8(key);
+
+    uint8_t *p2 = (uint8_t *)p;
+    const uint8_t *q2 = (const uint8_t *)q;
+    for (unsigned i = 0; i < n / 16; ++i, p2 += 16, q2 += 16) {
+      const __m128i qv = SSE2::Load(q2);
+      SSE2::Store(p2, SSE2::Keep(qv, SSE2::Load(p2),
+                                 _mm_cmpeq_epi8(qv, v_key)));
+    }
+  }
+};
+
+#ifndef GREYSCALE
+
+class SSE2Transparent32PixelOperations {
+  BGRA8Color key;
+
+public:
+  using PixelTraits = BGRAPixelTraits;
+  using SourcePixelTraits = BGRAPixelTraits;
+
+  explicit constexpr SSE2Transparent32PixelOperations(BGRA8Color _key)
+    :key(_key) {}
+
+  [[gnu::hot]] [[gnu::flatten]]
+  void CopyPixels(BGRA8Color *gcc_restrict p,
+                  const BGRA8Color *gcc_restrict q, unsigned n) const {
+    const __m128i v_key = _mm_set1_epi32(BGRAPixelTraits::ToInteger(key));
+
+    for (unsigned i = 0; i < n / 4; ++i, p += 4, q += 4) {
+      const __m128i qv = SSE2::Load(q);
+      SSE2::Store(p, SSE2::Keep(qv, SSE2::Load(p),
+                                _mm_cmpeq_epi32(qv, v_key)));
+    }
+  }
+};
+
+#endif /* !GREYSCALE */
+
+/**
+ * Read pixels and emit each pixel twice (horizontal upscaling by
+ * two).
+ */
+struct SSE2PixelsTwice {
+  /**
+   * @param n the number of source pixels; only whole vectors are
+   * copied
+   * @return the number of source pixels which were copied
+   */
+  static unsigned CopyPixels(Luminosity8 *gcc_restrict p,
+                             const Luminosity8 *gcc_restrict q,
+                             unsigned n) noexcept {
+    const unsigned n_vectors = n / 16;
+    for (unsigned i = 0; i < n_vectors; ++i, p += 32, q += 16) {
+      const __m128i v = SSE2::Load(q);
+      SSE2::Store(p, _mm_unpacklo_epi8(v, v));
+      SSE2::Store(p + 16, _mm_unpackhi_epi8(v, v));
+    }
+
+    return n_vectors * 16;
+  }
+
+#ifndef GREYSCALE
+  static unsigned CopyPixels(BGRA8Color *gcc_restrict p,
+                             const BGRA8Color *gcc_restrict q,
+                             unsigned n) noexcept {
+    const unsigned n_vectors = n / 4;
+    for (unsigned i = 0; i < n_vectors; ++i, p += 8, q += 4) {
+      const __m128i v = SSE2::Load(q);
+      SSE2::Store(p, _mm_unpacklo_epi32(v, v));
+      SSE2::Store(p + 4, _mm_unpackhi_epi32(v, v));
+    }
+
+    return n_vectors * 4;
+  }
+#endif
+};
@@ -10,6 +10,9 @@
 #include "Buffer.hpp"
 #include "VertexPointer.hpp"
 #include "ExactPixelPoint.hpp"
+#ifdef USE_FREETYPE
+#include "GlyphAtlas.hpp"
+#endif
 #include "ui/canvas/custom/Cache.hpp"
 #include "ui/canvas/Bitmap.hpp"
 #include "ui/canvas/Util.hpp"
@@ -578,6 +581,20 @@ Canvas::DrawText(PixelPoint p, std::string_view text) noexcept
   if (text3.empty())
     return;
 
+#ifdef USE_FREETYPE
+  const PixelRect rect{p, TextCache::GetSize(*font, text3)};
+  if (rect.GetWidth() == 0 || rect.GetHeight() == 0)
+    return;
+
+  if (background_mode == OPAQUE)
+    DrawFilledRectangle(rect, background_color);
+
+  PrepareColoredAlphaTexture(text_color);
+
+  const ScopeAlphaBlend alpha_blend;
+
+  GlyphAtlas::DrawText(*font, p, text3, rect);
+#else
   GLTexture *texture = TextCache::Get(*font, text3);
   if (texture == nullptr)
     return;
@@ -591,6 +608,7 @@ Canvas::DrawText(PixelPoint p, std::string_view text) noexcept
 
   texture->Bind();
   texture->Draw(p);
+#endif
 }
 
 void
@@ -608,6 +626,14 @@ Canvas::DrawTransparentText(PixelPoint p, std::string_view text) noexcept
   if (text3.empty())
     return;
 
+#ifdef USE_FREETYPE
+  PrepareColoredAlphaTexture(text_color);
+
+  const ScopeAlphaBlend alpha_blend;
+
+  GlyphAtlas::DrawText(*font, p, text3,
+                       {p, TextCache::GetSize(*font, text3)});
+#else
   GLTexture *texture = TextCache::Get(*font, text3);
   if (texture == nullptr)
     return;
@@ -618,6 +644,7 @@ Canvas::DrawTransparentText(PixelPoint p, std::string_view text) noexcept
 
   texture->Bind();
   texture->Draw(p);
+#endif
 }
 
 void
@@ -636,6 +663,19 @@ Canvas::DrawClippedText(PixelPoint p, PixelSize size,
   if (text3.empty())
     return;
 
+#ifdef USE_FREETYPE
+  const PixelSize text_size = TextCache::GetSize(*font, text3);
+  if (text_size.height < size.height)
+    size.height = text_size.height;
+  if (text_size.width < size.width)
+    size.width = text_size.width;
+
+  PrepareColoredAlphaTexture(text_color);
+
+  const ScopeAlphaBlend alpha_blend;
+
+  GlyphAtlas::DrawText(*font, p, text3, {p, size});
+#else
   GLTexture *texture = TextCache::Get(*font, text3);
   if (texture == nullptr)
     return;
@@ -651,6 +691,7 @@ Canvas::DrawClippedText(PixelPoint p, PixelSize size,
 
   texture->Bind();
   texture->Draw({p, size}, PixelRect{size});
+#endif
 }
 
 void
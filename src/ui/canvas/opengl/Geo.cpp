@@ -3,14 +3,14 @@
 
 #include "Geo.hpp"
 #include "ui/opengl/System.hpp"
-#include "Projection/WindowProjection.hpp"
+#include "Projection/Projection.hpp"
 #include "Geo/GeoPoint.hpp"
 #include "Geo/FAISphere.hpp"
 
 #include <glm/gtc/matrix_transform.hpp>
 
 glm::mat4
-ToGLM(const WindowProjection &projection, const GeoPoint &reference) noexcept
+ToGLM(const Projection &projection, const GeoPoint &reference) noexcept
 {
   auto angle = projection.GetScreenAngle().Radians();
   auto scale = projection.GetScale();
@@ -6,8 +6,8 @@
 #include <glm/fwd.hpp>
 
 struct GeoPoint;
-class WindowProjection;
+class Projection;
 
 [[gnu::pure]]
 glm::mat4
-ToGLM(const WindowProjection &projection, const GeoPoint &reference) noexcept;
+ToGLM(const Projection &projection, const GeoPoint &reference) noexcept;
@@ -0,0 +1,312 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#include "GlyphAtlas.hpp"
+#include "Texture.hpp"
+#include "VertexPointer.hpp"
+#include "Debug.hpp"
+#include "ui/canvas/Font.hpp"
+#include "ui/dim/BulkPoint.hpp"
+#include "ui/dim/Rect.hpp"
+#include "util/UTF8.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <functional>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+/**
+ * Glyph bitmaps packed into "shelves" (rows of glyphs with similar
+ * height) of one GL_ALPHA texture.
+ */
+class Atlas {
+  static constexpr unsigned SIZE = 1024;
+
+  /**
+   * Blank pixels between glyphs, so no neighbouring glyph bleeds
+   * into a quad.
+   */
+  static constexpr unsigned PADDING = 1;
+
+public:
+  struct Glyph {
+    /**
+     * The location in the texture; empty for blank glyphs.
+     */
+    PixelRect rect;
+
+    unsigned index;
+    int left, top, advance;
+
+    /**
+     * False if FreeType failed to load this glyph; it is skipped
+     * like in Font::Render().
+     */
+    bool valid;
+  };
+
+private:
+  struct Key {
+    const Font *font;
+    unsigned ch;
+
+    constexpr bool operator==(const Key &) const noexcept = default;
+  };
+
+  struct KeyHash {
+    [[gnu::pure]]
+    std::size_t operator()(const Key &key) const noexcept {
+      return std::hash<const void *>{}(key.font) ^ (key.ch * 2654435761u);
+    }
+  };
+
+  struct Shelf {
+    unsigned top, height, x;
+  };
+
+  GLTexture texture;
+
+  std::vector<Shelf> shelves;
+
+  /**
+   * The bottom of the lowest shelf.
+   */
+  unsigned bottom = PADDING;
+
+  std::unordered_map<Key, Glyph, KeyHash> glyphs;
+
+public:
+  Atlas() noexcept
+    :texture(GL_ALPHA, {SIZE, SIZE}, GL_ALPHA, GL_UNSIGNED_BYTE,
+             std::make_unique<uint8_t[]>(SIZE * SIZE).get()) {}
+
+  GLTexture &GetTexture() noexcept {
+    return texture;
+  }
+
+  /**
+   * Look up a glyph, rendering and uploading it if it is not yet in
+   * the texture.
+   *
+   * @return nullptr if the texture is full
+   */
+  const Glyph *Get(const Font &font, unsigned ch) noexcept;
+
+private:
+  /**
+   * Reserve space for a bitmap of the given size.
+   *
+   * @return false if the texture is full
+   */
+  bool Allocate(PixelSize size, PixelPoint &position) noexcept;
+};
+
+} // anonymous namespace
+
+bool
+Atlas::Allocate(PixelSize size, PixelPoint &position) noexcept
+{
+  const unsigned width = size.width + PADDING;
+  const unsigned height = size.height + PADDING;
+
+  /* find the flattest shelf which is tall enough and has room left */
+  Shelf *best = nullptr;
+  for (auto &shelf : shelves)
+    if (shelf.height >= height && shelf.x + width <= SIZE &&
+        (best == nullptr || shelf.height < best->height))
+      best = &shelf;
+
+  /* don't waste a tall shelf on a small glyph if a new shelf can
+     still be opened */
+  if (best != nullptr && best->height > height * 2 &&
+      bottom + height <= SIZE)
+    best = nullptr;
+
+  if (best == nullptr) {
+    if (PADDING + width > SIZE || bottom + height > SIZE)
+      return false;
+
+    best = &shelves.emplace_back(Shelf{bottom, height, PADDING});
+    bottom += height;
+  }
+
+  position = PixelPoint(best->x, best->top);
+  best->x += width;
+  return true;
+}
+
+const Atlas::Glyph *
+Atlas::Get(const Font &font, unsigned ch) noexcept
+{
+  const Key key{&font, ch};
+  if (auto i = glyphs.find(key); i != glyphs.end())
+    return &i->second;
+
+  Glyph glyph{};
+  glyph.index = font.GetGlyphIndex(ch);
+
+  Font::RasterizedGlyph r;
+  glyph.valid = glyph.index != 0 && font.RasterizeGlyph(glyph.index, r);
+
+  if (glyph.valid) {
+    glyph.left = r.left;
+    glyph.top = r.top;
+    glyph.advance = r.advance;
+
+    if (r.data) {
+      PixelPoint position;
+      if (!Allocate(r.size, position))
+        return nullptr;
+
+      glyph.rect = PixelRect(position, r.size);
+
+      texture.Bind();
+      glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+      glTexSubImage2D(GL_TEXTURE_2D, 0, position.x, position.y,
+                      r.size.width, r.size.height,
+                      GL_ALPHA, GL_UNSIGNED_BYTE, r.data.get());
+    }
+  }
+
+  return &glyphs.emplace(key, glyph).first->second;
+}
+
+static std::unique_ptr<Atlas> atlas;
+
+/* reused by all DrawText() calls to avoid allocations */
+static std::vector<BulkPixelPoint> vertices;
+static std::vector<GLfloat> coords;
+
+static void
+AddQuad(PixelRect dest, PixelRect src, const PixelRect &clip,
+        const PixelSize texture_size) noexcept
+{
+  /* clip the destination and move the source rectangle along */
+  if (dest.left < clip.left) {
+    src.left += clip.left - dest.left;
+    dest.left = clip.left;
+  }
+
+  if (dest.top < clip.top) {
+    src.top += clip.top - dest.top;
+    dest.top = clip.top;
+  }
+
+  if (dest.right > clip.right) {
+    src.right -= dest.right - clip.right;
+    dest.right = clip.right;
+  }
+
+  if (dest.bottom > clip.bottom) {
+    src.bottom -= dest.bottom - clip.bottom;
+    dest.bottom = clip.bottom;
+  }
+
+  if (dest.IsEmpty())
+    return;
+
+  const GLfloat x0 = (GLfloat)src.left / texture_size.width;
+  const GLfloat y0 = (GLfloat)src.top / texture_size.height;
+  const GLfloat x1 = (GLfloat)src.right / texture_size.width;
+  const GLfloat y1 = (GLfloat)src.bottom / texture_size.height;
+
+  /* two triangles */
+  vertices.insert(vertices.end(), {
+      dest.GetTopLeft(), dest.GetTopRight(), dest.GetBottomLeft(),
+      dest.GetTopRight(), dest.GetBottomRight(), dest.GetBottomLeft(),
+    });
+
+  coords.insert(coords.end(), {
+      x0, y0, x1, y0, x0, y1,
+      x1, y0, x1, y1, x0, y1,
+    });
+}
+
+/**
+ * Convert the string to quads, using the same layout as
+ * Font::Render().
+ *
+ * @return false if the atlas is full
+ */
+static bool
+Layout(Atlas &atlas, const Font &font, PixelPoint p, std::string_view text,
+       const PixelRect &clip) noexcept
+{
+  vertices.clear();
+  coords.clear();
+
+  const PixelSize texture_size = atlas.GetTexture().GetAllocatedSize();
+
+  int x = p.x;
+  unsigned previous_index = 0;
+
+  while (!text.empty()) {
+    const auto n = NextUTF8(text.data());
+    text.remove_prefix(n.second - text.data());
+
+    const auto *glyph = atlas.Get(font, n.first);
+    if (glyph == nullptr)
+      return false;
+
+    if (!glyph->valid)
+      continue;
+
+    x += font.GetKerning(previous_index, glyph->index);
+    previous_index = glyph->index;
+
+    if (glyph->rect.GetWidth() > 0)
+      AddQuad(PixelRect(PixelPoint(x + glyph->left, p.y + glyph->top),
+                        glyph->rect.GetSize()),
+              glyph->rect, clip, texture_size);
+
+    x += glyph->advance;
+  }
+
+  return true;
+}
+
+void
+GlyphAtlas::DrawText(const Font &font, PixelPoint p, std::string_view text,
+                     const PixelRect &clip) noexcept
+{
+  assert(pthread_equal(pthread_self(), OpenGL::thread));
+  assert(font.IsDefined());
+  assert(ValidateUTF8(text));
+
+  if (!atlas)
+    atlas = std::make_unique<Atlas>();
+
+  if (!Layout(*atlas, font, p, text, clip)) {
+    /* the texture is full: start over with an empty one */
+    atlas = std::make_unique<Atlas>();
+    if (!Layout(*atlas, font, p, text, clip))
+      return;
+  }
+
+  if (vertices.empty())
+    return;
+
+  atlas->GetTexture().Bind();
+
+  const ScopeVertexPointer vp(vertices.data());
+
+  glEnableVertexAttribArray(OpenGL::Attribute::TEXCOORD);
+  glVertexAttribPointer(OpenGL::Attribute::TEXCOORD, 2, GL_FLOAT, GL_FALSE,
+                        0, coords.data());
+
+  glDrawArrays(GL_TRIANGLES, 0, vertices.size());
+
+  glDisableVertexAttribArray(OpenGL::Attribute::TEXCOORD);
+}
+
+void
+GlyphAtlas::Flush() noexcept
+{
+  atlas.reset();
+  vertices = {};
+  coords = {};
+}
@@ -0,0 +1,40 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#pragma once
+
+#include <string_view>
+
+class Font;
+struct PixelPoint;
+struct PixelRect;
+
+/**
+ * A texture containing FreeType glyphs of all fonts.  Strings are
+ * drawn as a batch of textured quads from this texture, so texts
+ * which change all the time (e.g. InfoBox values) do not need a new
+ * texture for each new value.
+ *
+ * All functions must be called from the OpenGL thread.
+ */
+namespace GlyphAtlas {
+
+/**
+ * Draw a string with one draw call.  The caller must have selected
+ * a shader for GL_ALPHA textures.
+ *
+ * @param p the top left corner of the string
+ * @param clip glyph pixels outside of this rectangle are discarded
+ */
+void
+DrawText(const Font &font, PixelPoint p, std::string_view text,
+         const PixelRect &clip) noexcept;
+
+/**
+ * Discard all glyphs and free the texture.  This must be called
+ * before a #Font gets destroyed or reloaded.
+ */
+void
+Flush() noexcept;
+
+} // namespace GlyphAtlas
@@ -6,6 +6,7 @@
 #include "system/Args.hpp"
 #include "Computer/CirclingComputer.hpp"
 #include "DebugReplay.hpp"
+#include "DebugReplayIGC.hpp"
 #include "util/Macros.hpp"
 #include "io/StdioOutputStream.hxx"
 #include "Formatter/TimeFormatter.hpp"
@@ -14,7 +15,23 @@
 #include "FlightPhaseDetector.hpp"
 #include "FlightPhaseJSON.hpp"
 #include "Computer/Settings.hpp"
+#include "system/FileUtil.hpp"
+#include "system/Path.hpp"
+#include "thread/Thread.hpp"
+#include "thread/Mutex.hxx"
+#include "util/Exception.hxx"
+#include "util/PrintException.hxx"
+#include "util/StringAPI.hxx"
 #include "util/StringCompare.hxx"
+#include "util/StringStrip.hxx"
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include <sys/resource.h>
+#include <unistd.h>
 
 using namespace std::chrono;
 
@@ -34,9 +51,6 @@ struct Result {
 };
 
 
-static CirclingComputer circling_computer;
-static FlightPhaseDetector flight_phase_detector;
-
 static void
 Update(const MoreData &basic, const FlyingState &state,
        Result &result)
@@ -69,7 +83,8 @@ Update(const MoreData &basic, const DerivedInfo &calculated,
 }
 
 static void
-ComputeCircling(DebugReplay &replay, const CirclingSettings &circling_settings)
+ComputeCircling(CirclingComputer &circling_computer,
+                DebugReplay &replay, const CirclingSettings &circling_settings)
 {
   circling_computer.TurnRate(replay.SetCalculated(),
                              replay.Basic(),
@@ -95,8 +110,13 @@ Finish(const MoreData &basic, [[maybe_unused]] const DerivedInfo &calculated,
   }
 }
 
-static void
+/**
+ * @return the number of fixes which were read
+ */
+static unsigned
 Run(DebugReplay &replay, Result &result,
+    CirclingComputer &circling_computer,
+    FlightPhaseDetector &flight_phase_detector,
     Trace &full_trace, Trace &triangle_trace, Trace &sprint_trace)
 {
   CirclingSettings circling_settings;
@@ -108,8 +128,12 @@ Run(DebugReplay &replay, Result &result,
   constexpr Angle max_longitude_change = Angle::Degrees(30);
   constexpr Angle max_latitude_change = Angle::Degrees(1);
 
+  unsigned n_fixes = 0;
+
   while (replay.Next()) {
-    ComputeCircling(replay, circling_settings);
+    ++n_fixes;
+
+    ComputeCircling(circling_computer, replay, circling_settings);
 
     const MoreData &basic = replay.Basic();
 
@@ -154,6 +178,8 @@ Run(DebugReplay &replay, Result &result,
   Update(replay.Basic(), replay.Calculated(), result);
   Finish(replay.Basic(), replay.Calculated(), result);
   flight_phase_detector.Finish();
+
+  return n_fixes;
 }
 
 [[gnu::pure]]
@@ -307,28 +333,315 @@ WriteContests(const ContestStatistics &olc_plus,
   return object;
 }
 
+
+/**
+ * The maximum number of points of the traces passed to the
+ * #ContestManager.
+ */
+struct TraceSizes {
+  unsigned full = 512, triangle = 1024, sprint = 64;
+};
+
+/**
+ * The engine instances for analysing one flight after another.  In
+ * batch mode, each worker thread has its own instance.
+ */
+class FlightAnalyser {
+  CirclingComputer circling_computer;
+  FlightPhaseDetector flight_phase_detector;
+  Trace full_trace, triangle_trace, sprint_trace;
+
+public:
+  explicit FlightAnalyser(const TraceSizes &sizes) noexcept
+    :full_trace({}, Trace::null_time, sizes.full),
+     triangle_trace({}, Trace::null_time, sizes.triangle),
+     sprint_trace({}, minutes{120}, sizes.sprint) {}
+
+  /**
+   * Replay and analyse one flight.
+   *
+   * @param n_fixes_r receives the number of fixes which were read
+   */
+  boost::json::object Analyse(DebugReplay &replay, unsigned &n_fixes_r);
+};
+
+boost::json::object
+FlightAnalyser::Analyse(DebugReplay &replay, unsigned &n_fixes_r)
+{
+  circling_computer.Reset();
+  flight_phase_detector = {};
+  full_trace.clear();
+  triangle_trace.clear();
+  sprint_trace.clear();
+
+  Result result;
+  n_fixes_r = Run(replay, result, circling_computer, flight_phase_detector,
+                  full_trace, triangle_trace, sprint_trace);
+
+  const ContestStatistics olc_plus = SolveContest(Contest::OLC_PLUS, full_trace, triangle_trace, sprint_trace);
+  const ContestStatistics dmst = SolveContest(Contest::DMST, full_trace, triangle_trace, sprint_trace);
+
+  boost::json::object root;
+
+  WriteResult(root, result);
+  root.emplace("phases", WritePhaseList(flight_phase_detector.GetPhases()));
+  root.emplace("performance",
+               WritePerformanceStats(flight_phase_detector.GetTotals()));
+  root.emplace("contests", WriteContests(olc_plus, dmst));
+
+  return root;
+}
+
+/**
+ * Collects all IGC files of a directory tree.
+ */
+class IGCFileCollector final : public File::Visitor {
+  std::vector<AllocatedPath> &files;
+
+public:
+  explicit IGCFileCollector(std::vector<AllocatedPath> &_files) noexcept
+    :files(_files) {}
+
+  void Visit(Path path, Path filename) override {
+    if (StringEndsWithIgnoreCase(filename.c_str(), ".igc"))
+      files.emplace_back(path);
+  }
+};
+
+/**
+ * Add a batch mode command line argument: an IGC file, a directory
+ * (searched recursively) or "-" (a list of files on stdin, one per
+ * line).
+ */
+static void
+AddBatchInput(std::vector<AllocatedPath> &files, const char *arg)
+{
+  if (StringIsEqual(arg, "-")) {
+    char line[4096];
+    while (fgets(line, sizeof(line), stdin) != nullptr) {
+      *StripRight(line, line + strlen(line)) = 0;
+      if (*line != 0)
+        files.emplace_back(Path(line));
+    }
+  } else if (Directory::Exists(Path(arg))) {
+    IGCFileCollector collector(files);
+    Directory::VisitFiles(Path(arg), collector, true);
+  } else
+    files.emplace_back(Path(arg));
+}
+
+/**
+ * The state shared by all batch mode worker threads.
+ */
+struct BatchJob {
+  const TraceSizes trace_sizes;
+
+  std::vector<AllocatedPath> files;
+
+  /**
+   * The index of the next file to be analysed.
+   */
+  std::atomic<std::size_t> next{0};
+
+  std::atomic<unsigned> n_failed{0};
+  std::atomic<uint_least64_t> n_fixes{0};
+
+  /**
+   * Serialises the output of the worker threads.
+   */
+  Mutex output_mutex;
+
+  explicit BatchJob(const TraceSizes &_trace_sizes) noexcept
+    :trace_sizes(_trace_sizes) {}
+
+  /**
+   * Sort the files by size (largest first), so the longest flights
+   * don't start last and leave the other threads idle.
+   */
+  void SortFiles() noexcept {
+    std::vector<std::pair<uint64_t, AllocatedPath>> sized;
+    sized.reserve(files.size());
+    for (auto &path : files) {
+      const uint64_t size = File::GetSize(path);
+      sized.emplace_back(size, std::move(path));
+    }
+
+    std::stable_sort(sized.begin(), sized.end(),
+                     [](const auto &a, const auto &b){
+                       return a.first > b.first;
+                     });
+
+    files.clear();
+    for (auto &i : sized)
+      files.emplace_back(std::move(i.second));
+  }
+
+  /**
+   * @return the next file or nullptr if there are no more files
+   */
+  const AllocatedPath *Next() noexcept {
+    const std::size_t i = next.fetch_add(1, std::memory_order_relaxed);
+    return i < files.size() ? &files[i] : nullptr;
+  }
+
+  /**
+   * Print one result as a JSON line.
+   */
+  void Emit(const boost::json::value &value) {
+    const std::lock_guard lock{output_mutex};
+
+    StdioOutputStream os(stdout);
+    Json::Serialize(os, value);
+    putchar('\n');
+  }
+};
+
+class BatchWorker final : public Thread {
+  BatchJob &job;
+
+  FlightAnalyser analyser;
+
+public:
+  explicit BatchWorker(BatchJob &_job) noexcept
+    :Thread("AnalyseFlight"), job(_job), analyser(job.trace_sizes) {}
+
+private:
+  void AnalyseFile(Path path, boost::json::object &o);
+
+  /* virtual methods from class Thread */
+  void Run() noexcept override;
+};
+
+inline void
+BatchWorker::AnalyseFile(Path path, boost::json::object &o)
+{
+  const std::unique_ptr<DebugReplay> replay{DebugReplayIGC::Create(path)};
+
+  unsigned n_fixes;
+  o.emplace("result", analyser.Analyse(*replay, n_fixes));
+  job.n_fixes.fetch_add(n_fixes, std::memory_order_relaxed);
+}
+
+void
+BatchWorker::Run() noexcept
+{
+  while (const AllocatedPath *path = job.Next()) {
+    try {
+      boost::json::object o;
+      o.emplace("file", path->c_str());
+
+      try {
+        AnalyseFile(*path, o);
+      } catch (...) {
+        o.emplace("error", GetFullMessage(std::current_exception()));
+        job.n_failed.fetch_add(1, std::memory_order_relaxed);
+      }
+
+      job.Emit(o);
+    } catch (...) {
+      PrintException(std::current_exception());
+    }
+  }
+}
+
+static double
+GetProcessCPUTime() noexcept
+{
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) < 0)
+    return 0;
+
+  return usage.ru_utime.tv_sec + usage.ru_utime.tv_usec / 1e6 +
+    usage.ru_stime.tv_sec + usage.ru_stime.tv_usec / 1e6;
+}
+
+/**
+ * Analyse many IGC files on a pool of worker threads and print one
+ * JSON object per line ("JSON Lines"), in the order of completion.
+ * The throughput is reported on stderr.
+ */
+static int
+RunBatch(Args &args, const TraceSizes &trace_sizes, unsigned n_threads)
+{
+  BatchJob job(trace_sizes);
+
+  do {
+    AddBatchInput(job.files, args.ExpectNext());
+  } while (!args.IsEmpty());
+
+  if (job.files.empty()) {
+    fputs("No IGC files found\n", stderr);
+    return EXIT_FAILURE;
+  }
+
+  job.SortFiles();
+
+  if (n_threads == 0) {
+    const long n_cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    n_threads = n_cpus > 0 ? n_cpus : 1;
+  }
+
+  n_threads = std::min<std::size_t>(n_threads, job.files.size());
+
+  const auto start_time = steady_clock::now();
+  const double start_cpu = GetProcessCPUTime();
+
+  std::vector<std::unique_ptr<BatchWorker>> workers;
+  workers.reserve(n_threads);
+  for (unsigned i = 0; i < n_threads; ++i) {
+    auto &worker = *workers.emplace_back(std::make_unique<BatchWorker>(job));
+    worker.Start();
+  }
+
+  for (auto &worker : workers)
+    worker->Join();
+
+  fflush(stdout);
+
+  const duration<double> wall_time = steady_clock::now() - start_time;
+  const double cpu_time = GetProcessCPUTime() - start_cpu;
+
+  const std::size_t n_flights = job.files.size();
+  fprintf(stderr,
+          "%zu flights (%u failed), %llu fixes in %.2f s\n"
+          "%.2f flights/s, %.0f fixes/s, %u threads, %.0f%% CPU utilisation\n",
+          n_flights, job.n_failed.load(),
+          (unsigned long long)job.n_fixes.load(),
+          wall_time.count(),
+          n_flights / wall_time.count(),
+          job.n_fixes.load() / wall_time.count(),
+          n_threads,
+          100 * cpu_time / (wall_time.count() * n_threads));
+
+  return job.n_failed == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
 int main(int argc, char **argv)
 {
-  unsigned full_max_points = 512,
-           triangle_max_points = 1024,
-           sprint_max_points = 64;
+  TraceSizes trace_sizes;
+  bool batch = false;
+  unsigned n_threads = 0;
 
   Args args(argc, argv,
             "[options] DRIVER FILE\n"
+            "       [options] --batch FILE.igc|DIRECTORY|- ...\n"
             "Options:\n"
             "  --full-points=512        Maximum number of full trace points (default = 512)\n"
             "  --triangle-points=1024   Maximum number of triangle trace points (default = 1024)\n"
-            "  --sprint-points=64       Maximum number of sprint trace points (default = 64)");
+            "  --sprint-points=64       Maximum number of sprint trace points (default = 64)\n"
+            "  --batch                  Analyse many IGC files in parallel, print one JSON object per line\n"
+            "  --jobs=N                 Number of worker threads in batch mode (default = number of CPUs)");
 
   const char *arg;
-  while ((arg = args.PeekNext()) != nullptr && *arg == '-') {
+  while ((arg = args.PeekNext()) != nullptr && *arg == '-' &&
+         !StringIsEqual(arg, "-")) {
     args.Skip();
 
     const char *value;
     if ((value = StringAfterPrefix(arg, "--full-points=")) != nullptr) {
       unsigned _points = strtol(value, NULL, 10);
       if (_points > 0)
-        full_max_points = _points;
+        trace_sizes.full = _points;
       else {
         fputs("The start parameter could not be parsed correctly.\n", stderr);
         args.UsageError();
@@ -337,7 +650,7 @@ int main(int argc, char **argv)
     } else if ((value = StringAfterPrefix(arg, "--triangle-points=")) != nullptr) {
       unsigned _points = strtol(value, NULL, 10);
       if (_points > 0)
-        triangle_max_points = _points;
+        trace_sizes.triangle = _points;
       else {
         fputs("The start parameter could not be parsed correctly.\n", stderr);
         args.UsageError();
@@ -346,47 +659,44 @@ int main(int argc, char **argv)
     } else if ((value = StringAfterPrefix(arg, "--sprint-points=")) != nullptr) {
       unsigned _points = strtol(value, NULL, 10);
       if (_points > 0)
-        sprint_max_points = _points;
+        trace_sizes.sprint = _points;
       else {
         fputs("The start parameter could not be parsed correctly.\n", stderr);
         args.UsageError();
       }
 
+    } else if (StringIsEqual(arg, "--batch")) {
+      batch = true;
+
+    } else if ((value = StringAfterPrefix(arg, "--jobs=")) != nullptr) {
+      n_threads = strtoul(value, NULL, 10);
+      if (n_threads == 0) {
+        fputs("The jobs parameter could not be parsed correctly.\n", stderr);
+        args.UsageError();
+      }
+
     } else {
       args.UsageError();
     }
   }
 
+  if (batch)
+    return RunBatch(args, trace_sizes, n_threads);
+
   DebugReplay *replay = CreateDebugReplay(args);
   if (replay == NULL)
     return EXIT_FAILURE;
 
   args.ExpectEnd();
 
-  static Trace full_trace({}, Trace::null_time, full_max_points);
-  static Trace triangle_trace({}, Trace::null_time, triangle_max_points);
-  static Trace sprint_trace({}, minutes{120}, sprint_max_points);
+  const auto analyser = std::make_unique<FlightAnalyser>(trace_sizes);
 
-  Result result;
-  Run(*replay, result, full_trace, triangle_trace, sprint_trace);
+  unsigned n_fixes;
+  const boost::json::object root = analyser->Analyse(*replay, n_fixes);
   delete replay;
 
-  const ContestStatistics olc_plus = SolveContest(Contest::OLC_PLUS, full_trace, triangle_trace, sprint_trace);
-  const ContestStatistics dmst = SolveContest(Contest::DMST, full_trace, triangle_trace, sprint_trace);
-
   StdioOutputStream os(stdout);
-
-  {
-    boost::json::object root;
-
-    WriteResult(root, result);
-    root.emplace("phases", WritePhaseList(flight_phase_detector.GetPhases()));
-    root.emplace("performance",
-                 WritePerformanceStats(flight_phase_detector.GetTotals()));
-    root.emplace("contests", WriteContests(olc_plus, dmst));
-
-    Json::Serialize(os, root);
-  }
+  Json::Serialize(os, root);
 
   return EXIT_SUCCESS;
 }
@@ -0,0 +1,657 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+/*
+ * A load generator for xcsoar-cloud-server.  It simulates many
+ * clients which move along (shifted copies of) the given IGC tracks
+ * and submit fixes, thermals and requests like XCSoar does, and
+ * reports the server's throughput and latency.
+ *
+ * The latency is measured with PING packets, because the server
+ * doesn't reply to all other requests.  With --pid, the resident
+ * memory of the (local) server process is sampled before and after
+ * the run.
+ *
+ * The output consists of "key=value" lines, suitable for scripts.
+ */
+
+#include "CloudTrack.hpp"
+#include "Tracking/SkyLines/Assemble.hpp"
+#include "Tracking/SkyLines/Protocol.hpp"
+#include "Tracking/SkyLines/Server.hpp"
+#include "Geo/Math.hpp"
+#include "io/FileLineReader.hpp"
+#include "event/Loop.hxx"
+#include "event/SocketEvent.hxx"
+#include "event/FineTimerEvent.hxx"
+#include "net/Resolver.hxx"
+#include "net/AddressInfo.hxx"
+#include "net/UniqueSocketDescriptor.hxx"
+#include "net/SocketError.hxx"
+#include "system/Args.hpp"
+#include "util/ByteOrder.hxx"
+#include "util/SpanCast.hxx"
+#include "util/StringAPI.hxx"
+#include "util/StringCompare.hxx"
+#include "util/PrintException.hxx"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <chrono>
+#include <cmath>
+#include <memory>
+#include <queue>
+#include <random>
+#include <vector>
+
+#include <stdio.h>
+#include <stdlib.h>
+
+using namespace std::chrono;
+using Clock = steady_clock;
+
+/**
+ * Default intervals, see SkyLinesTracking::Glue.
+ */
+static constexpr Clock::duration FIX_INTERVAL = minutes(1);
+static constexpr Clock::duration REQUEST_INTERVAL = minutes(1);
+static constexpr Clock::duration PING_INTERVAL = seconds(10);
+static constexpr Clock::duration THERMAL_INTERVAL = minutes(10);
+
+/**
+ * The clients share this many sockets.  More than one, so the
+ * kernel can distribute the load over SO_REUSEPORT workers, but not
+ * one per client, to stay below the file descriptor limit.
+ */
+static constexpr unsigned MAX_SOCKETS = 64;
+
+/**
+ * Give the server this much time to answer the last pings.
+ */
+static constexpr Clock::duration DRAIN_TIME = seconds(1);
+
+/**
+ * Generate a two hour flight of alternating climbs and glides, for
+ * running without IGC files.
+ */
+static Track
+MakeSyntheticTrack()
+{
+  Track track;
+
+  GeoPoint location(Angle::Degrees(10), Angle::Degrees(50));
+  double altitude = 1000;
+
+  for (unsigned t = 0; t < 2 * 3600; ++t) {
+    const bool circling = t % 600 < 240;
+    const Angle direction = circling
+      ? Angle::Degrees(t * 18)
+      : Angle::Degrees(45);
+    const double speed = circling ? 22 : 40;
+
+    location = FindLatitudeLongitude(location, direction, speed);
+    altitude += circling ? 2 : -1;
+
+    track.push_back({double(t), location, int(altitude)});
+  }
+
+  return track;
+}
+
+/**
+ * Statistics of the whole run.
+ */
+struct Statistics {
+  unsigned long sent_packets = 0, sent_bytes = 0, send_errors = 0;
+  unsigned long received_packets = 0, received_bytes = 0;
+  unsigned long received_by_type[SkyLinesTracking::THERMAL_RESPONSE + 1]{};
+  unsigned long malformed = 0;
+
+  unsigned long pings = 0;
+
+  /**
+   * Round trip times of the acknowledged pings [microseconds].
+   */
+  std::vector<uint32_t> latencies;
+
+  [[gnu::pure]]
+  unsigned long GetPercentile(double p) const noexcept {
+    assert(!latencies.empty());
+    std::size_t i = std::size_t(p * (latencies.size() - 1) + 0.5);
+    return latencies[i];
+  }
+};
+
+struct SimulatedClient {
+  uint64_t key;
+
+  const Track *track;
+
+  /**
+   * The position of this client on the #track at the start.
+   */
+  double time_offset;
+
+  /**
+   * Shift the track by this angle, so the clients don't all fly in
+   * formation.
+   */
+  Angle shift_latitude, shift_longitude;
+
+  unsigned socket_index;
+
+  /**
+   * An index into #track, to speed up the lookup.
+   */
+  std::size_t position = 0;
+
+  const TrackPoint &Seek(double elapsed) noexcept {
+    const double t = std::fmod(time_offset + elapsed, track->back().time);
+
+    if (t < (*track)[position].time)
+      position = 0;
+
+    while (position + 1 < track->size() && (*track)[position + 1].time <= t)
+      ++position;
+
+    return (*track)[position];
+  }
+
+  GeoPoint GetLocation(const TrackPoint &p) const noexcept {
+    return GeoPoint(p.location.longitude + shift_longitude,
+                    p.location.latitude + shift_latitude);
+  }
+};
+
+enum class Action : uint8_t {
+  FIX,
+  TRAFFIC_REQUEST,
+  THERMAL_REQUEST,
+  THERMAL_SUBMIT,
+  PING,
+};
+
+struct ScheduledAction {
+  Clock::time_point due;
+  unsigned client;
+  Action action;
+
+  constexpr bool operator>(const ScheduledAction &other) const noexcept {
+    return due > other.due;
+  }
+};
+
+class LoadGenerator;
+
+/**
+ * A UDP socket connected to the server, shared by several
+ * #SimulatedClient instances.
+ */
+class Connection {
+  LoadGenerator &generator;
+  SocketEvent event;
+
+public:
+  Connection(LoadGenerator &_generator, EventLoop &event_loop,
+             UniqueSocketDescriptor &&fd) noexcept
+    :generator(_generator),
+     event(event_loop, BIND_THIS_METHOD(OnSocketReady), fd.Release()) {
+    event.ScheduleRead();
+  }
+
+  ~Connection() noexcept {
+    event.Close();
+  }
+
+  Connection(const Connection &) = delete;
+  Connection &operator=(const Connection &) = delete;
+
+  SocketDescriptor GetSocket() const noexcept {
+    return event.GetSocket();
+  }
+
+private:
+  void OnSocketReady(unsigned events) noexcept;
+};
+
+class LoadGenerator {
+  EventLoop &event_loop;
+
+  const double speed;
+
+  std::vector<SimulatedClient> clients;
+
+  std::vector<std::unique_ptr<Connection>> connections;
+
+  std::priority_queue<ScheduledAction, std::vector<ScheduledAction>,
+                      std::greater<ScheduledAction>> queue;
+
+  FineTimerEvent timer{event_loop, BIND_THIS_METHOD(OnTimer)};
+  FineTimerEvent stop_timer{event_loop, BIND_THIS_METHOD(OnStopTimer)};
+
+  Clock::time_point start_time, end_time;
+
+  Clock::duration fix_interval, request_interval;
+
+  /**
+   * The send time of each ping id.
+   */
+  std::array<Clock::time_point, 0x10000> ping_times;
+  uint16_t next_ping_id = 0;
+
+  Statistics statistics;
+
+public:
+  LoadGenerator(EventLoop &_event_loop, double _speed)
+    :event_loop(_event_loop), speed(_speed) {}
+
+  void Setup(SocketAddress address, unsigned n_clients,
+             const std::vector<Track> &tracks,
+             Clock::duration _fix_interval,
+             Clock::duration _request_interval);
+
+  void Start(Clock::duration duration) noexcept;
+
+  const Statistics &Finish() noexcept {
+    std::sort(statistics.latencies.begin(), statistics.latencies.end());
+    return statistics;
+  }
+
+  Clock::duration GetDuration() const noexcept {
+    return end_time - start_time;
+  }
+
+private:
+  void Schedule(Clock::time_point due, unsigned client,
+                Action action) noexcept {
+    if (due < end_time)
+      queue.push({due, client, action});
+  }
+
+  void Send(SimulatedClient &client, std::span<const std::byte> packet) noexcept;
+
+  void Run(SimulatedClient &client, Action action, Clock::time_point now) noexcept;
+
+  void OnTimer() noexcept;
+
+  void OnStopTimer() noexcept {
+    event_loop.Break();
+  }
+
+public:
+  void OnPacket(std::span<const std::byte> packet,
+                Clock::time_point now) noexcept;
+};
+
+void
+LoadGenerator::Setup(SocketAddress address, unsigned n_clients,
+                     const std::vector<Track> &tracks,
+                     Clock::duration _fix_interval,
+                     Clock::duration _request_interval)
+{
+  fix_interval = _fix_interval;
+  request_interval = _request_interval;
+
+  const unsigned n_sockets = std::min(n_clients, MAX_SOCKETS);
+  connections.reserve(n_sockets);
+
+  for (unsigned i = 0; i < n_sockets; ++i) {
+    UniqueSocketDescriptor fd;
+    if (!fd.CreateNonBlock(address.GetFamily(), SOCK_DGRAM, 0))
+      throw MakeSocketError("Failed to create socket");
+
+    if (!fd.Connect(address))
+      throw MakeSocketError("Failed to connect");
+
+    connections.emplace_back(std::make_unique<Connection>(*this, event_loop,
+                                                          std::move(fd)));
+  }
+
+  std::random_device rd;
+  std::mt19937 random(rd());
+
+  /* a different key range in each run, so the server doesn't
+     recognize the clients of the previous run */
+  const uint64_t key_base = uint64_t(random()) << 32;
+
+  /* all clients fly within about 50 km, like on a contest day */
+  std::uniform_real_distribution<double> shift(-0.3, 0.3);
+  std::uniform_real_distribution<double> unit(0, 1);
+
+  clients.reserve(n_clients);
+  for (unsigned i = 0; i < n_clients; ++i) {
+    const Track &track = tracks[i % tracks.size()];
+
+    clients.push_back({
+        key_base | (i + 1),
+        &track,
+        unit(random) * track.back().time,
+        Angle::Degrees(shift(random)),
+        Angle::Degrees(shift(random)),
+        i % n_sockets,
+      });
+  }
+}
+
+void
+LoadGenerator::Start(Clock::duration duration) noexcept
+{
+  start_time = Clock::now();
+  end_time = start_time + duration;
+
+  std::random_device rd;
+  std::mt19937 random(rd());
+
+  /* spread the first packets of each kind over one interval */
+  auto phase = [&random](Clock::duration interval){
+    return Clock::duration(std::uniform_int_distribution<Clock::rep>(0, interval.count())(random));
+  };
+
+  for (unsigned i = 0; i < clients.size(); ++i) {
+    /* the server ignores requests from unknown clients, so the first
+       fix is sent right away */
+    Schedule(start_time + phase(seconds(1)), i, Action::FIX);
+    Schedule(start_time + seconds(1) + phase(request_interval),
+             i, Action::TRAFFIC_REQUEST);
+    Schedule(start_time + seconds(1) + phase(request_interval),
+             i, Action::THERMAL_REQUEST);
+    Schedule(start_time + seconds(1) + phase(THERMAL_INTERVAL),
+             i, Action::THERMAL_SUBMIT);
+    Schedule(start_time + seconds(1) + phase(PING_INTERVAL),
+             i, Action::PING);
+  }
+
+  timer.Schedule(Clock::duration::zero());
+  stop_timer.Schedule(duration + DRAIN_TIME);
+}
+
+void
+LoadGenerator::Send(SimulatedClient &client,
+                    std::span<const std::byte> packet) noexcept
+{
+  const auto s = connections[client.socket_index]->GetSocket();
+  if (s.WriteNoWait(packet) < 0) {
+    ++statistics.send_errors;
+    return;
+  }
+
+  ++statistics.sent_packets;
+  statistics.sent_bytes += packet.size();
+}
+
+void
+LoadGenerator::Run(SimulatedClient &client, Action action,
+                   Clock::time_point now) noexcept
+{
+  const double elapsed =
+    duration_cast<duration<double>>(now - start_time).count() * speed;
+
+  switch (action) {
+  case Action::FIX: {
+    const TrackPoint &p = client.Seek(elapsed);
+    const uint32_t time_of_day =
+      uint32_t(std::fmod(client.time_offset + elapsed + 36000, 86400) * 1000);
+
+    const auto packet =
+      SkyLinesTracking::MakeFix(client.key,
+                                SkyLinesTracking::FixPacket::FLAG_LOCATION|
+                                SkyLinesTracking::FixPacket::FLAG_ALTITUDE,
+                                time_of_day, client.GetLocation(p),
+                                Angle::Zero(), 0, 0, p.altitude, 0, 0);
+    Send(client, ReferenceAsBytes(packet));
+    Schedule(now + fix_interval, &client - clients.data(), action);
+    break;
+  }
+
+  case Action::TRAFFIC_REQUEST: {
+    const auto packet =
+      SkyLinesTracking::MakeTrafficRequest(client.key, true, true, true);
+    Send(client, ReferenceAsBytes(packet));
+    Schedule(now + request_interval, &client - clients.data(), action);
+    break;
+  }
+
+  case Action::THERMAL_REQUEST: {
+    const auto packet = SkyLinesTracking::MakeThermalRequest(client.key);
+    Send(client, ReferenceAsBytes(packet));
+    Schedule(now + request_interval, &client - clients.data(), action);
+    break;
+  }
+
+  case Action::THERMAL_SUBMIT: {
+    /* pretend the last two minutes were a climb */
+    const TrackPoint bottom = client.Seek(std::max(elapsed - 120, 0.));
+    const TrackPoint top = client.Seek(elapsed);
+    const int height_gain = std::max(top.altitude - bottom.altitude, 100);
+
+    const auto packet =
+      SkyLinesTracking::MakeThermalSubmit(client.key, 0,
+                                          client.GetLocation(bottom),
+                                          bottom.altitude,
+                                          client.GetLocation(top),
+                                          bottom.altitude + height_gain,
+                                          height_gain / 120.);
+    Send(client, ReferenceAsBytes(packet));
+    Schedule(now + THERMAL_INTERVAL, &client - clients.data(), action);
+    break;
+  }
+
+  case Action::PING: {
+    const uint16_t id = next_ping_id++;
+    ping_times[id] = now;
+
+    const auto packet = SkyLinesTracking::MakePing(client.key, id);
+    Send(client, ReferenceAsBytes(packet));
+    ++statistics.pings;
+    Schedule(now + PING_INTERVAL, &client - clients.data(), action);
+    break;
+  }
+  }
+}
+
+void
+LoadGenerator::OnTimer() noexcept
+{
+  const auto now = Clock::now();
+
+  while (!queue.empty() && queue.top().due <= now) {
+    const auto a = queue.top();
+    queue.pop();
+
+    Run(clients[a.client], a.action, now);
+  }
+
+  if (!queue.empty())
+    timer.Schedule(queue.top().due - now);
+}
+
+void
+Connection::OnSocketReady(unsigned) noexcept
+{
+  std::array<std::byte, 2048> buffer;
+
+  ssize_t nbytes;
+  while ((nbytes = GetSocket().ReadNoWait(buffer)) > 0)
+    generator.OnPacket(std::span{buffer}.first(nbytes), Clock::now());
+}
+
+void
+LoadGenerator::OnPacket(std::span<const std::byte> packet,
+                        Clock::time_point now) noexcept
+{
+  ++statistics.received_packets;
+  statistics.received_bytes += packet.size();
+
+  if (packet.size() < sizeof(SkyLinesTracking::Header)) {
+    ++statistics.malformed;
+    return;
+  }
+
+  const auto &header = *(const SkyLinesTracking::Header *)packet.data();
+  const unsigned type = FromBE16(header.type);
+  if (FromBE32(header.magic) != SkyLinesTracking::MAGIC ||
+      type >= std::size(statistics.received_by_type)) {
+    ++statistics.malformed;
+    return;
+  }
+
+  ++statistics.received_by_type[type];
+
+  if (type == SkyLinesTracking::ACK &&
+      packet.size() >= sizeof(SkyLinesTracking::ACKPacket)) {
+    const auto &ack = *(const SkyLinesTracking::ACKPacket *)packet.data();
+    const auto latency = now - ping_times[FromBE16(ack.id)];
+    statistics.latencies.push_back(duration_cast<microseconds>(latency).count());
+  }
+}
+
+static unsigned long
+ReadResidentKB(unsigned pid)
+{
+  char path[64];
+  snprintf(path, sizeof(path), "/proc/%u/status", pid);
+
+  FileLineReaderA reader{Path(path)};
+
+  char *line;
+  while ((line = reader.ReadLine()) != nullptr) {
+    const char *value = StringAfterPrefix(line, "VmRSS:");
+    if (value != nullptr)
+      return strtoul(value, nullptr, 10);
+  }
+
+  throw std::runtime_error("No VmRSS in /proc/PID/status");
+}
+
+static Clock::duration
+ParseSeconds(const char *value, Args &args)
+{
+  char *endptr;
+  const double s = strtod(value, &endptr);
+  if (endptr == value || *endptr != 0 || s <= 0)
+    args.UsageError();
+
+  return duration_cast<Clock::duration>(duration<double>(s));
+}
+
+int
+main(int argc, char **argv)
+try {
+  Args args(argc, argv,
+            "[OPTIONS] HOST [FILE.igc ...]\n\n"
+            "Options:\n"
+            "  --clients=1000           Number of simulated clients\n"
+            "  --duration=60            Duration of the run [s]\n"
+            "  --fix-interval=60        Interval between two fixes [s]\n"
+            "  --request-interval=60    Interval between two traffic/thermal requests [s]\n"
+            "  --speed=1                Replay speed of the tracks\n"
+            "  --pid=PID                Measure the memory usage of this server process");
+
+  unsigned n_clients = 1000;
+  Clock::duration duration = seconds(60);
+  Clock::duration fix_interval = FIX_INTERVAL;
+  Clock::duration request_interval = REQUEST_INTERVAL;
+  double speed = 1;
+  unsigned pid = 0;
+
+  const char *arg;
+  while ((arg = args.PeekNext()) != nullptr && *arg == '-') {
+    args.Skip();
+
+    const char *value;
+    if ((value = StringAfterPrefix(arg, "--clients=")) != nullptr) {
+      n_clients = strtoul(value, nullptr, 10);
+      if (n_clients == 0)
+        args.UsageError();
+    } else if ((value = StringAfterPrefix(arg, "--duration=")) != nullptr) {
+      duration = ParseSeconds(value, args);
+    } else if ((value = StringAfterPrefix(arg, "--fix-interval=")) != nullptr) {
+      fix_interval = ParseSeconds(value, args);
+    } else if ((value = StringAfterPrefix(arg, "--request-interval=")) != nullptr) {
+      request_interval = ParseSeconds(value, args);
+    } else if ((value = StringAfterPrefix(arg, "--speed=")) != nullptr) {
+      speed = strtod(value, nullptr);
+      if (speed <= 0)
+        args.UsageError();
+    } else if ((value = StringAfterPrefix(arg, "--pid=")) != nullptr) {
+      pid = strtoul(value, nullptr, 10);
+    } else {
+      args.UsageError();
+    }
+  }
+
+  const char *host = args.ExpectNext();
+
+  std::vector<Track> tracks;
+  while (!args.IsEmpty())
+    tracks.emplace_back(LoadTrack(args.ExpectNextPath()));
+
+  if (tracks.empty())
+    tracks.emplace_back(MakeSyntheticTrack());
+
+  const auto address_list = Resolve(host,
+                                    SkyLinesTracking::Server::GetDefaultPort(),
+                                    0, SOCK_DGRAM);
+
+  EventLoop event_loop;
+  LoadGenerator generator(event_loop, speed);
+  generator.Setup(address_list.GetBest(), n_clients, tracks,
+                  fix_interval, request_interval);
+
+  const unsigned long rss_before = pid > 0 ? ReadResidentKB(pid) : 0;
+
+  generator.Start(duration);
+  event_loop.Run();
+
+  const unsigned long rss_after = pid > 0 ? ReadResidentKB(pid) : 0;
+
+  const auto &s = generator.Finish();
+  const double seconds =
+    duration_cast<std::chrono::duration<double>>(generator.GetDuration()).count();
+
+  printf("clients=%u\n", n_clients);
+  printf("duration=%.1f\n", seconds);
+  printf("sent_packets=%lu\n", s.sent_packets);
+  printf("sent_bytes=%lu\n", s.sent_bytes);
+  printf("send_errors=%lu\n", s.send_errors);
+  printf("received_packets=%lu\n", s.received_packets);
+  printf("received_bytes=%lu\n", s.received_bytes);
+  printf("received_ack=%lu\n", s.received_by_type[SkyLinesTracking::ACK]);
+  printf("received_traffic=%lu\n",
+         s.received_by_type[SkyLinesTracking::TRAFFIC_RESPONSE]);
+  printf("received_thermal=%lu\n",
+         s.received_by_type[SkyLinesTracking::THERMAL_RESPONSE]);
+  printf("received_malformed=%lu\n", s.malformed);
+
+  /* the offered load; the server may have dropped some of these
+     packets, which cannot be measured from here (see ping_loss) */
+  printf("offered_pps=%.1f\n", s.sent_packets / seconds);
+
+  /* the responses which arrived here, i.e. a lower bound for the
+     server's transmit rate */
+  printf("server_tx_pps=%.1f\n", s.received_packets / seconds);
+
+  printf("pings=%lu\n", s.pings);
+  printf("ping_loss=%.4f\n",
+         s.pings > 0 ? 1. - double(s.latencies.size()) / s.pings : 0.);
+
+  if (!s.latencies.empty()) {
+    printf("latency_p50_us=%lu\n", s.GetPercentile(0.5));
+    printf("latency_p90_us=%lu\n", s.GetPercentile(0.9));
+    printf("latency_p99_us=%lu\n", s.GetPercentile(0.99));
+    printf("latency_max_us=%lu\n", (unsigned long)s.latencies.back());
+  }
+
+  if (pid > 0) {
+    printf("server_rss_before_kb=%lu\n", rss_before);
+    printf("server_rss_after_kb=%lu\n", rss_after);
+    printf("server_bytes_per_client=%ld\n",
+           long(rss_after - rss_before) * 1024 / long(n_clients));
+  }
+
+  return s.latencies.empty() ? EXIT_FAILURE : EXIT_SUCCESS;
+} catch (...) {
+  PrintException(std::current_exception());
+  return EXIT_FAILURE;
+}
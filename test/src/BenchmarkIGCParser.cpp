@@ -0,0 +1,115 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+/*
+ * Compares reading IGC files line by line with #FileLineReaderA and
+ * IGCParseFix() with mapping them into memory and parsing them with
+ * IGCParseFixes().
+ */
+
+#include "system/Args.hpp"
+#include "system/Path.hpp"
+#include "io/FileLineReader.hpp"
+#include "io/FileMapping.hpp"
+#include "IGC/IGCParser.hpp"
+#include "IGC/IGCFix.hpp"
+#include "IGC/IGCExtensions.hpp"
+#include "util/SpanCast.hxx"
+#include "util/PrintException.hxx"
+
+#include <chrono>
+#include <vector>
+
+#include <stdio.h>
+
+static constexpr unsigned ITERATIONS = 20;
+
+template<typename F>
+static double
+Measure(std::size_t n_fixes, F &&f)
+{
+  const auto start = std::chrono::steady_clock::now();
+
+  for (unsigned i = 0; i < ITERATIONS; ++i)
+    f();
+
+  const std::chrono::duration<double, std::nano> duration =
+    std::chrono::steady_clock::now() - start;
+  return duration.count() / (double(ITERATIONS) * n_fixes);
+}
+
+static std::size_t
+ParseLines(Path path)
+{
+  FileLineReaderA reader(path);
+
+  IGCExtensions extensions;
+  extensions.clear();
+
+  std::size_t n = 0;
+
+  const char *line;
+  while ((line = reader.ReadLine()) != nullptr) {
+    IGCFix fix;
+    if (IGCParseFix(line, extensions, fix))
+      ++n;
+    else
+      IGCParseExtensions(line, extensions);
+  }
+
+  return n;
+}
+
+static std::size_t
+ParseMapped(Path path, std::vector<IGCFix> &fixes)
+{
+  const FileMapping mapping(path);
+
+  fixes.clear();
+  return IGCParseFixes(ToStringView(std::span<const std::byte>{mapping}),
+                       fixes);
+}
+
+int
+main(int argc, char **argv)
+try {
+  Args args(argc, argv, "FILE.igc ...");
+
+  std::vector<AllocatedPath> paths;
+  do {
+    paths.emplace_back(args.ExpectNextPath());
+  } while (!args.IsEmpty());
+
+  std::size_t n_fixes = 0;
+  for (const auto &path : paths)
+    n_fixes += ParseLines(path);
+
+  if (n_fixes == 0) {
+    fprintf(stderr, "No fixes found\n");
+    return EXIT_FAILURE;
+  }
+
+  /* prevent the compiler from optimizing the loops away */
+  std::size_t sink = 0;
+
+  const double lines = Measure(n_fixes, [&paths, &sink](){
+    for (const auto &path : paths)
+      sink += ParseLines(path);
+  });
+
+  std::vector<IGCFix> fixes;
+  const double mapped = Measure(n_fixes, [&paths, &fixes, &sink](){
+    for (const auto &path : paths)
+      sink += ParseMapped(path, fixes);
+  });
+
+  printf("%zu fixes\n", n_fixes);
+  printf("FileLineReaderA + IGCParseFix: %.1f ns/fix\n", lines);
+  printf("FileMapping + IGCParseFixes:   %.1f ns/fix\n", mapped);
+  printf("speedup:                       %.2fx\n", lines / mapped);
+
+  return sink == 0 ? EXIT_FAILURE : EXIT_SUCCESS;
+} catch (...) {
+  PrintException(std::current_exception());
+  return EXIT_FAILURE;
+}
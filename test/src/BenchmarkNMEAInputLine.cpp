@@ -0,0 +1,91 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+/*
+ * Compares the single-pass #NMEAInputLine (checksum and comma index
+ * in one scan) with a separate VerifyNMEAChecksum() pass followed by
+ * a plain #CSVLine, splitting all columns of all lines of the given
+ * NMEA log files.
+ */
+
+#include "system/Args.hpp"
+#include "io/FileLineReader.hpp"
+#include "NMEA/InputLine.hpp"
+#include "NMEA/Checksum.hpp"
+#include "util/PrintException.hxx"
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include <stdio.h>
+
+static constexpr unsigned ITERATIONS = 1000;
+
+template<typename F>
+static double
+Measure(const std::vector<std::string> &lines, F &&f)
+{
+  const auto start = std::chrono::steady_clock::now();
+
+  for (unsigned i = 0; i < ITERATIONS; ++i)
+    for (const auto &line : lines)
+      f(line.c_str());
+
+  const std::chrono::duration<double, std::nano> duration =
+    std::chrono::steady_clock::now() - start;
+  return duration.count() / (double(ITERATIONS) * lines.size());
+}
+
+int
+main(int argc, char **argv)
+try {
+  Args args(argc, argv, "FILE.nmea ...");
+
+  std::vector<std::string> lines;
+
+  do {
+    FileLineReaderA file(args.ExpectNextPath());
+
+    const char *line;
+    while ((line = file.ReadLine()) != nullptr)
+      if (*line == '$')
+        lines.emplace_back(line);
+  } while (!args.IsEmpty());
+
+  if (lines.empty()) {
+    fprintf(stderr, "No NMEA lines found\n");
+    return EXIT_FAILURE;
+  }
+
+  /* prevent the compiler from optimizing the loops away */
+  std::size_t sink = 0;
+
+  const double legacy = Measure(lines, [&sink](const char *line){
+    if (!VerifyNMEAChecksum(line))
+      return;
+
+    CSVLine csv(line);
+    while (!csv.IsEmpty())
+      sink += csv.ReadView().size();
+  });
+
+  const double single_pass = Measure(lines, [&sink](const char *line){
+    NMEAInputLine nmea(line);
+    if (!nmea.IsChecksumValid())
+      return;
+
+    while (!nmea.IsEmpty())
+      sink += nmea.ReadView().size();
+  });
+
+  printf("%zu lines\n", lines.size());
+  printf("checksum + CSVLine: %.1f ns/line\n", legacy);
+  printf("NMEAInputLine:      %.1f ns/line\n", single_pass);
+  printf("speedup:            %.2fx\n", legacy / single_pass);
+
+  return sink == 0 ? EXIT_FAILURE : EXIT_SUCCESS;
+} catch (...) {
+  PrintException(std::current_exception());
+  return EXIT_FAILURE;
+}
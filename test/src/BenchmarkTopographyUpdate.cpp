@@ -0,0 +1,98 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+/*
+ * Measures TopographyStore::ScanVisibility(), i.e. the work done by
+ * the topography thread, while panning the map across a map file at
+ * several zoom levels.
+ */
+
+#include "Topography/TopographyStore.hpp"
+#include "Topography/TopographyFile.hpp"
+#include "Projection/WindowProjection.hpp"
+#include "Geo/FAISphere.hpp"
+#include "system/Args.hpp"
+#include "system/Path.hpp"
+#include "io/ZipArchive.hpp"
+#include "io/ZipLineReader.hpp"
+#include "util/PrintException.hxx"
+
+#include <chrono>
+#include <stdexcept>
+
+#include <stdio.h>
+
+/**
+ * The number of map positions per zoom level.
+ */
+static constexpr unsigned STEPS = 200;
+
+/**
+ * The distance panned in each step, relative to the visible radius.
+ */
+static constexpr double STEP_FACTOR = 0.25;
+
+static void
+Measure(ZipArchive &archive, double radius)
+{
+  TopographyStore topography;
+
+  {
+    ZipLineReaderA reader(archive.get(), "topology.tpl");
+    topography.Load(reader, nullptr, archive.get());
+  }
+
+  if (topography.begin() == topography.end())
+    throw std::runtime_error("No topography in map file");
+
+  const GeoPoint start = topography.begin()->GetCenter();
+
+  WindowProjection projection;
+  projection.SetScreenSize({640, 480});
+  projection.SetScreenOrigin(320, 240);
+  projection.SetScaleFromRadius(radius);
+
+  const Angle step = Angle::Radians(radius * STEP_FACTOR
+                                    / FAISphere::REARTH);
+
+  unsigned n_updates = 0;
+  std::chrono::steady_clock::duration duration{};
+
+  for (unsigned i = 0; i < STEPS; ++i) {
+    /* pan east, then north-east */
+    GeoPoint location = start;
+    location.longitude += step * (int(i) - int(STEPS / 2));
+    if (i >= STEPS / 2)
+      location.latitude += step * (int(i) - int(STEPS / 2));
+
+    projection.SetGeoLocation(location);
+    projection.UpdateScreenBounds();
+
+    const auto t = std::chrono::steady_clock::now();
+    n_updates += topography.ScanVisibility(projection);
+    duration += std::chrono::steady_clock::now() - t;
+  }
+
+  const std::chrono::duration<double, std::micro> us = duration;
+  printf("radius=%.0fm updates=%u total=%.0fus per_update=%.0fus\n",
+         radius, n_updates, us.count(),
+         n_updates > 0 ? us.count() / n_updates : 0.);
+}
+
+int
+main(int argc, char **argv)
+try {
+  Args args(argc, argv, "FILE.xcm");
+  const auto path = args.ExpectNextPath();
+  args.ExpectEnd();
+
+  ZipArchive archive(path);
+
+  for (const double radius : {2000., 5000., 10000., 20000., 50000.})
+    Measure(archive, radius);
+
+  return EXIT_SUCCESS;
+} catch (...) {
+  PrintException(std::current_exception());
+  return EXIT_FAILURE;
+}
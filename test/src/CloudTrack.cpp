@@ -0,0 +1,55 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#include "CloudTrack.hpp"
+#include "IGC/IGCParser.hpp"
+#include "IGC/IGCFix.hpp"
+#include "io/FileMapping.hpp"
+#include "system/Path.hpp"
+#include "util/SpanCast.hxx"
+
+#include <stdexcept>
+
+Track
+LoadTrack(Path path)
+{
+  std::vector<IGCFix> fixes;
+
+  {
+    const FileMapping mapping(path);
+    IGCParseFixes(ToStringView(std::span<const std::byte>{mapping}), fixes);
+  }
+
+  Track track;
+  track.reserve(fixes.size());
+
+  /* the second of day of the first fix */
+  double start = 0;
+
+  for (const IGCFix &fix : fixes) {
+    if (!fix.gps_valid)
+      continue;
+
+    const double time = fix.time.GetSecondOfDay();
+    if (track.empty()) {
+      start = time;
+      track.push_back({0, fix.location, fix.gps_altitude});
+      continue;
+    }
+
+    double t = time - start;
+    if (t < 0)
+      /* midnight wraparound */
+      t += 24 * 3600;
+
+    if (t <= track.back().time)
+      continue;
+
+    track.push_back({t, fix.location, fix.gps_altitude});
+  }
+
+  if (track.size() < 2)
+    throw std::runtime_error("Not enough fixes in IGC file");
+
+  return track;
+}
@@ -0,0 +1,36 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#pragma once
+
+#include "Geo/GeoPoint.hpp"
+
+#include <vector>
+
+class Path;
+
+/**
+ * One point of a track replayed by BenchmarkCloudServer.
+ */
+struct TrackPoint {
+  /**
+   * Seconds since the beginning of the track.
+   */
+  double time;
+
+  GeoPoint location;
+  int altitude;
+};
+
+using Track = std::vector<TrackPoint>;
+
+/**
+ * Load the valid fixes of an IGC file.  The time of the first point
+ * is 0; fixes which don't advance the time are skipped, and a
+ * midnight wraparound is handled.
+ *
+ * Throws on error (including a file with less than two usable
+ * fixes).
+ */
+Track
+LoadTrack(Path path);
@@ -0,0 +1,211 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+/*
+ * Converts NMEA logs to sensor logs ("*.xsr") and back, and dumps
+ * the samples of a sensor log as CSV.
+ */
+
+#include "Logger/SensorLog.hpp"
+#include "Logger/SensorSample.hpp"
+#include "Device/Driver.hpp"
+#include "Device/Register.hpp"
+#include "Device/Parser.hpp"
+#include "Device/Config.hpp"
+#include "Device/Port/NullPort.hpp"
+#include "NMEA/Info.hpp"
+#include "io/FileLineReader.hpp"
+#include "io/FileOutputStream.hxx"
+#include "io/BufferedOutputStream.hxx"
+#include "io/FileMapping.hpp"
+#include "system/Args.hpp"
+#include "system/Path.hpp"
+#include "time/ReplayClock.hpp"
+#include "util/PrintException.hxx"
+
+#include <chrono>
+#include <memory>
+
+#include <stdio.h>
+#include <stdlib.h>
+
+using SensorLog::Field;
+
+static constexpr const char *field_names[] = {
+  "time", "date", "latitude", "longitude", "gps_altitude",
+  "fix_quality", "satellites_used", "hdop",
+  "ground_speed", "track",
+  "static_pressure", "pitot_pressure", "dynamic_pressure",
+  "baro_altitude", "pressure_altitude",
+  "noncomp_vario", "te_vario", "netto_vario",
+  "ias", "tas",
+  "bank", "pitch", "heading",
+  "g_load", "temperature",
+};
+
+static_assert(std::size(field_names) == SensorLog::N_FIELDS);
+
+static void
+Encode(const char *driver_name, Path input_path, Path output_path)
+{
+  const struct DeviceRegister *driver = FindDriverByName(driver_name);
+  if (driver == nullptr)
+    throw std::runtime_error("No such driver");
+
+  DeviceConfig config;
+  config.Clear();
+  NullPort port;
+  std::unique_ptr<Device> device{driver->CreateOnPort != nullptr
+    ? driver->CreateOnPort(config, port)
+    : nullptr};
+
+  NMEAParser parser;
+  ReplayClock clock;
+  clock.Reset();
+
+  NMEAInfo basic{};
+
+  FileLineReaderA reader(input_path);
+  FileOutputStream file(output_path);
+  BufferedOutputStream os(file);
+  SensorLog::Writer writer(os);
+
+  SensorLog::Sample last;
+  last.Clear();
+
+  std::size_t n_lines = 0, n_samples = 0, text_size = 0;
+
+  const char *line;
+  while ((line = reader.ReadLine()) != nullptr) {
+    basic.clock = clock.NextClock(basic.time_available
+                                  ? basic.time
+                                  : TimeStamp::Undefined());
+    basic.alive.Update(basic.clock);
+
+    using namespace std::chrono;
+    const uint64_t ms =
+      duration_cast<milliseconds>(basic.clock.ToDuration()).count();
+    writer.WriteLine(ms, 0, line);
+    ++n_lines;
+    text_size += strlen(line) + 2;
+
+    if (!device || !device->ParseNMEA(line, basic))
+      parser.ParseLine(line, basic);
+
+    /* record a sample only if a value has changed */
+    auto sample = MakeSensorSample(basic);
+    sample.clock = last.clock;
+    if (sample != last) {
+      sample.clock = ms;
+      writer.WriteSample(sample);
+      last = sample;
+      ++n_samples;
+    }
+  }
+
+  writer.Finish();
+  os.Flush();
+  file.Commit();
+
+  const std::size_t size =
+    std::span<const std::byte>{FileMapping{output_path}}.size();
+  printf("%zu lines, %zu samples, %zu keyframes\n"
+         "NMEA: %zu bytes, sensor log: %zu bytes\n",
+         n_lines, n_samples, writer.GetIndex().size(),
+         text_size, size);
+}
+
+static void
+WriteNMEA(SensorLog::Reader &reader, BufferedOutputStream &os)
+{
+  while (true) {
+    switch (reader.Next()) {
+    case SensorLog::Reader::Frame::END:
+      return;
+
+    case SensorLog::Reader::Frame::SAMPLE:
+      break;
+
+    case SensorLog::Reader::Frame::LINE:
+      os.Write(reader.GetLine());
+      os.Write("\r\n");
+      break;
+    }
+  }
+}
+
+static void
+WriteCSV(SensorLog::Reader &reader, BufferedOutputStream &os)
+{
+  os.Write("clock");
+  for (const char *name : field_names) {
+    os.Write(',');
+    os.Write(name);
+  }
+  os.Write('\n');
+
+  while (true) {
+    switch (reader.Next()) {
+    case SensorLog::Reader::Frame::END:
+      return;
+
+    case SensorLog::Reader::Frame::LINE:
+      break;
+
+    case SensorLog::Reader::Frame::SAMPLE: {
+      const auto &sample = reader.GetSample();
+      os.Fmt("{}", sample.clock);
+      for (unsigned i = 0; i < SensorLog::N_FIELDS; ++i) {
+        os.Write(',');
+        if (sample.Has(Field(i)))
+          os.Fmt("{}", sample.Get(Field(i)));
+      }
+      os.Write('\n');
+      break;
+    }
+    }
+  }
+}
+
+static void
+Decode(Path input_path, Path output_path)
+{
+  const FileMapping mapping(input_path);
+  SensorLog::Reader reader(mapping);
+
+  FileOutputStream file(output_path);
+  BufferedOutputStream os(file);
+
+  if (output_path.EndsWithIgnoreCase(".csv"))
+    WriteCSV(reader, os);
+  else
+    WriteNMEA(reader, os);
+
+  os.Flush();
+  file.Commit();
+}
+
+int
+main(int argc, char **argv)
+try {
+  Args args(argc, argv,
+            "DRIVER INFILE.nmea OUTFILE.xsr\n"
+            "INFILE.xsr OUTFILE.nmea|OUTFILE.csv");
+
+  const char *first = args.ExpectNext();
+  if (Path(first).EndsWithIgnoreCase(".xsr")) {
+    const auto output_path = args.ExpectNextPath();
+    args.ExpectEnd();
+    Decode(Path(first), output_path);
+  } else {
+    const auto input_path = args.ExpectNextPath();
+    const auto output_path = args.ExpectNextPath();
+    args.ExpectEnd();
+    Encode(first, input_path, output_path);
+  }
+
+  return EXIT_SUCCESS;
+} catch (...) {
+  PrintException(std::current_exception());
+  return EXIT_FAILURE;
+}
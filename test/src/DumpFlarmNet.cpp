@@ -17,7 +17,7 @@ int main(int argc, char **argv)
   FlarmNetReader::LoadFile(path, database);
 
   for (auto i = database.begin(), end = database.end(); i != end; ++i) {
-    const FlarmNetRecord &record = i->second;
+    const FlarmNetRecord &record = *i;
 
     char id_buf[16];
     printf("%s\t%s\t%s\t%s\n",
@@ -3,12 +3,21 @@
 
 #include "Terrain/RasterTerrain.hpp"
 
+#include <algorithm>
+
 TerrainHeight
 RasterMap::GetHeight([[maybe_unused]] const GeoPoint &location) const noexcept
 {
   return TerrainHeight::Invalid();
 }
 
+void
+RasterMap::GetHeights([[maybe_unused]] std::span<const GeoPoint> locations,
+                      std::span<TerrainHeight> heights) const noexcept
+{
+  std::fill(heights.begin(), heights.end(), TerrainHeight::Invalid());
+}
+
 GeoPoint
 RasterMap::GroundIntersection([[maybe_unused]] const GeoPoint &origin,
                               [[maybe_unused]] const int h_origin,
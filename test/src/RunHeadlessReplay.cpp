@@ -0,0 +1,315 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+/*
+ * Replays an IGC file through the complete calculation pipeline
+ * (#MergeThread and #CalculationThread with the #GlideComputer), as
+ * fast as possible and without a user interface.
+ *
+ * Both threads are never started; instead, their Tick() methods are
+ * called in lock step for each fix.  Unlike the interactive replay,
+ * there is no timer and no interpolation, and the #GlideComputer
+ * schedules its idle calculations by the GPS time; therefore the
+ * output depends only on the input files and can be compared between
+ * builds.
+ */
+
+#include "MergeThread.hpp"
+#include "CalculationThread.hpp"
+#include "Blackboard/DeviceBlackboard.hpp"
+#include "Computer/GlideComputer.hpp"
+#include "Computer/GlideComputerInterface.hpp"
+#include "Computer/Settings.hpp"
+#include "Engine/Waypoint/Waypoints.hpp"
+#include "Engine/Airspace/Airspaces.hpp"
+#include "Engine/Task/TaskManager.hpp"
+#include "Engine/Task/Ordered/OrderedTask.hpp"
+#include "Task/ProtectedTaskManager.hpp"
+#include "Task/LoadFile.hpp"
+#include "Replay/IgcReplay.hpp"
+#include "io/FileLineReader.hpp"
+#include "system/Args.hpp"
+#include "system/Path.hpp"
+#include "util/StringCompare.hxx"
+#include "util/PrintException.hxx"
+
+#include <chrono>
+#include <memory>
+
+#include <stdio.h>
+#include <stdlib.h>
+
+/* fake symbols: */
+
+#include "Protection.hpp"
+#include "Audio/VarioGlue.hpp"
+#include "Device/MultipleDevices.hpp"
+#include "FLARM/Details.hpp"
+#include "Logger/SensorLogger.hpp"
+#include "Logger/SensorSample.hpp"
+#include "Computer/ConditionMonitor/ConditionMonitors.hpp"
+#include "Input/InputQueue.hpp"
+#include "Logger/Logger.hpp"
+
+void TriggerMergeThread() noexcept {}
+void TriggerGPSUpdate() noexcept {}
+void TriggerVarioUpdate() noexcept {}
+void TriggerCalculatedUpdate() noexcept {}
+
+#ifdef HAVE_PCM_PLAYER
+void AudioVarioGlue::SetValue([[maybe_unused]] double vario) {}
+void AudioVarioGlue::NoValue() {}
+bool AudioVarioGlue::SelectDevice([[maybe_unused]] int device) noexcept { return false; }
+std::optional<std::chrono::steady_clock::duration> AudioVarioGlue::ConsumeLatency() noexcept { return std::nullopt; }
+#endif
+
+void
+MultipleDevices::NotifySensorUpdate([[maybe_unused]] const MoreData &basic) noexcept
+{
+}
+
+const char *
+FlarmDetails::LookupCallsign([[maybe_unused]] FlarmId id) noexcept
+{
+  return nullptr;
+}
+
+void
+SensorLogger::LogSample([[maybe_unused]] const SensorLog::Sample &sample) noexcept
+{
+}
+
+SensorLog::Sample
+MakeSensorSample([[maybe_unused]] const NMEAInfo &basic) noexcept
+{
+  SensorLog::Sample sample;
+  sample.Clear();
+  return sample;
+}
+
+void
+ConditionMonitors::Update([[maybe_unused]] const NMEAInfo &basic,
+                          [[maybe_unused]] const DerivedInfo &calculated,
+                          [[maybe_unused]] const ComputerSettings &settings) noexcept
+{
+}
+
+bool InputEvents::processGlideComputer(unsigned) { return false; }
+
+void Logger::LogStartEvent([[maybe_unused]] const NMEAInfo &gps_info) {}
+void Logger::LogFinishEvent([[maybe_unused]] const NMEAInfo &gps_info) {}
+void Logger::LogPoint([[maybe_unused]] const NMEAInfo &gps_info) {}
+
+/* done with fake symbols. */
+
+static void
+PrintTraceHeader() noexcept
+{
+  puts("time,latitude,longitude,nav_altitude,vario,netto_vario,"
+       "wind_speed,wind_bearing,flying,circling,"
+       "task_started,task_finished,active_index,task_remaining,"
+       "contest_distance,contest_score");
+}
+
+static void
+PrintTraceRow(const MoreData &basic, const DerivedInfo &calculated) noexcept
+{
+  const TaskStats &task = calculated.ordered_task_stats;
+  const ContestResult &contest = calculated.contest_stats.GetResult();
+
+  printf("%.0f,%.6f,%.6f,%.1f,%.2f,%.2f,",
+         basic.time.ToDuration().count(),
+         basic.location.latitude.Degrees(),
+         basic.location.longitude.Degrees(),
+         basic.nav_altitude,
+         basic.brutto_vario, basic.netto_vario);
+
+  if (calculated.wind_available)
+    printf("%.1f,%.0f,",
+           calculated.wind.norm, calculated.wind.bearing.Degrees());
+  else
+    fputs(",,", stdout);
+
+  printf("%d,%d,%d,%d,%u,",
+         calculated.flight.flying, calculated.circling,
+         task.start.HasStarted(), task.task_finished,
+         task.active_index);
+
+  if (task.task_valid && task.total.remaining.IsDefined())
+    printf("%.0f,", task.total.remaining.GetDistance());
+  else
+    fputs(",", stdout);
+
+  printf("%.0f,%.2f\n", contest.distance, contest.score);
+}
+
+static void
+PrintSummary(const DerivedInfo &calculated, unsigned n_fixes) noexcept
+{
+  const FlyingState &flight = calculated.flight;
+  const TaskStats &task = calculated.ordered_task_stats;
+
+  printf("# fixes: %u\n", n_fixes);
+
+  if (flight.takeoff_time.IsDefined())
+    printf("# takeoff: %.0f\n", flight.takeoff_time.ToDuration().count());
+
+  if (flight.landing_time.IsDefined())
+    printf("# landing: %.0f\n", flight.landing_time.ToDuration().count());
+
+  if (task.task_valid) {
+    printf("# task started: %d\n", task.start.HasStarted());
+    printf("# task finished: %d\n", task.task_finished);
+
+    if (task.start.HasStarted())
+      printf("# task start time: %.0f\n",
+             task.start.time.ToDuration().count());
+
+    if (task.total.travelled.IsDefined())
+      printf("# task distance travelled: %.0f\n",
+             task.total.travelled.GetDistance());
+
+    if (task.task_finished && task.total.travelled.IsDefined())
+      printf("# task speed: %.2f\n", task.total.travelled.GetSpeed());
+  }
+
+  for (std::size_t i = 0; i < calculated.contest_stats.result.size(); ++i) {
+    const ContestResult &result = calculated.contest_stats.result[i];
+    if (result.IsDefined())
+      printf("# contest %zu: distance=%.0f score=%.2f\n",
+             i, result.distance, result.score);
+  }
+}
+
+int
+main(int argc, char **argv)
+try {
+  const char *task_path = nullptr;
+  unsigned interval = 1;
+
+  Args args(argc, argv,
+            "[options] FILE.igc\n"
+            "Options:\n"
+            "  --task=FILE.tsk      Load this task before replaying\n"
+            "  --interval=SECONDS   Print one trace row every SECONDS (default = 1, 0 = summary only)");
+
+  const char *arg;
+  while ((arg = args.PeekNext()) != nullptr && *arg == '-') {
+    args.Skip();
+
+    const char *value;
+    if ((value = StringAfterPrefix(arg, "--task=")) != nullptr) {
+      task_path = value;
+    } else if ((value = StringAfterPrefix(arg, "--interval=")) != nullptr) {
+      char *endptr;
+      interval = strtoul(value, &endptr, 10);
+      if (endptr == value || *endptr != 0) {
+        fputs("The interval parameter could not be parsed correctly.\n", stderr);
+        args.UsageError();
+      }
+    } else {
+      args.UsageError();
+    }
+  }
+
+  const auto igc_path = args.ExpectNextPath();
+  args.ExpectEnd();
+
+  ComputerSettings settings;
+  settings.SetDefaults();
+  settings.polar.glide_polar_task = GlidePolar(1);
+
+  const Waypoints waypoints;
+  Airspaces airspaces;
+
+  TaskManager task_manager(settings.task, waypoints);
+  task_manager.SetGlidePolar(settings.polar.glide_polar_task);
+
+  GlideComputerTaskEvents task_events;
+  task_manager.SetTaskEvents(task_events);
+
+  ProtectedTaskManager protected_task_manager(task_manager, settings.task);
+
+  if (task_path != nullptr) {
+    const auto task = LoadTask(Path(task_path), settings.task);
+    if (!task) {
+      fprintf(stderr, "Failed to load task %s\n", task_path);
+      return EXIT_FAILURE;
+    }
+
+    protected_task_manager.TaskCommit(*task);
+  }
+
+  GlideComputer glide_computer(settings, waypoints, airspaces,
+                               protected_task_manager, task_events);
+  glide_computer.SetContestIncremental(false);
+  glide_computer.SetIdleByGPSClock(true);
+  glide_computer.Initialise();
+
+  DeviceBlackboard device_blackboard;
+  device_blackboard.ReadComputerSettings(settings);
+
+  MergeThread merge_thread(device_blackboard, nullptr, nullptr);
+  merge_thread.FirstRun();
+
+  CalculationThread calculation_thread(device_blackboard, glide_computer);
+  calculation_thread.SetComputerSettings(settings);
+
+  IgcReplay replay(std::make_unique<FileLineReaderA>(igc_path));
+
+  if (interval > 0)
+    PrintTraceHeader();
+
+  const auto start = std::chrono::steady_clock::now();
+
+  NMEAInfo data;
+  data.Reset();
+
+  unsigned n_fixes = 0;
+  TimeStamp next_row = TimeStamp::Undefined();
+
+  while (replay.Update(data)) {
+    if (!data.time_available)
+      continue;
+
+    {
+      const std::lock_guard lock{device_blackboard.mutex};
+      device_blackboard.SetReplayState() = data;
+    }
+
+    merge_thread.SynchronousTick();
+    calculation_thread.SynchronousTick();
+
+    ++n_fixes;
+
+    if (interval > 0) {
+      const std::lock_guard lock{device_blackboard.mutex};
+      const MoreData &basic = device_blackboard.Basic();
+
+      /* the last condition catches time warps, e.g. at midnight */
+      if (!next_row.IsDefined() || basic.time >= next_row ||
+          basic.time + std::chrono::seconds{interval} < next_row) {
+        PrintTraceRow(basic, device_blackboard.Calculated());
+        next_row = basic.time + std::chrono::seconds{interval};
+      }
+    }
+  }
+
+  /* run the slow calculations which the CalculationThread may have
+     postponed */
+  glide_computer.ProcessExhaustive();
+
+  const std::chrono::duration<double> duration =
+    std::chrono::steady_clock::now() - start;
+
+  PrintSummary(glide_computer.Calculated(), n_fixes);
+
+  fprintf(stderr, "%u fixes in %.3f s (%.0f fixes/s)\n",
+          n_fixes, duration.count(),
+          duration.count() > 0 ? n_fixes / duration.count() : 0.);
+
+  return EXIT_SUCCESS;
+} catch (...) {
+  PrintException(std::current_exception());
+  return EXIT_FAILURE;
+}
@@ -0,0 +1,229 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#include "Cloud/Journal.hpp"
+#include "Cloud/Records.hpp"
+#include "Cloud/Client.hpp"
+#include "Cloud/Thermal.hpp"
+#include "Cloud/Serialiser.hpp"
+#include "io/FileOutputStream.hxx"
+#include "io/StringOutputStream.hxx"
+#include "net/IPv4Address.hxx"
+#include "system/FileUtil.hpp"
+#include "system/Path.hpp"
+#include "util/CRC16CCITT.hpp"
+#include "util/SpanCast.hxx"
+#include "util/PrintException.hxx"
+#include "TestUtil.hpp"
+
+#include <cmath>
+#include <string>
+
+static constexpr auto expiry = std::chrono::hours(1);
+
+static const Path db_path("output/test/cloud.db");
+static const AllocatedPath journal_path = db_path + ".journal";
+static const AllocatedPath old_journal_path = db_path + ".journal.old";
+
+static void
+DeleteFiles()
+{
+  File::Delete(db_path);
+  File::Delete(journal_path);
+  File::Delete(old_journal_path);
+}
+
+static CloudClient
+MakeClient(uint64_t key, double latitude)
+{
+  return CloudClient(IPv4Address(127, 0, 0, 1, 5597), key, key,
+                     GeoPoint(Angle::Degrees(7), Angle::Degrees(latitude)),
+                     1000);
+}
+
+static CloudThermal
+MakeThermal(uint64_t client_key)
+{
+  const GeoPoint location(Angle::Degrees(7), Angle::Degrees(51));
+  return CloudThermal(client_key, AGeoPoint(location, 500),
+                      AGeoPoint(location, 1500), 2);
+}
+
+/**
+ * Build one journal record; see the format description in
+ * Journal.cpp.
+ */
+template<typename T>
+static std::string
+MakeRecord(uint8_t type, const T &object)
+{
+  StringOutputStream os;
+
+  {
+    Serialiser s(os);
+    s.Write8(type);
+    object.Save(s);
+    s.Flush();
+  }
+
+  const std::string &payload = os.GetValue();
+  const uint32_t size = payload.size();
+  const uint16_t crc = UpdateCRC16CCITT(AsBytes(payload), 0);
+
+  std::string record;
+  record.push_back(char(size >> 24));
+  record.push_back(char(size >> 16));
+  record.push_back(char(size >> 8));
+  record.push_back(char(size));
+  record.push_back(char(crc >> 8));
+  record.push_back(char(crc));
+  record += payload;
+  return record;
+}
+
+static std::string
+MakeRecord(const CloudClient &client)
+{
+  return MakeRecord(1, client);
+}
+
+static std::string
+MakeRecord(const CloudThermal &thermal)
+{
+  return MakeRecord(2, thermal);
+}
+
+static void
+WriteFile(Path path, std::string_view contents)
+{
+  FileOutputStream fos(path);
+  fos.Write(AsBytes(contents));
+  fos.Commit();
+}
+
+static CloudRecords
+Load()
+{
+  CloudRecords records;
+  CloudJournal journal(db_path, expiry, expiry);
+  journal.Load(records);
+  return records;
+}
+
+static void
+TestTornTail()
+{
+  DeleteFiles();
+
+  /* the server crashed while writing the third record */
+  const std::string torn = MakeRecord(MakeClient(3, 52));
+  WriteFile(journal_path,
+            MakeRecord(MakeClient(1, 51)) + MakeRecord(MakeThermal(1)) +
+            torn.substr(0, torn.size() / 2));
+
+  auto records = Load();
+  ok1(records.clients.size() == 1);
+  ok1(records.thermals.size() == 1);
+
+  /* a bad CRC ends the journal, even if valid records follow */
+  std::string corrupt = MakeRecord(MakeClient(2, 52));
+  corrupt.back() ^= 0x20;
+  WriteFile(journal_path,
+            MakeRecord(MakeClient(1, 51)) + corrupt +
+            MakeRecord(MakeClient(3, 53)));
+
+  records = Load();
+  ok1(records.clients.size() == 1 && records.clients.front()->key == 1);
+  ok1(records.thermals.empty());
+}
+
+static void
+TestReplayTwice()
+{
+  DeleteFiles();
+
+  const std::string journal =
+    MakeRecord(MakeClient(1, 51)) + MakeRecord(MakeThermal(1)) +
+    MakeRecord(MakeClient(1, 52)) + MakeRecord(MakeClient(2, 53));
+  WriteFile(journal_path, journal);
+
+  const auto once = Load();
+  ok1(once.clients.size() == 2);
+  ok1(once.thermals.size() == 1);
+
+  /* a crash during compaction leaves the same records in both
+     journals */
+  WriteFile(old_journal_path, journal);
+
+  const auto twice = Load();
+  ok1(twice.clients.size() == 2);
+  ok1(twice.thermals.size() == 1);
+
+  bool ok = twice.clients.size() == 2;
+  for (const auto &client : twice.clients)
+    if (client->key == 1 &&
+        std::fabs(client->location.latitude.Degrees() - 52) > 1e-4)
+      ok = false;
+  ok1(ok);
+}
+
+static void
+TestCompactOldJournal()
+{
+  DeleteFiles();
+
+  {
+    CloudRecords records;
+    records.Update(std::make_shared<CloudClient>(MakeClient(1, 51)));
+    records.SortByStamp();
+
+    FileOutputStream fos(db_path);
+    Serialiser s(fos);
+    records.Save(s);
+    s.Flush();
+    fos.Commit();
+  }
+
+  /* a previous compaction was interrupted after the database had
+     been written, but before the old journal was deleted */
+  WriteFile(old_journal_path,
+            MakeRecord(MakeClient(1, 51)) + MakeRecord(MakeClient(2, 52)) +
+            MakeRecord(MakeThermal(2)));
+  WriteFile(journal_path,
+            MakeRecord(MakeClient(3, 53)) + MakeRecord(MakeThermal(3)));
+
+  {
+    CloudRecords records;
+    CloudJournal journal(db_path, expiry, expiry);
+    journal.Load(records);
+    ok1(records.clients.size() == 3);
+
+    /* Stop() folds both journals into the database */
+    journal.Start();
+    journal.Stop();
+  }
+
+  ok1(File::Exists(db_path));
+  ok1(!File::Exists(journal_path));
+  ok1(!File::Exists(old_journal_path));
+
+  const auto records = Load();
+  ok1(records.clients.size() == 3);
+  ok1(records.thermals.size() == 2);
+}
+
+int main()
+try {
+  plan_tests(15);
+
+  TestTornTail();
+  TestReplayTwice();
+  TestCompactOldJournal();
+
+  DeleteFiles();
+
+  return exit_status();
+} catch (...) {
+  PrintException(std::current_exception());
+  return EXIT_FAILURE;
+}
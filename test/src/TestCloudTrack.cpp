@@ -0,0 +1,110 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#include "CloudTrack.hpp"
+#include "io/FileOutputStream.hxx"
+#include "system/FileUtil.hpp"
+#include "system/Path.hpp"
+#include "util/SpanCast.hxx"
+#include "util/PrintException.hxx"
+#include "TestUtil.hpp"
+
+#include <algorithm>
+#include <string_view>
+
+static const Path igc_path("output/test/track.igc");
+
+static Track
+LoadString(std::string_view contents)
+{
+  {
+    FileOutputStream fos(igc_path);
+    fos.Write(AsBytes(contents));
+    fos.Commit();
+  }
+
+  Track track = LoadTrack(igc_path);
+  File::Delete(igc_path);
+  return track;
+}
+
+[[gnu::pure]]
+static bool
+IsIncreasing(const Track &track) noexcept
+{
+  return std::adjacent_find(track.begin(), track.end(),
+                            [](const TrackPoint &a, const TrackPoint &b){
+                              return b.time <= a.time;
+                            }) == track.end();
+}
+
+static void
+TestRealFile()
+{
+  /* 01:14:58 to 05:39:55 */
+  const auto track = LoadTrack(Path("test/data/0asljd01.igc"));
+  ok1(track.size() > 1000);
+  ok1(track.front().time == 0);
+  ok1(track.back().time == 4 * 3600 + 24 * 60 + 57);
+  ok1(IsIncreasing(track));
+}
+
+static void
+TestShortFile()
+{
+  const auto track = LoadString(
+    "AXXX\n"
+    "B1000005103117N00742367EA0049000487\n"
+    "B1000015103118N00742368EA0049000488\n"
+    /* duplicate time: skipped */
+    "B1000015103118N00742368EA0049000488\n"
+    "B1000025103119N00742369EA0049000489\n"
+    "B1000035103120N00742370EA0049000490\n");
+
+  ok1(track.size() == 4);
+  ok1(track.front().time == 0);
+  ok1(track.back().time == 3);
+  ok1(track.back().altitude == 490);
+}
+
+static void
+TestMidnight()
+{
+  const auto track = LoadString(
+    "B2359585103117N00742367EA0049000487\r\n"
+    "B2359595103118N00742368EA0049000488\r\n"
+    "B0000005103119N00742369EA0049000489\r\n"
+    "B0000015103120N00742370EA0049000490\r\n");
+
+  ok1(track.size() == 4);
+  ok1(track.back().time == 3);
+  ok1(IsIncreasing(track));
+}
+
+static void
+TestTooShort()
+{
+  bool failed = false;
+  try {
+    LoadString("B1000005103117N00742367EA0049000487\n");
+  } catch (...) {
+    failed = true;
+  }
+
+  ok1(failed);
+}
+
+int main()
+try {
+  plan_tests(12);
+
+  TestRealFile();
+  TestShortFile();
+  TestMidnight();
+  TestTooShort();
+
+  return exit_status();
+} catch (...) {
+  PrintException(std::current_exception());
+  return EXIT_FAILURE;
+}
@@ -0,0 +1,178 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#include "Blackboard/DeviceBlackboard.hpp"
+#include "Device/DataEditor.hpp"
+#include "Protection.hpp"
+#include "TestUtil.hpp"
+
+void TriggerMergeThread() noexcept {}
+
+static void
+Merge(DeviceBlackboard &blackboard) noexcept
+{
+  const std::lock_guard lock{blackboard.mutex};
+  blackboard.Merge();
+}
+
+/**
+ * Simulate one NMEA sentence parsed by the I/O thread.
+ */
+static void
+ReceiveVario(DeviceBlackboard &blackboard, double value) noexcept
+{
+  DeviceDataEditor e{blackboard, 0};
+  e->UpdateClock();
+  e->alive.Update(e->clock);
+  e->ProvideTotalEnergyVario(value);
+  e.Commit();
+}
+
+static void
+TestUpdateBetweenMerges()
+{
+  DeviceBlackboard blackboard;
+
+  ReceiveVario(blackboard, 1);
+  Merge(blackboard);
+  ok1(blackboard.RealState(0).total_energy_vario == 1);
+
+  /* the main thread copies the working copy to talk to the device
+     (like DeviceDescriptor::ExchangeRadioFrequencies()) ... */
+  NMEAInfo copy;
+  {
+    DeviceDataEditor e{blackboard, 0};
+    copy = *e;
+  }
+
+  /* ... while the I/O thread keeps parsing */
+  ReceiveVario(blackboard, 2);
+  ReceiveVario(blackboard, 3);
+
+  copy.settings.active_frequency = RadioFrequency::FromKiloHertz(123450);
+  copy.settings.has_active_frequency.Update(copy.clock);
+
+  {
+    DeviceDataEditor e{blackboard, 0};
+    e->settings.Complement(copy.settings);
+    e.Commit();
+  }
+
+  Merge(blackboard);
+
+  const NMEAInfo &basic = blackboard.RealState(0);
+  ok1(basic.total_energy_vario == 3);
+  ok1(basic.settings.has_active_frequency);
+  ok1(basic.settings.active_frequency.GetKiloHertz() == 123450);
+  ok1(blackboard.Basic().total_energy_vario == 3);
+
+  /* nothing new: Merge() keeps the previous data */
+  Merge(blackboard);
+  ok1(blackboard.RealState(0).total_energy_vario == 3);
+}
+
+static void
+TestExpireWallClock()
+{
+  DeviceBlackboard blackboard;
+
+  {
+    DeviceDataEditor e{blackboard, 0};
+    e->UpdateClock();
+    e->alive.Update(e->clock - std::chrono::seconds(20));
+    e->ProvideTotalEnergyVario(1);
+    e.Commit();
+  }
+
+  Merge(blackboard);
+  ok1(blackboard.RealState(0).alive);
+
+  blackboard.ExpireWallClock();
+
+  {
+    DeviceDataEditor e{blackboard, 0};
+    ok1(!e->alive);
+  }
+
+  Merge(blackboard);
+  ok1(!blackboard.RealState(0).alive);
+  ok1(!blackboard.Basic().alive);
+}
+
+/**
+ * Sentences marked with CommitLater() become visible only after
+ * Flush(), and only the latest published copy is consumed.
+ */
+static void
+TestBatch()
+{
+  DeviceBlackboard blackboard;
+
+  ReceiveVario(blackboard, 1);
+  Merge(blackboard);
+
+  for (unsigned i = 2; i <= 4; ++i) {
+    DeviceDataEditor e{blackboard, 0};
+    e->ProvideTotalEnergyVario(i);
+    e.CommitLater();
+  }
+
+  Merge(blackboard);
+  ok1(blackboard.RealState(0).total_energy_vario == 1);
+
+  DeviceDataEditor{blackboard, 0}.Flush();
+
+  /* publish again before the MergeThread has consumed the previous
+     copy */
+  ReceiveVario(blackboard, 5);
+
+  Merge(blackboard);
+  ok1(blackboard.RealState(0).total_energy_vario == 5);
+
+  /* Flush() without modifications does not publish anything */
+  {
+    DeviceDataEditor e{blackboard, 0};
+    e->ProvideTotalEnergyVario(6);
+    e.Flush();
+  }
+
+  Merge(blackboard);
+  ok1(blackboard.RealState(0).total_energy_vario == 5);
+}
+
+/**
+ * DeviceDataEditor::Expire() runs at most once per second.
+ */
+static void
+TestExpireThrottled()
+{
+  DeviceBlackboard blackboard;
+  DeviceDataEditor e{blackboard, 0};
+
+  e->UpdateClock();
+  const TimeStamp now = e->clock;
+  e->ProvideTotalEnergyVario(1);
+  e.Expire();
+  ok1(e->total_energy_vario_available);
+
+  /* stale, but the previous Expire() call was just now */
+  e->total_energy_vario_available.Update(now - std::chrono::seconds(10));
+  e.Expire();
+  ok1(e->total_energy_vario_available);
+
+  e->clock = now + std::chrono::seconds(2);
+  e.Expire();
+  ok1(!e->total_energy_vario_available);
+}
+
+int main()
+{
+  plan_tests(16);
+
+  TestUpdateBetweenMerges();
+  TestExpireWallClock();
+  TestBatch();
+  TestExpireThrottled();
+
+  return exit_status();
+}
@@ -6,11 +6,18 @@
 #include "FLARM/FlarmNetRecord.hpp"
 #include "FLARM/Id.hpp"
 #include "system/Path.hpp"
+#include "io/StringOutputStream.hxx"
+#include "io/BufferedOutputStream.hxx"
+#include "io/MemoryReader.hxx"
+#include "io/BufferedReader.hxx"
+#include "util/SpanCast.hxx"
 #include "TestUtil.hpp"
 
+#include <iterator>
+
 int main()
 {
-  plan_tests(16);
+  plan_tests(23);
 
   FlarmNetDatabase db;
   int count = FlarmNetReader::LoadFile(Path("test/data/flarmnet/data.fln"),
@@ -60,5 +67,30 @@ int main()
   ok1(foundDDA85C);
   ok1(foundDDA896);
 
+  ok1(db.FindFirstRecordByCallSign("XX") == NULL);
+  ok1(db.FindIdsByCallSign("TH", ids, 1) == 1);
+
+  /* save to a cache and load it again */
+  StringOutputStream sos;
+  {
+    BufferedOutputStream bos(sos);
+    db.SaveCache(bos);
+    bos.Flush();
+  }
+
+  FlarmNetDatabase db2;
+  {
+    MemoryReader mr(AsBytes(std::string_view{sos.GetValue()}));
+    BufferedReader br(mr);
+    db2.LoadCache(br);
+  }
+
+  record = db2.FindRecordById(id);
+  ok1(record != NULL);
+  ok1(record->id == id);
+  ok1(StringIsEqual(record->registration, "D-4449"));
+  ok1(db2.FindIdsByCallSign("TH", ids, 3) == 2);
+  ok1(std::distance(db2.begin(), db2.end()) == count);
+
   return exit_status();
 }
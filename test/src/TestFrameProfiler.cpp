@@ -0,0 +1,164 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#include "Profiler/FrameProfiler.hpp"
+#include "io/BufferedOutputStream.hxx"
+#include "io/StringOutputStream.hxx"
+#include "util/StringAPI.hxx"
+#include "TestUtil.hpp"
+
+#include <string>
+
+#include <stdio.h>
+#include <string.h>
+
+static void
+TestHistogram()
+{
+  RollingHistogram<100> h;
+  ok1(h.empty());
+
+  auto s = h.GetSummary();
+  ok1(s.count == 0);
+  ok1(s.max == 0);
+
+  h.Add(7);
+  s = h.GetSummary();
+  ok1(s.count == 1);
+  ok1(s.p50 == 7);
+  ok1(s.p99 == 7);
+  ok1(s.max == 7);
+
+  /* 1..100 in reverse order */
+  h.Clear();
+  for (unsigned i = 100; i > 0; --i)
+    h.Add(i);
+
+  s = h.GetSummary();
+  ok1(s.count == 100);
+  ok1(s.p50 == 50);
+  ok1(s.p95 == 95);
+  ok1(s.p99 == 99);
+  ok1(s.max == 100);
+
+  /* the window is full: 100 more samples replace all old ones */
+  for (unsigned i = 0; i < 100; ++i)
+    h.Add(1000 + i);
+
+  s = h.GetSummary();
+  ok1(s.count == 200);
+  ok1(s.p50 == 1049);
+  ok1(s.max == 1099);
+}
+
+static std::string
+ToJSON(const FrameProfiler &profiler, bool trace)
+{
+  StringOutputStream sos;
+  BufferedOutputStream bos(sos);
+  if (trace)
+    profiler.WriteChromeTrace(bos);
+  else
+    profiler.WriteJSON(bos);
+  bos.Flush();
+  return std::move(sos).GetValue();
+}
+
+static void
+TestProfiler()
+{
+  using std::chrono::microseconds;
+
+  FrameProfiler profiler;
+  ok1(profiler.GetSummaries().empty());
+  ok1(ToJSON(profiler, false) == "{\"phases\":{}}\n");
+
+  const auto a = profiler.RegisterPhase("A");
+  const auto b = profiler.RegisterPhase("B");
+  ok1(a != b);
+
+  /* the same name from another call site (or translation unit) is
+     the same phase */
+  static char a2[] = "A";
+  ok1(profiler.RegisterPhase(a2) == a);
+
+  const auto t = FrameProfiler::Clock::now();
+  profiler.Record(a, t, microseconds(10));
+  profiler.Record(b, t, microseconds(30));
+  profiler.Record(a, t, microseconds(20));
+
+  const auto summaries = profiler.GetSummaries();
+  ok1(summaries.size() == 2);
+  ok1(StringIsEqual(summaries[0].name, "A"));
+  ok1(summaries[0].histogram.count == 2);
+  ok1(summaries[0].histogram.p50 == 10);
+  ok1(summaries[0].histogram.max == 20);
+  ok1(StringIsEqual(summaries[1].name, "B"));
+  ok1(summaries[1].histogram.p99 == 30);
+
+  ok1(ToJSON(profiler, false) ==
+      "{\"phases\":{"
+      "\"A\":{\"count\":2,\"p50_us\":10,\"p95_us\":20,\"p99_us\":20,\"max_us\":20},"
+      "\"B\":{\"count\":1,\"p50_us\":30,\"p95_us\":30,\"p99_us\":30,\"max_us\":30}"
+      "}}\n");
+
+  /* no events before EnableTrace() */
+  std::string trace = ToJSON(profiler, true);
+  ok1(trace.starts_with("{\"traceEvents\":[\n],"));
+
+  profiler.EnableTrace();
+  profiler.Record(b, t, microseconds(40));
+  trace = ToJSON(profiler, true);
+  ok1(trace.find("{\"name\":\"B\",\"ph\":\"X\",") != trace.npos);
+  ok1(trace.find("\"dur\":40,") != trace.npos);
+  ok1(trace.find("\"phases\":{\"A\":") != trace.npos);
+}
+
+static void
+TestEscape()
+{
+  FrameProfiler profiler;
+  profiler.EnableTrace();
+  profiler.Record(profiler.RegisterPhase("a\"b\\c\n"),
+                  FrameProfiler::Clock::now(), {});
+
+  ok1(ToJSON(profiler, false).starts_with("{\"phases\":{\"a\\\"b\\\\c\\u000a\":{"));
+
+  const auto trace = ToJSON(profiler, true);
+  ok1(trace.find("{\"name\":\"a\\\"b\\\\c\\u000a\",") != trace.npos);
+}
+
+static void
+TestFull()
+{
+  FrameProfiler profiler;
+
+  static char names[FrameProfiler::MAX_PHASES + 1][8];
+  bool ok = true;
+  for (unsigned i = 0; i < FrameProfiler::MAX_PHASES; ++i) {
+    snprintf(names[i], sizeof(names[i]), "P%u", i);
+    if (profiler.RegisterPhase(names[i]) != i)
+      ok = false;
+  }
+  ok1(ok);
+
+  strcpy(names[FrameProfiler::MAX_PHASES], "X");
+  const auto x = profiler.RegisterPhase(names[FrameProfiler::MAX_PHASES]);
+  ok1(x == FrameProfiler::INVALID_PHASE);
+
+  /* ignored */
+  profiler.Record(x, FrameProfiler::Clock::now(), {});
+  ok1(profiler.GetSummaries().size() == FrameProfiler::MAX_PHASES);
+}
+
+int main()
+{
+  plan_tests(36);
+
+  TestHistogram();
+  TestProfiler();
+  TestEscape();
+  TestFull();
+
+  return exit_status();
+}
@@ -10,6 +10,8 @@
 #include "time/BrokenTime.hpp"
 #include "TestUtil.hpp"
 
+#include <vector>
+
 #include <string.h>
 
 static void
@@ -58,6 +60,12 @@ TestExtensions()
   ok1(extensions[3].start == 47);
   ok1(extensions[3].finish == 49);
   ok1(strcmp(extensions[3].code, "TRT") == 0);
+
+  /* the codes are looked up while parsing the "I" record */
+  ok1(extensions[0].known < 0);
+  ok1(extensions[1].known >= 0);
+  ok1(extensions[2].known >= 0);
+  ok1(extensions[3].known >= 0);
 }
 
 static void
@@ -169,6 +177,69 @@ TestFix()
   ok1(equals(fix.location, -51.05195, -7.70611667));
   ok1(fix.pressure_altitude == 10490);
   ok1(fix.gps_altitude == 7);
+
+  ok1(IGCParseFix("B1122545103117N00742367EA-001200007", extensions, fix));
+  ok1(fix.pressure_altitude == -12);
+  ok1(fix.gps_altitude == 7);
+
+  ok1(IGCParseExtensions("I023638FXA3940SIU", extensions));
+  ok1(IGCParseFix("B1122385103117N00742367EA004900048701208",
+                  extensions, fix));
+  ok1(fix.siu == 8);
+  ok1(fix.enl == -1);
+
+  /* the SIU column exceeds the line */
+  ok1(IGCParseFix("B1122385103117N00742367EA00490004870120",
+                  extensions, fix));
+  ok1(fix.siu == -1);
+}
+
+static void
+TestFixes()
+{
+  std::vector<IGCFix> fixes;
+  ok1(IGCParseFixes("", fixes) == 0);
+  ok1(IGCParseFixes("AXCSfoo\nB1122385103117N00742367EA", fixes) == 0);
+  ok1(fixes.empty());
+
+  static constexpr char data[] =
+    "AXCSfoo\r\n"
+    "HFDTE040910\r\n"
+    "B1122375103117N00742367EA0049000487\r\n"
+    "I023638FXA3940SIU\r\n"
+    "B1122385103117N00742367EA004900048701208\r\n"
+    "B1122395103117X00742367EA004900048701208\r\n"
+    "LXCSfoo\r\n"
+    "B1122405103117N00742367EV-00120048701209\r\n"
+    "B1122415103117S00742367WA00490004870120";
+
+  ok1(IGCParseFixes(data, fixes) == 4);
+  ok1(fixes.size() == 4);
+
+  ok1(fixes[0].time == BrokenTime(11, 22, 37));
+  ok1(equals(fixes[0].location, 51.05195, 7.70611667));
+  ok1(fixes[0].gps_valid);
+  ok1(fixes[0].pressure_altitude == 490);
+  ok1(fixes[0].gps_altitude == 487);
+  ok1(fixes[0].siu == -1);
+
+  ok1(fixes[1].time == BrokenTime(11, 22, 38));
+  ok1(fixes[1].siu == 8);
+
+  ok1(fixes[2].time == BrokenTime(11, 22, 40));
+  ok1(!fixes[2].gps_valid);
+  ok1(fixes[2].pressure_altitude == -12);
+  ok1(fixes[2].siu == 9);
+
+  /* the last line has no line terminator, and its SIU column is
+     incomplete */
+  ok1(fixes[3].time == BrokenTime(11, 22, 41));
+  ok1(equals(fixes[3].location, -51.05195, -7.70611667));
+  ok1(fixes[3].siu == -1);
+
+  /* fixes are appended */
+  ok1(IGCParseFixes("B1122425103117N00742367EA0049000487\n", fixes) == 1);
+  ok1(fixes.size() == 5);
 }
 
 static void
@@ -251,13 +322,14 @@ TestDeclarationTurnpoint()
 
 int main()
 {
-  plan_tests(148);
+  plan_tests(183);
 
   TestHeader();
   TestDate();
   TestLocation();
   TestExtensions();
   TestFix();
+  TestFixes();
   TestFixTime();
   TestDeclarationHeader();
   TestDeclarationTurnpoint();
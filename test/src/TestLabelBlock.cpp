@@ -0,0 +1,50 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#include "Renderer/LabelBlock.hpp"
+#include "TestUtil.hpp"
+
+static constexpr PixelRect
+MakeRect(int x, int y, unsigned width=40, unsigned height=12) noexcept
+{
+  return PixelRect{PixelPoint{x, y}, PixelSize{width, height}};
+}
+
+int main()
+{
+  plan_tests(11);
+
+  LabelBlock lb;
+
+  ok1(lb.check(MakeRect(10, 10)));
+
+  /* overlapping */
+  ok1(!lb.check(MakeRect(30, 15)));
+
+  /* adjacent, but not overlapping */
+  ok1(lb.check(MakeRect(10, 30)));
+
+  /* overlapping across a cell boundary */
+  ok1(lb.check(MakeRect(60, 60)));
+  ok1(!lb.check(MakeRect(90, 70)));
+
+  /* negative coordinates */
+  ok1(lb.check(MakeRect(-50, -20)));
+  ok1(!lb.check(MakeRect(-30, -15)));
+
+  /* a large rectangle covering all of the above */
+  ok1(!lb.check(MakeRect(0, 0, 1000, 1000)));
+
+  /* many labels in one row; the old bucket list was limited to 64
+     per horizontal strip and ignored the rest */
+  bool all_added = true;
+  for (int i = 0; i < 200; ++i)
+    all_added = lb.check(MakeRect(i * 50, 500, 45)) && all_added;
+  ok1(all_added);
+  ok1(!lb.check(MakeRect(199 * 50 + 10, 505)));
+
+  lb.reset();
+  ok1(lb.check(MakeRect(30, 15)));
+
+  return exit_status();
+}
@@ -2,6 +2,7 @@
 // Copyright The XCSoar Project
 
 #include "IGC/IGCWriter.hpp"
+#include "IGC/AsyncIGCWriter.hpp"
 #include "system/FileUtil.hpp"
 #include "NMEA/Info.hpp"
 #include "io/FileLineReader.hpp"
@@ -10,6 +11,7 @@
 
 #include <cassert>
 #include <cstdio>
+#include <string>
 
 static void
 CheckTextFile(Path path, const char *const* expect)
@@ -62,20 +64,19 @@ static const char *const expect[] = {
   "E112243my_event",
   "B1122435103117N00742367EA004900048700000",
   "LPLTmy_note",
+  "LPLTlong_note",
   "F112253121701",
   "B1122535103117S00742367WA004900048700000",
   NULL
 };
 
-static void
-Run(IGCWriter &writer)
+static NMEAInfo
+MakeInfo()
 {
   static const GeoPoint home(Angle::Degrees(7.7061111111111114),
                              Angle::Degrees(51.051944444444445));
-  static const GeoPoint tp(Angle::Degrees(10.726111111111111),
-                           Angle::Degrees(50.6322));
 
-  static NMEAInfo i;
+  NMEAInfo i{};
   i.clock = i.time = TimeStamp{std::chrono::seconds{1}};
   i.time_available.Update(i.clock);
   i.date_time_utc.year = 2010;
@@ -90,6 +91,16 @@ Run(IGCWriter &writer)
   i.gps_altitude_available.Update(i.clock);
   i.ProvidePressureAltitude(490);
   i.ProvideBaroAltitudeTrue(400);
+  return i;
+}
+
+static void
+WriteHeader(IGCWriter &writer, const NMEAInfo &i)
+{
+  static const GeoPoint home(Angle::Degrees(7.7061111111111114),
+                             Angle::Degrees(51.051944444444445));
+  static const GeoPoint tp(Angle::Degrees(10.726111111111111),
+                           Angle::Degrees(50.6322));
 
   writer.WriteHeader(i.date_time_utc, "Pilot Name", "CoPilot Name", "ASK-21",
                      "D-1234", "34", "FOO", "bar", false);
@@ -98,7 +109,16 @@ Run(IGCWriter &writer)
   writer.AddDeclaration(tp, "Suhl");
   writer.AddDeclaration(home, "Bergneustadt");
   writer.EndDeclaration();
+}
 
+/**
+ * Write the fixes, either directly to the #IGCWriter or through an
+ * #AsyncIGCWriter.
+ */
+template<typename W>
+static void
+WriteRecords(W &writer, NMEAInfo &i)
+{
   writer.LogEmptyFRecord(i.date_time_utc);
 
   i.date_time_utc.second += 5;
@@ -108,6 +128,14 @@ Run(IGCWriter &writer)
   i.date_time_utc.second += 5;
   writer.LoggerNote("my_note");
 
+  /* a long note; the non-ASCII characters are dropped by the writer,
+     and they must not push the ASCII ones out of the record */
+  std::string long_note;
+  for (unsigned j = 0; j < 200; ++j)
+    long_note += "\xc3\xa4";
+  long_note += "long_note";
+  writer.LoggerNote(long_note.c_str());
+
   int satellites[GPSState::MAXSATELLITES];
   for (unsigned i = 0; i < GPSState::MAXSATELLITES; ++i)
     satellites[i] = 0;
@@ -122,6 +150,15 @@ Run(IGCWriter &writer)
   i.location = GeoPoint(Angle::Degrees(-7.7061111111111114),
                         Angle::Degrees(-51.051944444444445));
   writer.LogPoint(i);
+}
+
+static void
+Run(Path path)
+{
+  IGCWriter writer(path);
+  NMEAInfo i = MakeInfo();
+  WriteHeader(writer, i);
+  WriteRecords(writer, i);
 
   writer.Flush();
   writer.Sign();
@@ -129,26 +166,49 @@ Run(IGCWriter &writer)
 }
 
 static void
-Run(Path path)
+RunAsync(Path path, std::chrono::steady_clock::duration sync_interval)
 {
   IGCWriter writer(path);
-  Run(writer);
+  NMEAInfo i = MakeInfo();
+  WriteHeader(writer, i);
+
+  AsyncIGCWriter async_writer(writer, sync_interval);
+  WriteRecords(async_writer, i);
+  async_writer.Stop();
+
+  writer.Flush();
+  writer.Sign();
+  writer.Sync();
+}
+
+static void
+Check(Path path)
+{
+  CheckTextFile(path, expect);
+
+  GRecord grecord;
+  grecord.Initialize();
+  grecord.VerifyGRecordInFile(path);
 }
 
 int main()
 try {
-  plan_tests(51);
+  plan_tests(159);
 
   const Path path("output/test/test.igc");
   File::Delete(path);
-
   Run(path);
+  Check(path);
 
-  CheckTextFile(path, expect);
+  /* sync after each record */
+  File::Delete(path);
+  RunAsync(path, {});
+  Check(path);
 
-  GRecord grecord;
-  grecord.Initialize();
-  grecord.VerifyGRecordInFile(path);
+  /* everything is written by AsyncIGCWriter::Stop() */
+  File::Delete(path);
+  RunAsync(path, std::chrono::hours{1});
+  Check(path);
 
   return exit_status();
 } catch (...) {
@@ -0,0 +1,103 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#include "NMEA/InputLine.hpp"
+#include "NMEA/Checksum.hpp"
+#include "TestUtil.hpp"
+
+#include <string>
+
+using std::string_view_literals::operator""sv;
+
+static void
+TestColumns()
+{
+  NMEAInputLine line("$GPRMC,082311,A,5103.5403,N,00741.5742,E,055.3,022.4,230610,000.3,W*6C");
+
+  ok1(line.IsChecksumValid());
+  ok1(line.ReadView() == "$GPRMC"sv);
+  ok1(line.ReadView() == "082311"sv);
+  ok1(line.ReadOneChar() == 'A');
+
+  double value;
+  ok1(line.ReadChecked(value));
+  ok1(equals(value, 5103.5403));
+  ok1(line.ReadView() == "N"sv);
+  line.Skip(4);
+  ok1(line.ReadView() == "230610"sv);
+  ok1(line.ReadView() == "000.3"sv);
+
+  /* the column ends at the asterisk */
+  ok1(line.ReadView() == "W"sv);
+  ok1(line.IsEmpty());
+  ok1(line.ReadView().empty());
+}
+
+static void
+TestChecksum()
+{
+  ok1(!NMEAInputLine("$PFLAU,0,0,0,1,0,,0,,*00").IsChecksumValid());
+  ok1(NMEAInputLine("$PFLAU,0,0,0,1,0,,0,,*63").IsChecksumValid());
+  ok1(NMEAInputLine("$PFLAU,0,0,0,1,0,,0,,*063").IsChecksumValid());
+  ok1(!NMEAInputLine("$PFLAU,0,0,0,1,0,,0,,*6").IsChecksumValid());
+  ok1(!NMEAInputLine("$PFLAU,0,0,0,1,0,,0,,*").IsChecksumValid());
+  ok1(!NMEAInputLine("$PFLAU,0,0,0,1,0,,0,,*63\r").IsChecksumValid());
+  ok1(!NMEAInputLine("$PFLAU,0,0,0,1,0,,0,,").IsChecksumValid());
+  ok1(!NMEAInputLine("").IsChecksumValid());
+
+  /* the checksum follows the last asterisk, but columns end at the
+     first one */
+  char buffer[64] = "$PTEST,a*b,c";
+  AppendNMEAChecksum(buffer);
+  NMEAInputLine line(buffer);
+  ok1(VerifyNMEAChecksum(buffer));
+  ok1(line.IsChecksumValid());
+  line.Skip();
+  ok1(line.ReadView() == "a"sv);
+  ok1(line.IsEmpty());
+}
+
+/**
+ * Verify that the separator index matches a plain #CSVLine for all
+ * alignments and for more columns than fit into the index.
+ */
+static void
+TestManyColumns()
+{
+  std::string s = "$";
+  for (unsigned i = 0; i < 100; ++i) {
+    s += ',';
+    s += std::to_string(i);
+    s.append(i % 9, 'x');
+  }
+
+  const CSVLine csv_line(s.c_str());
+
+  char buffer[1024];
+  s.copy(buffer, s.size());
+  buffer[s.size()] = '\0';
+  AppendNMEAChecksum(buffer);
+
+  NMEAInputLine line(buffer);
+  ok1(line.IsChecksumValid());
+
+  CSVLine csv = csv_line;
+  bool equal = true;
+  while (!csv.IsEmpty())
+    if (line.ReadView() != csv.ReadView())
+      equal = false;
+
+  ok1(equal);
+  ok1(line.IsEmpty());
+}
+
+int main()
+{
+  plan_tests(27);
+
+  TestColumns();
+  TestChecksum();
+  TestManyColumns();
+
+  return exit_status();
+}
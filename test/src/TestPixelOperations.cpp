@@ -0,0 +1,215 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+/*
+ * Verify that the optimised (SIMD) pixel operations produce exactly
+ * the same pixels as the portable ones.
+ */
+
+#include "ui/canvas/memory/Optimised.hpp"
+#include "ui/canvas/memory/RasterCanvas.hpp"
+#include "TestUtil.hpp"
+
+#include <random>
+#include <vector>
+
+/**
+ * The MMX and NEON alpha kernels round differently than the portable
+ * code; only the SSE2 kernels are exact.
+ */
+#if defined(__SSE2__) || !(defined(__MMX__) || defined(__ARM_NEON__))
+static constexpr bool exact_alpha = true;
+#else
+static constexpr bool exact_alpha = false;
+#endif
+
+/**
+ * Lengths which cover empty spans, pure remainders and whole vectors
+ * plus remainders.
+ */
+static constexpr unsigned MAX_LENGTH = 71;
+
+static std::minstd_rand rng;
+
+static uint8_t
+RandomByte() noexcept
+{
+  return uint8_t(rng());
+}
+
+static Luminosity8
+RandomColor(GreyscalePixelTraits) noexcept
+{
+  /* few distinct values, so color keys match often */
+  return RandomByte() & 0x3;
+}
+
+#ifndef GREYSCALE
+
+static BGRA8Color
+RandomColor(BGRAPixelTraits) noexcept
+{
+  const uint8_t v = RandomByte() & 0x3;
+  return {v, uint8_t(v * 7), uint8_t(v * 3), uint8_t(0xff - v)};
+}
+
+#endif
+
+template<typename PixelTraits>
+static std::vector<typename PixelTraits::color_type>
+RandomPixels(unsigned n, bool small=false)
+{
+  std::vector<typename PixelTraits::color_type> v(n);
+  for (auto &i : v) {
+    if (small)
+      i = RandomColor(PixelTraits{});
+    else if constexpr (std::is_same_v<PixelTraits, GreyscalePixelTraits>)
+      i = RandomByte();
+    else
+      i = {RandomByte(), RandomByte(), RandomByte(), RandomByte()};
+  }
+
+  return v;
+}
+
+/**
+ * Apply CopyPixels() of both operations to the same random data at
+ * all lengths (and with an unaligned offset), and compare the
+ * results.
+ */
+template<typename PixelTraits, typename A, typename B>
+static bool
+CompareCopy(const A &a, const B &b, bool small=false)
+{
+  for (unsigned n = 0; n <= MAX_LENGTH; ++n) {
+    for (unsigned offset = 0; offset < 2; ++offset) {
+      const auto src = RandomPixels<PixelTraits>(n + offset, small);
+      const auto dest = RandomPixels<PixelTraits>(n + offset, small);
+
+      auto result_a = dest, result_b = dest;
+      a.CopyPixels(result_a.data() + offset, src.data() + offset, n);
+      b.CopyPixels(result_b.data() + offset, src.data() + offset, n);
+
+      if (result_a != result_b)
+        return false;
+    }
+  }
+
+  return true;
+}
+
+template<typename PixelTraits, typename A, typename B>
+static bool
+CompareFill(const A &a, const B &b)
+{
+  for (unsigned n = 0; n <= MAX_LENGTH; ++n) {
+    const auto dest = RandomPixels<PixelTraits>(n + 1);
+    const auto color = RandomPixels<PixelTraits>(1).front();
+
+    auto result_a = dest, result_b = dest;
+    a.FillPixels(result_a.data() + 1, n, color);
+    b.FillPixels(result_b.data() + 1, n, color);
+
+    if (result_a != result_b)
+      return false;
+  }
+
+  return true;
+}
+
+template<typename PixelTraits>
+static void
+TestAlpha()
+{
+  bool copy_ok = true, fill_ok = true;
+
+  for (const unsigned alpha : {0u, 1u, 64u, 127u, 128u, 200u, 255u}) {
+    const AlphaPixelOperations<PixelTraits> optimised(alpha);
+    const PortableAlphaPixelOperations<PixelTraits> portable(alpha);
+
+    copy_ok &= CompareCopy<PixelTraits>(optimised, portable);
+    fill_ok &= CompareFill<PixelTraits>(optimised, portable);
+  }
+
+  ok1(copy_ok || !exact_alpha);
+  ok1(fill_ok || !exact_alpha);
+}
+
+template<typename PixelTraits>
+static void
+TestBitOr()
+{
+  ok1(CompareCopy<PixelTraits>(BitOrPixelOperations<PixelTraits>(),
+                               PortableBitOrPixelOperations<PixelTraits>()));
+}
+
+template<typename PixelTraits>
+static void
+TestTransparent()
+{
+  const auto key = RandomColor(PixelTraits{});
+
+  ok1(CompareCopy<PixelTraits>(TransparentPixelOperations<PixelTraits>{key},
+                               PortableTransparentPixelOperations<PixelTraits>{key},
+                               true));
+}
+
+/**
+ * Scale by two horizontally, which is special-cased for SIMD.
+ */
+template<typename PixelTraits>
+static void
+TestScaleTwice()
+{
+  using color_type = typename PixelTraits::color_type;
+
+  bool result = true;
+
+  for (unsigned width = 1; width <= MAX_LENGTH; width += 5) {
+    const PixelSize src_size{width, 3u};
+    const PixelSize dest_size{width * 2, 3u};
+
+    const auto src = RandomPixels<PixelTraits>(src_size.width * src_size.height);
+    std::vector<color_type> dest(dest_size.width * dest_size.height);
+
+    RasterCanvas<PixelTraits> canvas({dest.data(),
+                                      dest_size.width * sizeof(color_type),
+                                      dest_size});
+    canvas.ScaleRectangle({0, 0}, dest_size,
+                          src.data(), src_size.width * sizeof(color_type),
+                          src_size);
+
+    for (unsigned y = 0; y < dest_size.height; ++y)
+      for (unsigned x = 0; x < dest_size.width; ++x)
+        result &= dest[y * dest_size.width + x] ==
+          src[y * src_size.width + x / 2];
+  }
+
+  ok1(result);
+}
+
+template<typename PixelTraits>
+static void
+TestPixelTraits()
+{
+  TestAlpha<PixelTraits>();
+  TestBitOr<PixelTraits>();
+  TestTransparent<PixelTraits>();
+  TestScaleTwice<PixelTraits>();
+}
+
+int main()
+{
+#ifdef GREYSCALE
+  plan_tests(5);
+#else
+  plan_tests(10);
+#endif
+
+  TestPixelTraits<GreyscalePixelTraits>();
+#ifndef GREYSCALE
+  TestPixelTraits<BGRAPixelTraits>();
+#endif
+
+  return exit_status();
+}
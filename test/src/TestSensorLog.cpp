@@ -0,0 +1,244 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#include "Logger/SensorLog.hpp"
+#include "io/BufferedOutputStream.hxx"
+#include "io/StringOutputStream.hxx"
+#include "util/SpanCast.hxx"
+#include "TestUtil.hpp"
+
+#include <cmath>
+#include <string>
+
+using SensorLog::Field;
+using SensorLog::Sample;
+
+/**
+ * Two minutes of 10 Hz samples.
+ */
+static constexpr unsigned N_SAMPLES = 1200;
+static constexpr uint64_t SAMPLE_INTERVAL = 100;
+
+/**
+ * Generate a sample which looks like a glider circling in a thermal.
+ */
+static Sample
+MakeSample(unsigned i)
+{
+  const double t = i * SAMPLE_INTERVAL / 1000.;
+
+  Sample sample;
+  sample.Clear(i * SAMPLE_INTERVAL);
+  sample.Set(Field::TIME, 43200000 + i * SAMPLE_INTERVAL);
+  sample.Set(Field::DATE, 20240704);
+  sample.Set(Field::LATITUDE, 515000000 + int32_t(3000 * std::sin(t / 5)));
+  sample.Set(Field::LONGITUDE, 72000000 + int32_t(5000 * std::cos(t / 5)));
+  sample.Set(Field::GPS_ALTITUDE, 120000 + int32_t(t * 150));
+  sample.Set(Field::FIX_QUALITY, 1);
+  sample.Set(Field::SATELLITES_USED, 9 + (i / 300) % 2);
+  sample.Set(Field::GROUND_SPEED, 2200 + int32_t(300 * std::sin(t / 5)));
+  sample.Set(Field::TRACK, int32_t(std::fmod(t * 7200, 36000)));
+  sample.Set(Field::NONCOMP_VARIO, 150 + int32_t(80 * std::sin(t)));
+
+  /* the pressure sensor is missing in the first half */
+  if (i >= N_SAMPLES / 2) {
+    sample.Set(Field::STATIC_PRESSURE, 870000 - int32_t(t * 15));
+    sample.Set(Field::PRESSURE_ALTITUDE, 119000 + int32_t(t * 150));
+  }
+
+  return sample;
+}
+
+static std::string
+Line(unsigned i)
+{
+  return "$GPRMC,line" + std::to_string(i);
+}
+
+/**
+ * Write all samples, and a line each second.
+ */
+static std::string
+Write(bool with_lines, bool finish, std::size_t &n_keyframes)
+{
+  StringOutputStream sos;
+  BufferedOutputStream bos(sos);
+  SensorLog::Writer writer(bos);
+
+  for (unsigned i = 0; i < N_SAMPLES; ++i) {
+    if (with_lines && i % 10 == 0)
+      writer.WriteLine(i * SAMPLE_INTERVAL, i % 3, Line(i));
+
+    writer.WriteSample(MakeSample(i));
+  }
+
+  n_keyframes = writer.GetIndex().size();
+
+  if (finish)
+    writer.Finish();
+
+  bos.Flush();
+  return std::move(sos).GetValue();
+}
+
+/**
+ * Read all frames and compare them with the generated ones.
+ *
+ * @return the number of samples which were read
+ */
+static unsigned
+ReadAll(SensorLog::Reader &reader, bool with_lines, bool &valid)
+{
+  valid = true;
+  unsigned n = 0;
+
+  while (true) {
+    switch (reader.Next()) {
+    case SensorLog::Reader::Frame::END:
+      return n;
+
+    case SensorLog::Reader::Frame::LINE:
+      if (!with_lines || n % 10 != 0 ||
+          reader.GetDevice() != n % 3 ||
+          reader.GetLine() != Line(n) ||
+          reader.GetClock() != n * SAMPLE_INTERVAL)
+        valid = false;
+      break;
+
+    case SensorLog::Reader::Frame::SAMPLE:
+      if (!(reader.GetSample() == MakeSample(n)))
+        valid = false;
+      ++n;
+      break;
+    }
+  }
+}
+
+static void
+TestRoundtrip()
+{
+  std::size_t n_keyframes;
+  const std::string data = Write(true, true, n_keyframes);
+
+  SensorLog::Reader reader{AsBytes(data)};
+  ok1(n_keyframes == N_SAMPLES * SAMPLE_INTERVAL /
+      SensorLog::Writer::KEYFRAME_INTERVAL);
+  ok1(reader.GetIndex().size() == n_keyframes);
+
+  bool valid;
+  ok1(ReadAll(reader, true, valid) == N_SAMPLES);
+  ok1(valid);
+}
+
+static void
+TestSeek()
+{
+  std::size_t n_keyframes;
+  const std::string data = Write(true, true, n_keyframes);
+  SensorLog::Reader reader{AsBytes(data)};
+
+  reader.Seek(55000);
+  ok1(reader.Next() == SensorLog::Reader::Frame::LINE);
+  ok1(reader.GetClock() == 50000);
+  ok1(reader.GetLine() == Line(500));
+  ok1(reader.Next() == SensorLog::Reader::Frame::SAMPLE);
+  ok1(reader.GetSample() == MakeSample(500));
+
+  /* seeking before the first keyframe restarts at the beginning */
+  reader.Seek(0);
+  ok1(reader.Next() == SensorLog::Reader::Frame::LINE);
+  ok1(reader.Next() == SensorLog::Reader::Frame::SAMPLE);
+  ok1(reader.GetSample() == MakeSample(0));
+
+  /* beyond the end: the last keyframe */
+  reader.Seek(1000000);
+  ok1(reader.Next() == SensorLog::Reader::Frame::LINE);
+  ok1(reader.GetClock() == 110000);
+}
+
+static void
+TestUnfinished()
+{
+  std::size_t n_keyframes;
+  const std::string data = Write(false, false, n_keyframes);
+
+  /* no index: it is rebuilt by scanning the file */
+  {
+    SensorLog::Reader reader{AsBytes(data)};
+    ok1(reader.GetIndex().size() == n_keyframes);
+
+    bool valid;
+    ok1(ReadAll(reader, false, valid) == N_SAMPLES);
+    ok1(valid);
+  }
+
+  /* the last frame is truncated */
+  {
+    SensorLog::Reader reader{AsBytes(data).first(data.size() - 1)};
+    ok1(reader.GetIndex().size() == n_keyframes);
+
+    bool valid;
+    ok1(ReadAll(reader, false, valid) == N_SAMPLES - 1);
+    ok1(valid);
+  }
+}
+
+static bool
+Throws(std::string_view data)
+{
+  try {
+    SensorLog::Reader reader{AsBytes(data)};
+    while (reader.Next() != SensorLog::Reader::Frame::END) {}
+    return false;
+  } catch (...) {
+    return true;
+  }
+}
+
+static void
+TestMalformed()
+{
+  ok1(Throws(""));
+  ok1(Throws("$GPRMC,1234"));
+
+  std::size_t n_keyframes;
+  std::string data = Write(false, true, n_keyframes);
+
+  std::string version = data;
+  version[4] = 99;
+  ok1(Throws(version));
+
+  /* an unknown frame tag */
+  std::string tag = data;
+  tag[8] = 0x7f;
+  ok1(Throws(tag));
+
+  /* a broken footer is ignored */
+  std::string footer = data;
+  footer[footer.size() - 5] ^= 0x55;
+  ok1(!Throws(footer));
+}
+
+static void
+TestCompact()
+{
+  std::size_t n_keyframes;
+  const std::string data = Write(false, true, n_keyframes);
+
+  /* a GGA + RMC sentence pair is more than 100 bytes */
+  const double bytes_per_sample = double(data.size()) / N_SAMPLES;
+  ok1(bytes_per_sample < 16);
+}
+
+int main()
+{
+  plan_tests(26);
+
+  TestRoundtrip();
+  TestSeek();
+  TestUnfinished();
+  TestMalformed();
+  TestCompact();
+
+  return exit_status();
+}
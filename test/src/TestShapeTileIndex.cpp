@@ -0,0 +1,166 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#include "Topography/ShapeTileIndex.hpp"
+#include "io/BufferedOutputStream.hxx"
+#include "io/BufferedReader.hxx"
+#include "io/MemoryReader.hxx"
+#include "io/StringOutputStream.hxx"
+#include "util/SpanCast.hxx"
+#include "TestUtil.hpp"
+
+#include <algorithm>
+#include <set>
+#include <string>
+
+static constexpr rectObj file_bounds{0, 0, 128, 128};
+
+static constexpr rectObj shape_bounds[] = {
+  /* 0: a point, goes to the finest level */
+  {10.5, 10.5, 10.5, 10.5},
+
+  /* 1: a small line, finest level, spans two cells */
+  {20.5, 30.5, 21.5, 30.8},
+
+  /* 2: a medium sized shape, middle level */
+  {64, 64, 66, 67},
+
+  /* 3: a shape covering the whole file, coarsest level */
+  {0, 0, 128, 128},
+
+  /* 4: a NULL shape, not indexed */
+  {0, 0, -1, -1},
+};
+
+/**
+ * Collect the ids of all shapes listed in the cells overlapping the
+ * given rectangle.
+ */
+static std::set<uint32_t>
+Query(const ShapeTileIndex &index, const rectObj &rect)
+{
+  std::set<uint32_t> result;
+
+  const auto cells = index.GetCells(rect);
+  for (unsigned level = 0; level < ShapeTileIndex::N_LEVELS; ++level) {
+    const auto &range = cells[level];
+    for (unsigned y = range.y0; y < range.y1; ++y)
+      for (unsigned x = range.x0; x < range.x1; ++x)
+        for (const uint32_t i : index.GetShapes(level, x, y))
+          result.insert(i);
+  }
+
+  return result;
+}
+
+static void
+TestQuery(const ShapeTileIndex &index)
+{
+  ok1(index.IsDefined());
+
+  ok1(Query(index, {0, 0, 128, 128}) ==
+      (std::set<uint32_t>{0, 1, 2, 3}));
+
+  ok1(Query(index, {10, 10, 11, 11}) ==
+      (std::set<uint32_t>{0, 3}));
+
+  ok1(Query(index, {21.2, 30, 21.3, 31}) ==
+      (std::set<uint32_t>{1, 3}));
+
+  ok1(Query(index, {65, 65, 66, 66}) ==
+      (std::set<uint32_t>{2, 3}));
+
+  /* outside of the file */
+  ok1(Query(index, {200, 200, 300, 300}).empty());
+}
+
+static void
+TestBuild()
+{
+  ShapeTileIndex index;
+  ok1(!index.IsDefined());
+  ok1(index.GetCells(file_bounds)[0].empty());
+
+  index.Build(file_bounds, shape_bounds);
+  TestQuery(index);
+
+  /* the cell ranges of a small rectangle */
+  const auto cells = index.GetCells({10, 10, 11, 11});
+  ok1((cells[0] == ShapeTileIndex::CellRange{0, 0, 1, 1}));
+  ok1((cells[2] == ShapeTileIndex::CellRange{10, 10, 12, 12}));
+  ok1(cells[2].Contains(11, 10));
+  ok1(!cells[2].Contains(12, 10));
+
+  /* the line is listed in both cells it touches */
+  ok1(index.GetShapes(2, 20, 30).size() == 1);
+  ok1(index.GetShapes(2, 21, 30).size() == 1);
+  ok1(index.GetShapes(2, 22, 30).empty());
+}
+
+static std::string
+Save(const ShapeTileIndex &index)
+{
+  StringOutputStream sos;
+  BufferedOutputStream bos(sos);
+  index.Save(bos);
+  bos.Flush();
+  return std::move(sos).GetValue();
+}
+
+static void
+TestSaveLoad()
+{
+  ShapeTileIndex index;
+  index.Build(file_bounds, shape_bounds);
+  const std::string data = Save(index);
+
+  {
+    ShapeTileIndex loaded;
+    MemoryReader mr{AsBytes(data)};
+    BufferedReader br{mr};
+    loaded.Load(br, file_bounds, std::size(shape_bounds));
+    TestQuery(loaded);
+  }
+
+  /* mismatching shapefile */
+  {
+    ShapeTileIndex loaded;
+    MemoryReader mr{AsBytes(data)};
+    BufferedReader br{mr};
+    bool failed = false;
+    try {
+      loaded.Load(br, file_bounds, std::size(shape_bounds) + 1);
+    } catch (...) {
+      failed = true;
+    }
+
+    ok1(failed);
+    ok1(!loaded.IsDefined());
+  }
+
+  /* truncated file */
+  {
+    ShapeTileIndex loaded;
+    MemoryReader mr{AsBytes(data).first(data.size() - 1)};
+    BufferedReader br{mr};
+    bool failed = false;
+    try {
+      loaded.Load(br, file_bounds, std::size(shape_bounds));
+    } catch (...) {
+      failed = true;
+    }
+
+    ok1(failed);
+    ok1(!loaded.IsDefined());
+  }
+}
+
+int main()
+{
+  plan_tests(25);
+
+  TestBuild();
+  TestSaveLoad();
+
+  return exit_status();
+}
@@ -0,0 +1,194 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#include "FLARM/List.hpp"
+#include "TestUtil.hpp"
+
+#include <cmath>
+
+#include <stdio.h>
+
+static FlarmId
+MakeId(unsigned i) noexcept
+{
+  char buffer[16];
+  snprintf(buffer, sizeof(buffer), "%06X", 0x100000 + i * 0x111);
+  return FlarmId::Parse(buffer, nullptr);
+}
+
+static void
+Fill(TrafficList &list, unsigned n, TimeStamp clock) noexcept
+{
+  for (unsigned i = 0; i < n; ++i) {
+    if (list.FindTraffic(MakeId(i)) != nullptr)
+      continue;
+
+    FlarmTraffic *traffic = list.AllocateTraffic(MakeId(i));
+    if (traffic == nullptr)
+      return;
+
+    traffic->valid.Update(clock);
+
+    /* spread the targets over +/-24 km, i.e. partly outside of the
+       grid */
+    traffic->relative_north = double(int(i * 7919 % 48000) - 24000);
+    traffic->relative_east = double(int(i * 104729 % 48000) - 24000);
+    traffic->distance = std::hypot(traffic->relative_north,
+                                   traffic->relative_east);
+  }
+}
+
+/**
+ * Is every item findable by its id at its own position?
+ */
+static bool
+CheckIndex(const TrafficList &list) noexcept
+{
+  for (const auto &traffic : list.list)
+    if (list.FindTraffic(traffic.id) != &traffic)
+      return false;
+
+  return true;
+}
+
+static unsigned
+CountWithinRange(const TrafficList &list, double range) noexcept
+{
+  unsigned n = 0;
+  list.VisitWithinRange(range, [&n](const FlarmTraffic &){
+    ++n;
+    return true;
+  });
+  return n;
+}
+
+static unsigned
+BruteForceWithinRange(const TrafficList &list, double range) noexcept
+{
+  unsigned n = 0;
+  for (const auto &traffic : list.list)
+    if (double(traffic.distance) <= range)
+      ++n;
+  return n;
+}
+
+static void
+TestAllocate()
+{
+  const TimeStamp clock{FloatDuration{1000}};
+
+  TrafficList list;
+  list.Clear();
+
+  Fill(list, TrafficList::MAX_COUNT + 10, clock);
+  ok1(list.GetActiveTrafficCount() == TrafficList::MAX_COUNT);
+  ok1(CheckIndex(list));
+  ok1(list.FindTraffic(MakeId(TrafficList::MAX_COUNT)) == nullptr);
+  ok1(list.AllocateTraffic(MakeId(TrafficList::MAX_COUNT)) == nullptr);
+
+  /* a copy includes valid indexes */
+  const TrafficList copy = list;
+  ok1(CheckIndex(copy));
+}
+
+static void
+TestExpire()
+{
+  const TimeStamp clock{FloatDuration{1000}};
+
+  constexpr unsigned n = TrafficList::MAX_COUNT;
+
+  TrafficList list;
+  list.Clear();
+  Fill(list, n, clock);
+
+  /* let every third target time out */
+  for (unsigned i = 0; i < list.list.size(); ++i)
+    if (i % 3 == 0)
+      list.list[i].valid.Update(clock - std::chrono::seconds(10));
+
+  list.Expire(clock);
+  ok1(list.GetActiveTrafficCount() == n - (n + 2) / 3);
+  ok1(CheckIndex(list));
+
+  bool ok = true;
+  for (unsigned i = 0; i < n; ++i)
+    if ((list.FindTraffic(MakeId(i)) == nullptr) != (i % 3 == 0))
+      ok = false;
+  ok1(ok);
+
+  /* refill, reusing the slots of the removed ids */
+  Fill(list, n, clock);
+  ok1(list.GetActiveTrafficCount() == n);
+  ok1(CheckIndex(list));
+}
+
+static void
+TestComplement()
+{
+  const TimeStamp clock{FloatDuration{1000}};
+
+  /* leave room for one more item in the merged list */
+  constexpr unsigned n = TrafficList::MAX_COUNT - 2;
+
+  TrafficList a, b;
+  a.Clear();
+  b.Clear();
+
+  Fill(b, n, clock);
+
+  /* copy into an empty list */
+  a.Complement(b);
+  ok1(a.GetActiveTrafficCount() == n);
+  ok1(CheckIndex(a));
+
+  /* merge */
+  TrafficList c;
+  c.Clear();
+  c.AllocateTraffic(MakeId(1000))->valid.Update(clock);
+  c.AllocateTraffic(MakeId(10))->valid.Update(clock);
+  c.Complement(b);
+  ok1(c.GetActiveTrafficCount() == n + 1);
+  ok1(CheckIndex(c));
+}
+
+static void
+TestRange()
+{
+  const TimeStamp clock{FloatDuration{1000}};
+
+  TrafficList list;
+  list.Clear();
+  Fill(list, TrafficList::MAX_COUNT, clock);
+
+  static constexpr double ranges[] = { 0, 1500, 4000, 9000, 15999, 40000 };
+
+  /* linear search */
+  bool ok = true;
+  for (const double range : ranges)
+    if (CountWithinRange(list, range) != BruteForceWithinRange(list, range))
+      ok = false;
+  ok1(ok);
+
+  /* grid */
+  list.UpdateGrid();
+  ok = true;
+  for (const double range : ranges)
+    if (CountWithinRange(list, range) != BruteForceWithinRange(list, range))
+      ok = false;
+  ok1(ok);
+
+  ok1(list.InCloseRange() == (BruteForceWithinRange(list, 3999) > 0));
+}
+
+int main()
+{
+  plan_tests(17);
+
+  TestAllocate();
+  TestExpire();
+  TestComplement();
+  TestRange();
+
+  return exit_status();
+}
@@ -0,0 +1,60 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#include "Audio/VarioSynthesiser.hpp"
+#include "TestUtil.hpp"
+
+#include <algorithm>
+
+static constexpr unsigned sample_rate = 44100;
+
+/* 10 ms */
+static constexpr size_t buffer_size = sample_rate / 100;
+
+static int16_t buffer[buffer_size];
+
+static bool
+IsSilent() noexcept
+{
+  return std::all_of(std::begin(buffer), std::end(buffer),
+                     [](int16_t sample){ return sample == 0; });
+}
+
+int
+main()
+{
+  plan_tests(9);
+
+  VarioSynthesiser synthesiser(sample_rate);
+
+  /* silent initially */
+  synthesiser.Synthesise(buffer, buffer_size);
+  ok1(IsSilent());
+  ok1(synthesiser.ConsumeLatency() == std::nullopt);
+
+  /* sinking: continuous tone, which is audible in the very next
+     buffer */
+  synthesiser.SetVario(-2);
+  synthesiser.Synthesise(buffer, buffer_size);
+  ok1(!IsSilent());
+
+  const auto latency = synthesiser.ConsumeLatency();
+  ok1(latency.has_value());
+  ok1(latency && *latency >= VarioSynthesiser::Clock::duration::zero() &&
+      *latency < std::chrono::milliseconds(20));
+  ok1(synthesiser.ConsumeLatency() == std::nullopt);
+
+  /* no new value: no latency sample */
+  synthesiser.Synthesise(buffer, buffer_size);
+  ok1(synthesiser.ConsumeLatency() == std::nullopt);
+
+  /* silence: the current sine wave is finished, then the output is
+     silent */
+  synthesiser.SetSilence();
+  synthesiser.Synthesise(buffer, buffer_size);
+  synthesiser.Synthesise(buffer, buffer_size);
+  ok1(IsSilent());
+  ok1(synthesiser.ConsumeLatency().has_value());
+
+  return exit_status();
+}
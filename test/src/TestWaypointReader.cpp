@@ -5,6 +5,7 @@
 #include "Waypoint/WaypointReaderBase.hpp"
 #include "Waypoint/WaypointReaderSeeYou.hpp"
 #include "Waypoint/CupWriter.hpp"
+#include "Waypoint/WaypointCache.hpp"
 #include "Waypoint/Factory.hpp"
 #include "Engine/Waypoint/Waypoints.hpp"
 #include "Terrain/RasterMap.hpp"
@@ -372,6 +373,89 @@ TestCupRoundTrip(const wp_vector &org_wp)
   }
 }
 
+static void
+TestCache(const wp_vector &org_wp)
+{
+  StringOutputStream sos;
+  WithBufferedOutputStream(sos, [&](BufferedOutputStream &bos){
+    SaveWaypointCache(bos, org_wp);
+  });
+  const auto s = std::move(sos).GetValue();
+
+  auto bytes = std::as_bytes(std::span{s.data(), s.size()});
+  MemoryReader mr(bytes);
+  BufferedReader br(mr);
+
+  const auto loaded = LoadWaypointCache(br,
+                                        WaypointFactory(WaypointOrigin::WATCHED, 3));
+  if (!ok1(loaded.size() == org_wp.size())) {
+    skip(9 * org_wp.size(), 0, "wrong number of cached waypoints");
+    return;
+  }
+
+  for (std::size_t i = 0; i < org_wp.size(); ++i) {
+    const auto &org = org_wp[i];
+    const auto &wp = loaded[i];
+
+    ok1(wp.location == org.location);
+    ok1(wp.has_elevation == org.has_elevation);
+    ok1(wp.elevation == org.elevation);
+    ok1(wp.name == org.name);
+    ok1(wp.comment == org.comment);
+    ok1(wp.type == org.type);
+    ok1(wp.flags.home == org.flags.home);
+    ok1(wp.runway.IsDirectionDefined() == org.runway.IsDirectionDefined() &&
+        (!wp.runway.IsDirectionDefined() ||
+         wp.runway.GetDirectionDegrees() == org.runway.GetDirectionDegrees()));
+
+    /* these are provided by the WaypointFactory */
+    ok1(wp.origin == WaypointOrigin::WATCHED && wp.file_num == 3);
+  }
+
+  /* a truncated cache must be rejected */
+  MemoryReader truncated_mr(bytes.first(bytes.size() - 1));
+  BufferedReader truncated_br(truncated_mr);
+  bool failed = false;
+  try {
+    LoadWaypointCache(truncated_br, WaypointFactory(WaypointOrigin::NONE));
+  } catch (...) {
+    failed = true;
+  }
+  ok1(failed);
+
+  /* a corrupt byte in the first record must never produce an
+     out-of-range enum value */
+  bool valid = true;
+  for (std::size_t i = 0; i < 64; ++i) {
+    std::string corrupt = s;
+    corrupt[8 + i] = '\xff';
+
+    auto corrupt_bytes = std::as_bytes(std::span{corrupt.data(),
+                                                 corrupt.size()});
+    MemoryReader corrupt_mr(corrupt_bytes);
+    BufferedReader corrupt_br(corrupt_mr);
+    try {
+      const auto result =
+        LoadWaypointCache(corrupt_br, WaypointFactory(WaypointOrigin::NONE));
+      if (!result.empty() &&
+          result.front().type > Waypoint::Type::PGLANDING)
+        valid = false;
+    } catch (...) {
+    }
+  }
+  ok1(valid);
+
+  /* an empty list is a valid cache */
+  StringOutputStream empty_sos;
+  WithBufferedOutputStream(empty_sos, [](BufferedOutputStream &bos){
+    SaveWaypointCache(bos, {});
+  });
+  const auto empty = std::move(empty_sos).GetValue();
+  MemoryReader empty_mr(std::as_bytes(std::span{empty.data(), empty.size()}));
+  BufferedReader empty_br(empty_mr);
+  ok1(LoadWaypointCache(empty_br, WaypointFactory(WaypointOrigin::NONE)).empty());
+}
+
 static void
 TestCupx()
 {
@@ -501,7 +585,7 @@ int main()
 {
   wp_vector org_wp = CreateOriginalWaypoints();
 
-  plan_tests(507 + 4);
+  plan_tests(507 + 4 + 4 + 9 * org_wp.size());
 
   TestWinPilot(org_wp);
   TestSeeYou(org_wp);
@@ -514,6 +598,7 @@ int main()
   TestCompeGPS_UTM(org_wp);
   TestCupWriter(org_wp);
   TestCupRoundTrip(org_wp);
+  TestCache(org_wp);
 
   return exit_status();
 }